@@ -40,6 +40,12 @@ readonly CONST_QEMU_NETWORK_ARGS="\
 -nic model=ne2k_pci,id=ne2k,hostfwd=udp::1797-:1797 -object filter-dump,id=filter0,netdev=ne2k,file=ne2k.dump, \
 -nic model=rtl8139,id=rtl8139,hostfwd=udp::1798-:1798 -object filter-dump,id=filter1,netdev=rtl8139,file=rtl8139.dump"
 
+readonly CONST_QEMU_VIRTIO_NETWORK_ARGS="\
+-nic model=virtio-net-pci,id=virtio,hostfwd=udp::1799-:1799 -object filter-dump,id=filter2,netdev=virtio,file=virtio.dump"
+
+readonly CONST_QEMU_E1000_NETWORK_ARGS="\
+-nic model=e1000,id=e1000,hostfwd=udp::1800-:1800 -object filter-dump,id=filter3,netdev=e1000,file=e1000.dump"
+
 readonly CONST_QEMU_OLD_AUDIO_ARGS="\
 -soundhw pcspk \
 -device sb16,irq=10,dma=1"
@@ -139,6 +145,21 @@ parse_cpu() {
   QEMU_CPU_OVERWRITE="true"
 }
 
+parse_network() {
+  local network=$1
+
+  if [ "${network}" == "default" ]; then
+    QEMU_NETWORK_ARGS="${CONST_QEMU_NETWORK_ARGS}"
+  elif [ "${network}" == "virtio" ]; then
+    QEMU_NETWORK_ARGS="${CONST_QEMU_NETWORK_ARGS} ${CONST_QEMU_VIRTIO_NETWORK_ARGS}"
+  elif [ "${network}" == "e1000" ]; then
+    QEMU_NETWORK_ARGS="${CONST_QEMU_NETWORK_ARGS} ${CONST_QEMU_E1000_NETWORK_ARGS}"
+  else
+    printf "Invalid network configuration '%s'!\\n" "${network}"
+    exit 1
+  fi
+}
+
 parse_debug() {
   local port=$1
 
@@ -167,6 +188,8 @@ print_usage() {
         Set the amount of ram, which qemu should use (e.g. 256, 1G, ...) (Default: 128M)
     -c, --cpu
         Set the CPU model, which qemu should emulate (e.g. 486, pentium, pentium2, ...) (Default: base)
+    -n, --network
+        Set the network configuration ([default] | [virtio] | [e1000]). 'virtio' and 'e1000' add a card of the given type to the default cards (Default: default)
     -d, --debug
         Set the port, on which qemu should listen for GDB clients (default: disabled)
     -h, --help
@@ -194,6 +217,9 @@ parse_args() {
     -c | --cpu)
       parse_cpu "$val"
       ;;
+    -n | --network)
+      parse_network "$val"
+      ;;
     -d | --debug)
       parse_debug "$val"
       ;;
@@ -44,10 +44,14 @@
 #include "device/storage/virtual/VirtualDiskDrive.h"
 #include "device/storage/ide/IdeController.h"
 #include "device/storage/ahci/AhciController.h"
+#include "device/storage/nvme/NvmeController.h"
+#include "device/storage/virtio/VirtioBlockDevice.h"
 #include "device/storage/floppy/FloppyController.h"
+#include "device/storage/StorageNode.h"
 #include "kernel/service/FilesystemService.h"
 #include "lib/util/reflection/InstanceFactory.h"
 #include "filesystem/fat/FatDriver.h"
+#include "filesystem/fat/FatFlushRunnable.h"
 #include "filesystem/memory/MemoryDriver.h"
 #include "filesystem/process/ProcessDriver.h"
 #include "filesystem/memory/NullNode.h"
@@ -67,6 +71,8 @@
 #include "device/hid/Keyboard.h"
 #include "kernel/service/NetworkService.h"
 #include "device/network/rtl8139/Rtl8139.h"
+#include "device/network/e1000/E1000.h"
+#include "device/network/virtio/VirtioNetworkDevice.h"
 #include "device/sound/speaker/PcSpeakerNode.h"
 #include "device/sound/soundblaster/SoundBlaster.h"
 #include "kernel/service/PowerManagementService.h"
@@ -623,6 +629,8 @@ void GatesOfHell::enter(uint32_t multibootMagic, const Kernel::Multiboot *multib
 
     Device::Storage::IdeController::initializeAvailableControllers();
     Device::Storage::AhciController::initializeAvailableControllers();
+    Device::Storage::NvmeController::initializeAvailableControllers();
+    Device::Storage::VirtioBlockDevice::initializeAvailableDevices();
 
     if (Device::Storage::FloppyController::isAvailable()) {
         auto *floppyController = new Device::Storage::FloppyController();
@@ -637,6 +645,10 @@ void GatesOfHell::enter(uint32_t multibootMagic, const Kernel::Multiboot *multib
     Util::Reflection::InstanceFactory::registerPrototype(new Filesystem::Fat::FatDriver());
     Util::Reflection::InstanceFactory::registerPrototype(new Filesystem::Iso::IsoDriver());
 
+    // Create thread to periodically write back pending data of FAT files
+    auto &fatFlushThread = Kernel::Thread::createKernelThread("FAT-Flusher", processService->getKernelProcess(), new Filesystem::Fat::FatFlushRunnable());
+    scheduler.ready(fatFlushThread);
+
     if (!multiboot->hasKernelOption("root")) {
         Util::Exception::throwException(Util::Exception::INVALID_ARGUMENT, "No root filesystem specified!");
     }
@@ -676,6 +688,11 @@ void GatesOfHell::enter(uint32_t multibootMagic, const Kernel::Multiboot *multib
     deviceDriver->addNode("", new Kernel::LogNode());
     deviceDriver->addNode("/", new Kernel::MemoryStatusNode());
 
+    // Expose storage devices and partitions for raw access
+    for (const auto &name : storageService->getDeviceNames()) {
+        deviceDriver->addNode("/", new Device::Storage::StorageNode(storageService->getDevice(name), name));
+    }
+
     if (Device::FirmwareConfiguration::isAvailable()) {
         auto *fwCfg = new Device::FirmwareConfiguration();
         auto *qemuDriver = new Filesystem::Qemu::FirmwareConfigurationDriver(*fwCfg);
@@ -757,6 +774,8 @@ void GatesOfHell::enter(uint32_t multibootMagic, const Kernel::Multiboot *multib
     networkService->initializeLoopback();
     Device::Network::Ne2000::initializeAvailableCards();
     Device::Network::Rtl8139::initializeAvailableCards();
+    Device::Network::E1000::initializeAvailableCards();
+    Device::Network::VirtioNetworkDevice::initializeAvailableDevices();
 
     if (Device::FirmwareConfiguration::isAvailable() && networkService->isNetworkDeviceRegistered("eth0")) {
         // Configure eth0 for QEMU virtual network
@@ -26,9 +26,18 @@
 #include "lib/util/io/stream/PrintStream.h"
 #include "lib/util/io/stream/InputStream.h"
 
+void concatenate(Util::Io::InputStream &stream) {
+    int16_t logChar = stream.read();
+    while (logChar != -1) {
+        Util::System::out << static_cast<char>(logChar) << Util::Io::PrintStream::flush;
+        logChar = stream.read();
+    }
+}
+
 int32_t main(int32_t argc, char *argv[]) {
     auto argumentParser = Util::ArgumentParser();
     argumentParser.setHelpText("Concatenate multiple files on stdout.\n"
+                               "Standard input is read, if no file is given.\n"
                                "Usage: cat [FILE]...\n"
                                "Options:\n"
                                "  -h, --help: Show this help message");
@@ -40,8 +49,9 @@ int32_t main(int32_t argc, char *argv[]) {
 
     auto arguments = argumentParser.getUnnamedArguments();
     if (arguments.length() == 0) {
-        Util::System::error << "cat: No arguments provided!" << Util::Io::PrintStream::endl << Util::Io::PrintStream::flush;
-        return -1;
+        concatenate(Util::System::in);
+        Util::System::out << Util::Io::PrintStream::flush;
+        return 0;
     }
 
     for (const auto &path : arguments) {
@@ -60,11 +70,7 @@ int32_t main(int32_t argc, char *argv[]) {
         auto bufferedStream = Util::Io::BufferedInputStream(fileStream);
         auto &stream = (file.getType() == Util::Io::File::REGULAR) ? static_cast<Util::Io::InputStream&>(bufferedStream) : static_cast<Util::Io::InputStream&>(fileStream);
 
-        int16_t logChar = stream.read();
-        while (logChar != -1) {
-            Util::System::out << static_cast<char>(logChar) << Util::Io::PrintStream::flush;
-            logChar = stream.read();
-        }
+        concatenate(stream);
     }
 
     Util::System::out << Util::Io::PrintStream::flush;
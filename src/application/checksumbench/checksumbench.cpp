@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <stdint.h>
+
+#include "lib/util/base/System.h"
+#include "lib/util/time/Timestamp.h"
+#include "lib/util/base/ArgumentParser.h"
+#include "lib/util/collection/Array.h"
+#include "lib/util/base/String.h"
+#include "lib/util/io/stream/PrintStream.h"
+#include "lib/util/math/Random.h"
+#include "lib/util/network/Checksum.h"
+#include "lib/interface.h"
+#include "lib/util/base/Constants.h"
+
+const constexpr uint8_t BENCHMARK_REPETITIONS = 10;
+
+Util::Math::Random random;
+
+/**
+ * The checksum loop, which has been used by the network stack before the Checksum class existed.
+ */
+uint16_t calculateLegacyChecksum(const uint8_t *buffer, uint32_t length) {
+    uint32_t checksum = 0;
+    for (uint32_t i = 0; i < length; i += 2) {
+        checksum += i == length - 1 ? buffer[i] << 8 : (buffer[i] << 8) | buffer[i + 1];
+    }
+
+    while (checksum >> 16 > 0) {
+        checksum = (checksum >> 16) + (checksum & 0xffff);
+    }
+
+    return ~checksum;
+}
+
+/**
+ * Bitwise CRC-32, as a baseline for the table-driven implementation.
+ */
+uint32_t calculateBitwiseCrc32(const uint8_t *buffer, uint32_t length) {
+    uint32_t crc = 0xffffffff;
+    for (uint32_t i = 0; i < length; i++) {
+        crc ^= buffer[i];
+        for (uint8_t j = 0; j < 8; j++) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xedb88320 : crc >> 1;
+        }
+    }
+
+    return ~crc;
+}
+
+template<typename T, typename F>
+Util::Time::Timestamp benchmark(F function, T &result) {
+    auto start = Util::Time::getSystemTime();
+    result = function();
+    return Util::Time::getSystemTime() - start;
+}
+
+template<typename T, typename F>
+void runBenchmark(const char *name, uint32_t size, T expectedResult, F function) {
+    Util::System::out << "  " << name << ":\t" << Util::Io::PrintStream::flush;
+
+    T result;
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < BENCHMARK_REPETITIONS; i++) {
+        sum += benchmark(function, result).toNanoseconds();
+    }
+
+    auto averageNanos = sum / BENCHMARK_REPETITIONS;
+    auto averageSeconds = averageNanos / 1000000000.0;
+    auto bandwidth = size / averageSeconds / 1000000.0;
+
+    Util::System::out.setDecimalPrecision(9);
+    Util::System::out << averageSeconds << "s (" << Util::Io::PrintStream::flush;
+    Util::System::out.setDecimalPrecision(2);
+    Util::System::out << bandwidth << " MB/s)" << (result == expectedResult ? "" : " [Wrong result!]") << Util::Io::PrintStream::endl << Util::Io::PrintStream::flush;
+}
+
+Util::String powerAsString(uint8_t power) {
+    auto bytes = 1 << power;
+    if (power < 10) {
+        return Util::String::format("%d B", bytes);
+    } else if (power < 20) {
+        return Util::String::format("%d KiB", bytes >> 10);
+    } else if (power < 30) {
+        return Util::String::format("%d MiB", bytes >> 20);
+    } else {
+        return Util::String::format("%d GiB", bytes >> 30);
+    }
+}
+
+int32_t main(int32_t argc, char *argv[]) {
+    auto argumentParser = Util::ArgumentParser();
+    argumentParser.setHelpText("Checksum throughput benchmark comparing the network stack's checksum implementations.\n"
+                               "'checksum' measures the internet checksum, 'crc' measures the Ethernet frame check sequence (CRC-32).\n"
+                               "Buffer sizes range from 64 B to 64 KiB by default, which is the maximum size of an IPv4 datagram.\n"
+                               "Usage: checksumbench [checksum/crc] [Minimimum power of 2] [Maximum power of 2]\n"
+                               "Options:\n"
+                               "  -h, --help: Show this help message");
+
+    if (!argumentParser.parse(argc, argv)) {
+        Util::System::error << argumentParser.getErrorString() << Util::Io::PrintStream::endl << Util::Io::PrintStream::flush;
+        return -1;
+    }
+
+    auto arguments = argumentParser.getUnnamedArguments();
+    if (arguments.length() == 0) {
+        Util::System::error << "checksumbench: No arguments provided!" << Util::Io::PrintStream::endl << Util::Io::PrintStream::flush;
+        return -1;
+    }
+
+    const auto &benchmarkType = arguments[0];
+    const uint8_t minPower = arguments.length() > 1 ? Util::String::parseInt(static_cast<const char*>(arguments[1])) : 6;
+    const uint8_t maxPower = arguments.length() > 2 ? Util::String::parseInt(static_cast<const char*>(arguments[2])) : 16;
+
+    if (benchmarkType != "checksum" && benchmarkType != "crc") {
+        Util::System::error << "checksumbench: Invalid benchmark type!" << Util::Io::PrintStream::endl << Util::Io::PrintStream::flush;
+        return -1;
+    }
+
+    for (uint8_t i = minPower; i <= maxPower; i++) {
+        uint32_t size = 1 << i;
+        auto *buffer = static_cast<uint8_t*>(::allocateMemory(size, Util::PAGESIZE));
+        for (uint32_t j = 0; j < size; j++) {
+            buffer[j] = static_cast<uint8_t>(random.nextRandomNumber() * 0xff);
+        }
+
+        Util::System::out << benchmarkType << " " << powerAsString(i) << ":" << Util::Io::PrintStream::endl << Util::Io::PrintStream::flush;
+
+        if (benchmarkType == "checksum") {
+            auto expected = calculateLegacyChecksum(buffer, size);
+            runBenchmark("Legacy", size, expected, [buffer, size]() {
+                return calculateLegacyChecksum(buffer, size);
+            });
+            runBenchmark("32-Bit", size, expected, [buffer, size]() {
+                return Util::Network::Checksum::finish(Util::Network::Checksum::add(Util::Network::Checksum::ACCUMULATOR_32, buffer, size));
+            });
+            runBenchmark("64-Bit", size, expected, [buffer, size]() {
+                return Util::Network::Checksum::finish(Util::Network::Checksum::add(Util::Network::Checksum::ACCUMULATOR_64, buffer, size));
+            });
+
+            if (Util::Network::Checksum::isSupported(Util::Network::Checksum::SSE2)) {
+                runBenchmark("SSE2", size, expected, [buffer, size]() {
+                    return Util::Network::Checksum::finish(Util::Network::Checksum::add(Util::Network::Checksum::SSE2, buffer, size));
+                });
+            }
+        } else {
+            auto expected = calculateBitwiseCrc32(buffer, size);
+            runBenchmark("Bitwise", size, expected, [buffer, size]() {
+                return calculateBitwiseCrc32(buffer, size);
+            });
+            runBenchmark("Slicing-by-8", size, expected, [buffer, size]() {
+                return Util::Network::Checksum::calculateCrc32(buffer, size);
+            });
+        }
+
+        ::freeMemory(buffer, Util::PAGESIZE);
+    }
+
+    return 0;
+}
@@ -22,8 +22,6 @@
 #include "lib/util/collection/Array.h"
 #include "lib/util/io/file/File.h"
 #include "lib/util/base/String.h"
-#include "lib/util/io/stream/FileInputStream.h"
-#include "lib/util/io/stream/FileOutputStream.h"
 #include "lib/util/io/stream/PrintStream.h"
 
 int32_t main(int32_t argc, char *argv[]) {
@@ -71,18 +69,24 @@ int32_t main(int32_t argc, char *argv[]) {
         return -1;
     }
 	
-    auto source = Util::Io::FileInputStream(sourceFile);
-    auto target = Util::Io::FileOutputStream(targetFile);
+    auto sourceFileDescriptor = Util::Io::File::open(sourceFile.getCanonicalPath());
+    auto targetFileDescriptor = Util::Io::File::open(targetFile.getCanonicalPath());
+    if (sourceFileDescriptor < 0 || targetFileDescriptor < 0) {
+        Util::System::error << "cp: Failed to open files!" << Util::Io::PrintStream::endl << Util::Io::PrintStream::flush;
+        return -1;
+    }
+
+    // Let the kernel copy the file directly, instead of passing each block through a user space buffer
+    auto length = sourceFile.getLength();
+    auto copied = Util::Io::File::transfer(sourceFileDescriptor, 0, targetFileDescriptor, 0, length);
 
-    auto *buffer = new uint8_t[4096];
-    int32_t read;
-    do {
-        read = source.read(buffer, 0, 4096);
-        if (read > 0) {
-            target.write(buffer, 0, read);
-        }
-    } while (read != -1);
+    Util::Io::File::close(sourceFileDescriptor);
+    Util::Io::File::close(targetFileDescriptor);
+
+    if (copied != length) {
+        Util::System::error << "cp: Failed to copy '" << arguments[0] << "'!" << Util::Io::PrintStream::endl << Util::Io::PrintStream::flush;
+        return -1;
+    }
 
-    delete[] buffer;
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,377 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <stdint.h>
+
+#include "lib/util/base/System.h"
+#include "lib/util/base/Address.h"
+#include "lib/util/base/ArgumentParser.h"
+#include "lib/util/async/Runnable.h"
+#include "lib/util/async/Thread.h"
+#include "lib/util/collection/Array.h"
+#include "lib/util/base/String.h"
+#include "lib/util/io/file/File.h"
+#include "lib/util/io/stream/PrintStream.h"
+#include "lib/util/math/Random.h"
+#include "lib/util/time/Timestamp.h"
+#include "lib/interface.h"
+
+const constexpr uint32_t DEFAULT_BLOCK_SIZE = 4096;
+const constexpr uint32_t DEFAULT_SIZE = 16 * 1024 * 1024;
+const constexpr uint32_t MAX_QUEUE_DEPTH = 32;
+
+/**
+ * Latency histogram with logarithmic buckets. Latencies below 16 microseconds get their own bucket,
+ * above that each power of two is split into 8 linear sub-buckets (i.e. a precision of 12.5%).
+ */
+struct LatencyHistogram {
+    static const constexpr uint32_t LINEAR_BUCKETS = 16;
+    static const constexpr uint32_t SUB_BUCKETS = 8;
+    static const constexpr uint32_t BUCKET_COUNT = LINEAR_BUCKETS + (32 - 4) * SUB_BUCKETS;
+
+    uint32_t buckets[BUCKET_COUNT]{};
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    uint32_t max = 0;
+
+    void add(uint32_t microseconds) {
+        buckets[getBucket(microseconds)]++;
+        count++;
+        sum += microseconds;
+        if (microseconds > max) {
+            max = microseconds;
+        }
+    }
+
+    void merge(const LatencyHistogram &other) {
+        for (uint32_t i = 0; i < BUCKET_COUNT; i++) {
+            buckets[i] += other.buckets[i];
+        }
+
+        count += other.count;
+        sum += other.sum;
+        if (other.max > max) {
+            max = other.max;
+        }
+    }
+
+    [[nodiscard]] uint32_t getPercentile(uint32_t percentile) const {
+        auto threshold = (count * percentile + 99) / 100;
+        uint64_t seen = 0;
+        for (uint32_t i = 0; i < BUCKET_COUNT; i++) {
+            seen += buckets[i];
+            if (seen >= threshold && seen > 0) {
+                auto upperBound = getUpperBound(i);
+                return upperBound < max ? upperBound : max;
+            }
+        }
+
+        return max;
+    }
+
+    static uint32_t getBucket(uint32_t value) {
+        if (value < LINEAR_BUCKETS) {
+            return value;
+        }
+
+        uint32_t msb = 31 - __builtin_clz(value);
+        uint32_t subBucket = (value >> (msb - 3)) & (SUB_BUCKETS - 1);
+        return LINEAR_BUCKETS + (msb - 4) * SUB_BUCKETS + subBucket;
+    }
+
+    static uint32_t getUpperBound(uint32_t bucket) {
+        if (bucket < LINEAR_BUCKETS) {
+            return bucket;
+        }
+
+        uint32_t msb = (bucket - LINEAR_BUCKETS) / SUB_BUCKETS + 4;
+        uint32_t subBucket = (bucket - LINEAR_BUCKETS) % SUB_BUCKETS;
+        uint64_t upperBound = ((static_cast<uint64_t>(SUB_BUCKETS + subBucket + 1)) << (msb - 3)) - 1;
+        return upperBound > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(upperBound);
+    }
+};
+
+struct Job {
+    Util::String path;
+    bool write;
+    bool random;
+    uint32_t blockSize;
+    uint32_t blockCount;
+    uint32_t operations;
+    uint32_t worker;
+    uint32_t workerCount;
+};
+
+struct JobResult {
+    LatencyHistogram latencies;
+    uint64_t transferredBytes = 0;
+    bool failed = false;
+};
+
+/**
+ * Each worker thread has its own file descriptor and issues synchronous requests.
+ * Multiple workers are used to keep several requests in flight at once (queue depth).
+ */
+class BenchmarkRunnable : public Util::Async::Runnable {
+
+public:
+
+    BenchmarkRunnable(const Job &job, JobResult &result) : job(job), result(result) {}
+
+    BenchmarkRunnable(const BenchmarkRunnable &other) = delete;
+
+    BenchmarkRunnable &operator=(const BenchmarkRunnable &other) = delete;
+
+    ~BenchmarkRunnable() override = default;
+
+    void run() override {
+        auto fileDescriptor = Util::Io::File::open(job.path);
+        if (fileDescriptor < 0) {
+            result.failed = true;
+            return;
+        }
+
+        auto *buffer = new uint8_t[job.blockSize];
+        Util::Address<uint32_t>(buffer).setRange(static_cast<uint8_t>(job.worker + 1), job.blockSize);
+        auto random = Util::Math::Random(Util::Time::getSystemTime().toMilliseconds() + job.worker * 7919);
+
+        for (uint32_t i = 0; i < job.operations; i++) {
+            uint32_t block;
+            if (job.random) {
+                block = static_cast<uint32_t>(random.nextRandomNumber() * job.blockCount) % job.blockCount;
+            } else {
+                // Workers interleave, so that the device still sees a sequential stream of requests
+                block = (i * job.workerCount + job.worker) % job.blockCount;
+            }
+
+            auto position = static_cast<uint64_t>(block) * job.blockSize;
+            auto start = Util::Time::getSystemTime();
+            auto transferred = job.write ? writeFile(fileDescriptor, buffer, position, job.blockSize) : readFile(fileDescriptor, buffer, position, job.blockSize);
+            auto latency = Util::Time::getSystemTime() - start;
+
+            if (transferred != job.blockSize) {
+                result.failed = true;
+                break;
+            }
+
+            result.latencies.add(static_cast<uint32_t>(latency.toMicroseconds()));
+            result.transferredBytes += transferred;
+        }
+
+        if (job.write) {
+            Util::Io::File::sync(fileDescriptor);
+        }
+
+        delete[] buffer;
+        Util::Io::File::close(fileDescriptor);
+    }
+
+private:
+
+    Job job;
+    JobResult &result;
+};
+
+Util::String sizeAsString(uint64_t bytes) {
+    if (bytes < 1024) {
+        return Util::String::format("%u B", static_cast<uint32_t>(bytes));
+    } else if (bytes < 1024 * 1024) {
+        return Util::String::format("%u KiB", static_cast<uint32_t>(bytes / 1024));
+    } else {
+        return Util::String::format("%u MiB", static_cast<uint32_t>(bytes / (1024 * 1024)));
+    }
+}
+
+bool prepareFile(const Util::String &path, uint32_t size, uint32_t blockSize) {
+    auto file = Util::Io::File(path);
+    if (!file.exists() && !file.create(Util::Io::File::REGULAR)) {
+        return false;
+    }
+
+    if (file.getLength() >= size) {
+        return true;
+    }
+
+    // Fill the file, so that read benchmarks do not hit the end of the file
+    auto fileDescriptor = Util::Io::File::open(path);
+    if (fileDescriptor < 0) {
+        return false;
+    }
+
+    auto *buffer = new uint8_t[blockSize];
+    Util::Address<uint32_t>(buffer).setRange(0xa5, blockSize);
+
+    bool success = true;
+    for (uint32_t position = file.getLength() / blockSize * blockSize; position < size; position += blockSize) {
+        if (writeFile(fileDescriptor, buffer, position, blockSize) != blockSize) {
+            success = false;
+            break;
+        }
+    }
+
+    Util::Io::File::sync(fileDescriptor);
+    Util::Io::File::close(fileDescriptor);
+    delete[] buffer;
+
+    return success;
+}
+
+bool runBenchmark(const Util::String &name, const Util::String &path, bool write, bool random, uint32_t size, uint32_t blockSize, uint32_t queueDepth) {
+    auto blockCount = size / blockSize;
+    auto results = Util::Array<JobResult*>(queueDepth);
+    auto threadIds = Util::Array<uint32_t>(queueDepth);
+
+    Util::System::out << name << ":\t" << Util::Io::PrintStream::flush;
+
+    auto start = Util::Time::getSystemTime();
+    for (uint32_t i = 0; i < queueDepth; i++) {
+        auto operations = blockCount / queueDepth + (i < blockCount % queueDepth ? 1 : 0);
+        results[i] = new JobResult();
+        auto thread = Util::Async::Thread::createThread(Util::String::format("diskbench-%u", i), new BenchmarkRunnable(Job{path, write, random, blockSize, blockCount, operations, i, queueDepth}, *results[i]));
+        threadIds[i] = thread.getId();
+    }
+
+    for (auto id : threadIds) {
+        Util::Async::Thread(id).join();
+    }
+
+    auto time = Util::Time::getSystemTime() - start;
+
+    auto latencies = LatencyHistogram();
+    uint64_t transferredBytes = 0;
+    bool failed = false;
+    for (auto *result : results) {
+        latencies.merge(result->latencies);
+        transferredBytes += result->transferredBytes;
+        failed |= result->failed;
+        delete result;
+    }
+
+    if (failed) {
+        Util::System::out << "I/O error!" << Util::Io::PrintStream::endl << Util::Io::PrintStream::flush;
+        return false;
+    }
+
+    auto seconds = time.toNanoseconds() / 1000000000.0;
+    auto bandwidth = seconds > 0 ? transferredBytes / seconds / 1000000.0 : 0;
+    auto iops = seconds > 0 ? latencies.count / seconds : 0;
+
+    Util::System::out.setDecimalPrecision(3);
+    Util::System::out << sizeAsString(transferredBytes) << " in " << seconds << "s (";
+    Util::System::out.setDecimalPrecision(2);
+    Util::System::out << bandwidth << " MB/s, " << static_cast<uint32_t>(iops) << " IOPS)" << Util::Io::PrintStream::endl;
+    Util::System::out << "\tLatency [us]: avg " << static_cast<uint32_t>(latencies.count > 0 ? latencies.sum / latencies.count : 0)
+                      << ", p50 " << latencies.getPercentile(50)
+                      << ", p90 " << latencies.getPercentile(90)
+                      << ", p99 " << latencies.getPercentile(99)
+                      << ", max " << latencies.max << Util::Io::PrintStream::endl << Util::Io::PrintStream::flush;
+
+    return true;
+}
+
+int32_t main(int32_t argc, char *argv[]) {
+    auto argumentParser = Util::ArgumentParser();
+    argumentParser.addArgument("pattern", false, "p");
+    argumentParser.addArgument("block-size", false, "b");
+    argumentParser.addArgument("queue-depth", false, "q");
+    argumentParser.addArgument("size", false, "s");
+    argumentParser.addSwitch("force", "f");
+    argumentParser.setHelpText("Storage throughput and latency benchmark.\n"
+                               "The target may be a regular file (created, if it does not exist) or a storage device (e.g. /device/ata0).\n"
+                               "Usage: diskbench [OPTION]... [TARGET]\n"
+                               "Options:\n"
+                               "  -p, --pattern [read/write/randread/randwrite/all]: Access pattern (Default: all)\n"
+                               "  -b, --block-size [BYTES]: Size of each request (Default: 4096)\n"
+                               "  -q, --queue-depth [COUNT]: Amount of requests in flight, each issued by its own thread (Default: 1)\n"
+                               "  -s, --size [KIB]: Amount of data to transfer per pattern (Default: 16384)\n"
+                               "  -f, --force: Allow write patterns on storage devices, which are not mounted (destroys data!)\n"
+                               "  -h, --help: Show this help message");
+
+    if (!argumentParser.parse(argc, argv)) {
+        Util::System::error << argumentParser.getErrorString() << Util::Io::PrintStream::endl << Util::Io::PrintStream::flush;
+        return -1;
+    }
+
+    auto arguments = argumentParser.getUnnamedArguments();
+    if (arguments.length() == 0) {
+        Util::System::error << "diskbench: No arguments provided!" << Util::Io::PrintStream::endl << Util::Io::PrintStream::flush;
+        return -1;
+    }
+
+    auto pattern = argumentParser.hasArgument("pattern") ? argumentParser.getArgument("pattern") : Util::String("all");
+    uint32_t blockSize = argumentParser.hasArgument("block-size") ? Util::String::parseInt(argumentParser.getArgument("block-size")) : DEFAULT_BLOCK_SIZE;
+    uint32_t queueDepth = argumentParser.hasArgument("queue-depth") ? Util::String::parseInt(argumentParser.getArgument("queue-depth")) : 1;
+    uint32_t size = argumentParser.hasArgument("size") ? Util::String::parseInt(argumentParser.getArgument("size")) * 1024 : DEFAULT_SIZE;
+
+    if (pattern != "read" && pattern != "write" && pattern != "randread" && pattern != "randwrite" && pattern != "all") {
+        Util::System::error << "diskbench: Invalid pattern!" << Util::Io::PrintStream::endl << Util::Io::PrintStream::flush;
+        return -1;
+    }
+
+    if (blockSize == 0 || queueDepth == 0 || queueDepth > MAX_QUEUE_DEPTH) {
+        Util::System::error << "diskbench: Invalid block size or queue depth!" << Util::Io::PrintStream::endl << Util::Io::PrintStream::flush;
+        return -1;
+    }
+
+    auto path = Util::Io::File(arguments[0]).getCanonicalPath();
+    auto isDevice = path.beginsWith("/device/");
+    bool writePattern = pattern == "write" || pattern == "randwrite" || pattern == "all";
+
+    if (isDevice) {
+        auto file = Util::Io::File(path);
+        if (!file.exists() || file.isDirectory()) {
+            Util::System::error << "diskbench: '" << arguments[0] << "' is not a storage device!" << Util::Io::PrintStream::endl << Util::Io::PrintStream::flush;
+            return -1;
+        }
+
+        if (writePattern && !argumentParser.checkSwitch("force")) {
+            Util::System::error << "diskbench: Refusing to write to a storage device without '--force'!" << Util::Io::PrintStream::endl << Util::Io::PrintStream::flush;
+            return -1;
+        }
+
+        if (file.getLength() < size) {
+            size = file.getLength();
+        }
+    } else if (!prepareFile(path, size, blockSize)) {
+        Util::System::error << "diskbench: Failed to prepare '" << arguments[0] << "'!" << Util::Io::PrintStream::endl << Util::Io::PrintStream::flush;
+        return -1;
+    }
+
+    if (size < blockSize) {
+        Util::System::error << "diskbench: Target is smaller than the block size!" << Util::Io::PrintStream::endl << Util::Io::PrintStream::flush;
+        return -1;
+    }
+
+    Util::System::out << path << ": " << sizeAsString(size) << " per pattern, " << sizeAsString(blockSize)
+                      << " blocks, queue depth " << queueDepth << Util::Io::PrintStream::endl << Util::Io::PrintStream::flush;
+
+    bool success = true;
+    if (success && (pattern == "write" || pattern == "all")) {
+        success = runBenchmark("write", path, true, false, size, blockSize, queueDepth);
+    }
+    if (success && (pattern == "read" || pattern == "all")) {
+        success = runBenchmark("read", path, false, false, size, blockSize, queueDepth);
+    }
+    if (success && (pattern == "randwrite" || pattern == "all")) {
+        success = runBenchmark("randwrite", path, true, true, size, blockSize, queueDepth);
+    }
+    if (success && (pattern == "randread" || pattern == "all")) {
+        success = runBenchmark("randread", path, false, true, size, blockSize, queueDepth);
+    }
+
+    return success ? 0 : -1;
+}
@@ -27,11 +27,33 @@
 #include "lib/util/io/stream/PrintStream.h"
 #include "lib/util/io/stream/InputStream.h"
 
+void printHead(Util::Io::InputStream &stream, bool byteMode, uint32_t count) {
+    if (byteMode) {
+        auto c = stream.read();
+        for (uint32_t i = 0; i < count && c != -1; i++) {
+            Util::System::out << static_cast<char>(c) << Util::Io::PrintStream::flush;
+            c = stream.read();
+        }
+    } else {
+        uint32_t lineCount = 0;
+        auto c = stream.read();
+        while (lineCount < count && c != -1) {
+            Util::System::out << static_cast<char>(c) << Util::Io::PrintStream::flush;
+            if (c == '\n') {
+                lineCount++;
+            }
+            c = stream.read();
+        }
+    }
+
+    Util::System::out << Util::Io::PrintStream::flush;
+}
+
 int32_t main(int32_t argc, char *argv[]) {
     auto argumentParser = Util::ArgumentParser();
     argumentParser.addArgument("bytes", false, "c");
     argumentParser.addArgument("lines", false, "n");
-    argumentParser.setHelpText("Print the first 10 lines of each file.\n"
+    argumentParser.setHelpText("Print the first 10 lines of each file (or standard input, if no file is given).\n"
                                "Usage: head [OPTION]... [FILE]...\n"
                                "Options:\n"
                                "  -c, --bytes [COUNT]: Print the first COUNT bytes.\n"
@@ -44,11 +66,6 @@ int32_t main(int32_t argc, char *argv[]) {
     }
 
     auto arguments = argumentParser.getUnnamedArguments();
-    if (arguments.length() == 0) {
-        Util::System::error << "head: No arguments provided!" << Util::Io::PrintStream::endl << Util::Io::PrintStream::flush;
-        return -1;
-    }
-
     bool byteMode = false;
     uint32_t count = 10;
     if (argumentParser.hasArgument("bytes")) {
@@ -58,6 +75,11 @@ int32_t main(int32_t argc, char *argv[]) {
         count = Util::String::parseInt(argumentParser.getArgument("lines"));
     }
 
+    if (arguments.length() == 0) {
+        printHead(Util::System::in, byteMode, count);
+        return 0;
+    }
+
     for (const auto &path : arguments) {
         auto file = Util::Io::File(path);
         if (!file.exists()) {
@@ -78,25 +100,7 @@ int32_t main(int32_t argc, char *argv[]) {
         auto bufferedStream = Util::Io::BufferedInputStream(fileStream);
         auto &stream = (file.getType() == Util::Io::File::REGULAR) ? static_cast<Util::Io::InputStream&>(bufferedStream) : static_cast<Util::Io::InputStream&>(fileStream);
 
-        if (byteMode) {
-            auto c = stream.read();
-            for (uint32_t i = 0; i < count && c != -1; i++) {
-                Util::System::out << static_cast<char>(c) << Util::Io::PrintStream::flush;
-                c = stream.read();
-            }
-        } else {
-            uint32_t lineCount = 0;
-            auto c = stream.read();
-            while (lineCount < count && c != -1) {
-                Util::System::out << static_cast<char>(c) << Util::Io::PrintStream::flush;
-                if (c == '\n') {
-                    lineCount++;
-                }
-                c = stream.read();
-            }
-        }
-
-        Util::System::out << Util::Io::PrintStream::flush;
+        printHead(stream, byteMode, count);
     }
 
     return 0;
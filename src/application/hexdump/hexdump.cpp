@@ -49,55 +49,13 @@ char sanitize(char value) {
     return value;
 }
 
-int32_t main(int32_t argc, char *argv[]) {
-    auto argumentParser = Util::ArgumentParser();
-    argumentParser.addArgument("length", false, "n");
-    argumentParser.addArgument("skip", false, "s");
-    argumentParser.setHelpText("Print file contents in hexadecimal numbers.\n"
-                               "Usage: hexdump [FILE]\n"
-                               "Options:\n"
-                               "  -n, --length [LENGTH]: The maximum amount of bytes to read\n"
-                               "  -s, --skip [POSITION]: Skip bytes from the beginning of the file to POSITION\n"
-                               "  -h, --help: Show this help message");
-
-    if (!argumentParser.parse(argc, argv)) {
-        Util::System::error << argumentParser.getErrorString() << Util::Io::PrintStream::endl << Util::Io::PrintStream::flush;
-        return -1;
-    }
-
-    auto arguments = argumentParser.getUnnamedArguments();
-    if (arguments.length() == 0) {
-        Util::System::error << "hexdump: No arguments provided!" << Util::Io::PrintStream::endl << Util::Io::PrintStream::flush;
-        return -1;
-    }
-
-    auto path = Util::String(arguments[0]);
-    auto file = Util::Io::File(path);
-    if (!file.exists()) {
-        Util::System::error << "hexdump: '" << path << "' not found!" << Util::Io::PrintStream::endl << Util::Io::PrintStream::flush;
-        return -1;
-    }
-
-    if (file.isDirectory()) {
-        Util::System::error << "hexdump: '" << path << "' is a directory!" << Util::Io::PrintStream::endl << Util::Io::PrintStream::flush;
-        return -1;
-    }
-
-    auto fileStream = Util::Io::FileInputStream(file);
-    auto bufferedStream = Util::Io::BufferedInputStream(fileStream);
-    auto &stream = (file.getType() == Util::Io::File::REGULAR) ? static_cast<Util::Io::InputStream&>(bufferedStream) : static_cast<Util::Io::InputStream&>(fileStream);
-
+void printHexdump(Util::Io::InputStream &stream, int32_t length, uint32_t skip) {
     Util::System::out << Util::Io::PrintStream::hex << HEXDUMP_HEADER << Util::Io::PrintStream::endl;
     printSeparationLine();
 
-    int32_t length = argumentParser.hasArgument("length") ? Util::String::parseInt(argumentParser.getArgument("length")) : -1;
     int32_t readBytes = 0;
-    uint32_t address = 0;
-
-    if (argumentParser.hasArgument("skip")) {
-        address = Util::String::parseInt(argumentParser.getArgument("skip"));
-        stream.skip(address);
-    }
+    uint32_t address = skip;
+    stream.skip(skip);
 
     while (length == -1 || readBytes < length) {
         Util::System::out.setIntegerPrecision(8);
@@ -133,6 +91,49 @@ int32_t main(int32_t argc, char *argv[]) {
             break;
         }
     }
+}
+
+int32_t main(int32_t argc, char *argv[]) {
+    auto argumentParser = Util::ArgumentParser();
+    argumentParser.addArgument("length", false, "n");
+    argumentParser.addArgument("skip", false, "s");
+    argumentParser.setHelpText("Print file contents (or standard input, if no file is given) in hexadecimal numbers.\n"
+                               "Usage: hexdump [FILE]\n"
+                               "Options:\n"
+                               "  -n, --length [LENGTH]: The maximum amount of bytes to read\n"
+                               "  -s, --skip [POSITION]: Skip bytes from the beginning of the file to POSITION\n"
+                               "  -h, --help: Show this help message");
+
+    if (!argumentParser.parse(argc, argv)) {
+        Util::System::error << argumentParser.getErrorString() << Util::Io::PrintStream::endl << Util::Io::PrintStream::flush;
+        return -1;
+    }
+
+    int32_t length = argumentParser.hasArgument("length") ? Util::String::parseInt(argumentParser.getArgument("length")) : -1;
+    uint32_t skip = argumentParser.hasArgument("skip") ? Util::String::parseInt(argumentParser.getArgument("skip")) : 0;
+
+    auto arguments = argumentParser.getUnnamedArguments();
+    if (arguments.length() == 0) {
+        printHexdump(Util::System::in, length, skip);
+        return 0;
+    }
+
+    auto path = Util::String(arguments[0]);
+    auto file = Util::Io::File(path);
+    if (!file.exists()) {
+        Util::System::error << "hexdump: '" << path << "' not found!" << Util::Io::PrintStream::endl << Util::Io::PrintStream::flush;
+        return -1;
+    }
+
+    if (file.isDirectory()) {
+        Util::System::error << "hexdump: '" << path << "' is a directory!" << Util::Io::PrintStream::endl << Util::Io::PrintStream::flush;
+        return -1;
+    }
+
+    auto fileStream = Util::Io::FileInputStream(file);
+    auto bufferedStream = Util::Io::BufferedInputStream(fileStream);
+    auto &stream = (file.getType() == Util::Io::File::REGULAR) ? static_cast<Util::Io::InputStream&>(bufferedStream) : static_cast<Util::Io::InputStream&>(fileStream);
 
+    printHexdump(stream, length, skip);
     return 0;
 }
\ No newline at end of file
@@ -25,6 +25,8 @@
 #include "lib/util/base/String.h"
 #include "lib/util/io/stream/PrintStream.h"
 
+static const constexpr uint32_t DIRECTORY_BATCH_SIZE = 16;
+
 void lsDirectory(const Util::String &path) {
     auto file = Util::Io::File(path);
     if (!file.exists()) {
@@ -34,11 +36,19 @@ void lsDirectory(const Util::String &path) {
 
     auto string = Util::String();
     if (file.isDirectory()) {
-        for (const auto &child : file.getChildren()) {
-            auto currentFile = Util::Io::File(file.getCanonicalPath() + "/" + child);
-            string += Util::Io::File::getTypeColor(currentFile) + currentFile.getName() + (currentFile.isDirectory() ? "/" : "") + Util::Graphic::Ansi::FOREGROUND_DEFAULT + " ";
+        // Entries contain type and length, so there is no need to open each child
+        auto *entries = new Util::Io::File::DirectoryEntry[DIRECTORY_BATCH_SIZE];
+        uint32_t cursor = 0;
+        uint32_t read;
+
+        while ((read = file.readDirectory(cursor, entries, DIRECTORY_BATCH_SIZE)) > 0) {
+            for (uint32_t i = 0; i < read; i++) {
+                const auto &entry = entries[i];
+                string += Util::Io::File::getTypeColor(entry.type) + Util::String(entry.name) + (entry.type == Util::Io::File::DIRECTORY ? "/" : "") + Util::Graphic::Ansi::FOREGROUND_DEFAULT + " ";
+            }
         }
 
+        delete[] entries;
         string = string.substring(0, string.length() - 1);
     } else {
         string = file.getName();
@@ -184,12 +184,19 @@ void CommandLine::parseInput() {
         return;
     }
 
+    const auto targetFile = pipeSplit.length() == 1 ? "/device/terminal" : pipeSplit[1].split(" ")[0];
+    const auto stages = pipeSplit[0].split("|");
+    if (stages.length() > 1) {
+        executePipeline(stages, targetFile, async);
+        addToHistory();
+        return;
+    }
+
     const auto command = pipeSplit[0].substring(0, currentLine.indexOf(" "));
     const auto rest = pipeSplit[0].substring(currentLine.indexOf(" "), currentLine.length());
 
     bool valid;
     auto arguments = parseArguments(rest.strip(), valid);
-    const auto targetFile = pipeSplit.length() == 1 ? "/device/terminal" : pipeSplit[1].split(" ")[0];
 
     if (!valid) {
         Util::System::out << "Invalid argument string!" << Util::Io::PrintStream::endl << Util::Io::PrintStream::flush;
@@ -206,6 +213,10 @@ void CommandLine::parseInput() {
         }
     }
 
+    addToHistory();
+}
+
+void CommandLine::addToHistory() {
     if (!currentLine.isEmpty() && (history.isEmpty() || currentLine != history.get(history.size() - 1))) {
         history.add(currentLine);
     }
@@ -261,18 +272,31 @@ Util::String CommandLine::checkDirectory(const Util::String &command, Util::Io::
         return "";
     }
 
-    for (const auto &child : directory.getChildren()) {
-        auto file = Util::Io::File(directory.getCanonicalPath() + "/" + child);
-        if (file.isFile() && file.getName() == command) {
-            return file.getCanonicalPath();
-        }
+    auto *entries = new Util::Io::File::DirectoryEntry[DIRECTORY_BATCH_SIZE];
+    auto result = Util::String();
+    uint32_t cursor = 0;
+    uint32_t read;
+
+    while (result.isEmpty() && (read = directory.readDirectory(cursor, entries, DIRECTORY_BATCH_SIZE)) > 0) {
+        for (uint32_t i = 0; i < read; i++) {
+            const auto &entry = entries[i];
+            if (entry.type != Util::Io::File::DIRECTORY && command == entry.name) {
+                result = directory.getCanonicalPath() + "/" + entry.name;
+                break;
+            }
 
-        if (file.isDirectory()) {
-            checkDirectory(command, file);
+            if (entry.type == Util::Io::File::DIRECTORY) {
+                auto subDirectory = Util::Io::File(directory.getCanonicalPath() + "/" + entry.name);
+                result = checkDirectory(command, subDirectory);
+                if (!result.isEmpty()) {
+                    break;
+                }
+            }
         }
     }
 
-    return "";
+    delete[] entries;
+    return result;
 }
 
 void CommandLine::cd(const Util::Array<Util::String> &arguments) {
@@ -354,6 +378,78 @@ void CommandLine::executeBinary(const Util::String &path, const Util::String &co
     }
 }
 
+void CommandLine::executePipeline(const Util::Array<Util::String> &stages, const Util::String &outputPath, bool async) {
+    auto binaryPaths = Util::Array<Util::String>(stages.length());
+    auto commands = Util::Array<Util::String>(stages.length());
+    auto argumentStrings = Util::Array<Util::String>(stages.length());
+
+    for (uint32_t i = 0; i < stages.length(); i++) {
+        const auto stage = stages[i].strip();
+        const auto split = stage.split(" ", 2);
+        if (split.length() == 0) {
+            Util::System::out << "Empty command in pipeline!" << Util::Io::PrintStream::endl << Util::Io::PrintStream::flush;
+            return;
+        }
+
+        bool valid;
+        commands[i] = split[0];
+        argumentStrings[i] = split.length() > 1 ? split[1].strip() : Util::String();
+        parseArguments(argumentStrings[i], valid);
+        if (!valid) {
+            Util::System::out << "Invalid argument string!" << Util::Io::PrintStream::endl << Util::Io::PrintStream::flush;
+            return;
+        }
+
+        auto binaryPath = checkPath(commands[i]);
+        binaryPaths[i] = binaryPath.isEmpty() ? commands[i] : binaryPath;
+
+        auto binaryFile = Util::Io::File(binaryPaths[i]);
+        if (!binaryFile.exists()) {
+            Util::System::out << "'" << binaryPaths[i] << "' not found!" << Util::Io::PrintStream::endl << Util::Io::PrintStream::flush;
+            return;
+        }
+
+        if (binaryFile.isDirectory()) {
+            Util::System::out << "'" << binaryPaths[i] << "' is a directory!" << Util::Io::PrintStream::endl << Util::Io::PrintStream::flush;
+            return;
+        }
+    }
+
+    auto outputFile = Util::Io::File(outputPath);
+    if (!outputFile.exists() && !outputFile.create(Util::Io::File::REGULAR)) {
+        Util::System::out << "Failed to create file '" << outputPath << "'!" << Util::Io::PrintStream::endl << Util::Io::PrintStream::flush;
+        return;
+    }
+
+    // Each stage reads from the pipe, written by its predecessor. All descriptors are handed over to the new processes.
+    auto processIds = Util::ArrayList<uint32_t>();
+    auto inputFileDescriptor = Util::Io::File::open("/device/terminal");
+    for (uint32_t i = 0; i < stages.length(); i++) {
+        int32_t outputFileDescriptor;
+        int32_t nextInputFileDescriptor = -1;
+        if (i == stages.length() - 1) {
+            outputFileDescriptor = Util::Io::File::open(outputFile.getCanonicalPath());
+        } else if (!Util::Io::File::createPipe(nextInputFileDescriptor, outputFileDescriptor)) {
+            Util::System::out << "Failed to create pipe!" << Util::Io::PrintStream::endl << Util::Io::PrintStream::flush;
+            Util::Io::File::close(inputFileDescriptor);
+            break;
+        }
+
+        bool valid;
+        auto errorFileDescriptor = Util::Io::File::open("/device/terminal");
+        auto process = Util::Async::Process::execute(Util::Io::File(binaryPaths[i]), inputFileDescriptor, outputFileDescriptor, errorFileDescriptor, commands[i], parseArguments(argumentStrings[i], valid));
+        processIds.add(process.getId());
+
+        inputFileDescriptor = nextInputFileDescriptor;
+    }
+
+    if (!async) {
+        for (auto id : processIds) {
+            Util::Async::Process(id).join();
+        }
+    }
+}
+
 void CommandLine::handleUpKey() {
     if (history.isEmpty()) {
         return;
@@ -568,20 +664,26 @@ void CommandLine::buildAutoCompletionLists() {
     for (const auto &path : Util::String(PATH).split(":")) {
         auto directory = Util::Io::File(path);
         if (directory.exists() && directory.isDirectory()) {
-            for (const auto &fileName : directory.getChildren()) {
-                auto file = Util::Io::File(directory.getCanonicalPath() + "/" + fileName);
-                if (file.isFile()) {
-                    autoCompletionPathSuggestions.add(fileName);
-                }
-            }
+            addFileNames(directory, autoCompletionPathSuggestions);
         }
     }
 
     auto workingDirectory = Util::Io::File::getCurrentWorkingDirectory();
-    for (const auto &fileName : workingDirectory.getChildren()) {
-        auto file = Util::Io::File(workingDirectory.getCanonicalPath() + "/" + fileName);
-        if (file.isFile()) {
-            autoCompletionCurrentWorkingDirectorySuggestions.add(fileName);
+    addFileNames(workingDirectory, autoCompletionCurrentWorkingDirectorySuggestions);
+}
+
+void CommandLine::addFileNames(Util::Io::File &directory, Util::ArrayList<Util::String> &names) {
+    auto *entries = new Util::Io::File::DirectoryEntry[DIRECTORY_BATCH_SIZE];
+    uint32_t cursor = 0;
+    uint32_t read;
+
+    while ((read = directory.readDirectory(cursor, entries, DIRECTORY_BATCH_SIZE)) > 0) {
+        for (uint32_t i = 0; i < read; i++) {
+            if (entries[i].type != Util::Io::File::DIRECTORY) {
+                names.add(entries[i].name);
+            }
         }
     }
+
+    delete[] entries;
 }
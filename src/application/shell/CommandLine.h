@@ -86,6 +86,8 @@ private:
 
     void parseInput();
 
+    void addToHistory();
+
     Util::Array<Util::String> parseArguments(const Util::String &argumentString, bool &valid);
 
     [[nodiscard]] uint32_t getScrolledLines() const;
@@ -100,10 +102,14 @@ private:
 
     void buildAutoCompletionLists();
 
+    static void addFileNames(Util::Io::File &directory, Util::ArrayList<Util::String> &names);
+
     static void cd(const Util::Array<Util::String> &arguments);
 
     static void executeBinary(const Util::String &path, const Util::String &command, const Util::Array<Util::String> &arguments, const Util::String &outputPath, bool async);
 
+    void executePipeline(const Util::Array<Util::String> &stages, const Util::String &outputPath, bool async);
+
     bool isRunning = true;
     Util::String startDirectory;
     Util::String currentLine;
@@ -119,6 +125,7 @@ private:
     uint32_t autoCompletionIndex = 0;
 
     static const constexpr char *PATH = "/bin";
+    static const constexpr uint32_t DIRECTORY_BATCH_SIZE = 16;
 };
 
 
@@ -25,27 +25,51 @@
 #include "lib/util/base/String.h"
 #include "lib/util/io/stream/PrintStream.h"
 
-void treeDirectory(const Util::String &path, uint32_t level) {
-    auto file = Util::Io::File(path);
-    if (!file.exists()) {
-        Util::System::error << "tree: '" << path << "' not found!" << Util::Io::PrintStream::endl << Util::Io::PrintStream::flush;
-        return;
-    }
+static const constexpr uint32_t DIRECTORY_BATCH_SIZE = 16;
 
+void printEntry(const Util::String &name, Util::Io::File::Type type, uint32_t level) {
     auto string = Util::String("|-");
     for (uint32_t i = 0; i < level; i++) {
         string += "-";
     }
 
-    string += Util::Io::File::getTypeColor(file) + file.getName() + (file.isDirectory() ? "/" : "") + Util::Graphic::Ansi::FOREGROUND_DEFAULT + " ";
+    string += Util::Io::File::getTypeColor(type) + name + (type == Util::Io::File::DIRECTORY ? "/" : "") + Util::Graphic::Ansi::FOREGROUND_DEFAULT + " ";
     Util::System::out << string << Util::Io::PrintStream::endl << Util::Io::PrintStream::flush;
+}
 
-    if (file.isDirectory()) {
-        auto basePath = file.getCanonicalPath();
-        for (const auto &child : file.getChildren()) {
-            treeDirectory(basePath + "/" + child, level + 1);
+void treeChildren(Util::Io::File &directory, uint32_t level) {
+    // Entries contain the type of each child, so only directories need to be opened
+    auto *entries = new Util::Io::File::DirectoryEntry[DIRECTORY_BATCH_SIZE];
+    auto basePath = directory.getCanonicalPath();
+    uint32_t cursor = 0;
+    uint32_t read;
+
+    while ((read = directory.readDirectory(cursor, entries, DIRECTORY_BATCH_SIZE)) > 0) {
+        for (uint32_t i = 0; i < read; i++) {
+            const auto &entry = entries[i];
+            printEntry(entry.name, entry.type, level);
+
+            if (entry.type == Util::Io::File::DIRECTORY) {
+                auto child = Util::Io::File(basePath + "/" + entry.name);
+                treeChildren(child, level + 1);
+            }
         }
     }
+
+    delete[] entries;
+}
+
+void treeDirectory(const Util::String &path) {
+    auto file = Util::Io::File(path);
+    if (!file.exists()) {
+        Util::System::error << "tree: '" << path << "' not found!" << Util::Io::PrintStream::endl << Util::Io::PrintStream::flush;
+        return;
+    }
+
+    printEntry(file.getName(), file.getType(), 0);
+    if (file.isDirectory()) {
+        treeChildren(file, 1);
+    }
 }
 
 int32_t main(int32_t argc, char *argv[]) {
@@ -62,10 +86,10 @@ int32_t main(int32_t argc, char *argv[]) {
 
     auto arguments = argumentParser.getUnnamedArguments();
     if (arguments.length() == 0) {
-        treeDirectory(Util::Io::File::getCurrentWorkingDirectory().getCanonicalPath(), 0);
+        treeDirectory(Util::Io::File::getCurrentWorkingDirectory().getCanonicalPath());
     } else {
         for (uint32_t i = 0; i < arguments.length(); i++) {
-            treeDirectory(arguments[i], 0);
+            treeDirectory(arguments[i]);
             if (i < static_cast<uint32_t>(arguments.length() - 1)) {
                 Util::System::out << Util::Io::PrintStream::endl << Util::Io::PrintStream::flush;
             }
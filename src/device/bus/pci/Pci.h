@@ -97,6 +97,14 @@ public:
         DETECTED_PARITY_ERROR = 0x8000
     };
 
+    enum Capability : uint8_t {
+        POWER_MANAGEMENT = 0x01,
+        MESSAGE_SIGNALED_INTERRUPTS = 0x05,
+        VENDOR_SPECIFIC = 0x09,
+        PCI_EXPRESS = 0x10,
+        MESSAGE_SIGNALED_INTERRUPTS_EXTENDED = 0x11
+    };
+
     enum Class : uint8_t {
         UNCLASSIFIED = 0x00,
         MASS_STORAGE = 0x01,
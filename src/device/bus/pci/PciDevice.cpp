@@ -119,6 +119,45 @@ Util::Array<uint8_t> PciDevice::readCapabilities() const {
     return capabilities.toArray();
 }
 
+uint8_t PciDevice::findCapability(Pci::Capability capability) const {
+    if (!readStatus().contains(Pci::CAPABILITIES_LIST)) {
+        return 0;
+    }
+
+    auto currentRegister = capabilitiesPointer;
+    while (currentRegister != 0x00) {
+        if (readByte(currentRegister) == capability) {
+            return currentRegister;
+        }
+
+        currentRegister = readByte(currentRegister + 1);
+    }
+
+    return 0;
+}
+
+bool PciDevice::enableMessageSignaledInterrupts(uint8_t vector, uint8_t destinationApicId) const {
+    auto capability = findCapability(Pci::MESSAGE_SIGNALED_INTERRUPTS);
+    if (capability == 0) {
+        return false;
+    }
+
+    // Message control: Bit 0 enables MSI, bits 4-6 select the amount of messages (only one is used), bit 7 indicates 64-bit addresses
+    auto control = readWord(capability + 2);
+    auto dataRegister = (control & 0x80) ? capability + 12 : capability + 8;
+
+    writeDoubleWord(capability + 4, MSI_ADDRESS_BASE | (static_cast<uint32_t>(destinationApicId) << 12));
+    if (control & 0x80) {
+        writeDoubleWord(capability + 8, 0);
+    }
+
+    writeWord(dataRegister, vector); // Fixed delivery mode, edge triggered
+    writeWord(capability + 2, (control & ~0x0070) | 0x0001);
+    writeWord(Pci::COMMAND, readWord(Pci::COMMAND) | Pci::INTERRUPT_DISABLE);
+
+    return true;
+}
+
 uint16_t PciDevice::getVendorId() const {
     return vendorId;
 }
@@ -74,6 +74,21 @@ public:
 
     [[nodiscard]] Util::Array<uint8_t> readCapabilities() const;
 
+    /**
+     * Search the capability list for a capability with the given id.
+     *
+     * @return The configuration space offset of the capability, or 0, if the device does not provide it
+     */
+    [[nodiscard]] uint8_t findCapability(Pci::Capability capability) const;
+
+    /**
+     * Configure the MSI capability to deliver a single, edge triggered interrupt with the given vector
+     * to the local APIC with the given id and disable the legacy interrupt pin.
+     *
+     * @return false, if the device does not support MSI
+     */
+    bool enableMessageSignaledInterrupts(uint8_t vector, uint8_t destinationApicId) const;
+
     void writeCommand(const Util::Array<Pci::Command> &commands) const;
 
     void overwriteCommand(const Util::Array<Pci::Command> &commands) const;
@@ -111,6 +126,8 @@ private:
     uint16_t subsystemId{};
     uint8_t capabilitiesPointer{};
     Device::InterruptRequest interruptLine{};
+
+    static const constexpr uint32_t MSI_ADDRESS_BASE = 0xfee00000;
 };
 
 }
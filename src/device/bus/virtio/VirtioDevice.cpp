@@ -0,0 +1,317 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "VirtioDevice.h"
+
+#include "Virtqueue.h"
+#include "device/bus/pci/Pci.h"
+#include "kernel/log/Log.h"
+#include "kernel/service/MemoryService.h"
+#include "kernel/service/Service.h"
+#include "lib/util/async/Thread.h"
+#include "lib/util/base/Constants.h"
+#include "lib/util/collection/Array.h"
+#include "lib/util/time/Timestamp.h"
+
+namespace Device {
+
+VirtioDevice::VirtioDevice(const PciDevice &pciDevice) : pciDevice(pciDevice) {
+    uint16_t command = pciDevice.readWord(Pci::COMMAND);
+    command |= Pci::BUS_MASTER | Pci::IO_SPACE | Pci::MEMORY_SPACE;
+    pciDevice.writeWord(Pci::COMMAND, command);
+
+    modern = parseCapabilities();
+    if (!modern) {
+        auto bar = pciDevice.readDoubleWord(Pci::BASE_ADDRESS_0);
+        if (bar & 0x01) {
+            legacyPort = IoPort(bar & ~0x03);
+        } else {
+            LOG_ERROR("Virtio device [0x%04x:0x%04x] has neither usable capabilities, nor a legacy I/O port", pciDevice.getVendorId(), pciDevice.getDeviceId());
+        }
+    }
+}
+
+VirtioDevice::~VirtioDevice() {
+    delete[] queueNotifyOffsets;
+}
+
+bool VirtioDevice::initialize() {
+    if (!modern && legacyPort.getAddress() == 0) {
+        return false;
+    }
+
+    // Reset device and wait until the reset has been completed
+    setStatus(0);
+    uint32_t timeout = 0;
+    while (getStatus() != 0) {
+        if (timeout >= 1000) {
+            LOG_ERROR("Failed to reset virtio device");
+            return false;
+        }
+
+        Util::Async::Thread::sleep(Util::Time::Timestamp::ofMilliseconds(1));
+        timeout++;
+    }
+
+    setStatus(ACKNOWLEDGE);
+    setStatus(getStatus() | DRIVER);
+
+    return true;
+}
+
+bool VirtioDevice::negotiateFeatures(uint64_t driverFeatures) {
+    if (modern) {
+        commonConfiguration->deviceFeatureSelect = 0;
+        uint64_t deviceFeatures = commonConfiguration->deviceFeature;
+        commonConfiguration->deviceFeatureSelect = 1;
+        deviceFeatures |= static_cast<uint64_t>(commonConfiguration->deviceFeature) << 32;
+
+        features = deviceFeatures & (driverFeatures | VERSION_1);
+        if (!(features & VERSION_1)) {
+            LOG_ERROR("Modern virtio device does not offer VERSION_1");
+            fail();
+            return false;
+        }
+
+        commonConfiguration->driverFeatureSelect = 0;
+        commonConfiguration->driverFeature = static_cast<uint32_t>(features);
+        commonConfiguration->driverFeatureSelect = 1;
+        commonConfiguration->driverFeature = static_cast<uint32_t>(features >> 32);
+
+        setStatus(getStatus() | FEATURES_OK);
+        if (!(getStatus() & FEATURES_OK)) {
+            LOG_ERROR("Virtio device did not accept negotiated features");
+            fail();
+            return false;
+        }
+    } else {
+        // Legacy devices only support the lower 32 feature bits and have no FEATURES_OK handshake
+        uint64_t deviceFeatures = legacyPort.readDoubleWord(DEVICE_FEATURES);
+        features = deviceFeatures & driverFeatures & 0xffffffff;
+        legacyPort.writeDoubleWord(DRIVER_FEATURES, static_cast<uint32_t>(features));
+    }
+
+    return true;
+}
+
+void VirtioDevice::finishInitialization() {
+    setStatus(getStatus() | DRIVER_OK);
+}
+
+void VirtioDevice::fail() {
+    setStatus(getStatus() | FAILED);
+}
+
+Virtqueue* VirtioDevice::setupQueue(uint16_t index, uint16_t maxSize, uint16_t indirectDescriptors) {
+    auto indirect = hasFeature(RING_INDIRECT_DESCRIPTORS) ? indirectDescriptors : static_cast<uint16_t>(0);
+    auto eventIndex = hasFeature(RING_EVENT_INDEX);
+
+    if (modern) {
+        if (index >= commonConfiguration->queueCount) {
+            return nullptr;
+        }
+
+        commonConfiguration->queueSelect = index;
+        uint16_t size = commonConfiguration->queueSize;
+        if (size == 0) {
+            return nullptr;
+        }
+
+        if (size > maxSize) {
+            size = maxSize;
+            commonConfiguration->queueSize = size;
+        }
+
+        auto *queue = new Virtqueue(*this, index, size, indirect, eventIndex);
+        commonConfiguration->queueMsixVector = 0xffff;
+        commonConfiguration->queueDescriptors = queue->getDescriptorTablePhysicalAddress();
+        commonConfiguration->queueDriver = queue->getAvailableRingPhysicalAddress();
+        commonConfiguration->queueDevice = queue->getUsedRingPhysicalAddress();
+        queueNotifyOffsets[index] = commonConfiguration->queueNotifyOffset;
+        commonConfiguration->queueEnable = 1;
+
+        return queue;
+    }
+
+    // Legacy devices dictate the queue size and expect the queue at a page aligned physical address
+    legacyPort.writeWord(QUEUE_SELECT, index);
+    uint16_t size = legacyPort.readWord(QUEUE_SIZE);
+    if (size == 0) {
+        return nullptr;
+    }
+
+    auto *queue = new Virtqueue(*this, index, size, indirect, eventIndex);
+    legacyPort.writeDoubleWord(QUEUE_ADDRESS, queue->getDescriptorTablePhysicalAddress() / LEGACY_QUEUE_ALIGNMENT);
+
+    return queue;
+}
+
+void VirtioDevice::notifyQueue(uint16_t index) {
+    if (modern) {
+        *reinterpret_cast<volatile uint16_t*>(notifyBase + queueNotifyOffsets[index] * notifyOffsetMultiplier) = index;
+    } else {
+        legacyPort.writeWord(QUEUE_NOTIFY, index);
+    }
+}
+
+uint8_t VirtioDevice::readInterruptStatus() {
+    return modern ? *isrStatus : legacyPort.readByte(ISR_STATUS);
+}
+
+bool VirtioDevice::hasFeature(uint64_t feature) const {
+    return (features & feature) == feature;
+}
+
+bool VirtioDevice::isModern() const {
+    return modern;
+}
+
+uint16_t VirtioDevice::getQueueCount() const {
+    return modern ? commonConfiguration->queueCount : 0;
+}
+
+const PciDevice& VirtioDevice::getPciDevice() const {
+    return pciDevice;
+}
+
+uint8_t VirtioDevice::readConfigByte(uint32_t offset) const {
+    return modern ? deviceConfiguration[offset] : legacyPort.readByte(DEVICE_CONFIG + offset);
+}
+
+uint16_t VirtioDevice::readConfigWord(uint32_t offset) const {
+    return modern ? *reinterpret_cast<volatile uint16_t*>(deviceConfiguration + offset) : legacyPort.readWord(DEVICE_CONFIG + offset);
+}
+
+uint32_t VirtioDevice::readConfigDoubleWord(uint32_t offset) const {
+    return modern ? *reinterpret_cast<volatile uint32_t*>(deviceConfiguration + offset) : legacyPort.readDoubleWord(DEVICE_CONFIG + offset);
+}
+
+uint64_t VirtioDevice::readConfigQuadWord(uint32_t offset) const {
+    uint64_t low, high;
+    if (modern) {
+        // Retry, if the device changed its configuration while we were reading both halves
+        uint8_t generation;
+        do {
+            generation = commonConfiguration->configGeneration;
+            low = readConfigDoubleWord(offset);
+            high = readConfigDoubleWord(offset + 4);
+        } while (generation != commonConfiguration->configGeneration);
+    } else {
+        low = readConfigDoubleWord(offset);
+        high = readConfigDoubleWord(offset + 4);
+    }
+
+    return low | (high << 32);
+}
+
+void VirtioDevice::writeConfigByte(uint32_t offset, uint8_t value) const {
+    if (modern) {
+        deviceConfiguration[offset] = value;
+    } else {
+        legacyPort.writeByte(DEVICE_CONFIG + offset, value);
+    }
+}
+
+void VirtioDevice::setStatus(uint8_t status) {
+    if (modern) {
+        commonConfiguration->deviceStatus = status;
+    } else {
+        legacyPort.writeByte(DEVICE_STATUS, status);
+    }
+}
+
+uint8_t VirtioDevice::getStatus() const {
+    return modern ? commonConfiguration->deviceStatus : legacyPort.readByte(DEVICE_STATUS);
+}
+
+bool VirtioDevice::parseCapabilities() {
+    if (!pciDevice.readStatus().contains(Pci::CAPABILITIES_LIST)) {
+        return false;
+    }
+
+    uint8_t capability = pciDevice.readByte(Pci::CAPABILITIES_POINTER) & 0xfc;
+    while (capability != 0x00) {
+        if (pciDevice.readByte(capability) == PCI_CAPABILITY_VENDOR_SPECIFIC) {
+            auto type = pciDevice.readByte(capability + 3);
+            auto bar = pciDevice.readByte(capability + 4);
+            auto offset = pciDevice.readDoubleWord(capability + 8);
+            auto length = pciDevice.readDoubleWord(capability + 12);
+
+            // The specification allows multiple capabilities of the same type, with the first one being preferred
+            switch (type) {
+                case COMMON_CONFIGURATION:
+                    if (commonConfiguration == nullptr) {
+                        commonConfiguration = static_cast<CommonConfiguration*>(mapCapability(bar, offset, length));
+                    }
+                    break;
+                case NOTIFY_CONFIGURATION:
+                    if (notifyBase == nullptr) {
+                        notifyBase = static_cast<uint8_t*>(mapCapability(bar, offset, length));
+                        notifyOffsetMultiplier = pciDevice.readDoubleWord(capability + 16);
+                    }
+                    break;
+                case ISR_CONFIGURATION:
+                    if (isrStatus == nullptr) {
+                        isrStatus = static_cast<uint8_t*>(mapCapability(bar, offset, length));
+                    }
+                    break;
+                case DEVICE_CONFIGURATION:
+                    if (deviceConfiguration == nullptr) {
+                        deviceConfiguration = static_cast<uint8_t*>(mapCapability(bar, offset, length));
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        capability = pciDevice.readByte(capability + 1) & 0xfc;
+    }
+
+    if (commonConfiguration == nullptr || notifyBase == nullptr || isrStatus == nullptr) {
+        return false;
+    }
+
+    queueNotifyOffsets = new uint16_t[commonConfiguration->queueCount]{};
+    return true;
+}
+
+void* VirtioDevice::mapCapability(uint8_t bar, uint32_t offset, uint32_t length) {
+    if (bar > 5) {
+        return nullptr;
+    }
+
+    auto barValue = pciDevice.readDoubleWord(Pci::BASE_ADDRESS_0 + bar * 4);
+    if (barValue & 0x01) {
+        return nullptr; // I/O space BARs are not supported for modern devices
+    }
+
+    if (((barValue >> 1) & 0x03) == 0x02 && (bar == 5 || pciDevice.readDoubleWord(Pci::BASE_ADDRESS_0 + (bar + 1) * 4) != 0)) {
+        return nullptr; // 64-bit BAR, located above 4 GiB
+    }
+
+    auto physicalAddress = (barValue & ~0x0f) + offset;
+    auto pageOffset = physicalAddress % Util::PAGESIZE;
+    auto pageCount = (pageOffset + length) % Util::PAGESIZE == 0 ? (pageOffset + length) / Util::PAGESIZE : (pageOffset + length) / Util::PAGESIZE + 1;
+
+    auto &memoryService = Kernel::Service::getService<Kernel::MemoryService>();
+    auto *virtualAddress = static_cast<uint8_t*>(memoryService.mapIO(reinterpret_cast<void*>(physicalAddress - pageOffset), pageCount));
+
+    return virtualAddress + pageOffset;
+}
+
+}
@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef HHUOS_VIRTIODEVICE_H
+#define HHUOS_VIRTIODEVICE_H
+
+#include <stdint.h>
+
+#include "device/bus/pci/PciDevice.h"
+#include "device/cpu/IoPort.h"
+
+namespace Device {
+
+class Virtqueue;
+
+/**
+ * PCI transport for virtio devices (virtio specification 1.1, chapter 4.1).
+ * Modern devices are accessed via the vendor specific PCI capabilities and memory mapped configuration structures.
+ * Transitional and legacy devices, which do not offer usable capabilities, are accessed via the legacy I/O port interface.
+ */
+class VirtioDevice {
+
+public:
+
+    enum Status : uint8_t {
+        ACKNOWLEDGE = 0x01,
+        DRIVER = 0x02,
+        DRIVER_OK = 0x04,
+        FEATURES_OK = 0x08,
+        DEVICE_NEEDS_RESET = 0x40,
+        FAILED = 0x80
+    };
+
+    enum Feature : uint64_t {
+        RING_INDIRECT_DESCRIPTORS = 1ull << 28,
+        RING_EVENT_INDEX = 1ull << 29,
+        VERSION_1 = 1ull << 32
+    };
+
+    enum InterruptStatus : uint8_t {
+        QUEUE_INTERRUPT = 0x01,
+        CONFIGURATION_CHANGE = 0x02
+    };
+
+    /**
+     * Constructor.
+     */
+    explicit VirtioDevice(const PciDevice &pciDevice);
+
+    /**
+     * Copy Constructor.
+     */
+    VirtioDevice(const VirtioDevice &other) = delete;
+
+    /**
+     * Assignment operator.
+     */
+    VirtioDevice &operator=(const VirtioDevice &other) = delete;
+
+    /**
+     * Destructor.
+     */
+    ~VirtioDevice();
+
+    /**
+     * Reset the device and perform the first steps of the initialization sequence (ACKNOWLEDGE and DRIVER).
+     * Afterward, features need to be negotiated and queues need to be set up, before calling finishInitialization().
+     *
+     * @return false, if the device could not be reset
+     */
+    bool initialize();
+
+    /**
+     * Negotiate features with the device. The accepted features are the intersection of the features
+     * offered by the device and the given driver features. VERSION_1 is added automatically for modern devices.
+     *
+     * @return false, if the device did not accept the negotiated feature set
+     */
+    bool negotiateFeatures(uint64_t driverFeatures);
+
+    /**
+     * Set DRIVER_OK. The device is live afterward.
+     */
+    void finishInitialization();
+
+    /**
+     * Mark the device as failed (e.g. if queue setup did not succeed).
+     */
+    void fail();
+
+    /**
+     * Create and register the virtqueue with the given index.
+     *
+     * @param index The queue index
+     * @param maxSize The maximum amount of descriptors (modern devices may use less than offered)
+     * @param indirectDescriptors The maximum length of indirect descriptor tables (0 = no indirect descriptors)
+     *
+     * @return The created queue or nullptr, if the device does not implement a queue with this index
+     */
+    Virtqueue* setupQueue(uint16_t index, uint16_t maxSize, uint16_t indirectDescriptors = 0);
+
+    void notifyQueue(uint16_t index);
+
+    /**
+     * Read and acknowledge the interrupt status register.
+     */
+    uint8_t readInterruptStatus();
+
+    [[nodiscard]] bool hasFeature(uint64_t feature) const;
+
+    [[nodiscard]] bool isModern() const;
+
+    /**
+     * Get the amount of queues, the device offers (only available on modern devices, 0 otherwise).
+     */
+    [[nodiscard]] uint16_t getQueueCount() const;
+
+    [[nodiscard]] const PciDevice& getPciDevice() const;
+
+    [[nodiscard]] uint8_t readConfigByte(uint32_t offset) const;
+
+    [[nodiscard]] uint16_t readConfigWord(uint32_t offset) const;
+
+    [[nodiscard]] uint32_t readConfigDoubleWord(uint32_t offset) const;
+
+    [[nodiscard]] uint64_t readConfigQuadWord(uint32_t offset) const;
+
+    void writeConfigByte(uint32_t offset, uint8_t value) const;
+
+    static const constexpr uint16_t VENDOR_ID = 0x1af4;
+    static const constexpr uint16_t TRANSITIONAL_DEVICE_ID_BASE = 0x0fff;
+    static const constexpr uint16_t MODERN_DEVICE_ID_BASE = 0x1040;
+
+private:
+
+    enum CapabilityType : uint8_t {
+        COMMON_CONFIGURATION = 0x01,
+        NOTIFY_CONFIGURATION = 0x02,
+        ISR_CONFIGURATION = 0x03,
+        DEVICE_CONFIGURATION = 0x04,
+        PCI_CONFIGURATION = 0x05
+    };
+
+    enum LegacyRegister : uint8_t {
+        DEVICE_FEATURES = 0x00,
+        DRIVER_FEATURES = 0x04,
+        QUEUE_ADDRESS = 0x08,
+        QUEUE_SIZE = 0x0c,
+        QUEUE_SELECT = 0x0e,
+        QUEUE_NOTIFY = 0x10,
+        DEVICE_STATUS = 0x12,
+        ISR_STATUS = 0x13,
+        DEVICE_CONFIG = 0x14
+    };
+
+    struct CommonConfiguration {
+        uint32_t deviceFeatureSelect;
+        uint32_t deviceFeature;
+        uint32_t driverFeatureSelect;
+        uint32_t driverFeature;
+        uint16_t msixConfig;
+        uint16_t queueCount;
+        uint8_t deviceStatus;
+        uint8_t configGeneration;
+        uint16_t queueSelect;
+        uint16_t queueSize;
+        uint16_t queueMsixVector;
+        uint16_t queueEnable;
+        uint16_t queueNotifyOffset;
+        uint64_t queueDescriptors;
+        uint64_t queueDriver;
+        uint64_t queueDevice;
+    } __attribute__((packed));
+
+    bool parseCapabilities();
+
+    void* mapCapability(uint8_t bar, uint32_t offset, uint32_t length);
+
+    void setStatus(uint8_t status);
+
+    [[nodiscard]] uint8_t getStatus() const;
+
+    PciDevice pciDevice;
+    bool modern = false;
+    uint64_t features = 0;
+
+    IoPort legacyPort = IoPort(0x00);
+
+    volatile CommonConfiguration *commonConfiguration = nullptr;
+    volatile uint8_t *notifyBase = nullptr;
+    uint32_t notifyOffsetMultiplier = 0;
+    uint16_t *queueNotifyOffsets = nullptr;
+    volatile uint8_t *isrStatus = nullptr;
+    volatile uint8_t *deviceConfiguration = nullptr;
+
+    static const constexpr uint8_t PCI_CAPABILITY_VENDOR_SPECIFIC = 0x09;
+    static const constexpr uint32_t LEGACY_QUEUE_ALIGNMENT = 4096;
+};
+
+}
+
+#endif
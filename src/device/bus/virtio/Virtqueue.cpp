@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "Virtqueue.h"
+
+#include "VirtioDevice.h"
+#include "kernel/service/MemoryService.h"
+#include "kernel/service/Service.h"
+#include "lib/util/base/Address.h"
+#include "lib/util/base/Constants.h"
+
+namespace Device {
+
+Virtqueue::Virtqueue(VirtioDevice &device, uint16_t index, uint16_t size, uint16_t indirectDescriptors, bool eventIndex) :
+        device(device), index(index), size(size), indirectDescriptors(indirectDescriptors), eventIndex(eventIndex), tokens(new void*[size]{}), freeCount(size) {
+    auto &memoryService = Kernel::Service::getService<Kernel::MemoryService>();
+    auto memorySize = calculateMemorySize(size);
+    auto pages = memorySize % Util::PAGESIZE == 0 ? memorySize / Util::PAGESIZE : memorySize / Util::PAGESIZE + 1;
+
+    memory = static_cast<uint8_t*>(memoryService.mapIO(pages));
+    physicalAddress = reinterpret_cast<uint32_t>(memoryService.getPhysicalAddress(memory));
+    Util::Address<uint32_t>(memory).setRange(0, pages * Util::PAGESIZE);
+
+    auto usedRingOffset = Util::Address<uint32_t>(sizeof(Descriptor) * size + sizeof(uint16_t) * (3 + size)).alignUp(Util::PAGESIZE).get();
+    descriptors = reinterpret_cast<Descriptor*>(memory);
+    availableRing = reinterpret_cast<AvailableRing*>(memory + sizeof(Descriptor) * size);
+    usedRing = reinterpret_cast<UsedRing*>(memory + usedRingOffset);
+
+    // Link all descriptors to a free list
+    for (uint16_t i = 0; i < size; i++) {
+        descriptors[i].next = i + 1;
+    }
+
+    if (indirectDescriptors > 0) {
+        auto tableSize = static_cast<uint32_t>(size) * indirectDescriptors * sizeof(Descriptor);
+        auto tablePages = tableSize % Util::PAGESIZE == 0 ? tableSize / Util::PAGESIZE : tableSize / Util::PAGESIZE + 1;
+        indirectTables = static_cast<Descriptor*>(memoryService.mapIO(tablePages));
+        indirectTablesPhysicalAddress = reinterpret_cast<uint32_t>(memoryService.getPhysicalAddress(indirectTables));
+    }
+}
+
+Virtqueue::~Virtqueue() {
+    delete[] tokens;
+    delete memory;
+    delete indirectTables;
+}
+
+uint32_t Virtqueue::calculateMemorySize(uint16_t size) {
+    auto usedRingOffset = Util::Address<uint32_t>(sizeof(Descriptor) * size + sizeof(uint16_t) * (3 + size)).alignUp(Util::PAGESIZE).get();
+    return usedRingOffset + sizeof(uint16_t) * 3 + sizeof(UsedElement) * size;
+}
+
+bool Virtqueue::canSubmit(uint16_t count) const {
+    if (indirectDescriptors > 0 && count > 1 && count <= indirectDescriptors) {
+        return freeCount >= 1;
+    }
+
+    return freeCount >= count;
+}
+
+bool Virtqueue::submit(const Buffer *buffers, uint16_t count, void *token) {
+    if (count == 0 || !canSubmit(count)) {
+        return false;
+    }
+
+    uint16_t head;
+    if (indirectDescriptors > 0 && count > 1 && count <= indirectDescriptors) {
+        // The whole chain is described by a table outside the ring, which only needs a single ring descriptor
+        head = allocateDescriptor();
+        auto *table = indirectTables + head * indirectDescriptors;
+        for (uint16_t i = 0; i < count; i++) {
+            table[i].address = buffers[i].physicalAddress;
+            table[i].length = buffers[i].length;
+            table[i].flags = (buffers[i].deviceWritable ? WRITE : 0) | (i < count - 1 ? NEXT : 0);
+            table[i].next = i + 1;
+        }
+
+        descriptors[head].address = indirectTablesPhysicalAddress + head * indirectDescriptors * sizeof(Descriptor);
+        descriptors[head].length = count * sizeof(Descriptor);
+        descriptors[head].flags = INDIRECT;
+    } else {
+        head = allocateDescriptor();
+        auto current = head;
+        for (uint16_t i = 0; i < count; i++) {
+            descriptors[current].address = buffers[i].physicalAddress;
+            descriptors[current].length = buffers[i].length;
+            descriptors[current].flags = buffers[i].deviceWritable ? WRITE : 0;
+
+            if (i < count - 1) {
+                auto next = allocateDescriptor();
+                descriptors[current].flags = descriptors[current].flags | NEXT;
+                descriptors[current].next = next;
+                current = next;
+            }
+        }
+    }
+
+    tokens[head] = token;
+
+    // Make descriptors visible before publishing the new ring entry
+    availableRing->ring[availableRing->index % size] = head;
+    asm volatile ("" : : : "memory");
+    availableRing->index = availableRing->index + 1;
+
+    return true;
+}
+
+void Virtqueue::notify() {
+    asm volatile ("" : : : "memory");
+
+    uint16_t newIndex = availableRing->index;
+    uint16_t oldIndex = lastNotifiedIndex;
+    if (newIndex == oldIndex) {
+        return;
+    }
+
+    lastNotifiedIndex = newIndex;
+
+    bool needsNotification;
+    if (eventIndex) {
+        // The device publishes the available index, at which it wants to be notified, right behind the used ring
+        uint16_t availableEvent = *reinterpret_cast<volatile uint16_t*>(&usedRing->ring[size]);
+        needsNotification = static_cast<uint16_t>(newIndex - availableEvent - 1) < static_cast<uint16_t>(newIndex - oldIndex);
+    } else {
+        needsNotification = (usedRing->flags & NO_NOTIFY) == 0;
+    }
+
+    if (needsNotification) {
+        device.notifyQueue(index);
+    }
+}
+
+bool Virtqueue::hasUsedBuffers() const {
+    return lastUsedIndex != usedRing->index;
+}
+
+void* Virtqueue::getUsedBuffer(uint32_t &length) {
+    if (!hasUsedBuffers()) {
+        return nullptr;
+    }
+
+    asm volatile ("" : : : "memory");
+
+    auto &element = usedRing->ring[lastUsedIndex % size];
+    auto head = static_cast<uint16_t>(element.id);
+    length = element.length;
+    lastUsedIndex++;
+
+    if (eventIndex && interruptsEnabled) {
+        // Request an interrupt for the next used buffer
+        availableRing->ring[size] = lastUsedIndex;
+    }
+
+    auto *token = tokens[head];
+    tokens[head] = nullptr;
+    freeChain(head);
+
+    return token;
+}
+
+void Virtqueue::setInterruptsEnabled(bool enabled) {
+    interruptsEnabled = enabled;
+    if (eventIndex) {
+        availableRing->ring[size] = enabled ? lastUsedIndex : static_cast<uint16_t>(lastUsedIndex - 1);
+    } else {
+        availableRing->flags = enabled ? 0 : NO_INTERRUPT;
+    }
+
+    asm volatile ("" : : : "memory");
+}
+
+uint16_t Virtqueue::allocateDescriptor() {
+    auto descriptor = freeHead;
+    freeHead = descriptors[descriptor].next;
+    freeCount--;
+
+    return descriptor;
+}
+
+void Virtqueue::freeChain(uint16_t head) {
+    auto current = head;
+    while (true) {
+        auto flags = descriptors[current].flags;
+        auto next = descriptors[current].next;
+
+        descriptors[current].flags = 0;
+        descriptors[current].next = freeHead;
+        freeHead = current;
+        freeCount++;
+
+        if ((flags & INDIRECT) || !(flags & NEXT)) {
+            break;
+        }
+
+        current = next;
+    }
+}
+
+uint16_t Virtqueue::getIndex() const {
+    return index;
+}
+
+uint16_t Virtqueue::getSize() const {
+    return size;
+}
+
+uint32_t Virtqueue::getDescriptorTablePhysicalAddress() const {
+    return physicalAddress;
+}
+
+uint32_t Virtqueue::getAvailableRingPhysicalAddress() const {
+    return physicalAddress + sizeof(Descriptor) * size;
+}
+
+uint32_t Virtqueue::getUsedRingPhysicalAddress() const {
+    return physicalAddress + (reinterpret_cast<volatile uint8_t*>(usedRing) - memory);
+}
+
+}
@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef HHUOS_VIRTQUEUE_H
+#define HHUOS_VIRTQUEUE_H
+
+#include <stdint.h>
+
+namespace Device {
+
+class VirtioDevice;
+
+/**
+ * Split virtqueue (virtio specification 1.1, chapter 2.6).
+ * The descriptor table, available ring and used ring are placed in one physically contiguous memory block,
+ * using the legacy layout, so that the same queue can be used by legacy and modern devices.
+ * The queue itself is not synchronized. Users must serialize calls to submit(), notify() and getUsedBuffer().
+ */
+class Virtqueue {
+
+public:
+
+    struct Buffer {
+        uint32_t physicalAddress;
+        uint32_t length;
+        bool deviceWritable;
+    };
+
+    /**
+     * Constructor.
+     */
+    Virtqueue(VirtioDevice &device, uint16_t index, uint16_t size, uint16_t indirectDescriptors, bool eventIndex);
+
+    /**
+     * Copy Constructor.
+     */
+    Virtqueue(const Virtqueue &other) = delete;
+
+    /**
+     * Assignment operator.
+     */
+    Virtqueue &operator=(const Virtqueue &other) = delete;
+
+    /**
+     * Destructor.
+     */
+    ~Virtqueue();
+
+    /**
+     * Place a buffer chain into the available ring.
+     * The device is not notified, so that multiple chains can be submitted with a single notification.
+     * If indirect descriptors are enabled and the chain consists of more than one buffer, it occupies only
+     * a single descriptor in the descriptor table.
+     *
+     * @param buffers The buffers, that make up the chain (device readable buffers must precede device writable buffers)
+     * @param count The amount of buffers
+     * @param token An arbitrary pointer, which is returned by getUsedBuffer(), once the device has processed the chain
+     *
+     * @return false, if there are not enough free descriptors
+     */
+    bool submit(const Buffer *buffers, uint16_t count, void *token);
+
+    /**
+     * Notify the device about all chains, that have been submitted since the last notification.
+     * The notification is suppressed, if the device has signaled that it does not need it.
+     */
+    void notify();
+
+    /**
+     * Get the next chain, which has been processed by the device and free its descriptors.
+     *
+     * @param length Is set to the amount of bytes, which the device has written into the chain
+     * @return The token, which has been passed to submit() or nullptr, if no processed chain is available
+     */
+    void* getUsedBuffer(uint32_t &length);
+
+    [[nodiscard]] bool hasUsedBuffers() const;
+
+    /**
+     * Check, if a chain of the given length can currently be submitted.
+     */
+    [[nodiscard]] bool canSubmit(uint16_t count) const;
+
+    /**
+     * Disable or enable used buffer notifications (interrupts) for this queue.
+     */
+    void setInterruptsEnabled(bool enabled);
+
+    [[nodiscard]] uint16_t getIndex() const;
+
+    [[nodiscard]] uint16_t getSize() const;
+
+    [[nodiscard]] uint32_t getDescriptorTablePhysicalAddress() const;
+
+    [[nodiscard]] uint32_t getAvailableRingPhysicalAddress() const;
+
+    [[nodiscard]] uint32_t getUsedRingPhysicalAddress() const;
+
+    static uint32_t calculateMemorySize(uint16_t size);
+
+private:
+
+    enum DescriptorFlag : uint16_t {
+        NEXT = 0x01,
+        WRITE = 0x02,
+        INDIRECT = 0x04
+    };
+
+    enum RingFlag : uint16_t {
+        NO_NOTIFY = 0x01,
+        NO_INTERRUPT = 0x01
+    };
+
+    struct Descriptor {
+        uint64_t address;
+        uint32_t length;
+        uint16_t flags;
+        uint16_t next;
+    } __attribute__((packed));
+
+    struct AvailableRing {
+        uint16_t flags;
+        uint16_t index;
+        uint16_t ring[];
+    } __attribute__((packed));
+
+    struct UsedElement {
+        uint32_t id;
+        uint32_t length;
+    } __attribute__((packed));
+
+    struct UsedRing {
+        uint16_t flags;
+        uint16_t index;
+        UsedElement ring[];
+    } __attribute__((packed));
+
+    uint16_t allocateDescriptor();
+
+    void freeChain(uint16_t head);
+
+    VirtioDevice &device;
+    const uint16_t index;
+    const uint16_t size;
+    const uint16_t indirectDescriptors;
+    const bool eventIndex;
+
+    uint8_t *memory;
+    uint32_t physicalAddress;
+    volatile Descriptor *descriptors;
+    volatile AvailableRing *availableRing;
+    volatile UsedRing *usedRing;
+
+    Descriptor *indirectTables = nullptr;
+    uint32_t indirectTablesPhysicalAddress = 0;
+
+    void **tokens;
+    uint16_t freeHead = 0;
+    uint16_t freeCount;
+    uint16_t lastUsedIndex = 0;
+    uint16_t lastNotifiedIndex = 0;
+    bool interruptsEnabled = true;
+};
+
+}
+
+#endif
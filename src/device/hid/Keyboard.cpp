@@ -110,7 +110,7 @@ Keyboard* Keyboard::initialize(Ps2Controller &controller) {
         LOG_WARN("Failed to enable scanning -> Keyboard might not be working");
     }
 
-    auto *streamNode = new Filesystem::Memory::StreamNode("keyboard", keyboard);
+    auto *streamNode = new Filesystem::Memory::StreamNode("keyboard", keyboard, &keyboard->waitQueue);
     auto &filesystem = Kernel::Service::getService<Kernel::FilesystemService>().getFilesystem();
     auto &driver = filesystem.getVirtualDriver("/device");
     bool success = driver.addNode("/", streamNode);
@@ -169,6 +169,7 @@ void Keyboard::trigger([[maybe_unused]] const Kernel::InterruptFrame &frame, [[m
 
     auto data = controller.readDataByte();
     keyBuffer.offer(data);
+    waitQueue.wakeUp();
 }
 
 }
\ No newline at end of file
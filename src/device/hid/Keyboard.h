@@ -21,6 +21,7 @@
 #include <stdint.h>
 
 #include "kernel/interrupt/InterruptHandler.h"
+#include "kernel/process/WaitQueue.h"
 #include "Ps2Device.h"
 #include "lib/util/io/stream/FilterInputStream.h"
 #include "lib/util/io/stream/QueueInputStream.h"
@@ -134,6 +135,7 @@ private:
 
     Util::ArrayBlockingQueue<uint8_t> keyBuffer;
     Util::Io::QueueInputStream inputStream;
+    Kernel::WaitQueue waitQueue;
 
     static const constexpr uint32_t BUFFER_SIZE = 1024;
 };
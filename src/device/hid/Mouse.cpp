@@ -106,7 +106,7 @@ Mouse* Mouse::initialize(Ps2Controller &controller) {
         LOG_INFO("Detected 5-button mouse with scroll wheel");
     }
 
-    auto *streamNode = new Filesystem::Memory::StreamNode("mouse", mouse);
+    auto *streamNode = new Filesystem::Memory::StreamNode("mouse", mouse, &mouse->waitQueue);
     auto &filesystem = Kernel::Service::getService<Kernel::FilesystemService>().getFilesystem();
     auto &driver = filesystem.getVirtualDriver("/device");
     bool success = driver.addNode("/", streamNode);
@@ -157,6 +157,7 @@ void Mouse::trigger([[maybe_unused]] const Kernel::InterruptFrame &frame, [[mayb
                     inputBuffer.offer(dx);
                     inputBuffer.offer(dy);
                     inputBuffer.offer(0);
+                    waitQueue.wakeUp();
                 }
 
                 // Reset cycle
@@ -173,6 +174,7 @@ void Mouse::trigger([[maybe_unused]] const Kernel::InterruptFrame &frame, [[mayb
                 inputBuffer.offer(dx);
                 inputBuffer.offer(dy);
                 inputBuffer.offer(data);
+                waitQueue.wakeUp();
             }
 
             // Reset cycle
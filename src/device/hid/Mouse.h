@@ -21,6 +21,7 @@
 #include <stdint.h>
 
 #include "kernel/interrupt/InterruptHandler.h"
+#include "kernel/process/WaitQueue.h"
 #include "lib/util/io/stream/FilterInputStream.h"
 #include "Ps2Device.h"
 #include "lib/util/collection/ArrayBlockingQueue.h"
@@ -108,6 +109,7 @@ private:
 
     Util::ArrayBlockingQueue<uint8_t> inputBuffer;
     Util::Io::QueueInputStream inputStream;
+    Kernel::WaitQueue waitQueue;
 
     static const constexpr uint32_t BUFFER_SIZE = 1024;
 };
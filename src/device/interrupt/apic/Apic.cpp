@@ -51,10 +51,11 @@ enum InterruptRequest : uint8_t;
 
 uint8_t initializedApplicationProcessorsCounter = 0; // Used to determine AP GDT/Stack slot
 
-Apic::Apic(const Util::Array<LocalApic*> &localApicsArray, IoApic *ioApic) : localApics(localApicsArray.length()), localTimers(localApicsArray.length()), ioApic(ioApic) {
+Apic::Apic(const Util::Array<LocalApic*> &localApicsArray, IoApic *ioApic) : localApics(localApicsArray.length()), localTimers(localApicsArray.length()), cpuIndices(localApicsArray.length()), ioApic(ioApic) {
     for (auto localApic : localApicsArray) {
         localApics.put(localApic->getCpuId(), localApic);
         localTimers.put(localApic->getCpuId(), nullptr);
+        cpuIndices.put(localApic->getCpuId(), cpuIndices.size());
     }
 }
 
@@ -150,6 +151,8 @@ void Apic::sendEndOfInterrupt(Kernel::InterruptVector vector) {
         // masking them and setting them as edge-triggered temporarily (which clears the remote IRR bit).
         // Here, EOI broadcasting is enabled, which makes it very simple:
         LocalApic::sendEndOfInterrupt(); // External interrupts get forwarded by the local APIC, so local EOI required
+    } else if (isMessageSignaledInterrupt(vector)) {
+        LocalApic::sendEndOfInterrupt(); // MSIs are delivered to the local APIC without involving the I/O APIC
     }
 }
 
@@ -162,6 +165,10 @@ bool Apic::isExternalInterrupt(Kernel::InterruptVector vector) const {
     return static_cast<Kernel::GlobalSystemInterrupt>(vector - 32) <= ioApic->getMaxGlobalSystemInterruptNumber();
 }
 
+bool Apic::isMessageSignaledInterrupt(Kernel::InterruptVector vector) const {
+    return vector >= Kernel::InterruptVector::MESSAGE_SIGNALED_INTERRUPT_START && vector <= Kernel::InterruptVector::MESSAGE_SIGNALED_INTERRUPT_END;
+}
+
 Util::Array<LocalApic*> Apic::getLocalApics() {
     const auto &acpi = Kernel::Service::getService<Kernel::InformationService>().getAcpi();
     auto localApics = Util::ArrayList<LocalApic*>();
@@ -322,6 +329,14 @@ bool Apic::isSymmetricMultiprocessingSupported() const {
     return localApics.size() > 1;
 }
 
+uint32_t Apic::getCpuCount() const {
+    return localApics.size();
+}
+
+uint32_t Apic::getCurrentCpuIndex() const {
+    return cpuIndices.get(LocalApic::getId());
+}
+
 void Apic::startupApplicationProcessors() {
     auto &timeService = Kernel::Service::getService<Kernel::TimeService>();
     auto *gdtPointers = prepareApplicationProcessorGdts();
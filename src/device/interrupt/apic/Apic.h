@@ -118,6 +118,11 @@ public:
      */
     bool isExternalInterrupt(Kernel::InterruptVector vector) const;
 
+    /**
+     * Check if an interrupt vector belongs to a message signaled interrupt (delivered directly to a local APIC).
+     */
+    bool isMessageSignaledInterrupt(Kernel::InterruptVector vector) const;
+
     /**
      * Check if this core's local APIC timer has been initialized.
      */
@@ -134,6 +139,14 @@ public:
     ApicTimer &getCurrentTimer();
 
     [[nodiscard]] bool isSymmetricMultiprocessingSupported() const;
+
+    [[nodiscard]] uint32_t getCpuCount() const;
+
+    /**
+     * Get the index of the current CPU in the range [0, getCpuCount()).
+     * Unlike local APIC ids, which may be sparse, indices are dense and can be used to select per-CPU resources.
+     */
+    [[nodiscard]] uint32_t getCurrentCpuIndex() const;
     
     void startupApplicationProcessors();
 
@@ -179,6 +192,7 @@ private:
     // Once the switch from PIC to APIC is done, it can't be switched back.
     Util::HashMap<uint8_t, LocalApic*> localApics;  // All LocalApic instances.
     Util::HashMap<uint8_t, ApicTimer*> localTimers; // All ApicTimer instances.
+    Util::HashMap<uint8_t, uint32_t> cpuIndices;    // Dense CPU indices of all local APIC ids, in MADT order.
     IoApic *ioApic;                      // The IoApic instance responsible for the external interrupts.
     LocalApicErrorHandler errorHandler;  // The interrupt handler that gets triggered on an internal APIC error.
 
@@ -21,8 +21,6 @@
 #include "lib/util/async/Thread.h"
 #include "device/network/PacketReader.h"
 #include "kernel/process/Process.h"
-#include "kernel/memory/VirtualAddressSpace.h"
-#include "lib/util/base/HeapMemoryManager.h"
 #include "kernel/process/Thread.h"
 #include "lib/util/base/Address.h"
 #include "kernel/network/ethernet/EthernetModule.h"
@@ -32,14 +30,26 @@
 #include "kernel/service/MemoryService.h"
 #include "lib/util/base/Constants.h"
 #include "kernel/memory/BitmapMemoryManager.h"
+#include "kernel/multiboot/Multiboot.h"
+#include "kernel/service/InformationService.h"
+#include "lib/util/network/Checksum.h"
+#include "lib/util/network/ethernet/EthernetHeader.h"
+#include "lib/util/network/ip4/Ip4Header.h"
 
 namespace Device::Network {
 
+Kernel::BitmapMemoryManager *NetworkDevice::outgoingPacketMemoryManager = nullptr;
+
 NetworkDevice::NetworkDevice() :
-        incomingPacketMemoryManager(*createPacketManager(MAX_BUFFERED_PACKETS)),
-        incomingPacketQueue(MAX_BUFFERED_PACKETS),
-        outgoingPacketQueue(MAX_BUFFERED_PACKETS),
+        incomingPacketMemoryManager(*createPacketManager(getReceiveRingSize())),
+        incomingPacketQueue(getReceiveRingSize()),
+        outgoingPacketQueue(MAX_OUTGOING_PACKETS),
         reader(new PacketReader(*this)) {
+    // Network devices are initialized during boot, so there is no need for synchronization here
+    if (outgoingPacketMemoryManager == nullptr) {
+        outgoingPacketMemoryManager = createPacketManager(MAX_OUTGOING_PACKETS);
+    }
+
     auto &processService = Kernel::Service::getService<Kernel::ProcessService>();
     auto &readerThread = Kernel::Thread::createKernelThread("Packet-Reader", processService.getKernelProcess(), reader);
 
@@ -58,34 +68,40 @@ const Util::String& NetworkDevice::getIdentifier() const {
     return identifier;
 }
 
-void NetworkDevice::sendPacket(const uint8_t *packet, uint32_t length) {
-    if (length > MAX_ETHERNET_PACKET_SIZE) {
-        return; // Discard too large packets
+uint8_t* NetworkDevice::allocatePacketBuffer() {
+    auto *buffer = outgoingPacketMemoryManager->allocateBlock();
+    while (buffer == nullptr) {
+        Util::Async::Thread::yield();
+        buffer = outgoingPacketMemoryManager->allocateBlock();
     }
 
-    // Allocate kernel buffer to copy and send packet
-    auto &memoryService = Kernel::Service::getService<Kernel::MemoryService>();
-    auto *buffer = static_cast<uint8_t*>(memoryService.mapIO(1));
+    return static_cast<uint8_t*>(buffer);
+}
 
-    // Copy packet into kernel buffer
-    auto source = Util::Address<uint32_t>(packet);
-    auto target = Util::Address<uint32_t>(buffer);
-    target.copyRange(source, length);
+void NetworkDevice::sendPacket(uint8_t *packetBuffer, uint32_t length, uint16_t checksumStart, uint16_t checksumOffset) {
+    if (length > MAX_ETHERNET_PACKET_SIZE) {
+        freeOutgoingPacketBuffer(packetBuffer);
+        return; // Discard too large packets
+    }
 
     // Add padding, if necessary
     if (length < MIN_ETHERNET_PACKET_SIZE) {
-        target.add(length).setRange(0, MIN_ETHERNET_PACKET_SIZE - length);
+        Util::Address<uint32_t>(packetBuffer).add(length).setRange(0, MIN_ETHERNET_PACKET_SIZE - length);
         length = MIN_ETHERNET_PACKET_SIZE;
     }
 
     outgoingPacketLock.acquire();
-    outgoingPacketQueue.add(Packet{buffer, length});
-    handleOutgoingPacket(buffer, length);
+    if (checksumStart > 0 && !offloadChecksum(checksumStart, checksumOffset)) {
+        completeChecksum(packetBuffer, length, checksumStart, checksumOffset);
+    }
+
+    outgoingPacketQueue.add(Packet{packetBuffer, length});
+    handleOutgoingPacket(packetBuffer, length);
     outgoingPacketLock.release();
 }
 
-void NetworkDevice::handleIncomingPacket(const uint8_t *packet, uint32_t length) {
-    if (!Kernel::Network::Ethernet::EthernetModule::checkPacket(packet, length)) {
+void NetworkDevice::handleIncomingPacket(const uint8_t *packet, uint32_t length, bool checksumVerified) {
+    if (hasUncheckedFrameCheckSequence() && !Kernel::Network::Ethernet::EthernetModule::checkPacket(packet, length)) {
         return; // Discard packets failing the checksum test
     }
 
@@ -102,17 +118,26 @@ void NetworkDevice::handleIncomingPacket(const uint8_t *packet, uint32_t length)
     auto target = Util::Address<uint32_t>(buffer);
     target.copyRange(source, length);
 
-    if (!incomingPacketQueue.offer(Packet{buffer, length})) {
+    if (!incomingPacketQueue.offer(Packet{buffer, length, checksumVerified})) {
         incomingPacketMemoryManager.freeBlock(buffer);
+        return;
     }
+
+    incomingPacketWaitQueue.wakeUp();
 }
 
-NetworkDevice::Packet NetworkDevice::getNextIncomingPacket() {
-    while (incomingPacketQueue.isEmpty()) {
-        Util::Async::Thread::yield();
+uint8_t* NetworkDevice::allocateReceiveBuffer() {
+    return static_cast<uint8_t*>(incomingPacketMemoryManager.allocateBlock());
+}
+
+void NetworkDevice::handleReceivedBuffer(uint8_t *buffer, uint32_t length, bool checksumVerified) {
+    if ((hasUncheckedFrameCheckSequence() && !Kernel::Network::Ethernet::EthernetModule::checkPacket(buffer, length)) ||
+            !incomingPacketQueue.offer(Packet{buffer, length, checksumVerified})) {
+        incomingPacketMemoryManager.freeBlock(buffer);
+        return;
     }
 
-    return incomingPacketQueue.poll();
+    incomingPacketWaitQueue.wakeUp();
 }
 
 NetworkDevice::Packet NetworkDevice::getNextOutgoingPacket() {
@@ -131,25 +156,56 @@ void NetworkDevice::freePacketBuffer(void *buffer) {
     }
 }
 
-void NetworkDevice::freeLastSendBuffer() {
-    outgoingPacketsToFree++;
-
-    auto &kernelProcess = Kernel::Service::getService<Kernel::ProcessService>().getKernelProcess();
-    if (!kernelProcess.getAddressSpace().getMemoryManager().isLocked()) {
-        while (outgoingPacketsToFree > 0) {
-            const auto &packet = outgoingPacketQueue.poll();
-            delete packet.buffer;
-            outgoingPacketsToFree--;
-        }
+void NetworkDevice::freeOutgoingPacketBuffer(void *buffer) {
+    if (buffer >= outgoingPacketMemoryManager->getStartAddress() && buffer <= outgoingPacketMemoryManager->getEndAddress()) {
+        outgoingPacketMemoryManager->freeBlock(buffer);
+    } else {
+        Util::Exception::throwException(Util::Exception::OUT_OF_BOUNDS, "NetworkDevice: Trying to free an invalid packet buffer!");
     }
 }
 
+void NetworkDevice::freeLastSendBuffer() {
+    // Freeing a block only clears a bit in the pool's bitmap, so this is safe to call from interrupt handlers
+    const auto &packet = outgoingPacketQueue.poll();
+    freeOutgoingPacketBuffer(packet.buffer);
+}
+
 Kernel::BitmapMemoryManager* NetworkDevice::createPacketManager(uint32_t packetCount) {
     auto &memoryService = Kernel::Service::getService<Kernel::MemoryService>();
     auto *startAddress = static_cast<uint8_t*>(memoryService.mapIO(packetCount / PACKETS_PER_PAGE));
     auto *endAddress = startAddress + (packetCount / PACKETS_PER_PAGE) * Util::PAGESIZE - 1;
 
-    return new Kernel::BitmapMemoryManager(startAddress, endAddress);
+    return new Kernel::BitmapMemoryManager(startAddress, endAddress, PACKET_BUFFER_SIZE);
+}
+
+void NetworkDevice::completeChecksum(uint8_t *packet, uint32_t length, uint16_t checksumStart, uint16_t checksumOffset) {
+    // The checksum field already contains the pseudo header sum, so it is simply added to the sum of the data
+    // The range includes the padding up to the minimum ethernet packet size, which only works, because the padding consists of zeros
+    auto checksum = Util::Network::Checksum::calculate(packet + checksumStart, length - checksumStart);
+    // A UDP checksum of zero means "no checksum", so it is sent as 0xffff instead (RFC 768)
+    if (checksum == 0 && packet[Util::Network::Ethernet::EthernetHeader::HEADER_LENGTH + Util::Network::Ip4::Ip4Header::PROTOCOL_OFFSET] == Util::Network::Ip4::Ip4Header::UDP) {
+        checksum = 0xffff;
+    }
+
+    packet[checksumStart + checksumOffset] = checksum >> 8;
+    packet[checksumStart + checksumOffset + 1] = checksum;
+}
+
+uint32_t NetworkDevice::getReceiveRingSize() {
+    const auto &multiboot = Kernel::Service::getService<Kernel::InformationService>().getMultibootInformation();
+    if (!multiboot.hasKernelOption("network_receive_ring")) {
+        return DEFAULT_RECEIVE_RING_SIZE;
+    }
+
+    // Packet buffers are allocated in whole pages
+    auto size = Util::String::parseInt(multiboot.getKernelOption("network_receive_ring"));
+    if (size < static_cast<int32_t>(PACKETS_PER_PAGE)) {
+        return PACKETS_PER_PAGE;
+    } else if (size > static_cast<int32_t>(MAX_RECEIVE_RING_SIZE)) {
+        return MAX_RECEIVE_RING_SIZE;
+    }
+
+    return size - size % PACKETS_PER_PAGE;
 }
 
 bool NetworkDevice::Packet::operator==(const NetworkDevice::Packet &other) const {
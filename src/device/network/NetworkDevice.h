@@ -25,6 +25,7 @@
 #include "lib/util/async/Spinlock.h"
 #include "lib/util/base/String.h"
 #include "lib/util/base/Constants.h"
+#include "kernel/process/WaitQueue.h"
 
 namespace Kernel {
 class BitmapMemoryManager;
@@ -51,6 +52,8 @@ public:
     struct Packet {
         uint8_t *buffer;
         uint32_t length;
+        // Set for incoming packets, whose transport layer checksum has already been verified by the device
+        bool checksumVerified = false;
 
         bool operator==(const Packet &other) const;
     };
@@ -81,20 +84,95 @@ public:
 
     [[nodiscard]] virtual Util::Network::MacAddress getMacAddress() const = 0;
 
-    void sendPacket(const uint8_t *packet, uint32_t length);
+    /**
+     * Get a buffer from the transmit pool, which is shared by all network devices.
+     * Packets are built directly inside this buffer and handed to sendPacket(), which transmits them without copying.
+     * The buffer is returned to the pool, once the device has finished transmitting it.
+     * If all buffers are in use, this function blocks until one is freed.
+     */
+    static uint8_t* allocatePacketBuffer();
 
-    Packet getNextIncomingPacket();
+    /**
+     * Return a buffer, obtained via allocatePacketBuffer(), to the transmit pool without sending it.
+     */
+    static void freeOutgoingPacketBuffer(void *buffer);
+
+    /**
+     * Transmit a packet, that has been built inside a buffer obtained via allocatePacketBuffer().
+     * The device takes ownership of the buffer.
+     * If 'checksumStart' is set, the checksum field at 'checksumStart + checksumOffset' only contains the sum of the
+     * pseudo header. The checksum over all bytes from 'checksumStart' to the end of the packet is then completed
+     * by the device, if it supports checksum offloading, or in software otherwise.
+     */
+    void sendPacket(uint8_t *packetBuffer, uint32_t length, uint16_t checksumStart = 0, uint16_t checksumOffset = 0);
 
     Packet getNextOutgoingPacket();
 
+    static const constexpr uint32_t PACKET_BUFFER_SIZE = 2048;
+
 protected:
 
     virtual void handleOutgoingPacket(const uint8_t *packet, uint32_t length) = 0;
 
-    void handleIncomingPacket(const uint8_t *packet, uint32_t length);
+    void handleIncomingPacket(const uint8_t *packet, uint32_t length, bool checksumVerified = false);
+
+    /**
+     * Get a buffer from the receive pool of this device. Devices with descriptor rings can let the hardware
+     * write received packets directly into these buffers and pass them on via handleReceivedBuffer().
+     *
+     * @return The buffer or nullptr, if the pool is exhausted
+     */
+    uint8_t* allocateReceiveBuffer();
+
+    /**
+     * Pass a packet, that has been received into a buffer obtained via allocateReceiveBuffer(), to the packet reader
+     * without copying it. The buffer is owned by the network stack afterward.
+     */
+    void handleReceivedBuffer(uint8_t *buffer, uint32_t length, bool checksumVerified = false);
+
+    /**
+     * Get the amount of buffers in the receive pool of each device.
+     */
+    static uint32_t getReceiveRingSize();
+
+    /**
+     * Called right before handleOutgoingPacket() for packets with an incomplete checksum (see sendPacket()).
+     * Devices, which can complete the checksum themselves, override this function and remember the checksum position
+     * for the following call of handleOutgoingPacket().
+     *
+     * @return true, if the device is going to complete the checksum
+     */
+    virtual bool offloadChecksum([[maybe_unused]] uint16_t checksumStart, [[maybe_unused]] uint16_t checksumOffset) {
+        return false;
+    }
+
+    /**
+     * Devices, which pass received frames on together with their frame check sequence, without having verified it,
+     * override this function, so that the frame check sequence is verified in software.
+     * Devices, which strip the frame check sequence or drop damaged frames in hardware, do not need to override it.
+     */
+    [[nodiscard]] virtual bool hasUncheckedFrameCheckSequence() const {
+        return false;
+    }
 
     void freeLastSendBuffer();
 
+    /**
+     * Enable or disable receive interrupts. Under load, the packet reader disables them and fetches received packets
+     * via pollReceivedPackets() instead, until the device is idle again.
+     * Devices, which do not support this, do not need to override these functions and keep signaling received packets via interrupts.
+     *
+     * @return true, if the receive interrupts have been changed
+     */
+    virtual bool setReceiveInterruptsEnabled([[maybe_unused]] bool enabled) {
+        return false;
+    }
+
+    /**
+     * Fetch all packets, that have been received while receive interrupts were disabled, and pass them to handleIncomingPacket().
+     */
+    virtual void pollReceivedPackets() {}
+
     static const constexpr uint32_t MIN_ETHERNET_PACKET_SIZE = 64;
     static const constexpr uint32_t MAX_ETHERNET_PACKET_SIZE = 1522;
 
@@ -102,21 +180,27 @@ private:
 
     static Kernel::BitmapMemoryManager* createPacketManager(uint32_t packetCount);
 
+    static void completeChecksum(uint8_t *packet, uint32_t length, uint16_t checksumStart, uint16_t checksumOffset);
+
     void freePacketBuffer(void *buffer);
 
     Util::String identifier;
 
     Kernel::BitmapMemoryManager &incomingPacketMemoryManager;
     Util::ArrayBlockingQueue<Packet> incomingPacketQueue;
+    Kernel::WaitQueue incomingPacketWaitQueue;
     Util::ArrayBlockingQueue<Packet> outgoingPacketQueue;
     Util::Async::Spinlock outgoingPacketLock;
-    uint32_t outgoingPacketsToFree = 0;
 
     PacketReader *reader;
 
-    static const constexpr uint32_t PACKET_BUFFER_SIZE = 2048;
-    static const constexpr uint32_t PACKETS_PER_PAGE = Util::PAGESIZE % PACKET_BUFFER_SIZE == 0 ? Util::PAGESIZE / PACKET_BUFFER_SIZE : Util::PAGESIZE / PACKET_BUFFER_SIZE + 1;
-    static const constexpr uint32_t MAX_BUFFERED_PACKETS = 16;
+    // Shared by all devices, since the device of a packet is only known after its route has been resolved
+    static Kernel::BitmapMemoryManager *outgoingPacketMemoryManager;
+
+    static const constexpr uint32_t PACKETS_PER_PAGE = Util::PAGESIZE / PACKET_BUFFER_SIZE;
+    static const constexpr uint32_t DEFAULT_RECEIVE_RING_SIZE = 64;
+    static const constexpr uint32_t MAX_RECEIVE_RING_SIZE = 1024;
+    static const constexpr uint32_t MAX_OUTGOING_PACKETS = 64;
 };
 
 }
@@ -27,20 +27,64 @@
 #include "kernel/network/ethernet/EthernetModule.h"
 #include "kernel/network/NetworkModule.h"
 #include "kernel/service/Service.h"
+#include "kernel/service/ProcessService.h"
+#include "kernel/process/Scheduler.h"
+#include "kernel/process/WaitQueue.h"
+#include "lib/util/async/Thread.h"
+#include "lib/util/time/Timestamp.h"
 
 namespace Device::Network {
 
 PacketReader::PacketReader(Device::Network::NetworkDevice &networkDevice) : networkDevice(networkDevice) {}
 
 void PacketReader::run() {
-    auto &ethernetModule = Kernel::Service::getService<Kernel::NetworkService>().getNetworkStack().getEthernetModule();
+    auto &scheduler = Kernel::Service::getService<Kernel::ProcessService>().getScheduler();
+    Kernel::WaitQueue::ThreadListener listener(scheduler.getCurrentThread());
+    networkDevice.incomingPacketWaitQueue.add(listener);
+    bool polling = false;
 
     while (true) {
-        const auto &packet = networkDevice.getNextIncomingPacket();
+        if (polling) {
+            networkDevice.pollReceivedPackets();
+        }
+
+        if (processPackets() == RECEIVE_BUDGET) {
+            // The device receives packets faster than they are processed -> Stop taking interrupts and poll the device instead
+            if (!polling) {
+                polling = networkDevice.setReceiveInterruptsEnabled(false);
+            }
+
+            Util::Async::Thread::yield();
+            continue;
+        }
+
+        if (polling) {
+            // The device is idle again -> Switch back to interrupts and fetch packets, that have arrived in the meantime
+            networkDevice.setReceiveInterruptsEnabled(true);
+            networkDevice.pollReceivedPackets();
+            polling = false;
+        }
+
+        // Wake ups, that arrive before the thread is blocked, are not lost, so no packet can be missed here
+        if (networkDevice.incomingPacketQueue.isEmpty()) {
+            scheduler.wait(Util::Time::Timestamp());
+        }
+    }
+}
+
+uint32_t PacketReader::processPackets() {
+    auto &ethernetModule = Kernel::Service::getService<Kernel::NetworkService>().getNetworkStack().getEthernetModule();
+    uint32_t processed = 0;
+
+    while (processed < RECEIVE_BUDGET && !networkDevice.incomingPacketQueue.isEmpty()) {
+        const auto packet = networkDevice.incomingPacketQueue.poll();
         auto stream = Util::Io::ByteArrayInputStream(packet.buffer, packet.length);
-        ethernetModule.readPacket(stream, Kernel::Network::NetworkModule::LayerInformation{Util::Network::MacAddress(), Util::Network::MacAddress(), packet.length}, networkDevice);
+        ethernetModule.readPacket(stream, Kernel::Network::NetworkModule::LayerInformation{Util::Network::MacAddress(), Util::Network::MacAddress(), packet.length, packet.checksumVerified}, networkDevice);
         networkDevice.freePacketBuffer(packet.buffer);
+        processed++;
     }
+
+    return processed;
 }
 
 }
\ No newline at end of file
@@ -54,7 +54,16 @@ public:
 
 private:
 
+    /**
+     * Pass up to RECEIVE_BUDGET queued packets to the network stack.
+     *
+     * @return The amount of processed packets
+     */
+    uint32_t processPackets();
+
     Device::Network::NetworkDevice &networkDevice;
+
+    static const constexpr uint32_t RECEIVE_BUDGET = 32;
 };
 
 }
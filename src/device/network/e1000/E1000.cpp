@@ -0,0 +1,387 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "E1000.h"
+
+#include "device/bus/pci/Pci.h"
+#include "kernel/log/Log.h"
+#include "kernel/multiboot/Multiboot.h"
+#include "kernel/service/InformationService.h"
+#include "kernel/service/InterruptService.h"
+#include "kernel/service/MemoryService.h"
+#include "kernel/service/NetworkService.h"
+#include "kernel/service/Service.h"
+#include "lib/util/async/Thread.h"
+#include "lib/util/base/Constants.h"
+#include "lib/util/base/String.h"
+#include "lib/util/collection/Array.h"
+#include "lib/util/time/Timestamp.h"
+
+namespace Kernel {
+enum InterruptVector : uint8_t;
+struct InterruptFrame;
+}  // namespace Kernel
+
+namespace Device::Network {
+
+E1000::E1000(const PciDevice &pciDevice) : pciDevice(pciDevice) {
+    uint16_t command = pciDevice.readWord(Pci::COMMAND);
+    command |= Pci::BUS_MASTER | Pci::MEMORY_SPACE;
+    pciDevice.writeWord(Pci::COMMAND, command);
+
+    // Determine the size of the register space by writing all ones into the base address register
+    auto bar = pciDevice.readDoubleWord(Pci::BASE_ADDRESS_0);
+    pciDevice.writeDoubleWord(Pci::BASE_ADDRESS_0, 0xffffffff);
+    auto barSize = ~(pciDevice.readDoubleWord(Pci::BASE_ADDRESS_0) & 0xfffffff0) + 1;
+    pciDevice.writeDoubleWord(Pci::BASE_ADDRESS_0, bar);
+
+    if (bar & 0x01) {
+        LOG_ERROR("E1000 registers are not memory mapped");
+        return;
+    }
+
+    auto pageCount = barSize % Util::PAGESIZE == 0 ? barSize / Util::PAGESIZE : barSize / Util::PAGESIZE + 1;
+    auto &memoryService = Kernel::Service::getService<Kernel::MemoryService>();
+    registers = static_cast<uint8_t*>(memoryService.mapIO(reinterpret_cast<void*>(bar & 0xfffffff0), pageCount));
+}
+
+E1000::~E1000() {
+    delete[] receiveBuffers;
+    delete[] transmitDescriptorHasPacket;
+}
+
+void E1000::initializeAvailableCards() {
+    auto &networkService = Kernel::Service::getService<Kernel::NetworkService>();
+    for (auto deviceId : {DEVICE_ID_82540EM, DEVICE_ID_82543GC, DEVICE_ID_82545EM}) {
+        for (const auto &pciDevice : Pci::search(VENDOR_ID, deviceId)) {
+            LOG_INFO("Initializing E1000 network card [0x%04x:0x%04x]", pciDevice.getVendorId(), pciDevice.getDeviceId());
+
+            auto *e1000 = new E1000(pciDevice);
+            if (!e1000->initialize()) {
+                LOG_ERROR("Failed to initialize E1000 network card");
+                delete e1000;
+                continue;
+            }
+
+            networkService.registerNetworkDevice(e1000, "eth");
+            e1000->plugin();
+        }
+    }
+}
+
+bool E1000::initialize() {
+    if (registers == nullptr) {
+        return false;
+    }
+
+    // Mask all interrupts and reset the controller (the reset takes about 1 ms)
+    writeRegister(INTERRUPT_MASK_CLEAR, 0xffffffff);
+    writeRegister(CONTROL, readRegister(CONTROL) | RESET);
+    Util::Async::Thread::sleep(Util::Time::Timestamp::ofMilliseconds(1));
+
+    uint32_t time = 0;
+    while (readRegister(CONTROL) & RESET) {
+        if (time++ >= RESET_TIMEOUT) {
+            LOG_ERROR("E1000 reset timed out");
+            return false;
+        }
+
+        Util::Async::Thread::sleep(Util::Time::Timestamp::ofMilliseconds(1));
+    }
+
+    writeRegister(INTERRUPT_MASK_CLEAR, 0xffffffff);
+    static_cast<void>(readRegister(INTERRUPT_CAUSE_READ));
+
+    writeRegister(CONTROL, readRegister(CONTROL) | SET_LINK_UP | AUTO_SPEED_DETECTION);
+    for (uint32_t i = 0; i < 128; i++) {
+        writeRegister(MULTICAST_TABLE_ARRAY + i * sizeof(uint32_t), 0);
+    }
+
+    // The receive address is loaded from the EEPROM during reset
+    if (!(readRegister(RECEIVE_ADDRESS_HIGH) & ADDRESS_VALID)) {
+        LOG_ERROR("E1000 does not provide a valid MAC address");
+        return false;
+    }
+
+    readMacAddress();
+    if (!setupReceiveRing()) {
+        return false;
+    }
+
+    setupTransmitRing();
+
+    writeRegister(RECEIVE_CHECKSUM_CONTROL, IP_CHECKSUM_OFFLOAD | TRANSPORT_CHECKSUM_OFFLOAD);
+    writeRegister(INTERRUPT_THROTTLING, getInterruptThrottlingInterval());
+    writeRegister(RECEIVE_DELAY_TIMER, 0);
+
+    LOG_INFO("E1000: MAC address [%s], [%u] receive descriptors, [%u] transmit descriptors, interrupt throttling interval [%u]",
+             static_cast<const char*>(macAddress.toString()), receiveDescriptorCount, TRANSMIT_DESCRIPTOR_COUNT, getInterruptThrottlingInterval());
+
+    return true;
+}
+
+Util::Network::MacAddress E1000::getMacAddress() const {
+    return macAddress;
+}
+
+void E1000::plugin() {
+    auto &interruptService = Kernel::Service::getService<Kernel::InterruptService>();
+    interruptService.assignInterrupt(static_cast<Kernel::InterruptVector>(pciDevice.getInterruptLine() + 32), *this);
+    interruptService.allowHardwareInterrupt(pciDevice.getInterruptLine());
+
+    writeRegister(INTERRUPT_MASK_SET, RECEIVE_INTERRUPTS | TRANSMIT_DESCRIPTOR_WRITTEN_BACK | LINK_STATUS_CHANGE);
+}
+
+void E1000::trigger([[maybe_unused]] const Kernel::InterruptFrame &frame, [[maybe_unused]] Kernel::InterruptVector slot) {
+    // Reading the cause register acknowledges all pending interrupts (the line may be shared with other devices)
+    auto cause = readRegister(INTERRUPT_CAUSE_READ);
+    if (cause == 0) {
+        return;
+    }
+
+    if (cause & RECEIVE_INTERRUPTS) {
+        receivePackets();
+    }
+
+    // If the transmit ring is locked, its owner is going to reclaim the sent descriptors itself
+    if ((cause & TRANSMIT_DESCRIPTOR_WRITTEN_BACK) && transmitLock.tryAcquire()) {
+        reclaimTransmitDescriptors();
+        transmitLock.release();
+    }
+}
+
+void E1000::handleOutgoingPacket(const uint8_t *packet, uint32_t length) {
+    transmitLock.acquire();
+    reclaimTransmitDescriptors();
+
+    // The checksum position is stored in a context descriptor, which stays valid for all following packets
+    auto checksumOffload = pendingChecksumStart > 0;
+    auto newContext = checksumOffload && (pendingChecksumStart != contextChecksumStart || pendingChecksumOffset != contextChecksumOffset);
+    while (getFreeTransmitDescriptors() < (newContext ? 2u : 1u)) {
+        transmitLock.release();
+        Util::Async::Thread::yield();
+        transmitLock.acquire();
+        reclaimTransmitDescriptors();
+    }
+
+    if (newContext) {
+        auto &context = reinterpret_cast<volatile TransmitContextDescriptor&>(transmitDescriptors[transmitTail]);
+        context.ipChecksumStart = 0;
+        context.ipChecksumOffset = 0;
+        context.ipChecksumEnd = 0;
+        context.transportChecksumStart = pendingChecksumStart;
+        context.transportChecksumOffset = pendingChecksumStart + pendingChecksumOffset;
+        context.transportChecksumEnd = 0; // Until the end of the packet
+        context.command = CONTEXT_DESCRIPTOR | DESCRIPTOR_EXTENSION | REPORT_STATUS;
+        context.status = 0;
+        context.headerLength = 0;
+        context.maximumSegmentSize = 0;
+
+        contextChecksumStart = pendingChecksumStart;
+        contextChecksumOffset = pendingChecksumOffset;
+        transmitDescriptorHasPacket[transmitTail] = false;
+        transmitTail = (transmitTail + 1) % TRANSMIT_DESCRIPTOR_COUNT;
+    }
+
+    auto &descriptor = transmitDescriptors[transmitTail];
+    descriptor.address = getPhysicalAddress(packet);
+    descriptor.command = length | DATA_DESCRIPTOR | DESCRIPTOR_EXTENSION | END_OF_PACKET_COMMAND | INSERT_FCS | REPORT_STATUS;
+    descriptor.status = 0;
+    descriptor.options = checksumOffload ? INSERT_TRANSPORT_CHECKSUM : 0;
+    descriptor.special = 0;
+
+    transmitDescriptorHasPacket[transmitTail] = true;
+    transmitTail = (transmitTail + 1) % TRANSMIT_DESCRIPTOR_COUNT;
+    pendingChecksumStart = 0;
+    pendingChecksumOffset = 0;
+
+    writeRegister(TRANSMIT_DESCRIPTOR_TAIL, transmitTail);
+    transmitLock.release();
+}
+
+bool E1000::offloadChecksum(uint16_t checksumStart, uint16_t checksumOffset) {
+    // Called right before handleOutgoingPacket() by the same sender, so the position can be kept until then
+    if (checksumStart + checksumOffset > UINT8_MAX) {
+        return false; // Context descriptors only hold 8-bit offsets
+    }
+
+    pendingChecksumStart = checksumStart;
+    pendingChecksumOffset = checksumOffset;
+    return true;
+}
+
+bool E1000::setReceiveInterruptsEnabled(bool enabled) {
+    writeRegister(enabled ? INTERRUPT_MASK_SET : INTERRUPT_MASK_CLEAR, RECEIVE_INTERRUPTS);
+    return true;
+}
+
+void E1000::pollReceivedPackets() {
+    receivePackets();
+}
+
+uint32_t E1000::readRegister(uint32_t reg) const {
+    return *reinterpret_cast<volatile uint32_t*>(registers + reg);
+}
+
+void E1000::writeRegister(uint32_t reg, uint32_t value) {
+    *reinterpret_cast<volatile uint32_t*>(registers + reg) = value;
+}
+
+void E1000::readMacAddress() {
+    auto low = readRegister(RECEIVE_ADDRESS_LOW);
+    auto high = readRegister(RECEIVE_ADDRESS_HIGH);
+
+    uint8_t buffer[6] = {
+            static_cast<uint8_t>(low), static_cast<uint8_t>(low >> 8), static_cast<uint8_t>(low >> 16), static_cast<uint8_t>(low >> 24),
+            static_cast<uint8_t>(high), static_cast<uint8_t>(high >> 8)
+    };
+
+    macAddress = Util::Network::MacAddress(buffer);
+}
+
+bool E1000::setupReceiveRing() {
+    // The ring is filled from the receive pool, so half of the pool is left for packets waiting to be processed
+    receiveDescriptorCount = getReceiveRingSize() / 2;
+    if (receiveDescriptorCount > MAX_RECEIVE_DESCRIPTORS) {
+        receiveDescriptorCount = MAX_RECEIVE_DESCRIPTORS;
+    }
+
+    // The ring length must be a multiple of 128 bytes
+    receiveDescriptorCount -= receiveDescriptorCount % MIN_RECEIVE_DESCRIPTORS;
+    if (receiveDescriptorCount < MIN_RECEIVE_DESCRIPTORS) {
+        receiveDescriptorCount = MIN_RECEIVE_DESCRIPTORS;
+    }
+
+    auto &memoryService = Kernel::Service::getService<Kernel::MemoryService>();
+    receiveDescriptors = static_cast<ReceiveDescriptor*>(memoryService.mapIO(1));
+    receiveBuffers = new uint8_t*[receiveDescriptorCount];
+
+    for (uint32_t i = 0; i < receiveDescriptorCount; i++) {
+        receiveBuffers[i] = allocateReceiveBuffer();
+        if (receiveBuffers[i] == nullptr) {
+            LOG_ERROR("E1000: Receive pool is too small for [%u] receive descriptors", receiveDescriptorCount);
+            return false;
+        }
+
+        receiveDescriptors[i].address = getPhysicalAddress(receiveBuffers[i]);
+        receiveDescriptors[i].status = 0;
+    }
+
+    auto physicalAddress = reinterpret_cast<uint32_t>(memoryService.getPhysicalAddress(const_cast<ReceiveDescriptor*>(receiveDescriptors)));
+    writeRegister(RECEIVE_DESCRIPTOR_BASE_LOW, physicalAddress);
+    writeRegister(RECEIVE_DESCRIPTOR_BASE_HIGH, 0);
+    writeRegister(RECEIVE_DESCRIPTOR_LENGTH, receiveDescriptorCount * sizeof(ReceiveDescriptor));
+    writeRegister(RECEIVE_DESCRIPTOR_HEAD, 0);
+    writeRegister(RECEIVE_DESCRIPTOR_TAIL, receiveDescriptorCount - 1);
+    writeRegister(RECEIVE_CONTROL, RECEIVER_ENABLE | BROADCAST_ACCEPT | BUFFER_SIZE_2048 | STRIP_CRC);
+
+    return true;
+}
+
+void E1000::setupTransmitRing() {
+    auto &memoryService = Kernel::Service::getService<Kernel::MemoryService>();
+    transmitDescriptors = static_cast<TransmitDescriptor*>(memoryService.mapIO((TRANSMIT_DESCRIPTOR_COUNT * sizeof(TransmitDescriptor) + Util::PAGESIZE - 1) / Util::PAGESIZE));
+    transmitDescriptorHasPacket = new bool[TRANSMIT_DESCRIPTOR_COUNT]{};
+
+    auto physicalAddress = reinterpret_cast<uint32_t>(memoryService.getPhysicalAddress(const_cast<TransmitDescriptor*>(transmitDescriptors)));
+    writeRegister(TRANSMIT_DESCRIPTOR_BASE_LOW, physicalAddress);
+    writeRegister(TRANSMIT_DESCRIPTOR_BASE_HIGH, 0);
+    writeRegister(TRANSMIT_DESCRIPTOR_LENGTH, TRANSMIT_DESCRIPTOR_COUNT * sizeof(TransmitDescriptor));
+    writeRegister(TRANSMIT_DESCRIPTOR_HEAD, 0);
+    writeRegister(TRANSMIT_DESCRIPTOR_TAIL, 0);
+    writeRegister(TRANSMIT_INTER_PACKET_GAP, TRANSMIT_INTER_PACKET_GAP_COPPER);
+    writeRegister(TRANSMIT_CONTROL, TRANSMITTER_ENABLE | PAD_SHORT_PACKETS | COLLISION_THRESHOLD | COLLISION_DISTANCE);
+}
+
+void E1000::receivePackets() {
+    // Called by the interrupt handler and by the packet reader in polling mode -> Whoever gets the lock drains the ring
+    if (!receiveLock.tryAcquire()) {
+        return;
+    }
+
+    auto lastProcessed = receiveDescriptorCount;
+    while (receiveDescriptors[nextReceiveDescriptor].status & RECEIVE_DESCRIPTOR_DONE) {
+        asm volatile ("" : : : "memory");
+
+        auto &descriptor = receiveDescriptors[nextReceiveDescriptor];
+        uint8_t status = descriptor.status;
+        uint8_t errors = descriptor.errors;
+
+        if (!(status & END_OF_PACKET)) {
+            // Packets spanning multiple buffers exceed the maximum ethernet packet size -> Discard all parts
+            discardingPacket = true;
+        } else if (discardingPacket) {
+            discardingPacket = false;
+        } else if (!(errors & FRAME_ERRORS)) {
+            // Hand the filled buffer over to the network stack and replace it (if the pool is exhausted, the packet is dropped)
+            auto *replacement = allocateReceiveBuffer();
+            if (replacement != nullptr) {
+                auto checksumVerified = (status & TRANSPORT_CHECKSUM_CALCULATED) && !(status & IGNORE_CHECKSUM) && !(errors & TRANSPORT_CHECKSUM_ERROR);
+                handleReceivedBuffer(receiveBuffers[nextReceiveDescriptor], descriptor.length, checksumVerified);
+
+                receiveBuffers[nextReceiveDescriptor] = replacement;
+                descriptor.address = getPhysicalAddress(replacement);
+            }
+        }
+
+        descriptor.status = 0;
+        lastProcessed = nextReceiveDescriptor;
+        nextReceiveDescriptor = (nextReceiveDescriptor + 1) % receiveDescriptorCount;
+    }
+
+    // All processed descriptors are returned to the controller with a single tail update
+    if (lastProcessed != receiveDescriptorCount) {
+        writeRegister(RECEIVE_DESCRIPTOR_TAIL, lastProcessed);
+    }
+
+    receiveLock.release();
+}
+
+void E1000::reclaimTransmitDescriptors() {
+    // The controller processes descriptors in order, so each sent packet corresponds to the oldest packet in the outgoing queue
+    while (transmitClean != transmitTail && (transmitDescriptors[transmitClean].status & TRANSMIT_DESCRIPTOR_DONE)) {
+        if (transmitDescriptorHasPacket[transmitClean]) {
+            freeLastSendBuffer();
+        }
+
+        transmitClean = (transmitClean + 1) % TRANSMIT_DESCRIPTOR_COUNT;
+    }
+}
+
+uint32_t E1000::getFreeTransmitDescriptors() const {
+    // One descriptor is always left empty, so that a full ring can be distinguished from an empty one
+    return TRANSMIT_DESCRIPTOR_COUNT - 1 - (transmitTail + TRANSMIT_DESCRIPTOR_COUNT - transmitClean) % TRANSMIT_DESCRIPTOR_COUNT;
+}
+
+uint32_t E1000::getInterruptThrottlingInterval() {
+    const auto &multiboot = Kernel::Service::getService<Kernel::InformationService>().getMultibootInformation();
+    auto rate = multiboot.hasKernelOption("e1000_interrupt_rate") ? Util::String::parseInt(multiboot.getKernelOption("e1000_interrupt_rate")) : DEFAULT_INTERRUPT_RATE;
+    if (rate <= 0) {
+        return 0; // No throttling
+    }
+
+    // The interval is given in units of 256 ns
+    auto interval = 1000000000 / (static_cast<uint32_t>(rate) * 256);
+    return interval > UINT16_MAX ? UINT16_MAX : interval;
+}
+
+uint32_t E1000::getPhysicalAddress(const uint8_t *address) {
+    auto &memoryService = Kernel::Service::getService<Kernel::MemoryService>();
+    return reinterpret_cast<uint32_t>(memoryService.getPhysicalAddress(const_cast<uint8_t*>(address)));
+}
+
+}
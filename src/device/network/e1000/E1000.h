@@ -0,0 +1,281 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef HHUOS_E1000_H
+#define HHUOS_E1000_H
+
+#include <stdint.h>
+
+#include "device/bus/pci/PciDevice.h"
+#include "device/network/NetworkDevice.h"
+#include "kernel/interrupt/InterruptHandler.h"
+#include "lib/util/async/Spinlock.h"
+#include "lib/util/network/MacAddress.h"
+
+namespace Kernel {
+enum InterruptVector : uint8_t;
+struct InterruptFrame;
+}  // namespace Kernel
+
+namespace Device::Network {
+
+/**
+ * Driver for Intel 8254x gigabit ethernet controllers (e.g. the 82540EM emulated by QEMU).
+ * The receive ring is filled with buffers from the device's receive pool, so that received packets are passed
+ * to the network stack without copying them. Outgoing packets are transmitted directly from the pooled transmit buffers.
+ * The interrupt rate is limited by the interrupt throttling register and checksums are offloaded in both directions.
+ */
+class E1000 : public NetworkDevice, Kernel::InterruptHandler {
+
+public:
+    /**
+     * Constructor.
+     */
+    explicit E1000(const PciDevice &pciDevice);
+
+    /**
+     * Copy Constructor.
+     */
+    E1000(const E1000 &other) = delete;
+
+    /**
+     * Assignment operator.
+     */
+    E1000 &operator=(const E1000 &other) = delete;
+
+    /**
+     * Destructor.
+     */
+    ~E1000() override;
+
+    static void initializeAvailableCards();
+
+    /**
+     * Reset the controller and set up the descriptor rings.
+     *
+     * @return false, if the controller could not be initialized
+     */
+    bool initialize();
+
+    [[nodiscard]] Util::Network::MacAddress getMacAddress() const override;
+
+    void plugin() override;
+
+    void trigger(const Kernel::InterruptFrame &frame, Kernel::InterruptVector slot) override;
+
+protected:
+
+    void handleOutgoingPacket(const uint8_t *packet, uint32_t length) override;
+
+    bool offloadChecksum(uint16_t checksumStart, uint16_t checksumOffset) override;
+
+    bool setReceiveInterruptsEnabled(bool enabled) override;
+
+    void pollReceivedPackets() override;
+
+private:
+
+    enum Register : uint32_t {
+        CONTROL = 0x0000,
+        STATUS = 0x0008,
+        INTERRUPT_CAUSE_READ = 0x00c0,
+        INTERRUPT_THROTTLING = 0x00c4,
+        INTERRUPT_MASK_SET = 0x00d0,
+        INTERRUPT_MASK_CLEAR = 0x00d8,
+        RECEIVE_CONTROL = 0x0100,
+        TRANSMIT_CONTROL = 0x0400,
+        TRANSMIT_INTER_PACKET_GAP = 0x0410,
+        RECEIVE_DESCRIPTOR_BASE_LOW = 0x2800,
+        RECEIVE_DESCRIPTOR_BASE_HIGH = 0x2804,
+        RECEIVE_DESCRIPTOR_LENGTH = 0x2808,
+        RECEIVE_DESCRIPTOR_HEAD = 0x2810,
+        RECEIVE_DESCRIPTOR_TAIL = 0x2818,
+        RECEIVE_DELAY_TIMER = 0x2820,
+        TRANSMIT_DESCRIPTOR_BASE_LOW = 0x3800,
+        TRANSMIT_DESCRIPTOR_BASE_HIGH = 0x3804,
+        TRANSMIT_DESCRIPTOR_LENGTH = 0x3808,
+        TRANSMIT_DESCRIPTOR_HEAD = 0x3810,
+        TRANSMIT_DESCRIPTOR_TAIL = 0x3818,
+        RECEIVE_CHECKSUM_CONTROL = 0x5000,
+        MULTICAST_TABLE_ARRAY = 0x5200,
+        RECEIVE_ADDRESS_LOW = 0x5400,
+        RECEIVE_ADDRESS_HIGH = 0x5404
+    };
+
+    enum Control : uint32_t {
+        AUTO_SPEED_DETECTION = 1 << 5,
+        SET_LINK_UP = 1 << 6,
+        RESET = 1 << 26
+    };
+
+    enum ReceiveAddress : uint32_t {
+        ADDRESS_VALID = 1u << 31
+    };
+
+    enum Interrupt : uint32_t {
+        TRANSMIT_DESCRIPTOR_WRITTEN_BACK = 1 << 0,
+        LINK_STATUS_CHANGE = 1 << 2,
+        RECEIVE_DESCRIPTOR_MINIMUM_THRESHOLD = 1 << 4,
+        RECEIVER_OVERRUN = 1 << 6,
+        RECEIVER_TIMER = 1 << 7,
+        RECEIVE_INTERRUPTS = RECEIVE_DESCRIPTOR_MINIMUM_THRESHOLD | RECEIVER_OVERRUN | RECEIVER_TIMER
+    };
+
+    enum ReceiveControl : uint32_t {
+        RECEIVER_ENABLE = 1 << 1,
+        BROADCAST_ACCEPT = 1 << 15,
+        BUFFER_SIZE_2048 = 0 << 16,
+        STRIP_CRC = 1 << 26
+    };
+
+    enum TransmitControl : uint32_t {
+        TRANSMITTER_ENABLE = 1 << 1,
+        PAD_SHORT_PACKETS = 1 << 3,
+        COLLISION_THRESHOLD = 0x0f << 4,
+        COLLISION_DISTANCE = 0x40 << 12
+    };
+
+    enum ReceiveChecksumControl : uint32_t {
+        IP_CHECKSUM_OFFLOAD = 1 << 8,
+        TRANSPORT_CHECKSUM_OFFLOAD = 1 << 9
+    };
+
+    enum ReceiveStatus : uint8_t {
+        RECEIVE_DESCRIPTOR_DONE = 1 << 0,
+        END_OF_PACKET = 1 << 1,
+        IGNORE_CHECKSUM = 1 << 2,
+        TRANSPORT_CHECKSUM_CALCULATED = 1 << 5
+    };
+
+    enum ReceiveError : uint8_t {
+        CRC_ERROR = 1 << 0,
+        SYMBOL_ERROR = 1 << 1,
+        SEQUENCE_ERROR = 1 << 2,
+        CARRIER_EXTENSION_ERROR = 1 << 4,
+        TRANSPORT_CHECKSUM_ERROR = 1 << 5,
+        DATA_ERROR = 1 << 7,
+        FRAME_ERRORS = CRC_ERROR | SYMBOL_ERROR | SEQUENCE_ERROR | CARRIER_EXTENSION_ERROR | DATA_ERROR
+    };
+
+    enum TransmitCommand : uint32_t {
+        END_OF_PACKET_COMMAND = 1 << 24,
+        INSERT_FCS = 1 << 25,
+        REPORT_STATUS = 1 << 27,
+        DESCRIPTOR_EXTENSION = 1 << 29,
+        DATA_DESCRIPTOR = 1 << 20,
+        CONTEXT_DESCRIPTOR = 0 << 20
+    };
+
+    enum TransmitOption : uint8_t {
+        INSERT_TRANSPORT_CHECKSUM = 1 << 1
+    };
+
+    enum TransmitStatus : uint8_t {
+        TRANSMIT_DESCRIPTOR_DONE = 1 << 0
+    };
+
+    struct ReceiveDescriptor {
+        uint64_t address;
+        uint16_t length;
+        uint16_t checksum;
+        uint8_t status;
+        uint8_t errors;
+        uint16_t special;
+    } __attribute__((packed));
+
+    /**
+     * Data and context descriptors share the same layout in the transmit ring.
+     * All data descriptors use the extended format, so that checksum insertion can be enabled per packet.
+     */
+    struct TransmitDescriptor {
+        uint64_t address;
+        uint32_t command;
+        uint8_t status;
+        uint8_t options;
+        uint16_t special;
+    } __attribute__((packed));
+
+    struct TransmitContextDescriptor {
+        uint8_t ipChecksumStart;
+        uint8_t ipChecksumOffset;
+        uint16_t ipChecksumEnd;
+        uint8_t transportChecksumStart;
+        uint8_t transportChecksumOffset;
+        uint16_t transportChecksumEnd;
+        uint32_t command;
+        uint8_t status;
+        uint8_t headerLength;
+        uint16_t maximumSegmentSize;
+    } __attribute__((packed));
+
+    [[nodiscard]] uint32_t readRegister(uint32_t reg) const;
+
+    void writeRegister(uint32_t reg, uint32_t value);
+
+    void readMacAddress();
+
+    bool setupReceiveRing();
+
+    void setupTransmitRing();
+
+    void receivePackets();
+
+    void reclaimTransmitDescriptors();
+
+    [[nodiscard]] uint32_t getFreeTransmitDescriptors() const;
+
+    static uint32_t getInterruptThrottlingInterval();
+
+    static uint32_t getPhysicalAddress(const uint8_t *address);
+
+    PciDevice pciDevice;
+    volatile uint8_t *registers = nullptr;
+    Util::Network::MacAddress macAddress;
+
+    volatile ReceiveDescriptor *receiveDescriptors = nullptr;
+    uint8_t **receiveBuffers = nullptr;
+    uint32_t receiveDescriptorCount = 0;
+    uint32_t nextReceiveDescriptor = 0;
+    bool discardingPacket = false;
+    Util::Async::Spinlock receiveLock;
+
+    volatile TransmitDescriptor *transmitDescriptors = nullptr;
+    bool *transmitDescriptorHasPacket = nullptr;
+    uint32_t transmitTail = 0;
+    uint32_t transmitClean = 0;
+    uint16_t contextChecksumStart = 0;
+    uint16_t contextChecksumOffset = 0;
+    uint16_t pendingChecksumStart = 0;
+    uint16_t pendingChecksumOffset = 0;
+    Util::Async::Spinlock transmitLock;
+
+    static const constexpr uint16_t VENDOR_ID = 0x8086;
+    static const constexpr uint16_t DEVICE_ID_82540EM = 0x100e;
+    static const constexpr uint16_t DEVICE_ID_82543GC = 0x1004;
+    static const constexpr uint16_t DEVICE_ID_82545EM = 0x100f;
+    static const constexpr uint32_t MIN_RECEIVE_DESCRIPTORS = 8;
+    static const constexpr uint32_t MAX_RECEIVE_DESCRIPTORS = 32;
+    static const constexpr uint32_t TRANSMIT_DESCRIPTOR_COUNT = 128;
+    static const constexpr uint32_t DEFAULT_INTERRUPT_RATE = 8000;
+    static const constexpr uint32_t RESET_TIMEOUT = 100;
+    // Recommended inter packet gap for copper (IPGT = 10, IPGR1 = 8, IPGR2 = 6)
+    static const constexpr uint32_t TRANSMIT_INTER_PACKET_GAP_COPPER = 10 | (8 << 10) | (6 << 20);
+};
+
+}
+
+#endif
@@ -115,19 +115,45 @@ void Rtl8139::plugin() {
 }
 
 void Rtl8139::trigger([[maybe_unused]] const Kernel::InterruptFrame &frame, [[maybe_unused]] Kernel::InterruptVector slot) {
-    auto interrupt = baseRegister.readWord(INTERRUPT_STATUS);
+    // Status bits of masked interrupts are still set (e.g. while receive interrupts are disabled for polling)
+    auto interrupt = baseRegister.readWord(INTERRUPT_STATUS) & baseRegister.readWord(INTERRUPT_MASK);
+
+    // Acknowledge all causes at once, even if the receive ring is drained by another context right now.
+    // The interrupt is level-triggered and would fire again immediately otherwise.
+    baseRegister.writeWord(INTERRUPT_STATUS, interrupt);
+
+    if (interrupt & TRANSMIT_OK) {
+        freeLastSendBuffer();
+    }
+
     if (interrupt & RECEIVE_OK) {
+        receivePackets();
+    }
+}
+
+bool Rtl8139::setReceiveInterruptsEnabled(bool enabled) {
+    baseRegister.writeWord(INTERRUPT_MASK, enabled ? RECEIVE_OK | RECEIVE_ERROR | TRANSMIT_OK | TRANSMIT_ERROR : TRANSMIT_OK | TRANSMIT_ERROR);
+    return true;
+}
+
+void Rtl8139::pollReceivedPackets() {
+    receivePackets();
+}
+
+void Rtl8139::receivePackets() {
+    // Called by the interrupt handler and by the packet reader in polling mode -> Whoever gets the lock drains the ring.
+    // If the lock is taken, the pending flag makes the owner drain the ring again, before it gives up the lock.
+    receivePending = true;
+    while (receivePending && receiveLock.tryAcquire()) {
+        receivePending = false;
+
+        // Acknowledge first, so that a packet arriving while draining raises a new interrupt
+        baseRegister.writeWord(INTERRUPT_STATUS, RECEIVE_OK);
         while (!(baseRegister.readByte(COMMAND) & BUFFER_EMPTY)) {
             processIncomingPacket();
         }
-        baseRegister.writeWord(INTERRUPT_STATUS, RECEIVE_OK);
-    } else if (interrupt & TRANSMIT_OK) {
-        freeLastSendBuffer();
-        baseRegister.writeWord(INTERRUPT_STATUS, TRANSMIT_OK);
-    } else if (interrupt & TRANSMIT_ERROR) {
-        baseRegister.writeWord(INTERRUPT_STATUS, TRANSMIT_ERROR);
-    } else if (interrupt & RECEIVE_ERROR) {
-        baseRegister.writeWord(INTERRUPT_STATUS, RECEIVE_ERROR);
+
+        receiveLock.release();
     }
 }
 
@@ -29,6 +29,7 @@
 #include "device/cpu/IoPort.h"
 #include "lib/util/network/MacAddress.h"
 #include "lib/util/base/Constants.h"
+#include "lib/util/async/Spinlock.h"
 
 namespace Kernel {
 enum InterruptVector : uint8_t;
@@ -72,6 +73,10 @@ protected:
 
     void handleOutgoingPacket(const uint8_t *packet, uint32_t length) override;
 
+    bool setReceiveInterruptsEnabled(bool enabled) override;
+
+    void pollReceivedPackets() override;
+
 private:
     
     enum Register : uint8_t {
@@ -147,6 +152,8 @@ private:
         uint16_t length;
     };
 
+    void receivePackets();
+
     bool isTransmitDescriptorAvailable();
 
     void setTransmitAddress(void *buffer);
@@ -160,6 +167,8 @@ private:
     uint16_t receiveIndex = 0;
     uint8_t *receiveBuffer{};
     IoPort baseRegister = IoPort(0x00);
+    Util::Async::Spinlock receiveLock;
+    volatile bool receivePending = false;
 
     static const constexpr uint16_t VENDOR_ID = 0x10ec;
     static const constexpr uint16_t DEVICE_ID = 0x8139;
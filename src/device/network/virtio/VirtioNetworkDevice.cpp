@@ -0,0 +1,288 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "VirtioNetworkDevice.h"
+
+#include "device/bus/pci/Pci.h"
+#include "device/bus/pci/PciDevice.h"
+#include "kernel/log/Log.h"
+#include "kernel/service/InterruptService.h"
+#include "kernel/service/MemoryService.h"
+#include "kernel/service/NetworkService.h"
+#include "kernel/service/Service.h"
+#include "lib/util/async/Thread.h"
+#include "lib/util/base/Address.h"
+#include "lib/util/base/Constants.h"
+#include "lib/util/collection/Array.h"
+
+namespace Kernel {
+enum InterruptVector : uint8_t;
+struct InterruptFrame;
+}  // namespace Kernel
+
+namespace Device::Network {
+
+VirtioNetworkDevice::VirtioNetworkDevice(const PciDevice &pciDevice) : device(pciDevice) {}
+
+VirtioNetworkDevice::~VirtioNetworkDevice() {
+    delete receiveQueue;
+    delete transmitQueue;
+    delete receiveSlots;
+    delete transmitHeaders;
+}
+
+void VirtioNetworkDevice::initializeAvailableDevices() {
+    auto &networkService = Kernel::Service::getService<Kernel::NetworkService>();
+    for (auto deviceId : {DEVICE_ID_TRANSITIONAL, DEVICE_ID_MODERN}) {
+        for (const auto &pciDevice : Pci::search(VirtioDevice::VENDOR_ID, deviceId)) {
+            LOG_INFO("Initializing virtio network device [0x%04x:0x%04x]", pciDevice.getVendorId(), pciDevice.getDeviceId());
+
+            auto *device = new VirtioNetworkDevice(pciDevice);
+            if (!device->initialize()) {
+                LOG_ERROR("Failed to initialize virtio network device");
+                delete device;
+                continue;
+            }
+
+            networkService.registerNetworkDevice(device, "eth");
+            device->plugin();
+        }
+    }
+}
+
+bool VirtioNetworkDevice::initialize() {
+    if (!device.initialize()) {
+        return false;
+    }
+
+    if (!device.negotiateFeatures(CHECKSUM | GUEST_CHECKSUM | MAC | MERGEABLE_RECEIVE_BUFFERS |
+                                  VirtioDevice::RING_INDIRECT_DESCRIPTORS | VirtioDevice::RING_EVENT_INDEX)) {
+        return false;
+    }
+
+    if (device.hasFeature(MAC)) {
+        uint8_t buffer[6];
+        for (uint8_t i = 0; i < sizeof(buffer); i++) {
+            buffer[i] = device.readConfigByte(MAC_ADDRESS + i);
+        }
+
+        macAddress = Util::Network::MacAddress(buffer);
+    }
+
+    // Legacy devices only append the buffer count to the header, if mergeable receive buffers are used
+    if (device.isModern() || device.hasFeature(MERGEABLE_RECEIVE_BUFFERS)) {
+        headerSize = sizeof(PacketHeader);
+    }
+
+    // Header and packet are always passed as separate descriptors, since legacy devices may expect this layout
+    auto indirectDescriptors = device.hasFeature(VirtioDevice::RING_INDIRECT_DESCRIPTORS);
+    receiveQueue = device.setupQueue(RECEIVE_QUEUE, MAX_QUEUE_SIZE, indirectDescriptors ? 2 : 0);
+    transmitQueue = device.setupQueue(TRANSMIT_QUEUE, MAX_QUEUE_SIZE, indirectDescriptors ? 2 : 0);
+    if (receiveQueue == nullptr || transmitQueue == nullptr) {
+        LOG_ERROR("Virtio network device does not provide a receive and a transmit queue");
+        device.fail();
+        return false;
+    }
+
+    // Receive buffers and transmit headers are accessed by the device, so they need to be placed in DMA memory
+    auto &memoryService = Kernel::Service::getService<Kernel::MemoryService>();
+    receiveSlotCount = indirectDescriptors ? receiveQueue->getSize() : receiveQueue->getSize() / 2;
+    receiveSlots = static_cast<uint8_t*>(memoryService.mapIO((receiveSlotCount * RECEIVE_SLOT_SIZE + Util::PAGESIZE - 1) / Util::PAGESIZE));
+    receiveSlotsPhysicalAddress = reinterpret_cast<uint32_t>(memoryService.getPhysicalAddress(receiveSlots));
+
+    transmitHeaders = static_cast<uint8_t*>(memoryService.mapIO((transmitQueue->getSize() * TRANSMIT_HEADER_SLOT_SIZE + Util::PAGESIZE - 1) / Util::PAGESIZE));
+    transmitHeadersPhysicalAddress = reinterpret_cast<uint32_t>(memoryService.getPhysicalAddress(transmitHeaders));
+    Util::Address<uint32_t>(transmitHeaders).setRange(0, transmitQueue->getSize() * TRANSMIT_HEADER_SLOT_SIZE);
+
+    for (uint32_t i = 0; i < receiveSlotCount; i++) {
+        submitReceiveBuffer(receiveSlots + i * RECEIVE_SLOT_SIZE);
+    }
+
+    device.finishInitialization();
+    receiveQueue->notify();
+
+    LOG_INFO("Virtio network device: MAC address [%s], [%u] receive buffers, [%s] interface, checksum offload [%s], mergeable receive buffers [%s]",
+             static_cast<const char*>(macAddress.toString()), receiveSlotCount, device.isModern() ? "modern" : "legacy",
+             device.hasFeature(CHECKSUM) ? "yes" : "no", device.hasFeature(MERGEABLE_RECEIVE_BUFFERS) ? "yes" : "no");
+
+    return true;
+}
+
+Util::Network::MacAddress VirtioNetworkDevice::getMacAddress() const {
+    return macAddress;
+}
+
+void VirtioNetworkDevice::plugin() {
+    auto &interruptService = Kernel::Service::getService<Kernel::InterruptService>();
+    interruptService.assignInterrupt(static_cast<Kernel::InterruptVector>(device.getPciDevice().getInterruptLine() + 32), *this);
+    interruptService.allowHardwareInterrupt(device.getPciDevice().getInterruptLine());
+}
+
+void VirtioNetworkDevice::trigger([[maybe_unused]] const Kernel::InterruptFrame &frame, [[maybe_unused]] Kernel::InterruptVector slot) {
+    // Reading the status register acknowledges the interrupt (the line may be shared with other devices)
+    if (!(device.readInterruptStatus() & VirtioDevice::QUEUE_INTERRUPT)) {
+        return;
+    }
+
+    receivePackets();
+
+    // If the transmit queue is locked, its owner is going to reclaim the sent buffers itself
+    if (transmitLock.tryAcquire()) {
+        reclaimTransmitBuffers();
+        transmitLock.release();
+    }
+}
+
+void VirtioNetworkDevice::handleOutgoingPacket(const uint8_t *packet, uint32_t length) {
+    transmitLock.acquire();
+    reclaimTransmitBuffers();
+
+    while (!transmitQueue->canSubmit(2)) {
+        transmitLock.release();
+        Util::Async::Thread::yield();
+        transmitLock.acquire();
+        reclaimTransmitBuffers();
+    }
+
+    // The queue never holds more packets than descriptors, so a header slot is free again, once its index comes around
+    auto headerOffset = nextTransmitHeader * TRANSMIT_HEADER_SLOT_SIZE;
+    nextTransmitHeader = (nextTransmitHeader + 1) % transmitQueue->getSize();
+
+    auto *header = reinterpret_cast<PacketHeader*>(transmitHeaders + headerOffset);
+    *header = PacketHeader{};
+    if (pendingChecksumStart > 0) {
+        header->flags = NEEDS_CHECKSUM;
+        header->checksumStart = pendingChecksumStart;
+        header->checksumOffset = pendingChecksumOffset;
+        pendingChecksumStart = 0;
+        pendingChecksumOffset = 0;
+    }
+
+    const Virtqueue::Buffer buffers[2] = {
+            { transmitHeadersPhysicalAddress + headerOffset, headerSize, false },
+            { getPhysicalAddress(packet), length, false }
+    };
+
+    transmitQueue->submit(buffers, 2, const_cast<uint8_t*>(packet));
+    transmitQueue->notify();
+    transmitLock.release();
+}
+
+bool VirtioNetworkDevice::offloadChecksum(uint16_t checksumStart, uint16_t checksumOffset) {
+    // Called right before handleOutgoingPacket() by the same sender, so the position can be kept until then
+    if (!device.hasFeature(CHECKSUM)) {
+        return false;
+    }
+
+    pendingChecksumStart = checksumStart;
+    pendingChecksumOffset = checksumOffset;
+    return true;
+}
+
+bool VirtioNetworkDevice::setReceiveInterruptsEnabled(bool enabled) {
+    receiveLock.acquire();
+    receiveQueue->setInterruptsEnabled(enabled);
+    receiveLock.release();
+
+    return true;
+}
+
+void VirtioNetworkDevice::pollReceivedPackets() {
+    receivePackets();
+}
+
+void VirtioNetworkDevice::submitReceiveBuffer(uint8_t *slot) {
+    auto physicalAddress = receiveSlotsPhysicalAddress + (slot - receiveSlots);
+    const Virtqueue::Buffer buffers[2] = {
+            { physicalAddress, headerSize, true },
+            { physicalAddress + headerSize, RECEIVE_SLOT_SIZE - headerSize, true }
+    };
+
+    receiveQueue->submit(buffers, 2, slot);
+}
+
+void VirtioNetworkDevice::receivePackets() {
+    // Called by the interrupt handler and by the packet reader in polling mode -> Whoever gets the lock drains the queue
+    if (!receiveLock.tryAcquire()) {
+        return;
+    }
+
+    uint32_t length;
+    uint8_t *slot;
+    while ((slot = static_cast<uint8_t*>(receiveQueue->getUsedBuffer(length))) != nullptr) {
+        auto *header = reinterpret_cast<PacketHeader*>(slot);
+        auto bufferCount = device.hasFeature(MERGEABLE_RECEIVE_BUFFERS) ? header->bufferCount : 1;
+        auto checksumVerified = device.hasFeature(GUEST_CHECKSUM) && (header->flags & (NEEDS_CHECKSUM | DATA_VALID));
+        auto packetLength = length > headerSize ? length - headerSize : 0;
+
+        if (bufferCount <= 1) {
+            // Common case: The packet fits into a single buffer and is passed on directly
+            handleIncomingPacket(slot + headerSize, packetLength, checksumVerified);
+            submitReceiveBuffer(slot);
+            continue;
+        }
+
+        // The packet is spread across multiple buffers (only the first one contains a header) -> Gather it in the merge buffer
+        bool valid = packetLength <= sizeof(mergeBuffer);
+        uint32_t mergedLength = 0;
+        if (valid) {
+            Util::Address<uint32_t>(mergeBuffer).copyRange(Util::Address<uint32_t>(slot + headerSize), packetLength);
+            mergedLength = packetLength;
+        }
+        submitReceiveBuffer(slot);
+
+        for (uint16_t i = 1; i < bufferCount; i++) {
+            slot = static_cast<uint8_t*>(receiveQueue->getUsedBuffer(length));
+            if (slot == nullptr) {
+                valid = false;
+                break;
+            }
+
+            if (valid && mergedLength + length <= sizeof(mergeBuffer)) {
+                Util::Address<uint32_t>(mergeBuffer + mergedLength).copyRange(Util::Address<uint32_t>(slot), length);
+                mergedLength += length;
+            } else {
+                valid = false;
+            }
+
+            submitReceiveBuffer(slot);
+        }
+
+        if (valid) {
+            handleIncomingPacket(mergeBuffer, mergedLength, checksumVerified);
+        }
+    }
+
+    // All refilled buffers are announced with a single notification
+    receiveQueue->notify();
+    receiveLock.release();
+}
+
+void VirtioNetworkDevice::reclaimTransmitBuffers() {
+    // The device completes transmissions in order, so each used buffer corresponds to the oldest packet in the outgoing queue
+    uint32_t length;
+    while (transmitQueue->getUsedBuffer(length) != nullptr) {
+        freeLastSendBuffer();
+    }
+}
+
+uint32_t VirtioNetworkDevice::getPhysicalAddress(const uint8_t *address) {
+    auto &memoryService = Kernel::Service::getService<Kernel::MemoryService>();
+    return reinterpret_cast<uint32_t>(memoryService.getPhysicalAddress(const_cast<uint8_t*>(address)));
+}
+
+}
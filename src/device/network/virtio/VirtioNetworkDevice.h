@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef HHUOS_VIRTIONETWORKDEVICE_H
+#define HHUOS_VIRTIONETWORKDEVICE_H
+
+#include <stdint.h>
+
+#include "device/bus/virtio/VirtioDevice.h"
+#include "device/bus/virtio/Virtqueue.h"
+#include "device/network/NetworkDevice.h"
+#include "kernel/interrupt/InterruptHandler.h"
+#include "lib/util/async/Spinlock.h"
+#include "lib/util/network/MacAddress.h"
+
+namespace Kernel {
+enum InterruptVector : uint8_t;
+struct InterruptFrame;
+}  // namespace Kernel
+
+namespace Device::Network {
+
+/**
+ * Driver for virtio network devices (virtio specification 1.1, chapter 5.1).
+ * The driver uses a single pair of receive/transmit queues, since the network stack processes the packets
+ * of a device with a single packet reader anyway. Receive buffers are refilled in batches and announced to the device
+ * with a single notification. Transport layer checksums are offloaded to the device in both directions, if supported.
+ */
+class VirtioNetworkDevice : public NetworkDevice, Kernel::InterruptHandler {
+
+public:
+    /**
+     * Constructor.
+     */
+    explicit VirtioNetworkDevice(const PciDevice &pciDevice);
+
+    /**
+     * Copy Constructor.
+     */
+    VirtioNetworkDevice(const VirtioNetworkDevice &other) = delete;
+
+    /**
+     * Assignment operator.
+     */
+    VirtioNetworkDevice &operator=(const VirtioNetworkDevice &other) = delete;
+
+    /**
+     * Destructor.
+     */
+    ~VirtioNetworkDevice() override;
+
+    static void initializeAvailableDevices();
+
+    /**
+     * Negotiate features, set up the queues and fill the receive queue.
+     *
+     * @return false, if the device could not be initialized
+     */
+    bool initialize();
+
+    [[nodiscard]] Util::Network::MacAddress getMacAddress() const override;
+
+    void plugin() override;
+
+    void trigger(const Kernel::InterruptFrame &frame, Kernel::InterruptVector slot) override;
+
+protected:
+
+    void handleOutgoingPacket(const uint8_t *packet, uint32_t length) override;
+
+    bool offloadChecksum(uint16_t checksumStart, uint16_t checksumOffset) override;
+
+    bool setReceiveInterruptsEnabled(bool enabled) override;
+
+    void pollReceivedPackets() override;
+
+private:
+
+    enum Feature : uint64_t {
+        CHECKSUM = 1 << 0,
+        GUEST_CHECKSUM = 1 << 1,
+        MAC = 1 << 5,
+        MERGEABLE_RECEIVE_BUFFERS = 1 << 15
+    };
+
+    enum ConfigRegister : uint8_t {
+        MAC_ADDRESS = 0x00
+    };
+
+    enum HeaderFlag : uint8_t {
+        NEEDS_CHECKSUM = 0x01,
+        DATA_VALID = 0x02
+    };
+
+    enum Queue : uint16_t {
+        RECEIVE_QUEUE = 0,
+        TRANSMIT_QUEUE = 1
+    };
+
+    /**
+     * Precedes each packet in the receive and transmit queues.
+     * The field 'bufferCount' only exists on modern devices or if mergeable receive buffers have been negotiated.
+     */
+    struct PacketHeader {
+        uint8_t flags;
+        uint8_t segmentationType;
+        uint16_t headerLength;
+        uint16_t segmentSize;
+        uint16_t checksumStart;
+        uint16_t checksumOffset;
+        uint16_t bufferCount;
+    } __attribute__((packed));
+
+    void submitReceiveBuffer(uint8_t *slot);
+
+    void receivePackets();
+
+    void reclaimTransmitBuffers();
+
+    static uint32_t getPhysicalAddress(const uint8_t *address);
+
+    VirtioDevice device;
+    Util::Network::MacAddress macAddress;
+    uint32_t headerSize = sizeof(PacketHeader) - sizeof(uint16_t);
+
+    Virtqueue *receiveQueue = nullptr;
+    uint8_t *receiveSlots = nullptr;
+    uint32_t receiveSlotsPhysicalAddress = 0;
+    uint32_t receiveSlotCount = 0;
+    uint8_t mergeBuffer[MAX_ETHERNET_PACKET_SIZE]{};
+    Util::Async::Spinlock receiveLock;
+
+    Virtqueue *transmitQueue = nullptr;
+    uint8_t *transmitHeaders = nullptr;
+    uint32_t transmitHeadersPhysicalAddress = 0;
+    uint32_t nextTransmitHeader = 0;
+    uint16_t pendingChecksumStart = 0;
+    uint16_t pendingChecksumOffset = 0;
+    Util::Async::Spinlock transmitLock;
+
+    static const constexpr uint16_t DEVICE_ID_TRANSITIONAL = 0x1000;
+    static const constexpr uint16_t DEVICE_ID_MODERN = 0x1041;
+    static const constexpr uint16_t MAX_QUEUE_SIZE = 256;
+    static const constexpr uint32_t RECEIVE_SLOT_SIZE = 2048;
+    static const constexpr uint32_t TRANSMIT_HEADER_SLOT_SIZE = 16;
+};
+
+}
+
+#endif
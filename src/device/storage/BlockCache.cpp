@@ -0,0 +1,289 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "BlockCache.h"
+
+#include "lib/util/async/Atomic.h"
+#include "lib/util/base/Address.h"
+
+namespace Device::Storage {
+
+BlockCache::BlockCache(StorageDevice &device, uint32_t blockCount) :
+        device(device), sectorSize(device.getSectorSize()), deviceSectorCount(device.getSectorCount()),
+        sectorsPerBlock(device.getSectorSize() >= BLOCK_SIZE ? 1 : BLOCK_SIZE / device.getSectorSize()),
+        blockCount(blockCount), bucketCount(blockCount * 2), blocks(new Block[blockCount]), buckets(new Block*[blockCount * 2]{}),
+        blockMemory(new uint8_t[blockCount * sectorsPerBlock * sectorSize]), fetchBuffer(new uint8_t[MAX_FETCH_BLOCKS * sectorsPerBlock * sectorSize]) {
+    for (uint32_t i = 0; i < blockCount; i++) {
+        blocks[i].data = blockMemory + i * sectorsPerBlock * sectorSize;
+        blocks[i].next = freeList;
+        freeList = &blocks[i];
+    }
+}
+
+void BlockCache::addReference() {
+    Util::Async::Atomic<uint32_t>(references).inc();
+}
+
+bool BlockCache::releaseReference() {
+    return Util::Async::Atomic<uint32_t>(references).fetchAndDec() == 1;
+}
+
+BlockCache::~BlockCache() {
+    delete[] blocks;
+    delete[] buckets;
+    delete[] blockMemory;
+    delete[] fetchBuffer;
+}
+
+uint32_t BlockCache::getSectorSize() {
+    return sectorSize;
+}
+
+uint64_t BlockCache::getSectorCount() {
+    return deviceSectorCount;
+}
+
+uint32_t BlockCache::read(uint8_t *buffer, uint32_t startSector, uint32_t sectorCount) {
+    // Cached blocks never differ from the device (write-through), so large requests can safely bypass the cache
+    if (sectorCount >= MAX_FETCH_BLOCKS * sectorsPerBlock) {
+        return device.read(buffer, startSector, sectorCount);
+    }
+
+    lock.acquire();
+
+    const uint32_t endSector = startSector + sectorCount;
+    uint32_t sector = startSector;
+    while (sector < endSector) {
+        auto blockNumber = sector / sectorsPerBlock;
+        auto *block = find(blockNumber);
+
+        if (block == nullptr) {
+            // Fetch all consecutive blocks of this request, that are missing, with a single device request
+            auto lastBlock = (endSector - 1) / sectorsPerBlock;
+            uint32_t count = 1;
+            while (blockNumber + count <= lastBlock && count < MAX_FETCH_BLOCKS && find(blockNumber + count) == nullptr) {
+                count++;
+            }
+
+            if (!fetch(blockNumber, count)) {
+                return lock.releaseAndReturn(sector - startSector);
+            }
+
+            block = find(blockNumber);
+        }
+
+        auto offset = sector % sectorsPerBlock;
+        auto count = sectorsPerBlock - offset < endSector - sector ? sectorsPerBlock - offset : endSector - sector;
+        auto target = Util::Address<uint32_t>(buffer + (sector - startSector) * sectorSize);
+        target.copyRange(Util::Address<uint32_t>(block->data + offset * sectorSize), count * sectorSize);
+
+        touch(block);
+        sector += count;
+    }
+
+    return lock.releaseAndReturn(sectorCount);
+}
+
+uint32_t BlockCache::write(const uint8_t *buffer, uint32_t startSector, uint32_t sectorCount) {
+    lock.acquire();
+
+    auto written = device.write(buffer, startSector, sectorCount);
+
+    // Update cached copies (or drop them, if the write failed)
+    const uint32_t endSector = startSector + sectorCount;
+    uint32_t sector = startSector;
+    while (sector < endSector) {
+        auto offset = sector % sectorsPerBlock;
+        auto count = sectorsPerBlock - offset < endSector - sector ? sectorsPerBlock - offset : endSector - sector;
+
+        auto *block = find(sector / sectorsPerBlock);
+        if (block != nullptr) {
+            if (written == sectorCount) {
+                auto target = Util::Address<uint32_t>(block->data + offset * sectorSize);
+                target.copyRange(Util::Address<uint32_t>(buffer + (sector - startSector) * sectorSize), count * sectorSize);
+            } else {
+                removeBlock(block);
+            }
+        }
+
+        sector += count;
+    }
+
+    return lock.releaseAndReturn(written);
+}
+
+void BlockCache::prefetch(uint32_t startSector, uint32_t sectorCount) {
+    if (startSector >= deviceSectorCount || sectorCount == 0) {
+        return;
+    }
+
+    if (startSector + sectorCount > deviceSectorCount) {
+        sectorCount = deviceSectorCount - startSector;
+    }
+
+    // Never prefetch more than half of the cache, to avoid evicting the blocks, that are about to be read
+    auto firstBlock = startSector / sectorsPerBlock;
+    auto lastBlock = (startSector + sectorCount - 1) / sectorsPerBlock;
+    if (lastBlock - firstBlock + 1 > blockCount / 2) {
+        lastBlock = firstBlock + blockCount / 2 - 1;
+    }
+
+    lock.acquire();
+
+    auto blockNumber = firstBlock;
+    while (blockNumber <= lastBlock) {
+        if (find(blockNumber) != nullptr) {
+            blockNumber++;
+            continue;
+        }
+
+        uint32_t count = 1;
+        while (blockNumber + count <= lastBlock && count < MAX_FETCH_BLOCKS && find(blockNumber + count) == nullptr) {
+            count++;
+        }
+
+        if (!fetch(blockNumber, count)) {
+            break;
+        }
+
+        blockNumber += count;
+    }
+
+    lock.release();
+}
+
+void BlockCache::invalidate() {
+    lock.acquire();
+    while (mostRecentlyUsed != nullptr) {
+        removeBlock(mostRecentlyUsed);
+    }
+    lock.release();
+}
+
+StorageDevice& BlockCache::getDevice() const {
+    return device;
+}
+
+BlockCache::Block* BlockCache::find(uint32_t blockNumber) {
+    auto *block = buckets[getBucket(blockNumber)];
+    while (block != nullptr && block->number != blockNumber) {
+        block = block->hashNext;
+    }
+
+    return block;
+}
+
+BlockCache::Block* BlockCache::allocateBlock(uint32_t blockNumber) {
+    if (freeList == nullptr) {
+        removeBlock(leastRecentlyUsed);
+    }
+
+    auto *block = freeList;
+    freeList = block->next;
+
+    block->number = blockNumber;
+    block->hashNext = buckets[getBucket(blockNumber)];
+    buckets[getBucket(blockNumber)] = block;
+
+    block->previous = nullptr;
+    block->next = mostRecentlyUsed;
+    if (mostRecentlyUsed != nullptr) {
+        mostRecentlyUsed->previous = block;
+    }
+
+    mostRecentlyUsed = block;
+    if (leastRecentlyUsed == nullptr) {
+        leastRecentlyUsed = block;
+    }
+
+    return block;
+}
+
+void BlockCache::removeBlock(Block *block) {
+    auto **current = &buckets[getBucket(block->number)];
+    while (*current != block) {
+        current = &(*current)->hashNext;
+    }
+    *current = block->hashNext;
+
+    if (block->previous != nullptr) {
+        block->previous->next = block->next;
+    } else {
+        mostRecentlyUsed = block->next;
+    }
+
+    if (block->next != nullptr) {
+        block->next->previous = block->previous;
+    } else {
+        leastRecentlyUsed = block->previous;
+    }
+
+    block->next = freeList;
+    freeList = block;
+}
+
+void BlockCache::touch(Block *block) {
+    if (block == mostRecentlyUsed) {
+        return;
+    }
+
+    // Unlink block (it is not the head, so it has a predecessor)
+    block->previous->next = block->next;
+    if (block->next != nullptr) {
+        block->next->previous = block->previous;
+    } else {
+        leastRecentlyUsed = block->previous;
+    }
+
+    block->previous = nullptr;
+    block->next = mostRecentlyUsed;
+    mostRecentlyUsed->previous = block;
+    mostRecentlyUsed = block;
+}
+
+bool BlockCache::fetch(uint32_t firstBlock, uint32_t count) {
+    uint64_t firstSector = static_cast<uint64_t>(firstBlock) * sectorsPerBlock;
+    uint64_t sectors = static_cast<uint64_t>(count) * sectorsPerBlock;
+    if (firstSector >= deviceSectorCount) {
+        return false;
+    }
+
+    if (firstSector + sectors > deviceSectorCount) {
+        sectors = deviceSectorCount - firstSector;
+    }
+
+    if (device.read(fetchBuffer, firstSector, sectors) != sectors) {
+        return false;
+    }
+
+    // Only cache blocks that have actually been read (the last block of the device may be incomplete)
+    auto fetchedBlocks = static_cast<uint32_t>((sectors + sectorsPerBlock - 1) / sectorsPerBlock);
+    for (uint32_t i = 0; i < fetchedBlocks; i++) {
+        auto blockSectors = sectors - i * sectorsPerBlock < sectorsPerBlock ? sectors - i * sectorsPerBlock : sectorsPerBlock;
+        auto *block = allocateBlock(firstBlock + i);
+        auto target = Util::Address<uint32_t>(block->data);
+        target.copyRange(Util::Address<uint32_t>(fetchBuffer + i * sectorsPerBlock * sectorSize), blockSectors * sectorSize);
+    }
+
+    return fetchedBlocks == count;
+}
+
+uint32_t BlockCache::getBucket(uint32_t blockNumber) const {
+    return blockNumber % bucketCount;
+}
+
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef HHUOS_BLOCKCACHE_H
+#define HHUOS_BLOCKCACHE_H
+
+#include <stdint.h>
+
+#include "StorageDevice.h"
+#include "lib/util/async/Spinlock.h"
+
+namespace Device::Storage {
+
+/**
+ * Write-through cache for a storage device, which is shared by all files of a mounted filesystem.
+ * Sectors are cached in blocks of BLOCK_SIZE bytes, which are replaced in least recently used order.
+ * Consecutive missing blocks are fetched with a single device request. Large requests bypass the cache,
+ * so that streaming a big file does not evict everything else.
+ */
+class BlockCache : public StorageDevice {
+
+public:
+    /**
+     * Constructor.
+     */
+    explicit BlockCache(StorageDevice &device, uint32_t blockCount = DEFAULT_BLOCK_COUNT);
+
+    /**
+     * Copy Constructor.
+     */
+    BlockCache(const BlockCache &other) = delete;
+
+    /**
+     * Assignment operator.
+     */
+    BlockCache &operator=(const BlockCache &other) = delete;
+
+    /**
+     * Destructor.
+     */
+    ~BlockCache() override;
+
+    /**
+     * Overriding function from StorageDevice.
+     */
+    uint32_t getSectorSize() override;
+
+    /**
+     * Overriding function from StorageDevice.
+     */
+    uint64_t getSectorCount() override;
+
+    /**
+     * Overriding function from StorageDevice.
+     */
+    uint32_t read(uint8_t *buffer, uint32_t startSector, uint32_t sectorCount) override;
+
+    /**
+     * Overriding function from StorageDevice.
+     */
+    uint32_t write(const uint8_t *buffer, uint32_t startSector, uint32_t sectorCount) override;
+
+    /**
+     * Load sectors into the cache, without copying them anywhere (used for read-ahead).
+     */
+    void prefetch(uint32_t startSector, uint32_t sectorCount);
+
+    /**
+     * Drop all cached blocks.
+     */
+    void invalidate();
+
+    [[nodiscard]] StorageDevice& getDevice() const;
+
+    /**
+     * Register an additional user (e.g. an open file), that accesses the cache independently of its creator.
+     * A new cache starts with a single reference, held by its creator.
+     */
+    void addReference();
+
+    /**
+     * Drop a reference, acquired via addReference() or held by the creator.
+     *
+     * @return true, if this was the last reference and the cache must be deleted by the caller
+     */
+    [[nodiscard]] bool releaseReference();
+
+    static const constexpr uint32_t BLOCK_SIZE = 4096;
+    static const constexpr uint32_t MAX_FETCH_BLOCKS = 32;
+
+private:
+
+    struct Block {
+        uint32_t number;
+        uint8_t *data;
+        Block *hashNext;
+        Block *previous;
+        Block *next;
+    };
+
+    Block* find(uint32_t blockNumber);
+
+    Block* allocateBlock(uint32_t blockNumber);
+
+    void removeBlock(Block *block);
+
+    void touch(Block *block);
+
+    bool fetch(uint32_t firstBlock, uint32_t blockCount);
+
+    [[nodiscard]] uint32_t getBucket(uint32_t blockNumber) const;
+
+    StorageDevice &device;
+    const uint32_t sectorSize;
+    const uint64_t deviceSectorCount;
+    const uint32_t sectorsPerBlock;
+    const uint32_t blockCount;
+    const uint32_t bucketCount;
+
+    Block *blocks;
+    Block **buckets;
+    Block *freeList = nullptr;
+    Block *mostRecentlyUsed = nullptr;
+    Block *leastRecentlyUsed = nullptr;
+    uint8_t *blockMemory;
+    uint8_t *fetchBuffer;
+
+    Util::Async::Spinlock lock;
+    uint32_t references = 1;
+
+    static const constexpr uint32_t DEFAULT_BLOCK_COUNT = 256;
+};
+
+}
+
+#endif
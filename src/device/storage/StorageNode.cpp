@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "StorageNode.h"
+
+#include "device/storage/StorageDevice.h"
+#include "filesystem/Filesystem.h"
+#include "kernel/service/FilesystemService.h"
+#include "kernel/service/Service.h"
+#include "lib/util/collection/Array.h"
+#include "lib/util/base/Address.h"
+
+namespace Device::Storage {
+
+StorageNode::StorageNode(StorageDevice &device, const Util::String &name) : MemoryNode(name), device(device), sectorSize(device.getSectorSize()), sectorBuffer(new uint8_t[sectorSize]) {}
+
+StorageNode::~StorageNode() {
+    delete[] sectorBuffer;
+}
+
+uint64_t StorageNode::getLength() {
+    return device.getSectorCount() * sectorSize;
+}
+
+uint64_t StorageNode::readData(uint8_t *targetBuffer, uint64_t pos, uint64_t numBytes) {
+    auto length = getLength();
+    if (pos >= length) {
+        return 0;
+    }
+
+    if (pos + numBytes > length) {
+        numBytes = length - pos;
+    }
+
+    auto sector = static_cast<uint32_t>(pos / sectorSize);
+    auto offset = static_cast<uint32_t>(pos % sectorSize);
+    auto targetAddress = Util::Address<uint32_t>(targetBuffer);
+    uint64_t readBytes = 0;
+
+    // Unaligned start
+    if (offset != 0 || numBytes < sectorSize) {
+        sectorBufferLock.acquire();
+        if (device.read(sectorBuffer, sector, 1) != 1) {
+            return sectorBufferLock.releaseAndReturn(0);
+        }
+
+        auto count = sectorSize - offset < numBytes ? sectorSize - offset : static_cast<uint32_t>(numBytes);
+        targetAddress.copyRange(Util::Address<uint32_t>(sectorBuffer + offset), count);
+        sectorBufferLock.release();
+
+        readBytes += count;
+        sector++;
+    }
+
+    // Whole sectors are transferred directly into the target buffer
+    auto sectorCount = static_cast<uint32_t>((numBytes - readBytes) / sectorSize);
+    if (sectorCount > 0) {
+        auto readSectors = device.read(targetBuffer + readBytes, sector, sectorCount);
+        readBytes += static_cast<uint64_t>(readSectors) * sectorSize;
+        if (readSectors < sectorCount) {
+            return readBytes;
+        }
+
+        sector += sectorCount;
+    }
+
+    // Unaligned end
+    if (readBytes < numBytes) {
+        sectorBufferLock.acquire();
+        if (device.read(sectorBuffer, sector, 1) != 1) {
+            return sectorBufferLock.releaseAndReturn(readBytes);
+        }
+
+        targetAddress.add(static_cast<uint32_t>(readBytes)).copyRange(Util::Address<uint32_t>(sectorBuffer), numBytes - readBytes);
+        sectorBufferLock.release();
+
+        readBytes = numBytes;
+    }
+
+    return readBytes;
+}
+
+uint64_t StorageNode::writeData(const uint8_t *sourceBuffer, uint64_t pos, uint64_t numBytes) {
+    // Raw writes would bypass the block cache (and pending data) of a filesystem, that is mounted on this device
+    if (isMounted()) {
+        return 0;
+    }
+
+    auto length = getLength();
+    if (pos >= length) {
+        return 0;
+    }
+
+    if (pos + numBytes > length) {
+        numBytes = length - pos;
+    }
+
+    auto sector = static_cast<uint32_t>(pos / sectorSize);
+    auto offset = static_cast<uint32_t>(pos % sectorSize);
+    auto sourceAddress = Util::Address<uint32_t>(sourceBuffer);
+    uint64_t writtenBytes = 0;
+
+    // Unaligned start (read-modify-write)
+    if (offset != 0 || numBytes < sectorSize) {
+        sectorBufferLock.acquire();
+        if (device.read(sectorBuffer, sector, 1) != 1) {
+            return sectorBufferLock.releaseAndReturn(0);
+        }
+
+        auto count = sectorSize - offset < numBytes ? sectorSize - offset : static_cast<uint32_t>(numBytes);
+        Util::Address<uint32_t>(sectorBuffer + offset).copyRange(sourceAddress, count);
+        if (device.write(sectorBuffer, sector, 1) != 1) {
+            return sectorBufferLock.releaseAndReturn(0);
+        }
+
+        sectorBufferLock.release();
+        writtenBytes += count;
+        sector++;
+    }
+
+    // Whole sectors are transferred directly from the source buffer
+    auto sectorCount = static_cast<uint32_t>((numBytes - writtenBytes) / sectorSize);
+    if (sectorCount > 0) {
+        auto writtenSectors = device.write(sourceBuffer + writtenBytes, sector, sectorCount);
+        writtenBytes += static_cast<uint64_t>(writtenSectors) * sectorSize;
+        if (writtenSectors < sectorCount) {
+            return writtenBytes;
+        }
+
+        sector += sectorCount;
+    }
+
+    // Unaligned end (read-modify-write)
+    if (writtenBytes < numBytes) {
+        sectorBufferLock.acquire();
+        if (device.read(sectorBuffer, sector, 1) != 1) {
+            return sectorBufferLock.releaseAndReturn(writtenBytes);
+        }
+
+        Util::Address<uint32_t>(sectorBuffer).copyRange(sourceAddress.add(static_cast<uint32_t>(writtenBytes)), numBytes - writtenBytes);
+        if (device.write(sectorBuffer, sector, 1) != 1) {
+            return sectorBufferLock.releaseAndReturn(writtenBytes);
+        }
+
+        sectorBufferLock.release();
+        writtenBytes = numBytes;
+    }
+
+    return writtenBytes;
+}
+
+bool StorageNode::isMounted() {
+    // Partitions are named after their device (e.g. "hdd0p1"), so overlapping devices can be recognized by their names
+    auto name = getName();
+    auto partitionPrefix = name + "p";
+    auto mountInformation = Kernel::Service::getService<Kernel::FilesystemService>().getFilesystem().getMountInformation();
+
+    for (const auto &mount : mountInformation) {
+        if (mount.device == name || mount.device.beginsWith(partitionPrefix) || name.beginsWith(mount.device + "p")) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef HHUOS_STORAGENODE_H
+#define HHUOS_STORAGENODE_H
+
+#include <stdint.h>
+
+#include "filesystem/memory/MemoryNode.h"
+#include "lib/util/async/Spinlock.h"
+#include "lib/util/base/String.h"
+
+namespace Device {
+namespace Storage {
+class StorageDevice;
+}  // namespace Storage
+}  // namespace Device
+
+namespace Device::Storage {
+
+/**
+ * Exposes a storage device as a file in /device, so that applications can access the raw device.
+ * Requests, which are not aligned to sector boundaries, are handled via a single sector bounce buffer.
+ */
+class StorageNode : public Filesystem::Memory::MemoryNode {
+
+public:
+    /**
+     * Constructor.
+     */
+    StorageNode(StorageDevice &device, const Util::String &name);
+
+    /**
+     * Copy Constructor.
+     */
+    StorageNode(const StorageNode &other) = delete;
+
+    /**
+     * Assignment operator.
+     */
+    StorageNode &operator=(const StorageNode &other) = delete;
+
+    /**
+     * Destructor.
+     */
+    ~StorageNode() override;
+
+    /**
+     * Overriding function from MemoryNode.
+     */
+    uint64_t getLength() override;
+
+    /**
+     * Overriding function from MemoryNode.
+     */
+    uint64_t readData(uint8_t *targetBuffer, uint64_t pos, uint64_t numBytes) override;
+
+    /**
+     * Overriding function from MemoryNode.
+     */
+    uint64_t writeData(const uint8_t *sourceBuffer, uint64_t pos, uint64_t numBytes) override;
+
+private:
+
+    /**
+     * Check if a filesystem is mounted on this device, a partition of it or the device, that this partition belongs to.
+     */
+    [[nodiscard]] bool isMounted();
+
+    StorageDevice &device;
+    uint32_t sectorSize;
+    uint8_t *sectorBuffer;
+    Util::Async::Spinlock sectorBufferLock;
+};
+
+}
+
+#endif
@@ -0,0 +1,604 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "NvmeController.h"
+
+#include "device/bus/pci/Pci.h"
+#include "device/storage/nvme/NvmeDevice.h"
+#include "kernel/log/Log.h"
+#include "kernel/service/InterruptService.h"
+#include "kernel/service/MemoryService.h"
+#include "kernel/service/Service.h"
+#include "kernel/service/StorageService.h"
+#include "lib/util/async/Thread.h"
+#include "lib/util/base/Address.h"
+#include "lib/util/collection/Array.h"
+#include "lib/util/collection/ArrayList.h"
+#include "lib/util/time/Timestamp.h"
+
+namespace Kernel {
+struct InterruptFrame;
+}  // namespace Kernel
+
+namespace Device::Storage {
+
+NvmeController::NvmeController(const PciDevice &pciDevice) : pciDevice(pciDevice) {
+    uint16_t command = pciDevice.readWord(Pci::COMMAND);
+    command |= Pci::BUS_MASTER | Pci::MEMORY_SPACE;
+    pciDevice.writeWord(Pci::COMMAND, command);
+
+    // Determine the size of the register space by writing all ones into the base address register
+    auto bar = pciDevice.readDoubleWord(Pci::BASE_ADDRESS_0);
+    pciDevice.writeDoubleWord(Pci::BASE_ADDRESS_0, 0xffffffff);
+    auto barSize = ~(pciDevice.readDoubleWord(Pci::BASE_ADDRESS_0) & 0xfffffff0) + 1;
+    pciDevice.writeDoubleWord(Pci::BASE_ADDRESS_0, bar);
+
+    if (((bar >> 1) & 0x03) == 0x02 && pciDevice.readDoubleWord(Pci::BASE_ADDRESS_1) != 0) {
+        LOG_ERROR("NVMe controller registers are located above 4 GiB");
+        return;
+    }
+
+    auto pageCount = barSize % PAGE_SIZE == 0 ? barSize / PAGE_SIZE : barSize / PAGE_SIZE + 1;
+    auto &memoryService = Kernel::Service::getService<Kernel::MemoryService>();
+    registers = static_cast<uint8_t*>(memoryService.mapIO(reinterpret_cast<void*>(bar & 0xfffffff0), pageCount));
+}
+
+void NvmeController::initializeAvailableControllers() {
+    auto devices = Pci::search(Pci::Class::MASS_STORAGE, PCI_SUBCLASS_NVM, PCI_PROGRAMMING_INTERFACE_NVME);
+    for (const auto &device : devices) {
+        LOG_INFO("Initializing NVMe controller [0x%04x:0x%04x]", device.getVendorId(), device.getDeviceId());
+
+        auto *controller = new NvmeController(device);
+        if (!controller->initialize()) {
+            LOG_ERROR("Failed to initialize NVMe controller");
+            delete controller;
+            continue;
+        }
+
+        controller->plugin();
+        controller->registerNamespaces();
+    }
+}
+
+bool NvmeController::initialize() {
+    if (registers == nullptr) {
+        return false;
+    }
+
+    auto capabilities = readQuadRegister(CAPABILITIES);
+    auto maxQueueSize = static_cast<uint32_t>(capabilities & 0xffff) + 1;
+    timeout = static_cast<uint32_t>((capabilities >> 24) & 0xff) * 500;
+    doorbellStride = 4 << ((capabilities >> 32) & 0x0f);
+
+    if (!((capabilities >> 37) & 0x01)) {
+        LOG_ERROR("NVMe controller does not support the NVM command set");
+        return false;
+    }
+
+    if (((capabilities >> 48) & 0x0f) != 0) {
+        LOG_ERROR("NVMe controller does not support a memory page size of 4 KiB");
+        return false;
+    }
+
+    auto version = readRegister(VERSION);
+    LOG_INFO("NVMe version: [%u.%u]", version >> 16, (version >> 8) & 0xff);
+
+    // Disable controller before reconfiguring the admin queue
+    if (readRegister(CONFIGURATION) & ENABLE) {
+        writeRegister(CONFIGURATION, readRegister(CONFIGURATION) & ~ENABLE);
+    }
+
+    if (!waitForStatus(READY, 0)) {
+        LOG_ERROR("Timeout while disabling NVMe controller");
+        return false;
+    }
+
+    // Admin commands are only issued during initialization, so a single command slot is sufficient
+    setupQueuePair(adminQueue, 0, ADMIN_QUEUE_SIZE > maxQueueSize ? maxQueueSize : ADMIN_QUEUE_SIZE, 1);
+    writeRegister(ADMIN_QUEUE_ATTRIBUTES, ((adminQueue.size - 1) << 16) | (adminQueue.size - 1));
+    writeQuadRegister(ADMIN_SUBMISSION_QUEUE, adminQueue.submissionQueuePhysicalAddress);
+    writeQuadRegister(ADMIN_COMPLETION_QUEUE, adminQueue.completionQueuePhysicalAddress);
+
+    writeRegister(CONFIGURATION, IO_QUEUE_ENTRY_SIZES | ENABLE);
+    if (!waitForStatus(READY, READY)) {
+        LOG_ERROR("Timeout while enabling NVMe controller");
+        return false;
+    }
+
+    // Read maximum data transfer size (power of two, in units of the minimum page size)
+    auto &memoryService = Kernel::Service::getService<Kernel::MemoryService>();
+    auto *identifyBuffer = static_cast<uint8_t*>(memoryService.mapIO(1));
+    if (!identify(CONTROLLER, 0, identifyBuffer)) {
+        LOG_ERROR("Failed to identify NVMe controller");
+        delete identifyBuffer;
+        return false;
+    }
+
+    auto maxDataTransferSize = identifyBuffer[77];
+    if (maxDataTransferSize > 0 && maxDataTransferSize < 16 && (PAGE_SIZE << maxDataTransferSize) < maxTransferSize) {
+        maxTransferSize = PAGE_SIZE << maxDataTransferSize;
+    }
+
+    delete identifyBuffer;
+
+    // Request one queue pair per CPU
+    auto cpuCount = Kernel::Service::getService<Kernel::InterruptService>().getCpuCount();
+    uint32_t requestedQueues = cpuCount > MAX_IO_QUEUES ? MAX_IO_QUEUES : cpuCount;
+    uint32_t allocatedQueues = 1;
+
+    uint32_t result = 0;
+    SubmissionEntry setFeatures{};
+    setFeatures.opcode = SET_FEATURES;
+    setFeatures.commandDword10 = NUMBER_OF_QUEUES;
+    setFeatures.commandDword11 = ((requestedQueues - 1) << 16) | (requestedQueues - 1);
+    if (executeAdminCommand(setFeatures, result)) {
+        auto submissionQueues = (result & 0xffff) + 1;
+        auto completionQueues = (result >> 16) + 1;
+        allocatedQueues = submissionQueues < completionQueues ? submissionQueues : completionQueues;
+    }
+
+    if (allocatedQueues > requestedQueues) {
+        allocatedQueues = requestedQueues;
+    }
+
+    auto ioQueueSize = static_cast<uint16_t>(MAX_IO_QUEUE_SIZE > maxQueueSize ? maxQueueSize : MAX_IO_QUEUE_SIZE);
+    auto commandCount = static_cast<uint16_t>(COMMANDS_PER_QUEUE < ioQueueSize ? COMMANDS_PER_QUEUE : ioQueueSize - 1);
+    ioQueues = new QueuePair[allocatedQueues];
+
+    for (uint32_t i = 0; i < allocatedQueues; i++) {
+        auto &queuePair = ioQueues[i];
+        auto id = static_cast<uint16_t>(i + 1);
+        setupQueuePair(queuePair, id, ioQueueSize, commandCount);
+
+        // Physically contiguous completion queue, interrupts enabled (vector 0)
+        SubmissionEntry createCompletionQueue{};
+        createCompletionQueue.opcode = CREATE_IO_COMPLETION_QUEUE;
+        createCompletionQueue.prp1 = queuePair.completionQueuePhysicalAddress;
+        createCompletionQueue.commandDword10 = ((queuePair.size - 1) << 16) | id;
+        createCompletionQueue.commandDword11 = 0x03;
+        if (!executeAdminCommand(createCompletionQueue, result)) {
+            LOG_ERROR("Failed to create NVMe completion queue [%u]", id);
+            break;
+        }
+
+        // Physically contiguous submission queue, bound to the completion queue with the same id
+        SubmissionEntry createSubmissionQueue{};
+        createSubmissionQueue.opcode = CREATE_IO_SUBMISSION_QUEUE;
+        createSubmissionQueue.prp1 = queuePair.submissionQueuePhysicalAddress;
+        createSubmissionQueue.commandDword10 = ((queuePair.size - 1) << 16) | id;
+        createSubmissionQueue.commandDword11 = (static_cast<uint32_t>(id) << 16) | 0x01;
+        if (!executeAdminCommand(createSubmissionQueue, result)) {
+            LOG_ERROR("Failed to create NVMe submission queue [%u]", id);
+            break;
+        }
+
+        ioQueueCount++;
+    }
+
+    if (ioQueueCount == 0) {
+        return false;
+    }
+
+    LOG_INFO("NVMe controller: [%u] I/O queue pair(s) with [%u] entries, max transfer size [%u KiB]", ioQueueCount, ioQueueSize, maxTransferSize / 1024);
+    return true;
+}
+
+void NvmeController::registerNamespaces() {
+    auto &memoryService = Kernel::Service::getService<Kernel::MemoryService>();
+    auto &storageService = Kernel::Service::getService<Kernel::StorageService>();
+    auto *identifyBuffer = static_cast<uint8_t*>(memoryService.mapIO(1));
+
+    // Active namespace lists are supported since NVMe 1.1 -> Fall back to probing all namespace ids
+    auto namespaceIds = Util::ArrayList<uint32_t>();
+    if (identify(ACTIVE_NAMESPACE_LIST, 0, identifyBuffer)) {
+        auto *list = reinterpret_cast<uint32_t*>(identifyBuffer);
+        for (uint32_t i = 0; i < PAGE_SIZE / sizeof(uint32_t) && list[i] != 0; i++) {
+            namespaceIds.add(list[i]);
+        }
+    } else if (identify(CONTROLLER, 0, identifyBuffer)) {
+        auto namespaceCount = *reinterpret_cast<uint32_t*>(identifyBuffer + 516);
+        for (uint32_t i = 1; i <= namespaceCount && i <= PAGE_SIZE / sizeof(uint32_t); i++) {
+            namespaceIds.add(i);
+        }
+    }
+
+    for (auto namespaceId : namespaceIds) {
+        if (!identify(NAMESPACE, namespaceId, identifyBuffer)) {
+            LOG_ERROR("Failed to identify NVMe namespace [%u]", namespaceId);
+            continue;
+        }
+
+        auto blockCount = *reinterpret_cast<uint64_t*>(identifyBuffer);
+        auto formatIndex = identifyBuffer[26] & 0x0f;
+        auto blockSize = static_cast<uint32_t>(1) << identifyBuffer[128 + formatIndex * 4 + 2];
+        if (blockCount == 0) {
+            continue;
+        }
+
+        if (blockSize < 512 || blockSize > PAGE_SIZE) {
+            LOG_ERROR("NVMe namespace [%u] has unsupported block size [%u]", namespaceId, blockSize);
+            continue;
+        }
+
+        LOG_INFO("NVMe namespace [%u]: %u MiB, block size [%u]", namespaceId, static_cast<uint32_t>(blockCount * blockSize / 1024 / 1024), blockSize);
+        storageService.registerDevice(new NvmeDevice(*this, namespaceId, blockSize, blockCount), "nvme");
+    }
+
+    delete identifyBuffer;
+}
+
+uint32_t NvmeController::performIO(Opcode opcode, uint32_t namespaceId, uint32_t blockSize, uint8_t *buffer, uint64_t startBlock, uint32_t blockCount) {
+    if (blockCount == 0) {
+        return 0;
+    }
+
+    auto &queuePair = ioQueues[Kernel::Service::getService<Kernel::InterruptService>().getCpuIndex() % ioQueueCount];
+    if (reinterpret_cast<uint32_t>(buffer) % sizeof(uint32_t) == 0) {
+        return transfer(queuePair, opcode, namespaceId, blockSize, buffer, startBlock, blockCount);
+    }
+
+    // PRP entries must be dword aligned -> Transfer unaligned buffers page by page via the queue's bounce buffer
+    auto blocksPerPage = PAGE_SIZE / blockSize;
+    auto bounceAddress = Util::Address<uint32_t>(queuePair.bounceBuffer);
+    uint32_t transferred = 0;
+
+    queuePair.bounceBufferLock.acquire();
+    while (transferred < blockCount) {
+        auto blocks = blockCount - transferred < blocksPerPage ? blockCount - transferred : blocksPerPage;
+        auto bufferAddress = Util::Address<uint32_t>(buffer + transferred * blockSize);
+
+        if (opcode == WRITE) {
+            bounceAddress.copyRange(bufferAddress, blocks * blockSize);
+        }
+
+        if (transfer(queuePair, opcode, namespaceId, blockSize, queuePair.bounceBuffer, startBlock + transferred, blocks) != blocks) {
+            break;
+        }
+
+        if (opcode == READ) {
+            bufferAddress.copyRange(bounceAddress, blocks * blockSize);
+        }
+
+        transferred += blocks;
+    }
+    queuePair.bounceBufferLock.release();
+
+    return transferred == blockCount ? blockCount : 0;
+}
+
+void NvmeController::plugin() {
+    auto &interruptService = Kernel::Service::getService<Kernel::InterruptService>();
+    if (interruptService.isMessageSignaledInterruptAvailable() && pciDevice.findCapability(Pci::MESSAGE_SIGNALED_INTERRUPTS) != 0) {
+        auto vector = interruptService.allocateMessageSignaledInterrupt();
+        interruptService.assignInterrupt(vector, *this);
+        pciDevice.enableMessageSignaledInterrupts(vector, interruptService.getCpuId());
+        messageSignaledInterrupts = true;
+
+        LOG_INFO("NVMe controller uses MSI vector [%u]", vector);
+        return;
+    }
+
+    interruptService.assignInterrupt(static_cast<Kernel::InterruptVector>(pciDevice.getInterruptLine() + 32), *this);
+    interruptService.allowHardwareInterrupt(pciDevice.getInterruptLine());
+}
+
+void NvmeController::trigger([[maybe_unused]] const Kernel::InterruptFrame &frame, [[maybe_unused]] Kernel::InterruptVector slot) {
+    bool skippedQueue = false;
+    for (uint32_t i = 0; i <= ioQueueCount; i++) {
+        auto &queuePair = i == 0 ? adminQueue : ioQueues[i - 1];
+        if (queuePair.lock.tryAcquire()) {
+            collectCompletions(queuePair);
+            queuePair.lock.release();
+        } else {
+            skippedQueue = true;
+        }
+    }
+
+    // The legacy interrupt stays asserted until all completions are consumed.
+    // If a queue is currently locked, mask the interrupt until the lock owner has collected its completions.
+    if (skippedQueue && !messageSignaledInterrupts) {
+        interruptsMasked = true;
+        writeRegister(INTERRUPT_MASK_SET, 0x01);
+    }
+}
+
+uint32_t NvmeController::readRegister(Register reg) const {
+    return *reinterpret_cast<volatile uint32_t*>(registers + reg);
+}
+
+uint64_t NvmeController::readQuadRegister(Register reg) const {
+    uint64_t low = *reinterpret_cast<volatile uint32_t*>(registers + reg);
+    uint64_t high = *reinterpret_cast<volatile uint32_t*>(registers + reg + 4);
+    return low | (high << 32);
+}
+
+void NvmeController::writeRegister(Register reg, uint32_t value) {
+    *reinterpret_cast<volatile uint32_t*>(registers + reg) = value;
+}
+
+void NvmeController::writeQuadRegister(Register reg, uint64_t value) {
+    *reinterpret_cast<volatile uint32_t*>(registers + reg) = static_cast<uint32_t>(value);
+    *reinterpret_cast<volatile uint32_t*>(registers + reg + 4) = static_cast<uint32_t>(value >> 32);
+}
+
+bool NvmeController::waitForStatus(uint32_t mask, uint32_t value) {
+    uint32_t time = 0;
+    while ((readRegister(STATUS) & mask) != value) {
+        if (readRegister(STATUS) & FATAL_STATUS) {
+            LOG_ERROR("NVMe controller reported a fatal error");
+            return false;
+        }
+
+        if (time >= timeout) {
+            return false;
+        }
+
+        Util::Async::Thread::sleep(Util::Time::Timestamp::ofMilliseconds(10));
+        time += 10;
+    }
+
+    return true;
+}
+
+void NvmeController::setupQueuePair(QueuePair &queuePair, uint16_t id, uint16_t size, uint16_t commandCount) {
+    auto &memoryService = Kernel::Service::getService<Kernel::MemoryService>();
+    auto submissionQueuePages = (size * sizeof(SubmissionEntry) + PAGE_SIZE - 1) / PAGE_SIZE;
+    auto completionQueuePages = (size * sizeof(CompletionEntry) + PAGE_SIZE - 1) / PAGE_SIZE;
+    auto prpListPages = (commandCount * PRP_LIST_SIZE + PAGE_SIZE - 1) / PAGE_SIZE;
+
+    auto *submissionQueue = memoryService.mapIO(submissionQueuePages);
+    auto *completionQueue = memoryService.mapIO(completionQueuePages);
+    Util::Address<uint32_t>(submissionQueue).setRange(0, submissionQueuePages * PAGE_SIZE);
+    Util::Address<uint32_t>(completionQueue).setRange(0, completionQueuePages * PAGE_SIZE);
+
+    queuePair.id = id;
+    queuePair.size = size;
+    queuePair.submissionQueue = static_cast<SubmissionEntry*>(submissionQueue);
+    queuePair.completionQueue = static_cast<CompletionEntry*>(completionQueue);
+    queuePair.submissionQueuePhysicalAddress = reinterpret_cast<uint32_t>(memoryService.getPhysicalAddress(submissionQueue));
+    queuePair.completionQueuePhysicalAddress = reinterpret_cast<uint32_t>(memoryService.getPhysicalAddress(completionQueue));
+    queuePair.submissionTail = 0;
+    queuePair.completionHead = 0;
+    queuePair.phase = true;
+
+    queuePair.commands = new Command[commandCount]{};
+    queuePair.commandCount = commandCount;
+    queuePair.prpLists = static_cast<uint64_t*>(memoryService.mapIO(prpListPages));
+    queuePair.prpListsPhysicalAddress = reinterpret_cast<uint32_t>(memoryService.getPhysicalAddress(queuePair.prpLists));
+    queuePair.bounceBuffer = static_cast<uint8_t*>(memoryService.mapIO(1));
+    queuePair.bounceBufferPhysicalAddress = reinterpret_cast<uint32_t>(memoryService.getPhysicalAddress(queuePair.bounceBuffer));
+}
+
+NvmeController::Command* NvmeController::allocateCommand(QueuePair &queuePair) {
+    for (uint32_t i = 0; i < queuePair.commandCount; i++) {
+        auto &command = queuePair.commands[i];
+        if (!command.used) {
+            command.used = true;
+            command.completed = false;
+            return &command;
+        }
+    }
+
+    return nullptr;
+}
+
+void NvmeController::submitCommand(QueuePair &queuePair, const SubmissionEntry &entry) {
+    *const_cast<SubmissionEntry*>(&queuePair.submissionQueue[queuePair.submissionTail]) = entry;
+    queuePair.submissionTail = (queuePair.submissionTail + 1) % queuePair.size;
+}
+
+void NvmeController::ringSubmissionDoorbell(QueuePair &queuePair) {
+    // Make submission entries visible before handing them to the controller
+    asm volatile ("" : : : "memory");
+    *reinterpret_cast<volatile uint32_t*>(registers + DOORBELL_BASE + (2 * queuePair.id) * doorbellStride) = queuePair.submissionTail;
+}
+
+uint32_t NvmeController::collectCompletions(QueuePair &queuePair) {
+    uint32_t count = 0;
+    while (true) {
+        auto &entry = queuePair.completionQueue[queuePair.completionHead];
+        uint16_t status = entry.status;
+        if ((status & 0x01) != queuePair.phase) {
+            break;
+        }
+
+        asm volatile ("" : : : "memory");
+
+        auto &command = queuePair.commands[entry.commandId];
+        command.status = status >> 1;
+        command.result = entry.result;
+        command.completed = true;
+
+        // The phase tag is inverted by the controller every time it wraps around
+        if (++queuePair.completionHead == queuePair.size) {
+            queuePair.completionHead = 0;
+            queuePair.phase = !queuePair.phase;
+        }
+
+        count++;
+    }
+
+    if (count > 0) {
+        *reinterpret_cast<volatile uint32_t*>(registers + DOORBELL_BASE + (2 * queuePair.id + 1) * doorbellStride) = queuePair.completionHead;
+    }
+
+    return count;
+}
+
+void NvmeController::waitForCommands(QueuePair &queuePair, Command **commands, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        while (!commands[i]->completed) {
+            // Completions are normally collected by the interrupt handler, but it skips queues that are locked
+            if (queuePair.lock.tryAcquire()) {
+                collectCompletions(queuePair);
+                queuePair.lock.release();
+
+                if (interruptsMasked) {
+                    interruptsMasked = false;
+                    writeRegister(INTERRUPT_MASK_CLEAR, 0x01);
+                }
+            }
+
+            if (!commands[i]->completed) {
+                Util::Async::Thread::yield();
+            }
+        }
+    }
+}
+
+bool NvmeController::executeAdminCommand(SubmissionEntry &entry, uint32_t &result) {
+    Command *command;
+    while (true) {
+        adminQueue.lock.acquire();
+        command = allocateCommand(adminQueue);
+        if (command != nullptr) {
+            break;
+        }
+
+        adminQueue.lock.release();
+        Util::Async::Thread::yield();
+    }
+
+    entry.commandId = command - adminQueue.commands;
+    submitCommand(adminQueue, entry);
+    ringSubmissionDoorbell(adminQueue);
+    adminQueue.lock.release();
+
+    waitForCommands(adminQueue, &command, 1);
+
+    adminQueue.lock.acquire();
+    auto status = command->status;
+    result = command->result;
+    command->used = false;
+    adminQueue.lock.release();
+
+    if (status != 0) {
+        LOG_ERROR("NVMe admin command [0x%02x] failed with status [0x%04x]", entry.opcode, status);
+        return false;
+    }
+
+    return true;
+}
+
+bool NvmeController::identify(IdentifyType type, uint32_t namespaceId, void *buffer) {
+    uint32_t result;
+    SubmissionEntry entry{};
+    entry.opcode = IDENTIFY;
+    entry.namespaceId = namespaceId;
+    entry.prp1 = getPhysicalAddress(static_cast<uint8_t*>(buffer));
+    entry.commandDword10 = type;
+
+    return executeAdminCommand(entry, result);
+}
+
+uint32_t NvmeController::transfer(QueuePair &queuePair, Opcode opcode, uint32_t namespaceId, uint32_t blockSize, uint8_t *buffer, uint64_t startBlock, uint32_t blockCount) {
+    Command *batch[COMMANDS_PER_QUEUE];
+    uint32_t batchSize = 0;
+    bool success = true;
+
+    const uint32_t maxBlocks = maxTransferSize / blockSize;
+    uint32_t submitted = 0;
+
+    queuePair.lock.acquire();
+    while (submitted < blockCount) {
+        auto *command = allocateCommand(queuePair);
+        if (command == nullptr) {
+            // All command slots are in use -> Let the controller process the current batch first
+            ringSubmissionDoorbell(queuePair);
+            queuePair.lock.release();
+
+            waitForCommands(queuePair, batch, batchSize);
+
+            queuePair.lock.acquire();
+            for (uint32_t i = 0; i < batchSize; i++) {
+                success &= batch[i]->status == 0;
+                batch[i]->used = false;
+            }
+
+            batchSize = 0;
+            continue;
+        }
+
+        auto commandId = static_cast<uint16_t>(command - queuePair.commands);
+        auto blocks = blockCount - submitted < maxBlocks ? blockCount - submitted : maxBlocks;
+        auto *data = buffer + submitted * blockSize;
+        auto length = blocks * blockSize;
+
+        SubmissionEntry entry{};
+        entry.opcode = opcode;
+        entry.commandId = commandId;
+        entry.namespaceId = namespaceId;
+        entry.prp1 = getPhysicalAddress(data);
+
+        // PRP1 may start anywhere in a page, all further entries describe whole pages
+        auto firstPageLength = PAGE_SIZE - reinterpret_cast<uint32_t>(data) % PAGE_SIZE;
+        if (length > firstPageLength) {
+            auto remaining = length - firstPageLength;
+            auto *page = data + firstPageLength;
+            if (remaining <= PAGE_SIZE) {
+                entry.prp2 = getPhysicalAddress(page);
+            } else {
+                auto *list = queuePair.prpLists + commandId * (PRP_LIST_SIZE / sizeof(uint64_t));
+                for (uint32_t i = 0; remaining > 0; i++) {
+                    list[i] = getPhysicalAddress(page);
+                    page += PAGE_SIZE;
+                    remaining -= remaining < PAGE_SIZE ? remaining : PAGE_SIZE;
+                }
+
+                entry.prp2 = queuePair.prpListsPhysicalAddress + commandId * PRP_LIST_SIZE;
+            }
+        }
+
+        auto block = startBlock + submitted;
+        entry.commandDword10 = static_cast<uint32_t>(block);
+        entry.commandDword11 = static_cast<uint32_t>(block >> 32);
+        entry.commandDword12 = blocks - 1;
+
+        submitCommand(queuePair, entry);
+        batch[batchSize++] = command;
+        submitted += blocks;
+    }
+
+    // Announce all remaining commands with a single doorbell write
+    ringSubmissionDoorbell(queuePair);
+    queuePair.lock.release();
+
+    waitForCommands(queuePair, batch, batchSize);
+
+    queuePair.lock.acquire();
+    for (uint32_t i = 0; i < batchSize; i++) {
+        success &= batch[i]->status == 0;
+        batch[i]->used = false;
+    }
+    queuePair.lock.release();
+
+    return success ? blockCount : 0;
+}
+
+uint32_t NvmeController::getPhysicalAddress(const uint8_t *address) {
+    auto &memoryService = Kernel::Service::getService<Kernel::MemoryService>();
+    auto *physicalAddress = memoryService.getPhysicalAddress(const_cast<uint8_t*>(address));
+    if (physicalAddress == nullptr) {
+        // The page has not been touched yet -> Access it, so that the page fault handler maps it
+        static_cast<void>(*reinterpret_cast<const volatile uint8_t*>(address));
+        physicalAddress = memoryService.getPhysicalAddress(const_cast<uint8_t*>(address));
+    }
+
+    return reinterpret_cast<uint32_t>(physicalAddress);
+}
+
+}
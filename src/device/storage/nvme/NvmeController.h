@@ -0,0 +1,250 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef HHUOS_NVMECONTROLLER_H
+#define HHUOS_NVMECONTROLLER_H
+
+#include <stdint.h>
+
+#include "device/bus/pci/PciDevice.h"
+#include "kernel/interrupt/InterruptHandler.h"
+#include "lib/util/async/Spinlock.h"
+
+namespace Kernel {
+enum InterruptVector : uint8_t;
+struct InterruptFrame;
+}  // namespace Kernel
+
+namespace Device::Storage {
+
+/**
+ * Driver for NVM Express controllers (NVMe base specification 1.4).
+ * The controller gets one I/O submission/completion queue pair per CPU (as far as the controller allows),
+ * so that cores do not have to contend for a single queue. Each namespace is exposed as an NvmeDevice.
+ */
+class NvmeController : Kernel::InterruptHandler {
+
+public:
+
+    enum Opcode : uint8_t {
+        // Admin commands
+        DELETE_IO_SUBMISSION_QUEUE = 0x00,
+        CREATE_IO_SUBMISSION_QUEUE = 0x01,
+        DELETE_IO_COMPLETION_QUEUE = 0x04,
+        CREATE_IO_COMPLETION_QUEUE = 0x05,
+        IDENTIFY = 0x06,
+        SET_FEATURES = 0x09,
+        // NVM commands
+        FLUSH = 0x00,
+        WRITE = 0x01,
+        READ = 0x02
+    };
+
+    /**
+     * Constructor.
+     */
+    explicit NvmeController(const PciDevice &pciDevice);
+
+    /**
+     * Copy Constructor.
+     */
+    NvmeController(const NvmeController &other) = delete;
+
+    /**
+     * Assignment operator.
+     */
+    NvmeController &operator=(const NvmeController &other) = delete;
+
+    /**
+     * Destructor.
+     */
+    ~NvmeController() override = default;
+
+    static void initializeAvailableControllers();
+
+    /**
+     * Reset and enable the controller, identify it and create the I/O queues.
+     *
+     * @return false, if the controller could not be initialized
+     */
+    bool initialize();
+
+    /**
+     * Identify all active namespaces and register them at the StorageService.
+     */
+    void registerNamespaces();
+
+    /**
+     * Transfer blocks between a namespace and the given buffer.
+     * The command is submitted to the queue of the calling CPU, large transfers are split into multiple commands,
+     * which are announced with a single doorbell write.
+     *
+     * @return The amount of transferred blocks (0 on error)
+     */
+    uint32_t performIO(Opcode opcode, uint32_t namespaceId, uint32_t blockSize, uint8_t *buffer, uint64_t startBlock, uint32_t blockCount);
+
+    void plugin() override;
+
+    void trigger(const Kernel::InterruptFrame &frame, Kernel::InterruptVector slot) override;
+
+private:
+
+    enum Register : uint32_t {
+        CAPABILITIES = 0x00,
+        VERSION = 0x08,
+        INTERRUPT_MASK_SET = 0x0c,
+        INTERRUPT_MASK_CLEAR = 0x10,
+        CONFIGURATION = 0x14,
+        STATUS = 0x1c,
+        ADMIN_QUEUE_ATTRIBUTES = 0x24,
+        ADMIN_SUBMISSION_QUEUE = 0x28,
+        ADMIN_COMPLETION_QUEUE = 0x30,
+        DOORBELL_BASE = 0x1000
+    };
+
+    enum Configuration : uint32_t {
+        ENABLE = 0x00000001,
+        // 64 byte submission entries, 16 byte completion entries
+        IO_QUEUE_ENTRY_SIZES = (6 << 16) | (4 << 20)
+    };
+
+    enum ControllerStatus : uint32_t {
+        READY = 0x01,
+        FATAL_STATUS = 0x02
+    };
+
+    enum IdentifyType : uint32_t {
+        NAMESPACE = 0x00,
+        CONTROLLER = 0x01,
+        ACTIVE_NAMESPACE_LIST = 0x02
+    };
+
+    enum Feature : uint32_t {
+        NUMBER_OF_QUEUES = 0x07
+    };
+
+    struct SubmissionEntry {
+        uint8_t opcode;
+        uint8_t flags;
+        uint16_t commandId;
+        uint32_t namespaceId;
+        uint64_t reserved;
+        uint64_t metadataPointer;
+        uint64_t prp1;
+        uint64_t prp2;
+        uint32_t commandDword10;
+        uint32_t commandDword11;
+        uint32_t commandDword12;
+        uint32_t commandDword13;
+        uint32_t commandDword14;
+        uint32_t commandDword15;
+    } __attribute__((packed));
+
+    struct CompletionEntry {
+        uint32_t result;
+        uint32_t reserved;
+        uint16_t submissionQueueHead;
+        uint16_t submissionQueueId;
+        uint16_t commandId;
+        uint16_t status;
+    } __attribute__((packed));
+
+    struct Command {
+        volatile bool completed;
+        bool used;
+        uint16_t status;
+        uint32_t result;
+    };
+
+    struct QueuePair {
+        uint16_t id;
+        uint16_t size;
+        volatile SubmissionEntry *submissionQueue;
+        volatile CompletionEntry *completionQueue;
+        uint32_t submissionQueuePhysicalAddress;
+        uint32_t completionQueuePhysicalAddress;
+        uint16_t submissionTail;
+        uint16_t completionHead;
+        bool phase;
+
+        Command *commands;
+        uint16_t commandCount;
+        uint64_t *prpLists;
+        uint32_t prpListsPhysicalAddress;
+        uint8_t *bounceBuffer;
+        uint32_t bounceBufferPhysicalAddress;
+
+        Util::Async::Spinlock lock;
+        Util::Async::Spinlock bounceBufferLock;
+    };
+
+    [[nodiscard]] uint32_t readRegister(Register reg) const;
+
+    [[nodiscard]] uint64_t readQuadRegister(Register reg) const;
+
+    void writeRegister(Register reg, uint32_t value);
+
+    void writeQuadRegister(Register reg, uint64_t value);
+
+    bool waitForStatus(uint32_t mask, uint32_t value);
+
+    void setupQueuePair(QueuePair &queuePair, uint16_t id, uint16_t size, uint16_t commandCount);
+
+    Command* allocateCommand(QueuePair &queuePair);
+
+    void submitCommand(QueuePair &queuePair, const SubmissionEntry &entry);
+
+    void ringSubmissionDoorbell(QueuePair &queuePair);
+
+    uint32_t collectCompletions(QueuePair &queuePair);
+
+    void waitForCommands(QueuePair &queuePair, Command **commands, uint32_t count);
+
+    bool executeAdminCommand(SubmissionEntry &entry, uint32_t &result);
+
+    bool identify(IdentifyType type, uint32_t namespaceId, void *buffer);
+
+    uint32_t transfer(QueuePair &queuePair, Opcode opcode, uint32_t namespaceId, uint32_t blockSize, uint8_t *buffer, uint64_t startBlock, uint32_t blockCount);
+
+    static uint32_t getPhysicalAddress(const uint8_t *address);
+
+    PciDevice pciDevice;
+    volatile uint8_t *registers = nullptr;
+    uint32_t doorbellStride = 4;
+    uint32_t timeout = 0;
+    uint32_t maxTransferSize = MAX_TRANSFER_SIZE;
+    bool messageSignaledInterrupts = false;
+    volatile bool interruptsMasked = false;
+
+    QueuePair adminQueue{};
+    QueuePair *ioQueues = nullptr;
+    uint32_t ioQueueCount = 0;
+
+    static const constexpr uint32_t PAGE_SIZE = 4096;
+    static const constexpr uint8_t PCI_SUBCLASS_NVM = 0x08;
+    static const constexpr uint8_t PCI_PROGRAMMING_INTERFACE_NVME = 0x02;
+    static const constexpr uint16_t ADMIN_QUEUE_SIZE = 32;
+    static const constexpr uint16_t MAX_IO_QUEUE_SIZE = 256;
+    static const constexpr uint16_t COMMANDS_PER_QUEUE = 32;
+    static const constexpr uint32_t MAX_IO_QUEUES = 16;
+    static const constexpr uint32_t MAX_TRANSFER_SIZE = 128 * 1024;
+    static const constexpr uint32_t PRP_LIST_SIZE = MAX_TRANSFER_SIZE / PAGE_SIZE * sizeof(uint64_t);
+};
+
+}
+
+#endif
@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "NvmeDevice.h"
+
+#include "device/storage/nvme/NvmeController.h"
+#include "lib/util/base/Exception.h"
+
+namespace Device::Storage {
+
+NvmeDevice::NvmeDevice(NvmeController &controller, uint32_t namespaceId, uint32_t blockSize, uint64_t blockCount) :
+        controller(controller), namespaceId(namespaceId), blockSize(blockSize), blockCount(blockCount) {}
+
+uint32_t NvmeDevice::getSectorSize() {
+    return blockSize;
+}
+
+uint64_t NvmeDevice::getSectorCount() {
+    return blockCount;
+}
+
+uint32_t NvmeDevice::read(uint8_t *buffer, uint32_t startSector, uint32_t sectorCount) {
+    if (static_cast<uint64_t>(startSector) + sectorCount > blockCount) {
+        Util::Exception::throwException(Util::Exception::OUT_OF_BOUNDS, "NVMe: Trying to read out of namespace bounds!");
+    }
+
+    return controller.performIO(NvmeController::READ, namespaceId, blockSize, buffer, startSector, sectorCount);
+}
+
+uint32_t NvmeDevice::write(const uint8_t *buffer, uint32_t startSector, uint32_t sectorCount) {
+    if (static_cast<uint64_t>(startSector) + sectorCount > blockCount) {
+        Util::Exception::throwException(Util::Exception::OUT_OF_BOUNDS, "NVMe: Trying to write out of namespace bounds!");
+    }
+
+    return controller.performIO(NvmeController::WRITE, namespaceId, blockSize, const_cast<uint8_t*>(buffer), startSector, sectorCount);
+}
+
+}
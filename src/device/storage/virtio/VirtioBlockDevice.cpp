@@ -0,0 +1,380 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "VirtioBlockDevice.h"
+
+#include "device/bus/pci/Pci.h"
+#include "device/bus/pci/PciDevice.h"
+#include "kernel/log/Log.h"
+#include "kernel/service/InterruptService.h"
+#include "kernel/service/MemoryService.h"
+#include "kernel/service/Service.h"
+#include "kernel/service/StorageService.h"
+#include "lib/util/async/Thread.h"
+#include "lib/util/base/Address.h"
+#include "lib/util/base/Exception.h"
+#include "lib/util/collection/Array.h"
+
+namespace Kernel {
+enum InterruptVector : uint8_t;
+struct InterruptFrame;
+}  // namespace Kernel
+
+namespace Device::Storage {
+
+VirtioBlockDevice::VirtioBlockDevice(const PciDevice &pciDevice) : device(pciDevice) {}
+
+VirtioBlockDevice::~VirtioBlockDevice() {
+    for (uint32_t i = 0; i < queueCount; i++) {
+        delete requestQueues[i].queue;
+        delete reinterpret_cast<uint8_t*>(requestQueues[i].requests[0].header);
+        delete[] requestQueues[i].requests;
+    }
+
+    delete[] requestQueues;
+}
+
+void VirtioBlockDevice::initializeAvailableDevices() {
+    auto &storageService = Kernel::Service::getService<Kernel::StorageService>();
+    for (auto deviceId : {DEVICE_ID_TRANSITIONAL, DEVICE_ID_MODERN}) {
+        for (const auto &pciDevice : Pci::search(VirtioDevice::VENDOR_ID, deviceId)) {
+            LOG_INFO("Initializing virtio block device [0x%04x:0x%04x]", pciDevice.getVendorId(), pciDevice.getDeviceId());
+
+            auto *device = new VirtioBlockDevice(pciDevice);
+            if (!device->initialize()) {
+                LOG_ERROR("Failed to initialize virtio block device");
+                delete device;
+                continue;
+            }
+
+            device->plugin();
+            storageService.registerDevice(device, "vblk");
+        }
+    }
+}
+
+bool VirtioBlockDevice::initialize() {
+    if (!device.initialize()) {
+        return false;
+    }
+
+    if (!device.negotiateFeatures(SEGMENT_SIZE_LIMIT | SEGMENT_COUNT_LIMIT | READ_ONLY | BLOCK_SIZE | MULTI_QUEUE |
+                                  VirtioDevice::RING_INDIRECT_DESCRIPTORS | VirtioDevice::RING_EVENT_INDEX)) {
+        return false;
+    }
+
+    capacity = device.readConfigQuadWord(CAPACITY);
+
+    if (device.hasFeature(BLOCK_SIZE)) {
+        auto size = device.readConfigDoubleWord(LOGICAL_BLOCK_SIZE);
+        if (size >= SECTOR_SIZE && size % SECTOR_SIZE == 0) {
+            blockSize = size;
+        }
+    }
+
+    if (device.hasFeature(SEGMENT_SIZE_LIMIT)) {
+        auto size = device.readConfigDoubleWord(SEGMENT_SIZE_MAX);
+        if (size >= Util::PAGESIZE && size < maxSegmentSize) {
+            maxSegmentSize = size;
+        }
+    }
+
+    if (device.hasFeature(SEGMENT_COUNT_LIMIT)) {
+        auto count = device.readConfigDoubleWord(SEGMENT_COUNT_MAX);
+        if (count >= 2 && count < maxSegments) {
+            maxSegments = count;
+        }
+    }
+
+    uint32_t offeredQueues = device.hasFeature(MULTI_QUEUE) ? device.readConfigWord(QUEUE_COUNT) : 1;
+    if (offeredQueues == 0) {
+        offeredQueues = 1;
+    }
+
+    auto &memoryService = Kernel::Service::getService<Kernel::MemoryService>();
+    requestQueues = new RequestQueue[offeredQueues > MAX_QUEUES ? MAX_QUEUES : offeredQueues];
+
+    for (uint32_t i = 0; i < MAX_QUEUES && i < offeredQueues; i++) {
+        auto *queue = device.setupQueue(i, MAX_QUEUE_SIZE, MAX_SEGMENTS + 2);
+        if (queue == nullptr) {
+            break;
+        }
+
+        // Request headers and status bytes are read/written by the device, so they need to be placed in DMA memory
+        auto *requestMemory = static_cast<uint8_t*>(memoryService.mapIO((REQUESTS_PER_QUEUE * REQUEST_SLOT_SIZE + Util::PAGESIZE - 1) / Util::PAGESIZE));
+        auto requestMemoryPhysical = reinterpret_cast<uint32_t>(memoryService.getPhysicalAddress(requestMemory));
+
+        auto &requestQueue = requestQueues[i];
+        requestQueue.queue = queue;
+        requestQueue.requestCount = REQUESTS_PER_QUEUE;
+        requestQueue.requests = new Request[REQUESTS_PER_QUEUE];
+        for (uint32_t j = 0; j < REQUESTS_PER_QUEUE; j++) {
+            auto &request = requestQueue.requests[j];
+            request.header = reinterpret_cast<RequestHeader*>(requestMemory + j * REQUEST_SLOT_SIZE);
+            request.status = requestMemory + j * REQUEST_SLOT_SIZE + sizeof(RequestHeader);
+            request.headerPhysicalAddress = requestMemoryPhysical + j * REQUEST_SLOT_SIZE;
+            request.completed = false;
+            request.used = false;
+        }
+
+        queueCount++;
+    }
+
+    if (queueCount == 0) {
+        LOG_ERROR("Virtio block device does not provide a request queue");
+        device.fail();
+        return false;
+    }
+
+    device.finishInitialization();
+
+    LOG_INFO("Virtio block device: %u MiB, block size [%u], [%u] request queue(s), [%s] interface, indirect descriptors [%s]",
+             static_cast<uint32_t>(capacity * SECTOR_SIZE / 1024 / 1024), blockSize, queueCount, device.isModern() ? "modern" : "legacy",
+             device.hasFeature(VirtioDevice::RING_INDIRECT_DESCRIPTORS) ? "yes" : "no");
+
+    return true;
+}
+
+uint32_t VirtioBlockDevice::getSectorSize() {
+    return blockSize;
+}
+
+uint64_t VirtioBlockDevice::getSectorCount() {
+    return capacity * SECTOR_SIZE / blockSize;
+}
+
+uint32_t VirtioBlockDevice::read(uint8_t *buffer, uint32_t startSector, uint32_t sectorCount) {
+    return performIO(IN, buffer, startSector, sectorCount);
+}
+
+uint32_t VirtioBlockDevice::write(const uint8_t *buffer, uint32_t startSector, uint32_t sectorCount) {
+    if (device.hasFeature(READ_ONLY)) {
+        return 0;
+    }
+
+    return performIO(OUT, const_cast<uint8_t*>(buffer), startSector, sectorCount);
+}
+
+void VirtioBlockDevice::plugin() {
+    auto &interruptService = Kernel::Service::getService<Kernel::InterruptService>();
+    interruptService.assignInterrupt(static_cast<Kernel::InterruptVector>(device.getPciDevice().getInterruptLine() + 32), *this);
+    interruptService.allowHardwareInterrupt(device.getPciDevice().getInterruptLine());
+}
+
+void VirtioBlockDevice::trigger([[maybe_unused]] const Kernel::InterruptFrame &frame, [[maybe_unused]] Kernel::InterruptVector slot) {
+    // Reading the status register acknowledges the interrupt (the line may be shared with other devices)
+    if (!(device.readInterruptStatus() & VirtioDevice::QUEUE_INTERRUPT)) {
+        return;
+    }
+
+    // If a queue is locked, its owner is going to collect the completions itself
+    for (uint32_t i = 0; i < queueCount; i++) {
+        auto &requestQueue = requestQueues[i];
+        if (requestQueue.lock.tryAcquire()) {
+            collectCompletions(requestQueue);
+            requestQueue.lock.release();
+        }
+    }
+}
+
+uint32_t VirtioBlockDevice::performIO(RequestType type, uint8_t *buffer, uint32_t startSector, uint32_t sectorCount) {
+    if (static_cast<uint64_t>(startSector) + sectorCount > getSectorCount()) {
+        Util::Exception::throwException(Util::Exception::OUT_OF_BOUNDS, "Virtio: Trying to read/write out of disk bounds!");
+    }
+
+    if (sectorCount == 0) {
+        return 0;
+    }
+
+    // Distribute transfers of concurrent threads over all request queues
+    auto &requestQueue = requestQueues[nextQueue++ % queueCount];
+
+    Request *batch[REQUESTS_PER_QUEUE];
+    Virtqueue::Buffer buffers[MAX_SEGMENTS + 2];
+    uint32_t batchSize = 0;
+    bool success = true;
+
+    const uint32_t totalBytes = sectorCount * blockSize;
+    uint32_t offset = 0;
+
+    requestQueue.lock.acquire();
+    while (offset < totalBytes) {
+        auto *request = requestQueue.queue->canSubmit(maxSegments + 2) ? allocateRequest(requestQueue) : nullptr;
+        if (request == nullptr) {
+            // All request slots (or descriptors) are in use -> Let the device process the current batch first
+            requestQueue.queue->notify();
+            requestQueue.lock.release();
+
+            if (batchSize == 0) {
+                // The slots are used by other threads -> Wait until one of their requests has been completed and released
+                waitForFreeRequest(requestQueue);
+            } else {
+                waitForRequests(requestQueue, batch, batchSize);
+            }
+
+            requestQueue.lock.acquire();
+            for (uint32_t i = 0; i < batchSize; i++) {
+                success &= *batch[i]->status == OK;
+                batch[i]->used = false;
+            }
+
+            batchSize = 0;
+            continue;
+        }
+
+        // Build the scatter list for this request, merging physically contiguous pages
+        auto chunkStart = offset;
+        uint16_t segments = 0;
+        while (offset < totalBytes && segments < maxSegments) {
+            auto *address = buffer + offset;
+            auto physicalAddress = getPhysicalAddress(address);
+            auto pageRemainder = Util::PAGESIZE - (reinterpret_cast<uint32_t>(address) % Util::PAGESIZE);
+            auto length = totalBytes - offset < pageRemainder ? totalBytes - offset : pageRemainder;
+
+            auto &last = buffers[segments];
+            if (segments > 0 && last.physicalAddress + last.length == physicalAddress && last.length + length <= maxSegmentSize) {
+                last.length += length;
+            } else {
+                buffers[++segments] = Virtqueue::Buffer{physicalAddress, length, type == IN};
+            }
+
+            offset += length;
+        }
+
+        // A request must consist of whole blocks -> Move a trailing partial block to the next request
+        auto remainder = (offset - chunkStart) % blockSize;
+        offset -= remainder;
+        while (remainder > 0) {
+            auto &last = buffers[segments];
+            if (last.length > remainder) {
+                last.length -= remainder;
+                remainder = 0;
+            } else {
+                remainder -= last.length;
+                segments--;
+            }
+        }
+
+        if (segments == 0) {
+            // Not even a single block fits into the scatter list (e.g. badly fragmented buffer with a large block size)
+            request->used = false;
+            success = false;
+            break;
+        }
+
+        request->header->type = type;
+        request->header->reserved = 0;
+        request->header->sector = (static_cast<uint64_t>(startSector) * blockSize + chunkStart) / SECTOR_SIZE;
+        *request->status = PENDING;
+        request->completed = false;
+
+        buffers[0] = Virtqueue::Buffer{request->headerPhysicalAddress, sizeof(RequestHeader), false};
+        buffers[segments + 1] = Virtqueue::Buffer{request->headerPhysicalAddress + static_cast<uint32_t>(sizeof(RequestHeader)), 1, true};
+
+        requestQueue.queue->submit(buffers, segments + 2, request);
+        batch[batchSize++] = request;
+    }
+
+    // Announce all remaining requests with a single notification
+    requestQueue.queue->notify();
+    requestQueue.lock.release();
+
+    waitForRequests(requestQueue, batch, batchSize);
+
+    requestQueue.lock.acquire();
+    for (uint32_t i = 0; i < batchSize; i++) {
+        success &= *batch[i]->status == OK;
+        batch[i]->used = false;
+    }
+    requestQueue.lock.release();
+
+    return success ? sectorCount : 0;
+}
+
+VirtioBlockDevice::Request* VirtioBlockDevice::allocateRequest(RequestQueue &requestQueue) {
+    for (uint32_t i = 0; i < requestQueue.requestCount; i++) {
+        auto &request = requestQueue.requests[i];
+        if (!request.used) {
+            request.used = true;
+            return &request;
+        }
+    }
+
+    return nullptr;
+}
+
+uint32_t VirtioBlockDevice::collectCompletions(RequestQueue &requestQueue) {
+    uint32_t count = 0;
+    uint32_t length;
+
+    void *token;
+    while ((token = requestQueue.queue->getUsedBuffer(length)) != nullptr) {
+        static_cast<Request*>(token)->completed = true;
+        count++;
+    }
+
+    return count;
+}
+
+void VirtioBlockDevice::waitForRequests(RequestQueue &requestQueue, Request **requests, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        while (!requests[i]->completed) {
+            // Completions are normally collected by the interrupt handler, but it skips queues that are locked
+            if (requestQueue.lock.tryAcquire()) {
+                collectCompletions(requestQueue);
+                requestQueue.lock.release();
+            }
+
+            if (!requests[i]->completed) {
+                Util::Async::Thread::yield();
+            }
+        }
+    }
+}
+
+void VirtioBlockDevice::waitForFreeRequest(RequestQueue &requestQueue) {
+    while (true) {
+        if (requestQueue.lock.tryAcquire()) {
+            collectCompletions(requestQueue);
+            auto available = requestQueue.queue->canSubmit(maxSegments + 2);
+            for (uint32_t i = 0; available && i < requestQueue.requestCount; i++) {
+                if (!requestQueue.requests[i].used) {
+                    requestQueue.lock.release();
+                    return;
+                }
+            }
+
+            requestQueue.lock.release();
+        }
+
+        Util::Async::Thread::yield();
+    }
+}
+
+uint32_t VirtioBlockDevice::getPhysicalAddress(const uint8_t *address) {
+    auto &memoryService = Kernel::Service::getService<Kernel::MemoryService>();
+    auto *physicalAddress = memoryService.getPhysicalAddress(const_cast<uint8_t*>(address));
+    if (physicalAddress == nullptr) {
+        // The page has not been touched yet -> Access it, so that the page fault handler maps it
+        static_cast<void>(*reinterpret_cast<const volatile uint8_t*>(address));
+        physicalAddress = memoryService.getPhysicalAddress(const_cast<uint8_t*>(address));
+    }
+
+    return reinterpret_cast<uint32_t>(physicalAddress);
+}
+
+}
@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef HHUOS_VIRTIOBLOCKDEVICE_H
+#define HHUOS_VIRTIOBLOCKDEVICE_H
+
+#include <stdint.h>
+
+#include "device/bus/virtio/VirtioDevice.h"
+#include "device/bus/virtio/Virtqueue.h"
+#include "device/storage/StorageDevice.h"
+#include "kernel/interrupt/InterruptHandler.h"
+#include "lib/util/async/Spinlock.h"
+#include "lib/util/base/Constants.h"
+
+namespace Kernel {
+enum InterruptVector : uint8_t;
+struct InterruptFrame;
+}  // namespace Kernel
+
+namespace Device::Storage {
+
+/**
+ * Driver for virtio block devices (virtio specification 1.1, chapter 5.2).
+ * Requests are split into chains of at most MAX_SEGMENTS pages, which are transferred directly from/to the caller's buffer.
+ * All chains of a transfer are submitted to one of the device's request queues and announced with a single notification.
+ * Completions are collected by the interrupt handler or by the waiting thread, whichever gets to the queue first.
+ */
+class VirtioBlockDevice : public StorageDevice, Kernel::InterruptHandler {
+
+public:
+    /**
+     * Constructor.
+     */
+    explicit VirtioBlockDevice(const PciDevice &pciDevice);
+
+    /**
+     * Copy Constructor.
+     */
+    VirtioBlockDevice(const VirtioBlockDevice &other) = delete;
+
+    /**
+     * Assignment operator.
+     */
+    VirtioBlockDevice &operator=(const VirtioBlockDevice &other) = delete;
+
+    /**
+     * Destructor.
+     */
+    ~VirtioBlockDevice() override;
+
+    static void initializeAvailableDevices();
+
+    /**
+     * Negotiate features and set up the request queues.
+     *
+     * @return false, if the device could not be initialized
+     */
+    bool initialize();
+
+    /**
+     * Overriding function from StorageDevice.
+     */
+    uint32_t getSectorSize() override;
+
+    /**
+     * Overriding function from StorageDevice.
+     */
+    uint64_t getSectorCount() override;
+
+    /**
+     * Overriding function from StorageDevice.
+     */
+    uint32_t read(uint8_t *buffer, uint32_t startSector, uint32_t sectorCount) override;
+
+    /**
+     * Overriding function from StorageDevice.
+     */
+    uint32_t write(const uint8_t *buffer, uint32_t startSector, uint32_t sectorCount) override;
+
+    void plugin() override;
+
+    void trigger(const Kernel::InterruptFrame &frame, Kernel::InterruptVector slot) override;
+
+private:
+
+    enum Feature : uint64_t {
+        SEGMENT_SIZE_LIMIT = 1 << 1,
+        SEGMENT_COUNT_LIMIT = 1 << 2,
+        GEOMETRY = 1 << 4,
+        READ_ONLY = 1 << 5,
+        BLOCK_SIZE = 1 << 6,
+        FLUSH = 1 << 9,
+        TOPOLOGY = 1 << 10,
+        CONFIG_WRITEBACK_CACHE = 1 << 11,
+        MULTI_QUEUE = 1 << 12
+    };
+
+    enum ConfigRegister : uint8_t {
+        CAPACITY = 0x00,
+        SEGMENT_SIZE_MAX = 0x08,
+        SEGMENT_COUNT_MAX = 0x0c,
+        LOGICAL_BLOCK_SIZE = 0x14,
+        QUEUE_COUNT = 0x22
+    };
+
+    enum RequestType : uint32_t {
+        IN = 0,
+        OUT = 1,
+        FLUSH_CACHE = 4,
+        GET_ID = 8
+    };
+
+    enum RequestStatus : uint8_t {
+        OK = 0,
+        IO_ERROR = 1,
+        UNSUPPORTED = 2,
+        PENDING = 0xff
+    };
+
+    struct RequestHeader {
+        uint32_t type;
+        uint32_t reserved;
+        uint64_t sector;
+    } __attribute__((packed));
+
+    /**
+     * Per request bookkeeping. Header and status live in DMA memory, owned by the request queue.
+     */
+    struct Request {
+        RequestHeader *header;
+        volatile uint8_t *status;
+        uint32_t headerPhysicalAddress;
+        volatile bool completed;
+        bool used;
+    };
+
+    struct RequestQueue {
+        Virtqueue *queue;
+        Request *requests;
+        uint32_t requestCount;
+        Util::Async::Spinlock lock;
+    };
+
+    uint32_t performIO(RequestType type, uint8_t *buffer, uint32_t startSector, uint32_t sectorCount);
+
+    Request* allocateRequest(RequestQueue &requestQueue);
+
+    uint32_t collectCompletions(RequestQueue &requestQueue);
+
+    void waitForRequests(RequestQueue &requestQueue, Request **requests, uint32_t count);
+
+    void waitForFreeRequest(RequestQueue &requestQueue);
+
+    static uint32_t getPhysicalAddress(const uint8_t *address);
+
+    VirtioDevice device;
+    RequestQueue *requestQueues = nullptr;
+    uint32_t queueCount = 0;
+    uint32_t nextQueue = 0;
+
+    uint32_t blockSize = SECTOR_SIZE;
+    uint64_t capacity = 0;
+    uint32_t maxSegmentSize = MAX_SEGMENT_SIZE;
+    uint32_t maxSegments = MAX_SEGMENTS;
+
+    static const constexpr uint16_t DEVICE_ID_TRANSITIONAL = 0x1001;
+    static const constexpr uint16_t DEVICE_ID_MODERN = 0x1042;
+    static const constexpr uint32_t SECTOR_SIZE = 512;
+    static const constexpr uint16_t MAX_QUEUE_SIZE = 256;
+    static const constexpr uint32_t MAX_QUEUES = 4;
+    static const constexpr uint32_t MAX_SEGMENTS = 32;
+    static const constexpr uint32_t MAX_SEGMENT_SIZE = 64 * 1024;
+    static const constexpr uint32_t REQUESTS_PER_QUEUE = 32;
+    static const constexpr uint32_t REQUEST_SLOT_SIZE = 32;
+};
+
+}
+
+#endif
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "CachedNode.h"
+
+namespace Filesystem {
+
+CachedNode::CachedNode(NodeCache &cache, NodeCache::Entry &entry) : cache(cache), entry(entry), node(*entry.node) {}
+
+CachedNode::~CachedNode() {
+    cache.release(entry);
+}
+
+Util::String CachedNode::getName() {
+    return node.getName();
+}
+
+Util::Io::File::Type CachedNode::getType() {
+    return node.getType();
+}
+
+uint64_t CachedNode::getLength() {
+    return node.getLength();
+}
+
+Util::Array<Util::String> CachedNode::getChildren() {
+    return node.getChildren();
+}
+
+uint32_t CachedNode::readDirectory(uint32_t &cursor, Util::Io::File::DirectoryEntry *entries, uint32_t count) {
+    return node.readDirectory(cursor, entries, count);
+}
+
+uint64_t CachedNode::readData(uint8_t *targetBuffer, uint64_t pos, uint64_t numBytes) {
+    return node.readDataAhead(targetBuffer, pos, numBytes, readAhead.update(pos, numBytes));
+}
+
+uint64_t CachedNode::writeData(const uint8_t *sourceBuffer, uint64_t pos, uint64_t numBytes) {
+    readAhead.reset();
+    return node.writeData(sourceBuffer, pos, numBytes);
+}
+
+bool CachedNode::isReadyToRead() {
+    return node.isReadyToRead();
+}
+
+bool CachedNode::isReadyToWrite() {
+    return node.isReadyToWrite();
+}
+
+Kernel::WaitQueue* CachedNode::getWaitQueue() {
+    return node.getWaitQueue();
+}
+
+bool CachedNode::sync() {
+    return node.sync();
+}
+
+bool CachedNode::truncate(uint64_t length) {
+    return node.truncate(length);
+}
+
+bool CachedNode::control(uint32_t request, const Util::Array<uint32_t> &parameters) {
+    return node.control(request, parameters);
+}
+
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef HHUOS_CACHEDNODE_H
+#define HHUOS_CACHEDNODE_H
+
+#include <stdint.h>
+
+#include "filesystem/Node.h"
+#include "filesystem/NodeCache.h"
+#include "filesystem/ReadAhead.h"
+#include "lib/util/collection/Array.h"
+#include "lib/util/base/String.h"
+#include "lib/util/io/file/File.h"
+
+namespace Filesystem {
+
+/**
+ * Handed out by the NodeCache for each reference on a cached node.
+ * All calls are forwarded to the cached node, deleting the wrapper drops the reference.
+ * Since every open file gets its own wrapper, sequential access is detected here and passed on as read-ahead window.
+ */
+class CachedNode : public Node {
+
+public:
+    /**
+     * Constructor.
+     */
+    CachedNode(NodeCache &cache, NodeCache::Entry &entry);
+
+    /**
+     * Copy Constructor.
+     */
+    CachedNode(const CachedNode &copy) = delete;
+
+    /**
+     * Assignment operator.
+     */
+    CachedNode& operator=(const CachedNode &other) = delete;
+
+    /**
+     * Destructor.
+     */
+    ~CachedNode() override;
+
+    /**
+     * Overriding function from Node.
+     */
+    Util::String getName() override;
+
+    /**
+     * Overriding function from Node.
+     */
+    Util::Io::File::Type getType() override;
+
+    /**
+     * Overriding function from Node.
+     */
+    uint64_t getLength() override;
+
+    /**
+     * Overriding function from Node.
+     */
+    Util::Array<Util::String> getChildren() override;
+
+    /**
+     * Overriding function from Node.
+     */
+    uint32_t readDirectory(uint32_t &cursor, Util::Io::File::DirectoryEntry *entries, uint32_t count) override;
+
+    /**
+     * Overriding function from Node.
+     */
+    uint64_t readData(uint8_t *targetBuffer, uint64_t pos, uint64_t numBytes) override;
+
+    /**
+     * Overriding function from Node.
+     */
+    uint64_t writeData(const uint8_t *sourceBuffer, uint64_t pos, uint64_t numBytes) override;
+
+    /**
+     * Overriding function from Node.
+     */
+    bool isReadyToRead() override;
+
+    /**
+     * Overriding function from Node.
+     */
+    bool isReadyToWrite() override;
+
+    /**
+     * Overriding function from Node.
+     */
+    Kernel::WaitQueue* getWaitQueue() override;
+
+    /**
+     * Overriding function from Node.
+     */
+    bool sync() override;
+
+    /**
+     * Overriding function from Node.
+     */
+    bool truncate(uint64_t length) override;
+
+    /**
+     * Overriding function from Node.
+     */
+    bool control(uint32_t request, const Util::Array<uint32_t> &parameters) override;
+
+private:
+
+    NodeCache &cache;
+    NodeCache::Entry &entry;
+    Node &node;
+    ReadAhead readAhead;
+};
+
+}
+
+#endif
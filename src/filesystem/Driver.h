@@ -77,6 +77,16 @@ public:
      * @return true on success
      */
     virtual bool deleteNode(const Util::String &path) = 0;
+
+    /**
+     * Check whether nodes returned by this driver may be kept in the node cache and shared by multiple users.
+     * This requires, that nodes stay valid as long as the corresponding file is not deleted via this driver.
+     *
+     * @return true, if nodes may be cached
+     */
+    virtual bool isCacheable() {
+        return false;
+    }
 };
 
 }
@@ -47,6 +47,8 @@ bool Filesystem::mount(const Util::String &deviceName, const Util::String &targe
         }
     }
 
+    delete targetNode;
+
     auto &device = storageService.getDevice(deviceName);
     auto *driver = INSTANCE_FACTORY_CREATE_INSTANCE(PhysicalDriver, driverName);
     if (driver == nullptr || !driver->mount(device)) {
@@ -60,6 +62,8 @@ bool Filesystem::mount(const Util::String &deviceName, const Util::String &targe
 
     mountPoints.put(parsedPath, driver);
     mountInformation.put(parsedPath, {deviceName, targetPath, driverName});
+    mountTrie.insert(parsedPath, driver);
+    nodeCache.invalidate(Util::Io::File::getCanonicalPath(parsedPath));
     return lock.releaseAndReturn(true);
 }
 
@@ -83,6 +87,8 @@ bool Filesystem::mountVirtualDriver(const Util::String &targetPath, VirtualDrive
 
     mountPoints.put(parsedPath, driver);
     mountInformation.put(parsedPath, {"Virtual", targetPath, "VirtualDriver"});
+    mountTrie.insert(parsedPath, driver);
+    nodeCache.invalidate(Util::Io::File::getCanonicalPath(parsedPath));
     return lock.releaseAndReturn(true);
 }
 
@@ -108,15 +114,19 @@ bool Filesystem::unmount(const Util::String &path) {
 
     delete targetNode;
 
-    for(const Util::String &key : mountPoints.keys()) {
-        if(key.beginsWith(parsedPath)) {
-            if(key != parsedPath) {
-                return lock.releaseAndReturn(false);
-            }
-        }
+    if (mountTrie.hasChildren(parsedPath)) {
+        return lock.releaseAndReturn(false);
     }
 
     if(mountPoints.containsKey(parsedPath)) {
+        // Nodes must be gone, before their driver is deleted -> Refuse to unmount, while files are still in use
+        auto cachePath = Util::Io::File::getCanonicalPath(parsedPath);
+        if (nodeCache.isReferenced(cachePath)) {
+            return lock.releaseAndReturn(false);
+        }
+
+        nodeCache.invalidate(cachePath);
+        mountTrie.remove(parsedPath);
         mountInformation.remove(parsedPath);
         delete mountPoints.remove(parsedPath);
         return lock.releaseAndReturn(true);
@@ -145,12 +155,22 @@ Node* Filesystem::getNode(const Util::String &path) {
     auto parsedPath = Util::Io::File::getCanonicalPath(path);
     lock.acquire();
 
-    auto *driver = getMountedDriver(parsedPath);
+    Node *ret;
+    if (nodeCache.get(parsedPath, ret)) {
+        return lock.releaseAndReturn(ret);
+    }
+
+    auto driverPath = parsedPath;
+    auto *driver = getMountedDriver(driverPath);
     if (driver == nullptr) {
         return lock.releaseAndReturn(nullptr);
     }
 
-    Node *ret = driver->getNode(parsedPath);
+    ret = driver->getNode(driverPath);
+    if (driver->isCacheable()) {
+        ret = nodeCache.put(parsedPath, ret);
+    }
+
     return lock.releaseAndReturn(ret);
 }
 
@@ -158,12 +178,14 @@ bool Filesystem::createFile(const Util::String &path) {
     auto parsedPath = Util::Io::File::getCanonicalPath(path);
     lock.acquire();
 
-    auto *driver = getMountedDriver(parsedPath);
+    auto driverPath = parsedPath;
+    auto *driver = getMountedDriver(driverPath);
     if (driver == nullptr) {
         return lock.releaseAndReturn(false);
     }
 
-    bool ret = driver->createNode(parsedPath, Util::Io::File::REGULAR);
+    bool ret = driver->createNode(driverPath, Util::Io::File::REGULAR);
+    nodeCache.invalidate(parsedPath);
     return lock.releaseAndReturn(ret);
 }
 
@@ -171,12 +193,14 @@ bool Filesystem::createDirectory(const Util::String &path) {
     auto parsedPath = Util::Io::File::getCanonicalPath(path);
     lock.acquire();
 
-    auto *driver = getMountedDriver(parsedPath);
+    auto driverPath = parsedPath;
+    auto *driver = getMountedDriver(driverPath);
     if (driver == nullptr) {
         return lock.releaseAndReturn(false);
     }
 
-    bool ret = driver->createNode(parsedPath, Util::Io::File::DIRECTORY);
+    bool ret = driver->createNode(driverPath, Util::Io::File::DIRECTORY);
+    nodeCache.invalidate(parsedPath);
     return lock.releaseAndReturn(ret);
 }
 
@@ -184,19 +208,20 @@ bool Filesystem::deleteFile(const Util::String &path) {
     auto parsedPath = Util::Io::File::getCanonicalPath(path);
     lock.acquire();
 
-    for (const Util::String &key : mountPoints.keys()) {
-        if (key.beginsWith(parsedPath)) {
-            lock.release();
-            return false;
-        }
+    if (mountTrie.contains(parsedPath + Util::Io::File::SEPARATOR)) {
+        lock.release();
+        return false;
     }
 
-    auto *driver = getMountedDriver(parsedPath);
+    auto driverPath = parsedPath;
+    auto *driver = getMountedDriver(driverPath);
     if (driver == nullptr) {
         return lock.releaseAndReturn(false);
     }
 
-    bool ret = driver->deleteNode(parsedPath);
+    // Drop cached nodes first, so that the driver does not delete a file, which it still has opened itself
+    nodeCache.invalidate(parsedPath);
+    bool ret = driver->deleteNode(driverPath);
     return lock.releaseAndReturn<bool>(ret);
 }
 
@@ -208,21 +233,14 @@ Driver* Filesystem::getMountedDriver(Util::String &path) {
 
     lock.acquire();
 
-    Util::String ret;
-    for (const Util::String &currentString: mountPoints.keys()) {
-        if (path.beginsWith(currentString)) {
-            if (currentString.length() > ret.length()) {
-                ret = currentString;
-            }
-        }
-    }
-
-    if (ret.isEmpty()) {
+    uint32_t mountPathLength;
+    auto *driver = mountTrie.find(path, mountPathLength);
+    if (driver == nullptr) {
         return lock.releaseAndReturn(nullptr);
     }
 
-    path = path.substring(ret.length(), path.length() - 1);
-    return lock.releaseAndReturn(mountPoints.get(ret));
+    path = path.substring(mountPathLength, path.length() - 1);
+    return lock.releaseAndReturn(driver);
 }
 
 Util::Array<MountInformation> Filesystem::getMountInformation() {
@@ -18,6 +18,8 @@
 #ifndef HHUOS_FILESYSTEM_H
 #define HHUOS_FILESYSTEM_H
 
+#include "filesystem/MountTrie.h"
+#include "filesystem/NodeCache.h"
 #include "lib/util/async/ReentrantSpinlock.h"
 #include "lib/util/collection/HashMap.h"
 #include "lib/util/collection/Array.h"
@@ -44,6 +46,8 @@ struct MountInformation {
 /**
  * The filesystem. It works by maintaining a list of mount points.
  * Every request is handled by picking the right mount point and and passing the request over to the corresponding driver.
+ * Mount points are looked up in a trie of path components and nodes of cacheable drivers are kept in a node cache,
+ * so that repeated lookups of the same path do not need to traverse the driver again.
  */
 class Filesystem {
 
@@ -92,6 +96,7 @@ public:
 
     /**
      * Unmount a device from a specified location.
+     * This fails, as long as nodes of the mounted filesystem are still in use.
      *
      * @param path The mountVirtualDriver-path
      *
@@ -182,6 +187,8 @@ private:
 
     Util::HashMap<Util::String, Driver*> mountPoints;
     Util::HashMap<Util::String, MountInformation> mountInformation;
+    MountTrie mountTrie;
+    NodeCache nodeCache;
     Util::Async::ReentrantSpinlock lock;
 };
 
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "MountTrie.h"
+
+#include "lib/util/collection/Array.h"
+#include "lib/util/io/file/File.h"
+
+namespace Filesystem {
+
+MountTrie::~MountTrie() {
+    delete root;
+}
+
+MountTrie::Entry::~Entry() {
+    for (auto *child : children.values()) {
+        delete child;
+    }
+}
+
+void MountTrie::insert(const Util::String &path, Driver *driver) {
+    auto *entry = root;
+    uint32_t position = 0;
+    Util::String component;
+
+    while (nextComponent(path, position, component)) {
+        if (!entry->children.containsKey(component)) {
+            entry->children.put(component, new Entry());
+        }
+
+        entry = entry->children.get(component);
+    }
+
+    entry->driver = driver;
+}
+
+void MountTrie::remove(const Util::String &path) {
+    auto components = path.split(Util::Io::File::SEPARATOR);
+    auto entries = Util::Array<Entry*>(components.length() + 1);
+    entries[0] = root;
+
+    for (uint32_t i = 0; i < components.length(); i++) {
+        if (!entries[i]->children.containsKey(components[i])) {
+            return;
+        }
+
+        entries[i + 1] = entries[i]->children.get(components[i]);
+    }
+
+    entries[components.length()]->driver = nullptr;
+
+    // Prune entries, which neither hold a driver nor lead to one
+    for (uint32_t i = components.length(); i > 0; i--) {
+        auto *entry = entries[i];
+        if (entry->driver != nullptr || entry->children.size() > 0) {
+            break;
+        }
+
+        delete entries[i - 1]->children.remove(components[i - 1]);
+    }
+}
+
+Driver* MountTrie::find(const Util::String &path, uint32_t &mountPathLength) const {
+    auto *entry = root;
+    Driver *driver = root->driver;
+    uint32_t position = 0;
+    mountPathLength = 1;
+    Util::String component;
+
+    while (nextComponent(path, position, component)) {
+        if (!entry->children.containsKey(component)) {
+            break;
+        }
+
+        entry = entry->children.get(component);
+        if (entry->driver != nullptr) {
+            driver = entry->driver;
+            mountPathLength = position + 1;
+        }
+    }
+
+    return driver;
+}
+
+bool MountTrie::contains(const Util::String &path) const {
+    return findEntry(path) != nullptr;
+}
+
+bool MountTrie::hasChildren(const Util::String &path) const {
+    auto *entry = findEntry(path);
+    return entry != nullptr && entry->children.size() > 0;
+}
+
+MountTrie::Entry* MountTrie::findEntry(const Util::String &path) const {
+    auto *entry = root;
+    uint32_t position = 0;
+    Util::String component;
+
+    while (nextComponent(path, position, component)) {
+        if (!entry->children.containsKey(component)) {
+            return nullptr;
+        }
+
+        entry = entry->children.get(component);
+    }
+
+    return entry;
+}
+
+bool MountTrie::nextComponent(const Util::String &path, uint32_t &position, Util::String &component) {
+    // Skip separators
+    while (position < path.length() && path[position] == Util::Io::File::SEPARATOR[0]) {
+        position++;
+    }
+
+    if (position >= path.length()) {
+        return false;
+    }
+
+    auto end = path.indexOf(Util::Io::File::SEPARATOR[0], position);
+    if (end == UINT32_MAX) {
+        end = path.length();
+    }
+
+    component = path.substring(position, end);
+    position = end;
+    return true;
+}
+
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef HHUOS_MOUNTTRIE_H
+#define HHUOS_MOUNTTRIE_H
+
+#include <stdint.h>
+
+#include "lib/util/collection/HashMap.h"
+#include "lib/util/base/String.h"
+
+namespace Filesystem {
+class Driver;
+}  // namespace Filesystem
+
+namespace Filesystem {
+
+/**
+ * Maps mount points to drivers. Paths are split into their components, so that finding the driver
+ * responsible for a path only needs one hash lookup per path component, regardless of the amount of mount points.
+ * All paths need to be absolute and canonical.
+ */
+class MountTrie {
+
+public:
+    /**
+     * Default Constructor.
+     */
+    MountTrie() = default;
+
+    /**
+     * Copy Constructor.
+     */
+    MountTrie(const MountTrie &other) = delete;
+
+    /**
+     * Assignment operator.
+     */
+    MountTrie &operator=(const MountTrie &other) = delete;
+
+    /**
+     * Destructor.
+     */
+    ~MountTrie();
+
+    void insert(const Util::String &path, Driver *driver);
+
+    void remove(const Util::String &path);
+
+    /**
+     * Find the driver, that is mounted closest to the given path.
+     *
+     * @param path The path
+     * @param mountPathLength Set to the length of the matching mount point path (including the trailing separator)
+     *
+     * @return The driver (or nullptr, if no mount point matches)
+     */
+    Driver* find(const Util::String &path, uint32_t &mountPathLength) const;
+
+    /**
+     * Check whether the given path is a mount point or the parent of one.
+     */
+    [[nodiscard]] bool contains(const Util::String &path) const;
+
+    /**
+     * Check whether there are any mount points below the given path.
+     */
+    [[nodiscard]] bool hasChildren(const Util::String &path) const;
+
+private:
+
+    struct Entry {
+        Util::HashMap<Util::String, Entry*> children;
+        Driver *driver = nullptr;
+
+        ~Entry();
+    };
+
+    [[nodiscard]] Entry* findEntry(const Util::String &path) const;
+
+    static bool nextComponent(const Util::String &path, uint32_t &position, Util::String &component);
+
+    Entry *root = new Entry();
+};
+
+}
+
+#endif
@@ -21,6 +21,10 @@
 #include "lib/util/base/String.h"
 #include "lib/util/io/file/File.h"
 
+namespace Kernel {
+class WaitQueue;
+}  // namespace Kernel
+
 namespace Filesystem {
 
 /**
@@ -73,6 +77,27 @@ public:
      */
     virtual Util::Array<Util::String> getChildren() = 0;
 
+    /**
+     * Read a batch of directory entries, starting at the given cursor.
+     * The cursor's meaning is up to the driver (e.g. an index or a byte offset into the directory's data),
+     * 0 always refers to the first entry. It is advanced past the returned entries.
+     * Directory nodes need to override this function, so that entries can be streamed without building
+     * the whole list of children and without opening each child to get its type and length.
+     *
+     * @param cursor The position to continue at
+     * @param entries The buffer to write the entries to
+     * @param count The maximum amount of entries to read
+     *
+     * @return The amount of entries read (0 = end of directory)
+     */
+    virtual uint32_t readDirectory([[maybe_unused]] uint32_t &cursor, [[maybe_unused]] Util::Io::File::DirectoryEntry *entries, [[maybe_unused]] uint32_t count) {
+        if (getType() != Util::Io::File::DIRECTORY) {
+            return 0;
+        }
+
+        Util::Exception::throwException(Util::Exception::UNSUPPORTED_OPERATION, "Node does not implement 'readDirectory()'!");
+    }
+
     /**
      * Read bytes from the node's data.
      * If (pos + numBytes) is greater than the data's length, END_OF_FILE shall be appended.
@@ -87,6 +112,17 @@ public:
      */
     virtual uint64_t readData(uint8_t *targetBuffer, uint64_t pos, uint64_t numBytes) = 0;
 
+    /**
+     * Read bytes like readData() and additionally read ahead as far as the given window.
+     * The window is tracked per open file (see ReadAhead), so that users of the same node do not disturb each other.
+     * Nodes, which do not read ahead, do not need to override this function.
+     *
+     * @param window The amount of bytes behind the request, that are likely to be read next (0 = do not read ahead)
+     */
+    virtual uint64_t readDataAhead(uint8_t *targetBuffer, uint64_t pos, uint64_t numBytes, [[maybe_unused]] uint32_t window) {
+        return readData(targetBuffer, pos, numBytes);
+    }
+
     /**
      * Write bytes to the node's data. If the offset points right into the existing data,
      * it shall be overwritten with the new data. If the new data does not fit, the data size shall be increased.
@@ -116,6 +152,56 @@ public:
         }
     }
 
+    /**
+     * Check if data can be written to this node without blocking.
+     * Only nodes with a limited buffer (e.g. pipes) need to override this function.
+     *
+     * @return Whether this node is writable without blocking
+     */
+    virtual bool isReadyToWrite() {
+        return getType() != Util::Io::File::DIRECTORY;
+    }
+
+    /**
+     * Get the queue, which is woken up whenever this node may have become ready to read or write.
+     * Threads waiting for multiple nodes register at these queues instead of polling them.
+     * Nodes without a wait queue are polled periodically.
+     *
+     * @return The wait queue, or nullptr if this node does not signal readiness changes
+     */
+    virtual Kernel::WaitQueue* getWaitQueue() {
+        return nullptr;
+    }
+
+    /**
+     * Write all data, that has been buffered by the underlying driver, back to the storage device.
+     * Nodes without write buffering do not need to override this function.
+     *
+     * @return true, on success
+     */
+    virtual bool sync() {
+        return true;
+    }
+
+    /**
+     * Free memory, that is only used to speed up reads (e.g. read-ahead buffers).
+     * Called when the node is not opened anymore, but stays cached. Nodes without such buffers do not need to override this function.
+     */
+    virtual void releaseBuffers() {}
+
+    /**
+     * Change the length of the node's data. Data behind the new length is discarded,
+     * while reading from the space gained by extending the node shall return zeros.
+     * Nodes, which do not support changing their length, do not need to override this function.
+     *
+     * @param length The new length
+     *
+     * @return true, on success
+     */
+    virtual bool truncate([[maybe_unused]] uint64_t length) {
+        return false;
+    }
+
     /**
      * If this nodes represents a device, this function can be used to manipulate this device.
      * The parameters are implementation dependent.
@@ -128,6 +214,22 @@ public:
     virtual bool control([[maybe_unused]] uint32_t request, [[maybe_unused]] const Util::Array<uint32_t> &parameters) {
         return false;
     }
+
+protected:
+
+    /**
+     * Fill a directory entry. Names, that are too long, are truncated.
+     */
+    static void setDirectoryEntry(Util::Io::File::DirectoryEntry &entry, const Util::String &name, Util::Io::File::Type type, uint64_t length) {
+        auto nameLength = name.length() > Util::Io::File::MAX_NAME_LENGTH ? Util::Io::File::MAX_NAME_LENGTH : name.length();
+        for (uint32_t i = 0; i < nameLength; i++) {
+            entry.name[i] = name[i];
+        }
+
+        entry.name[nameLength] = '\0';
+        entry.type = type;
+        entry.length = length;
+    }
 };
 
 }
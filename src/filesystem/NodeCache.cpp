@@ -0,0 +1,217 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "NodeCache.h"
+
+#include "filesystem/CachedNode.h"
+#include "filesystem/Node.h"
+#include "lib/util/collection/Array.h"
+#include "lib/util/collection/ArrayList.h"
+#include "lib/util/io/file/File.h"
+
+namespace Filesystem {
+
+NodeCache::NodeCache(uint32_t capacity) : capacity(capacity) {}
+
+NodeCache::~NodeCache() {
+    auto unusedEntries = Util::ArrayList<Entry*>();
+    for (auto *entry : entries.values()) {
+        detach(entry, unusedEntries);
+    }
+
+    deleteEntries(unusedEntries);
+}
+
+bool NodeCache::get(const Util::String &path, Node *&node) {
+    lock.acquire();
+    if (!entries.containsKey(path)) {
+        return lock.releaseAndReturn(false);
+    }
+
+    node = acquire(*entries.get(path));
+    return lock.releaseAndReturn(true);
+}
+
+Node* NodeCache::put(const Util::String &path, Node *node) {
+    auto unusedEntries = Util::ArrayList<Entry*>();
+    lock.acquire();
+
+    if (entries.containsKey(path)) {
+        detach(entries.remove(path), unusedEntries);
+    }
+
+    if (entries.size() >= capacity) {
+        evict(unusedEntries);
+    }
+
+    auto *entry = new Entry{path, node, 0, true, nullptr, nullptr};
+    entries.put(path, entry);
+    auto *ret = acquire(*entry);
+
+    lock.release();
+    deleteEntries(unusedEntries);
+    return ret;
+}
+
+void NodeCache::invalidate(const Util::String &path) {
+    auto unusedEntries = Util::ArrayList<Entry*>();
+    lock.acquire();
+
+    for (const auto &key : entries.keys()) {
+        if (isAtOrBelow(key, path)) {
+            detach(entries.remove(key), unusedEntries);
+        }
+    }
+
+    lock.release();
+    deleteEntries(unusedEntries);
+}
+
+bool NodeCache::isReferenced(const Util::String &path) {
+    lock.acquire();
+
+    for (const auto *entry : entries.values()) {
+        if (entry->references > 0 && isAtOrBelow(entry->path, path)) {
+            return lock.releaseAndReturn(true);
+        }
+    }
+
+    for (uint32_t i = 0; i < detachedEntries.size(); i++) {
+        if (isAtOrBelow(detachedEntries.get(i)->path, path)) {
+            return lock.releaseAndReturn(true);
+        }
+    }
+
+    return lock.releaseAndReturn(false);
+}
+
+void NodeCache::release(Entry &entry) {
+    lock.acquire();
+    if (entry.references == 1 && entry.valid) {
+        // The node stays cached, but data buffered by the driver should reach the disk, as if the node had been closed.
+        // Read buffers are freed, so that unreferenced entries only cost the memory of the node itself.
+        // The reference is kept meanwhile, so that the entry cannot be deleted concurrently.
+        lock.release();
+        entry.node->sync();
+        entry.node->releaseBuffers();
+        lock.acquire();
+    }
+
+    if (--entry.references > 0) {
+        lock.release();
+        return;
+    }
+
+    if (entry.valid) {
+        linkMostRecentlyUsed(&entry);
+        lock.release();
+        return;
+    }
+
+    detachedEntries.remove(&entry);
+    lock.release();
+
+    delete entry.node;
+    delete &entry;
+}
+
+Node* NodeCache::acquire(Entry &entry) {
+    if (entry.node == nullptr) {
+        // Negative entries are never referenced, so they stay in the least recently used list
+        unlink(&entry);
+        linkMostRecentlyUsed(&entry);
+        return nullptr;
+    }
+
+    if (entry.references++ == 0) {
+        unlink(&entry);
+    }
+
+    return new CachedNode(*this, entry);
+}
+
+void NodeCache::evict(Util::ArrayList<Entry*> &unusedEntries) {
+    while (entries.size() > capacity * 3 / 4 && leastRecentlyUsed != nullptr) {
+        auto *entry = leastRecentlyUsed;
+        entries.remove(entry->path);
+        detach(entry, unusedEntries);
+    }
+}
+
+void NodeCache::detach(Entry *entry, Util::ArrayList<Entry*> &unusedEntries) {
+    entry->valid = false;
+    if (entry->references == 0) {
+        unlink(entry);
+        unusedEntries.add(entry);
+    } else {
+        detachedEntries.add(entry);
+    }
+}
+
+void NodeCache::linkMostRecentlyUsed(Entry *entry) {
+    entry->previous = mostRecentlyUsed;
+    entry->next = nullptr;
+    if (mostRecentlyUsed != nullptr) {
+        mostRecentlyUsed->next = entry;
+    } else {
+        leastRecentlyUsed = entry;
+    }
+
+    mostRecentlyUsed = entry;
+}
+
+void NodeCache::unlink(Entry *entry) {
+    if (entry->previous == nullptr && leastRecentlyUsed != entry) {
+        // Not part of the list
+        return;
+    }
+
+    if (entry->previous != nullptr) {
+        entry->previous->next = entry->next;
+    } else {
+        leastRecentlyUsed = entry->next;
+    }
+
+    if (entry->next != nullptr) {
+        entry->next->previous = entry->previous;
+    } else {
+        mostRecentlyUsed = entry->previous;
+    }
+
+    entry->previous = nullptr;
+    entry->next = nullptr;
+}
+
+bool NodeCache::isAtOrBelow(const Util::String &key, const Util::String &path) {
+    // The root directory is cached as an empty path, but may also be passed as "/"
+    if (path.isEmpty() || path == Util::Io::File::SEPARATOR) {
+        return true;
+    }
+
+    auto prefix = path.endsWith(Util::Io::File::SEPARATOR) ? path : path + Util::Io::File::SEPARATOR;
+    return key == path || key.beginsWith(prefix);
+}
+
+void NodeCache::deleteEntries(const Util::ArrayList<Entry*> &unusedEntries) {
+    for (uint32_t i = 0; i < unusedEntries.size(); i++) {
+        auto *entry = unusedEntries.get(i);
+        delete entry->node;
+        delete entry;
+    }
+}
+
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef HHUOS_NODECACHE_H
+#define HHUOS_NODECACHE_H
+
+#include <stdint.h>
+
+#include "lib/util/async/Spinlock.h"
+#include "lib/util/collection/ArrayList.h"
+#include "lib/util/collection/HashMap.h"
+#include "lib/util/base/String.h"
+
+namespace Filesystem {
+class Node;
+}  // namespace Filesystem
+
+namespace Filesystem {
+
+/**
+ * Caches the nodes of resolved paths, so that opening a path again does not need to traverse the driver.
+ * Paths, which do not exist, are cached as negative entries.
+ * Cached nodes are shared by all users and handed out as CachedNode wrappers, which hold a reference on their entry.
+ * Unreferenced entries are kept in least recently used order and the oldest ones are evicted, when the cache is full.
+ * When the last reference on a node is dropped, its read buffers are released (see Node::releaseBuffers()),
+ * so that the capacity limits the amount of nodes and not the amount of buffered data.
+ * Invalidated entries are removed from the cache immediately, but their nodes are only deleted when the last reference is dropped.
+ * Nodes are synced and deleted without holding the cache lock, since this may cause disk I/O.
+ */
+class NodeCache {
+
+public:
+
+    struct Entry {
+        Util::String path;
+        Node *node;
+        uint32_t references;
+        bool valid;
+        // Neighbours in the least recently used list (only unreferenced, valid entries are part of it)
+        Entry *previous;
+        Entry *next;
+    };
+
+    /**
+     * Constructor.
+     */
+    explicit NodeCache(uint32_t capacity = DEFAULT_CAPACITY);
+
+    /**
+     * Copy Constructor.
+     */
+    NodeCache(const NodeCache &other) = delete;
+
+    /**
+     * Assignment operator.
+     */
+    NodeCache &operator=(const NodeCache &other) = delete;
+
+    /**
+     * Destructor.
+     */
+    ~NodeCache();
+
+    /**
+     * Look up a path.
+     *
+     * @param path The canonical path
+     * @param node Set to a new reference on the cached node (nullptr, if the path is known not to exist)
+     *
+     * @return true, if the path is cached
+     */
+    bool get(const Util::String &path, Node *&node);
+
+    /**
+     * Insert the result of resolving a path.
+     *
+     * @param path The canonical path
+     * @param node The node, returned by the driver (nullptr, if the path does not exist). The cache takes ownership.
+     *
+     * @return A new reference on the cached node (nullptr for a negative entry)
+     */
+    Node* put(const Util::String &path, Node *node);
+
+    /**
+     * Remove a path and all paths below it from the cache.
+     */
+    void invalidate(const Util::String &path);
+
+    /**
+     * Check if a node at or below a path is still referenced (including invalidated nodes, which are still in use).
+     */
+    [[nodiscard]] bool isReferenced(const Util::String &path);
+
+    /**
+     * Drop a reference, acquired via get() or put().
+     */
+    void release(Entry &entry);
+
+private:
+
+    Node* acquire(Entry &entry);
+
+    /**
+     * Remove unreferenced entries in least recently used order, until the cache is filled to three quarters.
+     */
+    void evict(Util::ArrayList<Entry*> &unusedEntries);
+
+    /**
+     * Invalidate an entry, that has already been removed from the map.
+     * Unreferenced entries are added to the given list and must be deleted via deleteEntries(), after the lock has been released.
+     */
+    void detach(Entry *entry, Util::ArrayList<Entry*> &unusedEntries);
+
+    void linkMostRecentlyUsed(Entry *entry);
+
+    void unlink(Entry *entry);
+
+    static bool isAtOrBelow(const Util::String &key, const Util::String &path);
+
+    static void deleteEntries(const Util::ArrayList<Entry*> &unusedEntries);
+
+    uint32_t capacity;
+    Util::HashMap<Util::String, Entry*> entries;
+    Util::ArrayList<Entry*> detachedEntries;
+    Entry *leastRecentlyUsed = nullptr;
+    Entry *mostRecentlyUsed = nullptr;
+    Util::Async::Spinlock lock;
+
+    static const constexpr uint32_t DEFAULT_CAPACITY = 256;
+};
+
+}
+
+#endif
@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "ReadAhead.h"
+
+namespace Filesystem {
+
+ReadAhead::ReadAhead(uint32_t minimumWindow, uint32_t maximumWindow) : minimumWindow(minimumWindow), maximumWindow(maximumWindow) {}
+
+uint32_t ReadAhead::update(uint64_t position, uint64_t length) {
+    if (position == nextPosition) {
+        // Sequential access (a first read at the beginning of the file counts as well)
+        window = window == 0 ? minimumWindow : (window * 2 > maximumWindow ? maximumWindow : window * 2);
+    } else {
+        window = 0;
+    }
+
+    nextPosition = position + length;
+    return window;
+}
+
+void ReadAhead::reset() {
+    window = 0;
+}
+
+uint32_t ReadAhead::getWindow() const {
+    return window;
+}
+
+}
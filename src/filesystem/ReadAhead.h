@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef HHUOS_READAHEAD_H
+#define HHUOS_READAHEAD_H
+
+#include <stdint.h>
+
+namespace Filesystem {
+
+/**
+ * Sequential access detection for a single open file.
+ * As long as reads continue where the previous one ended, the read-ahead window is doubled with every read
+ * (up to a maximum). Any other access pattern disables read-ahead until the next sequential read.
+ */
+class ReadAhead {
+
+public:
+    /**
+     * Constructor.
+     */
+    explicit ReadAhead(uint32_t minimumWindow = MINIMUM_WINDOW, uint32_t maximumWindow = MAXIMUM_WINDOW);
+
+    /**
+     * Copy Constructor.
+     */
+    ReadAhead(const ReadAhead &other) = delete;
+
+    /**
+     * Assignment operator.
+     */
+    ReadAhead &operator=(const ReadAhead &other) = delete;
+
+    /**
+     * Destructor.
+     */
+    ~ReadAhead() = default;
+
+    /**
+     * Register a read request and calculate how many bytes behind it should be read ahead.
+     *
+     * @return The size of the read-ahead window in bytes (0, if the access is not sequential)
+     */
+    uint32_t update(uint64_t position, uint64_t length);
+
+    /**
+     * Shrink the window back to its initial size (e.g. after the file has been written).
+     */
+    void reset();
+
+    [[nodiscard]] uint32_t getWindow() const;
+
+    static const constexpr uint32_t MINIMUM_WINDOW = 16 * 1024;
+    static const constexpr uint32_t MAXIMUM_WINDOW = 128 * 1024;
+
+private:
+
+    const uint32_t minimumWindow;
+    const uint32_t maximumWindow;
+
+    uint64_t nextPosition = 0;
+    uint32_t window = 0;
+};
+
+}
+
+#endif
@@ -18,6 +18,7 @@
 #include "FatDirectory.h"
 
 #include "lib/util/collection/ArrayList.h"
+#include "filesystem/fat/FatDriver.h"
 #include "filesystem/fat/FatNode.h"
 #include "lib/util/base/String.h"
 
@@ -40,6 +41,9 @@ Util::Array<Util::String> FatDirectory::getChildren() {
 
     auto children = Util::ArrayList<Util::String>();
     auto *childInfo = new FILINFO{};
+    auto &fatFsLock = FatDriver::getFatFsLock();
+    lock.acquire();
+    fatFsLock.acquire();
 
     while (true) {
         auto result = f_readdir(directory, childInfo);
@@ -51,10 +55,53 @@ Util::Array<Util::String> FatDirectory::getChildren() {
     }
 
     f_rewinddir(directory);
+    position = 0;
+    fatFsLock.release();
+    lock.release();
     delete childInfo;
     return children.toArray();
 }
 
+uint32_t FatDirectory::readDirectory(uint32_t &cursor, Util::Io::File::DirectoryEntry *entries, uint32_t count) {
+    auto *childInfo = new FILINFO{};
+    auto &fatFsLock = FatDriver::getFatFsLock();
+    lock.acquire();
+    fatFsLock.acquire();
+
+    // The directory object is shared by all users of this node, so it needs to be repositioned, if another enumeration has moved it
+    if (cursor != position) {
+        f_rewinddir(directory);
+        position = 0;
+
+        while (position < cursor) {
+            auto result = f_readdir(directory, childInfo);
+            if (result != FR_OK || childInfo->fname[0] == 0) {
+                break;
+            }
+
+            position++;
+        }
+    }
+
+    uint32_t read = 0;
+    while (read < count) {
+        auto result = f_readdir(directory, childInfo);
+        if (result != FR_OK || childInfo->fname[0] == 0) {
+            break;
+        }
+
+        auto type = (childInfo->fattrib & AM_DIR) ? Util::Io::File::DIRECTORY : Util::Io::File::REGULAR;
+        setDirectoryEntry(entries[read++], childInfo->fname, type, childInfo->fsize);
+        position++;
+    }
+
+    cursor = position;
+    fatFsLock.release();
+    lock.release();
+    delete childInfo;
+    return read;
+}
+
 uint64_t FatDirectory::readData([[maybe_unused]] uint8_t *targetBuffer, [[maybe_unused]] uint64_t pos, [[maybe_unused]] uint64_t numBytes) {
     return 0;
 }
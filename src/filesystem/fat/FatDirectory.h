@@ -22,6 +22,7 @@
 
 #include "FatNode.h"
 #include "filesystem/fat/ff/source/ff.h"
+#include "lib/util/async/Spinlock.h"
 #include "lib/util/collection/Array.h"
 #include "lib/util/io/file/File.h"
 
@@ -66,6 +67,11 @@ public:
      */
     Util::Array <Util::String> getChildren() override;
 
+    /**
+     * Overriding function from Node.
+     */
+    uint32_t readDirectory(uint32_t &cursor, Util::Io::File::DirectoryEntry *entries, uint32_t count) override;
+
     /**
      * Overriding function from Node.
      */
@@ -79,6 +85,8 @@ public:
 private:
 
     DIR *directory;
+    uint32_t position = 0;
+    Util::Async::Spinlock lock;
 };
 
 }
@@ -22,6 +22,8 @@
 #include "lib/util/base/Exception.h"
 #include "lib/util/collection/Array.h"
 #include "lib/util/async/AtomicBitmap.h"
+#include "device/storage/BlockCache.h"
+#include "filesystem/fat/FatFile.h"
 
 namespace Device {
 namespace Storage {
@@ -34,28 +36,43 @@ class Node;
 
 namespace Filesystem::Fat {
 
+Util::Async::ReentrantSpinlock FatDriver::fatFsLock;
 Util::Async::AtomicBitmap FatDriver::volumeIdAllocator(FF_VOLUMES);
 Util::Array<Device::Storage::StorageDevice*> FatDriver::deviceMap(FF_VOLUMES);
 
 FatDriver::~FatDriver() {
+    // Write back pending data of files, that are still open, before the volume disappears
+    FatFile::syncAll(&fatVolume);
+
+    fatFsLock.acquire();
     f_mount(nullptr, static_cast<const char*>(Util::String::format("%u:", volumeId)), 1);
+    fatFsLock.release();
+
     volumeIdAllocator.unset(volumeId);
+    delete cache;
 }
 
 Device::Storage::StorageDevice& FatDriver::getStorageDevice(uint8_t volumeId) {
     return *deviceMap[volumeId];
 }
 
+Util::Async::ReentrantSpinlock& FatDriver::getFatFsLock() {
+    return fatFsLock;
+}
+
 bool FatDriver::mount(Device::Storage::StorageDevice &device) {
     volumeId = volumeIdAllocator.findAndSet();
     if (volumeId == Util::Async::AtomicBitmap::INVALID_INDEX) {
         Util::Exception::throwException(Util::Exception::ILLEGAL_STATE, "Maximum amount of fat volumes reached!");
     }
 
-    deviceMap[volumeId] = &device;
+    // All files of this volume share a cache (FAT and directory sectors benefit the most)
+    cache = new Device::Storage::BlockCache(device);
+    deviceMap[volumeId] = cache;
 
+    fatFsLock.acquire();
     auto result = f_mount(&fatVolume, static_cast<const char*>(Util::String::format("%u:", volumeId)), 1);
-    return result == FR_OK;
+    return fatFsLock.releaseAndReturn(result == FR_OK);
 }
 
 bool FatDriver::createFilesystem(Device::Storage::StorageDevice &device) {
@@ -74,18 +91,28 @@ bool FatDriver::createFilesystem(Device::Storage::StorageDevice &device) {
         0
     };
 
+    fatFsLock.acquire();
     auto result = f_mkfs(static_cast<const char*>(Util::String::format("%u:", volumeId)), &parameters, work, FF_MAX_SS);
-    return result == FR_OK;
+    return fatFsLock.releaseAndReturn(result == FR_OK);
 }
 
 Node* FatDriver::getNode(const Util::String &path) {
     auto fatPath = Util::String::format("%u:%s", volumeId, static_cast<const char*>(path));
-    return FatNode::open(fatPath);
+    fatFsLock.acquire();
+    auto *node = FatNode::open(fatPath);
+    fatFsLock.release();
+
+    if (node != nullptr && node->getType() == Util::Io::File::REGULAR) {
+        static_cast<FatFile*>(node)->registerOpenFile();
+    }
+
+    return node;
 }
 
 bool FatDriver::createNode(const Util::String &path, Util::Io::File::Type type) {
     auto fatPath = Util::String::format("%u:%s", volumeId, static_cast<const char*>(path));
     FRESULT result = FR_DISK_ERR;
+    fatFsLock.acquire();
 
     if (type == Util::Io::File::DIRECTORY) {
         result = f_mkdir(static_cast<const char*>(fatPath));
@@ -99,14 +126,19 @@ bool FatDriver::createNode(const Util::String &path, Util::Io::File::Type type)
         delete file;
     }
 
-    return result == FR_OK;
+    return fatFsLock.releaseAndReturn(result == FR_OK);
 }
 
 bool FatDriver::deleteNode(const Util::String &path) {
     auto fatPath = Util::String::format("%u:%s", volumeId, static_cast<const char*>(path));
+    fatFsLock.acquire();
     auto result = f_unlink(static_cast<const char*>(fatPath));
 
-    return result == FR_OK;
+    return fatFsLock.releaseAndReturn(result == FR_OK);
+}
+
+bool FatDriver::isCacheable() {
+    return true;
 }
 
 }
\ No newline at end of file
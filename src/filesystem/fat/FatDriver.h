@@ -22,12 +22,14 @@
 
 #include "filesystem/fat/ff/source/ff.h"
 #include "filesystem/PhysicalDriver.h"
+#include "lib/util/async/ReentrantSpinlock.h"
 #include "lib/util/base/String.h"
 #include "lib/util/reflection/Prototype.h"
 #include "lib/util/io/file/File.h"
 
 namespace Device {
 namespace Storage {
+class BlockCache;
 class StorageDevice;
 }  // namespace Storage
 }  // namespace Device
@@ -97,13 +99,26 @@ public:
      */
     bool deleteNode(const Util::String &path) override;
 
+    /**
+     * Overriding function from Driver.
+     */
+    bool isCacheable() override;
+
     static Device::Storage::StorageDevice& getStorageDevice(uint8_t volumeId);
 
+    /**
+     * FatFs is not configured to be reentrant and keeps state, that is shared between volumes (e.g. the LFN working buffer).
+     * All calls into FatFs must hold this lock, since files are accessed concurrently by their users and the FatFlushRunnable.
+     */
+    static Util::Async::ReentrantSpinlock& getFatFsLock();
+
 private:
 
     uint32_t volumeId{};
     FATFS fatVolume{};
+    Device::Storage::BlockCache *cache = nullptr;
 
+    static Util::Async::ReentrantSpinlock fatFsLock;
     static Util::Async::AtomicBitmap volumeIdAllocator;
     static Util::Array<Device::Storage::StorageDevice*> deviceMap;
 };
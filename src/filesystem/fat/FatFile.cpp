@@ -17,54 +17,290 @@
 
 #include "FatFile.h"
 
+#include "filesystem/fat/FatDriver.h"
 #include "filesystem/fat/FatNode.h"
+#include "filesystem/fat/ff/source/diskio.h"
+#include "lib/util/base/Address.h"
 #include "lib/util/base/String.h"
+#include "lib/util/async/Thread.h"
 
 namespace Filesystem::Fat {
 
+uint32_t FatFile::writeGenerations[FF_VOLUMES]{};
+Util::ArrayList<FatFile*> FatFile::openFiles;
+Util::Async::Spinlock FatFile::openFilesLock;
+
 FatFile::FatFile(FIL *file, FILINFO *info) : FatNode(info), file(file) {}
 
 FatFile::~FatFile() {
+    // Wait for a concurrent syncAll(), which may still be syncing this file
+    openFilesLock.acquire();
+    openFiles.remove(this);
+    while (syncReferences > 0) {
+        openFilesLock.release();
+        Util::Async::Thread::yield();
+        openFilesLock.acquire();
+    }
+
+    openFilesLock.release();
+
+    // Closing the file writes back all pending data
+    auto &fatFsLock = FatDriver::getFatFsLock();
+    fatFsLock.acquire();
+    f_close(file);
+    fatFsLock.release();
+
     delete file;
+    delete[] readAheadBuffer;
+    delete[] clusterMap;
 }
 
 Util::Io::File::Type FatFile::getType() {
     return Util::Io::File::REGULAR;
 }
 
+uint64_t FatFile::getLength() {
+    // The file information is only read on opening, but the file may have grown since then
+    return f_size(file);
+}
+
 Util::Array<Util::String> FatFile::getChildren() {
     return Util::Array<Util::String>(0);
 }
 
 uint64_t FatFile::readData(uint8_t *targetBuffer, uint64_t pos, uint64_t numBytes) {
-    auto result = f_lseek(file, pos);
-    if (result != FR_OK) {
-        return 0;
+    return readDataAhead(targetBuffer, pos, numBytes, 0);
+}
+
+uint64_t FatFile::readDataAhead(uint8_t *targetBuffer, uint64_t pos, uint64_t numBytes, uint32_t window) {
+    lock.acquire();
+    if (readAheadGeneration != writeGenerations[file->obj.fs->pdrv]) {
+        readAheadLength = 0;
     }
 
-    uint32_t readBytes;
-    result = f_read(file, targetBuffer, numBytes, &readBytes);
-    if (result != FR_OK) {
-        return 0;
+    // Serve the request from the read-ahead buffer, if it has already been read
+    if (pos >= readAheadPosition && pos + numBytes <= readAheadPosition + readAheadLength) {
+        auto targetAddress = Util::Address<uint32_t>(targetBuffer);
+        targetAddress.copyRange(Util::Address<uint32_t>(readAheadBuffer + (pos - readAheadPosition)), numBytes);
+        return lock.releaseAndReturn(numBytes);
+    }
+
+    // Random access and large requests go directly to FatFs, which transfers whole clusters without copying
+    if (window == 0 || numBytes >= READ_AHEAD_BUFFER_SIZE / 2) {
+        return lock.releaseAndReturn(readFile(targetBuffer, pos, numBytes));
+    }
+
+    if (readAheadBuffer == nullptr) {
+        readAheadBuffer = new uint8_t[READ_AHEAD_BUFFER_SIZE];
     }
 
-    return readBytes;
+    auto fetchLength = numBytes + window > READ_AHEAD_BUFFER_SIZE ? READ_AHEAD_BUFFER_SIZE : numBytes + window;
+    readAheadGeneration = writeGenerations[file->obj.fs->pdrv];
+    readAheadPosition = pos;
+    readAheadLength = readFile(readAheadBuffer, pos, fetchLength);
+
+    auto readBytes = readAheadLength < numBytes ? readAheadLength : numBytes;
+    auto targetAddress = Util::Address<uint32_t>(targetBuffer);
+    targetAddress.copyRange(Util::Address<uint32_t>(readAheadBuffer), readBytes);
+
+    return lock.releaseAndReturn(readBytes);
 }
 
 uint64_t FatFile::writeData(const uint8_t *sourceBuffer, uint64_t pos, uint64_t numBytes) {
-    auto result = f_lseek(file, pos);
+    lock.acquire();
+    writeGenerations[file->obj.fs->pdrv]++;
+
+    auto &fatFsLock = FatDriver::getFatFsLock();
+    fatFsLock.acquire();
+
+    auto result = seek(pos);
     if (result != FR_OK) {
-        return 0;
+        fatFsLock.release();
+        return lock.releaseAndReturn(0);
     }
 
     uint32_t writtenBytes;
     result = f_write(file, sourceBuffer, numBytes, &writtenBytes);
+    fatFsLock.release();
     if (result != FR_OK) {
-        return 0;
+        return lock.releaseAndReturn(0);
     }
 
-    f_sync(file);
-    return writtenBytes;
+    // Data and directory entry are written back later (see sync())
+    dirty = true;
+    return lock.releaseAndReturn(writtenBytes);
+}
+
+bool FatFile::sync() {
+    lock.acquire();
+    if (!dirty) {
+        return lock.releaseAndReturn(true);
+    }
+
+    auto &fatFsLock = FatDriver::getFatFsLock();
+    fatFsLock.acquire();
+    auto result = f_sync(file);
+    fatFsLock.release();
+    dirty = result != FR_OK;
+
+    return lock.releaseAndReturn(result == FR_OK);
+}
+
+void FatFile::releaseBuffers() {
+    lock.acquire();
+    delete[] readAheadBuffer;
+    readAheadBuffer = nullptr;
+    readAheadLength = 0;
+    lock.release();
+}
+
+void FatFile::registerOpenFile() {
+    openFilesLock.acquire();
+    openFiles.add(this);
+    openFilesLock.release();
+}
+
+void FatFile::syncAll(const FATFS *volume) {
+    // Syncing takes the FatFs lock and writes to disk -> Pin the dirty files and sync them without holding openFilesLock
+    auto dirtyFiles = Util::ArrayList<FatFile*>();
+
+    openFilesLock.acquire();
+    for (uint32_t i = 0; i < openFiles.size(); i++) {
+        auto *fatFile = openFiles.get(i);
+        if (fatFile->dirty && (volume == nullptr || fatFile->file->obj.fs == volume)) {
+            fatFile->syncReferences++;
+            dirtyFiles.add(fatFile);
+        }
+    }
+
+    openFilesLock.release();
+
+    for (uint32_t i = 0; i < dirtyFiles.size(); i++) {
+        dirtyFiles.get(i)->sync();
+    }
+
+    openFilesLock.acquire();
+    for (uint32_t i = 0; i < dirtyFiles.size(); i++) {
+        dirtyFiles.get(i)->syncReferences--;
+    }
+
+    openFilesLock.release();
+}
+
+uint64_t FatFile::readFile(uint8_t *targetBuffer, uint64_t pos, uint64_t numBytes) {
+    auto &fatFsLock = FatDriver::getFatFsLock();
+    fatFsLock.acquire();
+
+    auto result = seek(pos);
+    if (result != FR_OK) {
+        return fatFsLock.releaseAndReturn(0);
+    }
+
+    uint32_t readBytes;
+    result = f_read(file, targetBuffer, numBytes, &readBytes);
+    if (result != FR_OK) {
+        return fatFsLock.releaseAndReturn(0);
+    }
+
+    return fatFsLock.releaseAndReturn(readBytes);
+}
+
+FRESULT FatFile::seek(uint64_t pos) {
+    // Small files only span a few clusters, so following their chain is cheap
+    if (pos == 0 || f_size(file) < CLUSTER_MAP_THRESHOLD) {
+        return f_lseek(file, pos);
+    }
+
+    auto clusterSize = getClusterSize();
+    auto index = static_cast<uint32_t>((pos - 1) / clusterSize);
+    if (index >= clusterMapSize && !updateClusterMap()) {
+        return f_lseek(file, pos);
+    }
+
+    if (index >= clusterMapSize) {
+        // Seeking beyond the end of a file extends it -> FatFs continues the chain from the last cluster
+        index = clusterMapSize - 1;
+    }
+
+    // f_lseek() follows the chain from the current cluster, if the target is not located before it.
+    // Placing the file pointer inside the target cluster makes FatFs start there, without reading the FAT at all.
+    auto result = invalidateSectorBuffer();
+    if (result != FR_OK) {
+        return result;
+    }
+
+    file->fptr = static_cast<FSIZE_t>(index) * clusterSize + 1;
+    file->clust = clusterMap[index];
+
+    return f_lseek(file, pos);
+}
+
+bool FatFile::updateClusterMap() {
+    auto clusterSize = getClusterSize();
+    auto size = f_size(file);
+    auto clusterCount = static_cast<uint32_t>((static_cast<uint64_t>(size) + clusterSize - 1) / clusterSize);
+    if (clusterCount <= clusterMapSize) {
+        return clusterMapSize > 0;
+    }
+
+    auto *newMap = new DWORD[clusterCount];
+    for (uint32_t i = 0; i < clusterMapSize; i++) {
+        newMap[i] = clusterMap[i];
+    }
+
+    if (clusterMapSize > 0) {
+        // Continue at the last known cluster
+        if (invalidateSectorBuffer() != FR_OK) {
+            delete[] newMap;
+            return false;
+        }
+
+        file->fptr = static_cast<FSIZE_t>(clusterMapSize - 1) * clusterSize + 1;
+        file->clust = clusterMap[clusterMapSize - 1];
+    }
+
+    // Seeking to the end of each cluster only reads the FAT, since FatFs does not load data sectors at cluster boundaries.
+    // Afterwards, the current cluster of the file is the one, that ends at the new position.
+    for (uint32_t i = clusterMapSize; i < clusterCount; i++) {
+        auto clusterEnd = static_cast<uint64_t>(i + 1) * clusterSize;
+        if (f_lseek(file, clusterEnd < size ? clusterEnd : size) != FR_OK) {
+            delete[] newMap;
+            return false;
+        }
+
+        newMap[i] = file->clust;
+    }
+
+    delete[] clusterMap;
+    clusterMap = newMap;
+    clusterMapSize = clusterCount;
+
+    return true;
+}
+
+FRESULT FatFile::invalidateSectorBuffer() {
+#if !FF_FS_TINY
+    // FatFs writes back its sector buffer only when it moves to another sector, which it determines from the file pointer
+    if (file->flag & FATFS_DIRTY_FLAG) {
+        if (disk_write(file->obj.fs->pdrv, file->buf, file->sect, 1) != RES_OK) {
+            return FR_DISK_ERR;
+        }
+
+        file->flag &= ~FATFS_DIRTY_FLAG;
+    }
+#endif
+
+    // No data sector is located at sector 0, so FatFs reloads the buffer for the next access inside a sector
+    file->sect = 0;
+    return FR_OK;
+}
+
+uint32_t FatFile::getClusterSize() const {
+#if FF_MAX_SS == FF_MIN_SS
+    return static_cast<uint32_t>(file->obj.fs->csize) * FF_MAX_SS;
+#else
+    return static_cast<uint32_t>(file->obj.fs->csize) * file->obj.fs->ssize;
+#endif
 }
 
 }
\ No newline at end of file
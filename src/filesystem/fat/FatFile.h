@@ -22,7 +22,10 @@
 
 #include "FatNode.h"
 #include "filesystem/fat/ff/source/ff.h"
+#include "filesystem/ReadAhead.h"
+#include "lib/util/async/Spinlock.h"
 #include "lib/util/collection/Array.h"
+#include "lib/util/collection/ArrayList.h"
 #include "lib/util/io/file/File.h"
 
 namespace Util {
@@ -33,6 +36,11 @@ class String;
 
 namespace Filesystem::Fat {
 
+/**
+ * Written data is kept in the FatFs sector buffer and the volume's block cache until the file is synced.
+ * This happens, when the file is closed, when a sync is requested explicitly, when the volume is unmounted
+ * or periodically by the FatFlushRunnable.
+ */
 class FatFile : public FatNode {
 
 public:
@@ -61,6 +69,11 @@ public:
      */
     Util::Io::File::Type getType() override;
 
+    /**
+     * Overriding function from FatNode.
+     */
+    uint64_t getLength() override;
+
     /**
      * Overriding function from Node.
      */
@@ -71,14 +84,92 @@ public:
      */
     uint64_t readData(uint8_t *targetBuffer, uint64_t pos, uint64_t numBytes) override;
 
+    /**
+     * Overriding function from Node.
+     */
+    uint64_t readDataAhead(uint8_t *targetBuffer, uint64_t pos, uint64_t numBytes, uint32_t window) override;
+
     /**
      * Overriding function from Node.
      */
     uint64_t writeData(const uint8_t *sourceBuffer, uint64_t pos, uint64_t numBytes) override;
 
+    /**
+     * Overriding function from Node.
+     */
+    bool sync() override;
+
+    /**
+     * Overriding function from Node.
+     */
+    void releaseBuffers() override;
+
+    /**
+     * Sync all open files with pending writes.
+     *
+     * @param volume Only sync files on this volume (all volumes, if nullptr)
+     */
+    static void syncAll(const FATFS *volume = nullptr);
+
+    /**
+     * Make the file visible to syncAll(). Must be called without holding the FatFs lock,
+     * since syncAll() takes the FatFs lock while holding the lock of the open file list.
+     */
+    void registerOpenFile();
+
 private:
 
+    uint64_t readFile(uint8_t *targetBuffer, uint64_t pos, uint64_t numBytes);
+
+    /**
+     * Move the file pointer to a position.
+     * For backward seeks, FatFs follows the cluster chain from the start of the file. For large files, the cluster
+     * containing the target position is looked up in the cluster map instead and FatFs only continues from there.
+     */
+    FRESULT seek(uint64_t pos);
+
+    /**
+     * Extend the cluster map, so that it covers all clusters of the file.
+     * Clusters never move while the file is open (it cannot be truncated), so only clusters appended by writes are missing.
+     *
+     * @return false, if the cluster chain could not be followed
+     */
+    bool updateClusterMap();
+
+    /**
+     * Write back the sector buffer of the file, if it is dirty, and mark it as invalid.
+     * Must be called before the file pointer is changed without f_lseek().
+     */
+    FRESULT invalidateSectorBuffer();
+
+    [[nodiscard]] uint32_t getClusterSize() const;
+
     FIL *file;
+    bool dirty = false;
+    // Amount of running syncAll() calls, that use this file (guarded by openFilesLock)
+    uint32_t syncReferences = 0;
+    Util::Async::Spinlock lock;
+
+    // Cluster numbers of the file's clusters in file order (built on the first seek in a large file)
+    DWORD *clusterMap = nullptr;
+    uint32_t clusterMapSize = 0;
+
+    // Allocated on the first sequential read and freed, when the file is not opened anymore
+    uint8_t *readAheadBuffer = nullptr;
+    uint64_t readAheadPosition = 0;
+    uint32_t readAheadLength = 0;
+    uint32_t readAheadGeneration = 0;
+
+    // Incremented on every write to a volume, to invalidate the read-ahead buffers of all open files on it
+    static uint32_t writeGenerations[FF_VOLUMES];
+
+    static Util::ArrayList<FatFile*> openFiles;
+    static Util::Async::Spinlock openFilesLock;
+
+    static const constexpr uint32_t READ_AHEAD_BUFFER_SIZE = ReadAhead::MAXIMUM_WINDOW;
+    static const constexpr uint32_t CLUSTER_MAP_THRESHOLD = 256 * 1024;
+    // Equal to FA_DIRTY, which is private to ff.c
+    static const constexpr BYTE FATFS_DIRTY_FLAG = 0x80;
 };
 
 }
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef HHUOS_FATFLUSHRUNNABLE_H
+#define HHUOS_FATFLUSHRUNNABLE_H
+
+#include <stdint.h>
+
+#include "lib/util/async/Runnable.h"
+
+namespace Filesystem::Fat {
+
+/**
+ * Runs in background and periodically writes back data of open FAT files,
+ * so that not too much data gets lost, if a file is never closed or the system crashes.
+ */
+class FatFlushRunnable : public Util::Async::Runnable {
+
+public:
+    /**
+     * Default Constructor.
+     */
+    FatFlushRunnable() = default;
+
+    /**
+     * Copy Constructor.
+     */
+    FatFlushRunnable(const FatFlushRunnable &copy) = delete;
+
+    /**
+     * Assignment operator.
+     */
+    FatFlushRunnable& operator=(const FatFlushRunnable &other) = delete;
+
+    /**
+     * Destructor.
+     */
+    ~FatFlushRunnable() override = default;
+
+    /**
+     * Overriding function from Runnable.
+     */
+    void run() override;
+
+private:
+
+    static const constexpr uint32_t INTERVAL = 5000;
+};
+
+}
+
+#endif
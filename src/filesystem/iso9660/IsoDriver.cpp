@@ -23,6 +23,7 @@
 #include "kernel/log/Log.h"
 #include "IsoNode.h"
 #include "lib/util/base/Address.h"
+#include "device/storage/BlockCache.h"
 #include "device/storage/StorageDevice.h"
 #include "lib/util/collection/Array.h"
 #include "lib/util/collection/Iterator.h"
@@ -33,8 +34,16 @@ class Node;
 
 namespace Filesystem::Iso {
 
+IsoDriver::~IsoDriver() {
+    // Nodes, which are still open, keep the cache alive until they are deleted
+    if (device != nullptr && device->releaseReference()) {
+        delete device;
+    }
+}
+
 bool IsoDriver::mount(Device::Storage::StorageDevice &device) {
-    IsoDriver::device = &device;
+    // All nodes of this filesystem share a cache, which is also used for read-ahead
+    IsoDriver::device = new Device::Storage::BlockCache(device);
 
     if (!initializePrimaryVolumeDescriptor()) {
         return false;
@@ -133,6 +142,10 @@ bool IsoDriver::deleteNode([[maybe_unused]] const Util::String &path) {
     return false;
 }
 
+bool IsoDriver::isCacheable() {
+    return true;
+}
+
 bool IsoDriver::initializePrimaryVolumeDescriptor() {
     LOG_INFO("Searching primary volume descriptor");
     auto *buffer = new uint8_t[device->getSectorSize()];
@@ -31,6 +31,7 @@
 
 namespace Device {
 namespace Storage {
+class BlockCache;
 class StorageDevice;
 }  // namespace Storage
 }  // namespace Device
@@ -104,7 +105,7 @@ public:
     /**
      * Destructor.
      */
-    ~IsoDriver() override = default;
+    ~IsoDriver() override;
 
     PROTOTYPE_IMPLEMENT_CLONE(IsoDriver);
 
@@ -135,6 +136,11 @@ public:
      */
     bool deleteNode(const Util::String &path) override;
 
+    /**
+     * Overriding function from Driver.
+     */
+    bool isCacheable() override;
+
 private:
 
     enum VolumeDescriptorType : uint8_t {
@@ -224,7 +230,7 @@ private:
 
 private:
 
-    Device::Storage::StorageDevice *device = nullptr;
+    Device::Storage::BlockCache *device = nullptr;
     PrimaryVolumeDescriptor primaryVolumeDescriptor{};
     Util::ArrayList<PathTableEntry*> pathTableEntryList = Util::ArrayList<PathTableEntry*>();
 
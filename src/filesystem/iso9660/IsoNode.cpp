@@ -21,16 +21,21 @@
 #include "IsoNode.h"
 
 #include "lib/util/base/Address.h"
-#include "device/storage/StorageDevice.h"
+#include "device/storage/BlockCache.h"
 #include "filesystem/iso9660/IsoDriver.h"
 #include "lib/util/collection/ArrayList.h"
 
 namespace Filesystem::Iso {
 
-IsoNode::IsoNode(Device::Storage::StorageDevice &device, const IsoDriver::DirectoryRecord *record) : device(device), record(*record) {}
+IsoNode::IsoNode(Device::Storage::BlockCache &device, const IsoDriver::DirectoryRecord *record) : device(device), record(*record) {
+    device.addReference();
+}
 
 IsoNode::~IsoNode() {
     delete &record;
+    if (device.releaseReference()) {
+        delete &device;
+    }
 }
 
 Util::String IsoNode::getName() {
@@ -77,7 +82,52 @@ Util::Array<Util::String> IsoNode::getChildren() {
     return names.toArray();
 }
 
+uint32_t IsoNode::readDirectory(uint32_t &cursor, Util::Io::File::DirectoryEntry *entries, uint32_t count) {
+    if (!record.isDirectory()) {
+        return 0;
+    }
+
+    // The cursor is a byte offset into the directory's extent. Only the sectors containing the requested entries are read.
+    auto sectorSize = device.getSectorSize();
+    auto *sector = new uint8_t[sectorSize];
+    auto currentSector = UINT32_MAX;
+    uint32_t read = 0;
+
+    while (read < count && cursor < record.dataLengthLSB) {
+        auto sectorIndex = cursor / sectorSize;
+        if (sectorIndex != currentSector) {
+            if (device.read(sector, record.extentLbaLSB + sectorIndex, 1) != 1) {
+                break;
+            }
+
+            currentSector = sectorIndex;
+        }
+
+        const auto &currentRecord = *reinterpret_cast<IsoDriver::DirectoryRecord*>(sector + cursor % sectorSize);
+        if (currentRecord.recordLength == 0) {
+            // Skip padding bytes by aligning the cursor to the next sector
+            cursor = (sectorIndex + 1) * sectorSize;
+            continue;
+        }
+
+        // Skip self and parent referencing records
+        if (!(currentRecord.identifierLength == 1 && (currentRecord.identifier[0] == 0x00 || currentRecord.identifier[0] == 0x01))) {
+            auto type = currentRecord.isDirectory() ? Util::Io::File::DIRECTORY : Util::Io::File::REGULAR;
+            setDirectoryEntry(entries[read++], currentRecord.getName(), type, currentRecord.dataLengthLSB);
+        }
+
+        cursor += currentRecord.recordLength;
+    }
+
+    delete[] sector;
+    return read;
+}
+
 uint64_t IsoNode::readData(uint8_t *targetBuffer, uint64_t pos, uint64_t numBytes) {
+    return readDataAhead(targetBuffer, pos, numBytes, 0);
+}
+
+uint64_t IsoNode::readDataAhead(uint8_t *targetBuffer, uint64_t pos, uint64_t numBytes, uint32_t window) {
     if (pos >= record.dataLengthLSB) {
         return 0;
     }
@@ -86,17 +136,35 @@ uint64_t IsoNode::readData(uint8_t *targetBuffer, uint64_t pos, uint64_t numByte
         numBytes = (record.dataLengthLSB - pos);
     }
 
-    uint32_t startSector = record.extentLbaLSB + (static_cast<uint32_t>(pos) / device.getSectorSize());
-    uint32_t sectorCount = (static_cast<uint32_t>(numBytes) / device.getSectorSize()) + 1;
+    if (numBytes == 0) {
+        return 0;
+    }
+
+    auto sectorSize = device.getSectorSize();
+    uint32_t startSector = record.extentLbaLSB + (static_cast<uint32_t>(pos) / sectorSize);
+    uint32_t endSector = record.extentLbaLSB + (static_cast<uint32_t>(pos + numBytes - 1) / sectorSize);
+    uint32_t sectorCount = endSector - startSector + 1;
+
+    // Files are stored contiguously, so reading ahead just means loading the following sectors into the block cache
+    if (window > 0 && pos + numBytes < record.dataLengthLSB) {
+        auto readAheadEnd = pos + numBytes + window > record.dataLengthLSB ? record.dataLengthLSB : pos + numBytes + window;
+        auto readAheadEndSector = record.extentLbaLSB + static_cast<uint32_t>((readAheadEnd - 1) / sectorSize);
+        device.prefetch(startSector, readAheadEndSector - startSector + 1);
+    }
+
+    // Sector aligned requests can be read directly into the target buffer
+    if (pos % sectorSize == 0 && numBytes % sectorSize == 0) {
+        return device.read(targetBuffer, startSector, sectorCount) == sectorCount ? numBytes : 0;
+    }
 
-    auto *buffer = new uint8_t[sectorCount * device.getSectorSize()];
+    auto *buffer = new uint8_t[sectorCount * sectorSize];
     auto readSectors = device.read(buffer, startSector, sectorCount);
     if (readSectors != sectorCount) {
         delete[] buffer;
         return 0;
     }
 
-    auto sourceAddress = Util::Address<uint32_t>(buffer).add(static_cast<uint32_t>(pos) % device.getSectorSize());
+    auto sourceAddress = Util::Address<uint32_t>(buffer).add(static_cast<uint32_t>(pos) % sectorSize);
     auto targetAddress = Util::Address<uint32_t>(targetBuffer);
     targetAddress.copyRange(sourceAddress, numBytes);
 
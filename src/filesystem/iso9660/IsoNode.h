@@ -31,7 +31,7 @@
 
 namespace Device {
 namespace Storage {
-class StorageDevice;
+class BlockCache;
 }  // namespace Storage
 }  // namespace Device
 
@@ -43,7 +43,7 @@ public:
     /**
      * Constructor.
      */
-    explicit IsoNode(Device::Storage::StorageDevice &device, const IsoDriver::DirectoryRecord *record);
+    explicit IsoNode(Device::Storage::BlockCache &device, const IsoDriver::DirectoryRecord *record);
 
     /**
      * Copy Constructor.
@@ -80,11 +80,21 @@ public:
      */
     Util::Array<Util::String> getChildren() override;
 
+    /**
+     * Overriding function from Node.
+     */
+    uint32_t readDirectory(uint32_t &cursor, Util::Io::File::DirectoryEntry *entries, uint32_t count) override;
+
     /**
      * Overriding function from Node.
      */
     uint64_t readData(uint8_t *targetBuffer, uint64_t pos, uint64_t numBytes) override;
 
+    /**
+     * Overriding function from Node.
+     */
+    uint64_t readDataAhead(uint8_t *targetBuffer, uint64_t pos, uint64_t numBytes, uint32_t window) override;
+
     /**
      * Overriding function from Node.
      */
@@ -92,7 +102,7 @@ public:
 
 private:
 
-    Device::Storage::StorageDevice &device;
+    Device::Storage::BlockCache &device;
     const IsoDriver::DirectoryRecord &record;
 };
 
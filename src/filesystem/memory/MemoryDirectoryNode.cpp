@@ -41,6 +41,16 @@ Util::Array<Util::String> MemoryDirectoryNode::getChildren() {
     return ret;
 }
 
+uint32_t MemoryDirectoryNode::readDirectory(uint32_t &cursor, Util::Io::File::DirectoryEntry *entries, uint32_t count) {
+    uint32_t read = 0;
+    for (; read < count && cursor < children.size(); cursor++) {
+        auto *child = children.get(cursor);
+        setDirectoryEntry(entries[read++], child->getName(), child->getType(), child->getLength());
+    }
+
+    return read;
+}
+
 uint64_t MemoryDirectoryNode::readData([[maybe_unused]] uint8_t *targetBuffer, [[maybe_unused]] uint64_t pos, [[maybe_unused]] uint64_t numBytes) {
     Util::Exception::throwException(Util::Exception::UNSUPPORTED_OPERATION, "MemoryDriver: Trying to read from a directory!");
 }
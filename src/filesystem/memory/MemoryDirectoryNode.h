@@ -66,6 +66,11 @@ public:
      */
     Util::Array<Util::String> getChildren() override;
 
+    /**
+     * Overriding function from Node.
+     */
+    uint32_t readDirectory(uint32_t &cursor, Util::Io::File::DirectoryEntry *entries, uint32_t count) override;
+
     /**
      * Overriding function from Node.
      */
@@ -23,6 +23,11 @@ namespace Filesystem::Memory {
 
 MemoryFileNode::MemoryFileNode(const Util::String &name) : MemoryNode(name) {}
 
+MemoryFileNode::~MemoryFileNode() {
+    freePages(0);
+    delete[] pages;
+}
+
 Util::Io::File::Type MemoryFileNode::getType() {
     return Util::Io::File::REGULAR;
 }
@@ -44,34 +49,105 @@ uint64_t MemoryFileNode::readData(uint8_t *targetBuffer, uint64_t pos, uint64_t
         numBytes = (length - pos);
     }
 
-    auto sourceAddress = Util::Address<uint32_t>(data).add(pos);
-    auto targetAddress = Util::Address<uint32_t>(targetBuffer);
-    targetAddress.copyRange(sourceAddress, numBytes);
+    uint64_t read = 0;
+    while (read < numBytes) {
+        auto pageIndex = static_cast<uint32_t>((pos + read) / PAGE_SIZE);
+        auto pageOffset = static_cast<uint32_t>((pos + read) % PAGE_SIZE);
+        auto chunkSize = PAGE_SIZE - pageOffset;
+        if (chunkSize > numBytes - read) {
+            chunkSize = numBytes - read;
+        }
+
+        auto targetAddress = Util::Address<uint32_t>(targetBuffer + read);
+        if (pageIndex < pageTableSize && pages[pageIndex] != nullptr) {
+            targetAddress.copyRange(Util::Address<uint32_t>(pages[pageIndex] + pageOffset), chunkSize);
+        } else {
+            targetAddress.setRange(0, chunkSize);
+        }
+
+        read += chunkSize;
+    }
 
     return numBytes;
 }
 
 uint64_t MemoryFileNode::writeData(const uint8_t *sourceBuffer, uint64_t pos, uint64_t numBytes) {
-    auto sourceAddress = Util::Address<uint32_t>(sourceBuffer);
+    if (numBytes == 0) {
+        return 0;
+    }
 
-    if (pos + numBytes >= length) {
-        auto newLength = pos + numBytes;
-        auto *newData = new uint8_t[newLength];
-        auto oldAddress = Util::Address<uint32_t>(data);
-        auto newAddress = Util::Address<uint32_t>(newData);
+    auto end = pos + numBytes;
+    ensureCapacity(static_cast<uint32_t>((end + PAGE_SIZE - 1) / PAGE_SIZE));
+
+    uint64_t written = 0;
+    while (written < numBytes) {
+        auto pageIndex = static_cast<uint32_t>((pos + written) / PAGE_SIZE);
+        auto pageOffset = static_cast<uint32_t>((pos + written) % PAGE_SIZE);
+        auto chunkSize = PAGE_SIZE - pageOffset;
+        if (chunkSize > numBytes - written) {
+            chunkSize = numBytes - written;
+        }
+
+        if (pages[pageIndex] == nullptr) {
+            pages[pageIndex] = new uint8_t[PAGE_SIZE];
+            if (chunkSize < PAGE_SIZE) {
+                Util::Address<uint32_t>(pages[pageIndex]).setRange(0, PAGE_SIZE);
+            }
+        }
+
+        Util::Address<uint32_t>(pages[pageIndex] + pageOffset).copyRange(Util::Address<uint32_t>(sourceBuffer + written), chunkSize);
+        written += chunkSize;
+    }
 
-        newAddress.setRange(0, newLength);
-        newAddress.copyRange(oldAddress, length);
+    if (end > length) {
+        length = end;
+    }
 
-        delete data;
-        data = newData;
-        length = newLength;
+    return numBytes;
+}
+
+bool MemoryFileNode::truncate(uint64_t newLength) {
+    if (newLength < length) {
+        auto firstFreePage = static_cast<uint32_t>((newLength + PAGE_SIZE - 1) / PAGE_SIZE);
+        freePages(firstFreePage);
+
+        // Clear the rest of the last page, so that extending the file again reads zeros
+        auto pageOffset = static_cast<uint32_t>(newLength % PAGE_SIZE);
+        auto lastPage = static_cast<uint32_t>(newLength / PAGE_SIZE);
+        if (pageOffset > 0 && lastPage < pageTableSize && pages[lastPage] != nullptr) {
+            Util::Address<uint32_t>(pages[lastPage] + pageOffset).setRange(0, PAGE_SIZE - pageOffset);
+        }
     }
 
-    auto targetAddress = Util::Address<uint32_t>(data).add(pos);
-    targetAddress.copyRange(sourceAddress, numBytes);
+    length = newLength;
+    return true;
+}
 
-    return numBytes;
+void MemoryFileNode::ensureCapacity(uint32_t pageCount) {
+    if (pageCount <= pageTableSize) {
+        return;
+    }
+
+    auto newSize = pageTableSize == 0 ? INITIAL_PAGE_TABLE_SIZE : pageTableSize * 2;
+    while (newSize < pageCount) {
+        newSize *= 2;
+    }
+
+    auto **newPages = new uint8_t*[newSize]{};
+    for (uint32_t i = 0; i < pageTableSize; i++) {
+        newPages[i] = pages[i];
+    }
+
+    delete[] pages;
+    pages = newPages;
+    pageTableSize = newSize;
+}
+
+void MemoryFileNode::freePages(uint32_t fromPage) {
+    for (uint32_t i = fromPage; i < pageTableSize; i++) {
+        delete[] pages[i];
+        pages[i] = nullptr;
+    }
 }
 
 }
\ No newline at end of file
@@ -23,6 +23,7 @@
 #include "MemoryNode.h"
 #include "lib/util/collection/Array.h"
 #include "lib/util/base/String.h"
+#include "lib/util/base/Constants.h"
 #include "lib/util/io/file/File.h"
 
 namespace Filesystem::Memory {
@@ -48,7 +49,7 @@ public:
     /**
      * Destructor.
      */
-    ~MemoryFileNode() override = default;
+    ~MemoryFileNode() override;
 
     /**
      * Overriding function from Node.
@@ -75,10 +76,28 @@ public:
      */
     uint64_t writeData(const uint8_t *sourceBuffer, uint64_t pos, uint64_t numBytes) override;
 
+    /**
+     * Overriding function from Node.
+     */
+    bool truncate(uint64_t length) override;
+
 private:
 
+    void ensureCapacity(uint32_t pageCount);
+
+    void freePages(uint32_t fromPage);
+
+    /**
+     * The file's data is stored in pages, which are allocated on first write.
+     * Missing pages (holes) read as zeros. The page table grows by doubling its size,
+     * so that appending to a file does not copy the existing data.
+     */
     uint64_t length = 0;
-    uint8_t *data = nullptr;
+    uint8_t **pages = nullptr;
+    uint32_t pageTableSize = 0;
+
+    static const constexpr uint32_t PAGE_SIZE = Util::PAGESIZE;
+    static const constexpr uint32_t INITIAL_PAGE_TABLE_SIZE = 8;
 
 };
 
@@ -39,6 +39,10 @@ Util::Array<Util::String> MemoryWrapperNode::getChildren() {
     return node.getChildren();
 }
 
+uint32_t MemoryWrapperNode::readDirectory(uint32_t &cursor, Util::Io::File::DirectoryEntry *entries, uint32_t count) {
+    return node.readDirectory(cursor, entries, count);
+}
+
 uint64_t MemoryWrapperNode::readData(uint8_t *targetBuffer, uint64_t pos, uint64_t numBytes) {
     return node.readData(targetBuffer, pos, numBytes);
 }
@@ -47,6 +51,10 @@ uint64_t MemoryWrapperNode::writeData(const uint8_t *sourceBuffer, uint64_t pos,
     return node.writeData(sourceBuffer, pos, numBytes);
 }
 
+bool MemoryWrapperNode::truncate(uint64_t length) {
+    return node.truncate(length);
+}
+
 bool MemoryWrapperNode::control(uint32_t request, const Util::Array<uint32_t> &parameters) {
     return node.control(request, parameters);
 }
@@ -55,4 +63,12 @@ bool MemoryWrapperNode::isReadyToRead() {
     return node.isReadyToRead();
 }
 
+bool MemoryWrapperNode::isReadyToWrite() {
+    return node.isReadyToWrite();
+}
+
+Kernel::WaitQueue* MemoryWrapperNode::getWaitQueue() {
+    return node.getWaitQueue();
+}
+
 }
\ No newline at end of file
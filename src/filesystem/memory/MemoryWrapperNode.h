@@ -76,6 +76,11 @@ public:
      */
     Util::Array<Util::String> getChildren() override;
 
+    /**
+     * Overriding function from Node.
+     */
+    uint32_t readDirectory(uint32_t &cursor, Util::Io::File::DirectoryEntry *entries, uint32_t count) override;
+
     /**
      * Overriding function from Node.
      */
@@ -86,6 +91,11 @@ public:
      */
     uint64_t writeData(const uint8_t *sourceBuffer, uint64_t pos, uint64_t numBytes) override;
 
+    /**
+     * Overriding function from Node.
+     */
+    bool truncate(uint64_t length) override;
+
     /**
      * Overriding function from Node.
      */
@@ -93,6 +103,10 @@ public:
 
     bool isReadyToRead() override;
 
+    bool isReadyToWrite() override;
+
+    Kernel::WaitQueue* getWaitQueue() override;
+
 private:
 
     MemoryNode &node;
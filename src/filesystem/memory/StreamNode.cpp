@@ -27,7 +27,7 @@ StreamNode::StreamNode(const Util::String &name, Util::Io::OutputStream *outputS
 
 StreamNode::StreamNode(const Util::String &name, Util::Io::OutputStream *outputStream) : MemoryNode(name), outputStream(outputStream), inputStream(nullptr) {}
 
-StreamNode::StreamNode(const Util::String &name, Util::Io::InputStream *inputStream) : MemoryNode(name), outputStream(nullptr), inputStream(inputStream) {}
+StreamNode::StreamNode(const Util::String &name, Util::Io::InputStream *inputStream, Kernel::WaitQueue *waitQueue) : MemoryNode(name), outputStream(nullptr), inputStream(inputStream), waitQueue(waitQueue) {}
 
 Util::Io::File::Type StreamNode::getType() {
     return Util::Io::File::CHARACTER;
@@ -53,4 +53,8 @@ bool StreamNode::isReadyToRead() {
     return inputStream->isReadyToRead();
 }
 
+Kernel::WaitQueue* StreamNode::getWaitQueue() {
+    return waitQueue;
+}
+
 }
\ No newline at end of file
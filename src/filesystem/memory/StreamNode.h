@@ -49,7 +49,7 @@ public:
     /**
      * Constructor.
      */
-    StreamNode(const Util::String &name, Util::Io::InputStream *inputStream);
+    StreamNode(const Util::String &name, Util::Io::InputStream *inputStream, Kernel::WaitQueue *waitQueue = nullptr);
 
     /**
      * Copy Constructor.
@@ -83,10 +83,17 @@ public:
 
     bool isReadyToRead() override;
 
+    /**
+     * Overriding function from Node.
+     * The wait queue is owned by the producer of the input stream's data.
+     */
+    Kernel::WaitQueue* getWaitQueue() override;
+
 private:
 
     Util::Io::OutputStream *outputStream;
     Util::Io::InputStream *inputStream;
+    Kernel::WaitQueue *waitQueue = nullptr;
 
 };
 
@@ -17,6 +17,11 @@
 
 #include "ProcessDirectoryNode.h"
 
+#include "kernel/process/Process.h"
+#include "kernel/service/ProcessService.h"
+#include "kernel/service/Service.h"
+#include "lib/util/io/file/File.h"
+
 namespace Filesystem::Process {
 
 ProcessDirectoryNode::ProcessDirectoryNode(uint32_t processId) : name(Util::String::format("%u", processId)) {}
@@ -37,6 +42,27 @@ Util::Array<Util::String> ProcessDirectoryNode::getChildren() {
     return Util::Array<Util::String>({"name", "cwd", "thread_count"});
 }
 
+uint32_t ProcessDirectoryNode::readDirectory(uint32_t &cursor, Util::Io::File::DirectoryEntry *entries, uint32_t count) {
+    auto *process = Kernel::Service::getService<Kernel::ProcessService>().getProcess(Util::String::parseInt(name));
+    if (process == nullptr) {
+        return 0;
+    }
+
+    const Util::String names[] = { "name", "cwd", "thread_count" };
+    const uint64_t lengths[] = {
+            process->getName().length(),
+            process->getWorkingDirectory().getCanonicalPath().length(),
+            Util::String::format("%u", process->getThreadCount()).length()
+    };
+
+    uint32_t read = 0;
+    for (; read < count && cursor < 3; cursor++) {
+        setDirectoryEntry(entries[read++], names[cursor], Util::Io::File::REGULAR, lengths[cursor]);
+    }
+
+    return read;
+}
+
 uint64_t ProcessDirectoryNode::readData([[maybe_unused]] uint8_t *targetBuffer, [[maybe_unused]] uint64_t pos, [[maybe_unused]] uint64_t numBytes) {
     return 0;
 }
@@ -46,6 +46,17 @@ Util::Array<Util::String> ProcessRootNode::getChildren() {
     return ret;
 }
 
+uint32_t ProcessRootNode::readDirectory(uint32_t &cursor, Util::Io::File::DirectoryEntry *entries, uint32_t count) {
+    auto ids = Kernel::Service::getService<Kernel::ProcessService>().getActiveProcessIds();
+
+    uint32_t read = 0;
+    for (; read < count && cursor < ids.length(); cursor++) {
+        setDirectoryEntry(entries[read++], Util::String::format("%u", ids[cursor]), Util::Io::File::DIRECTORY, 0);
+    }
+
+    return read;
+}
+
 uint64_t ProcessRootNode::readData([[maybe_unused]] uint8_t *targetBuffer, [[maybe_unused]] uint64_t pos, [[maybe_unused]] uint64_t numBytes) {
     return 0;
 }
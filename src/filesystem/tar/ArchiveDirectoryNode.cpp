@@ -5,26 +5,13 @@
 
 namespace Filesystem::Tar {
 
-ArchiveDirectoryNode::ArchiveDirectoryNode(Util::Io::Tar::Archive &archive, const Util::String &path) {
+ArchiveDirectoryNode::ArchiveDirectoryNode(Util::Io::Tar::Archive &archive, const Util::String &path) : archive(archive), path(path), children(archive.getChildren(path)) {
     if(path.isEmpty() || path == "/") {
         name = "/";
     } else {
         Util::Array<Util::String> tokens = path.split("/");
         name = tokens[tokens.length() - 1];
     }
-
-    for(const auto &header : archive.getFileHeaders()) {
-        Util::String fullPath = header.filename;
-
-        if(fullPath.beginsWith(path) && fullPath != path) {
-            Util::String subPath = fullPath.substring(path.length(), fullPath.length());
-            Util::String childName = subPath.split("/")[0];
-
-            if(!children.contains(childName)) {
-                children.add(childName);
-            }
-        }
-    }
 }
 
 Util::String ArchiveDirectoryNode::getName() {
@@ -40,7 +27,23 @@ uint64_t ArchiveDirectoryNode::getLength() {
 }
 
 Util::Array<Util::String> ArchiveDirectoryNode::getChildren() {
-    return children.toArray();
+    return children;
+}
+
+uint32_t ArchiveDirectoryNode::readDirectory(uint32_t &cursor, Util::Io::File::DirectoryEntry *entries, uint32_t count) {
+    uint32_t read = 0;
+    for (; read < count && cursor < children.length(); cursor++) {
+        const auto &child = children[cursor];
+        auto *header = archive.getHeader(path.isEmpty() || path == "/" ? child : path + "/" + child);
+
+        if (header == nullptr) {
+            setDirectoryEntry(entries[read++], child, Util::Io::File::DIRECTORY, 0);
+        } else {
+            setDirectoryEntry(entries[read++], child, Util::Io::File::REGULAR, Util::Io::Tar::Archive::calculateFileSize(*header));
+        }
+    }
+
+    return read;
 }
 
 uint64_t ArchiveDirectoryNode::readData([[maybe_unused]] uint8_t *targetBuffer, [[maybe_unused]] uint64_t pos, [[maybe_unused]] uint64_t numBytes) {
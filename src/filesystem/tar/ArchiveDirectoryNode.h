@@ -5,7 +5,6 @@
 
 #include "ArchiveNode.h"
 #include "lib/util/collection/Array.h"
-#include "lib/util/collection/ArrayList.h"
 #include "lib/util/base/String.h"
 #include "lib/util/io/file/File.h"
 
@@ -62,6 +61,11 @@ public:
      */
     Util::Array<Util::String> getChildren() override;
 
+    /**
+     * Overriding function from Node.
+     */
+    uint32_t readDirectory(uint32_t &cursor, Util::Io::File::DirectoryEntry *entries, uint32_t count) override;
+
     /**
      * Overriding function from Node.
      */
@@ -74,8 +78,10 @@ public:
 
 private:
 
+    Util::Io::Tar::Archive &archive;
+    Util::String path;
     Util::String name;
-    Util::ArrayList<Util::String> children;
+    Util::Array<Util::String> children;
 
 };
 
@@ -26,19 +26,16 @@ class Node;
 
 namespace Filesystem::Tar {
 
-ArchiveDriver::ArchiveDriver(Util::Io::Tar::Archive &archive) : archive(archive), fileHeaders(archive.getFileHeaders()) {}
+ArchiveDriver::ArchiveDriver(Util::Io::Tar::Archive &archive) : archive(archive) {}
 
 Node *ArchiveDriver::getNode(const Util::String &path) {
-    for(const auto &header : fileHeaders) {
-        Util::String currentPath = header.filename;
-
-        if(path == currentPath) {
-            return new ArchiveFileNode(archive, header);
-        }
+    auto *header = archive.getHeader(path);
+    if (header != nullptr) {
+        return new ArchiveFileNode(archive, *header);
+    }
 
-        if((path == "") || (currentPath.beginsWith(path) && currentPath[path.length()] == '/')) {
-            return new ArchiveDirectoryNode(archive, path);
-        }
+    if (archive.isDirectory(path)) {
+        return new ArchiveDirectoryNode(archive, path);
     }
 
     return nullptr;
@@ -51,4 +48,9 @@ bool ArchiveDriver::createNode([[maybe_unused]] const Util::String &path, [[mayb
 bool ArchiveDriver::deleteNode([[maybe_unused]] const Util::String &path) {
     return false;
 }
+
+bool ArchiveDriver::isCacheable() {
+    return true;
+}
+
 }
\ No newline at end of file
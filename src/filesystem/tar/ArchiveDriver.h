@@ -72,10 +72,14 @@ public:
      */
     bool deleteNode(const Util::String &path) override;
 
+    /**
+     * Overriding function from Driver.
+     */
+    bool isCacheable() override;
+
 private:
 
     Util::Io::Tar::Archive &archive;
-    Util::Array<Util::Io::Tar::Archive::Header> fileHeaders{};
 
 };
 
@@ -68,6 +68,10 @@ enum InterruptVector : uint8_t {
 
     SYSTEM_CALL = 0x86,
 
+    // Message signaled interrupts (assigned to PCI devices on demand)
+    MESSAGE_SIGNALED_INTERRUPT_START = 0x90,
+    MESSAGE_SIGNALED_INTERRUPT_END = 0x9f,
+
     // Software exceptions
     NULL_POINTER = 0xc8,
     OUT_OF_BOUNDS = 0xc9,
@@ -20,7 +20,9 @@
 
 #include "DatagramSocket.h"
 
-#include "lib/util/async/Thread.h"
+#include "kernel/process/Scheduler.h"
+#include "kernel/service/ProcessService.h"
+#include "kernel/service/Service.h"
 #include "lib/util/network/NetworkAddress.h"
 #include "kernel/network/Socket.h"
 #include "lib/util/time/Timestamp.h"
@@ -42,15 +44,21 @@ namespace Kernel::Network {
 DatagramSocket::DatagramSocket(NetworkModule &networkModule, Util::Network::Socket::Type type) : Socket(networkModule, type) {}
 
 Util::Network::Datagram *DatagramSocket::receive() {
+    auto &scheduler = Service::getService<ProcessService>().getScheduler();
+    WaitQueue::ThreadListener listener(scheduler.getCurrentThread());
+    waitQueue.add(listener);
+
     uint32_t startTime = Util::Time::getSystemTime().toMilliseconds();
     while (incomingDatagramQueue.isEmpty()) {
-        Util::Async::Thread::yield();
-
         if (timeout > 0) {
-            auto currentTime = Util::Time::getSystemTime().toMilliseconds();
-            if (currentTime - startTime >= timeout) {
+            auto elapsedTime = Util::Time::getSystemTime().toMilliseconds() - startTime;
+            if (elapsedTime >= timeout) {
                 return nullptr;
             }
+
+            scheduler.wait(Util::Time::Timestamp::ofMilliseconds(timeout - elapsedTime));
+        } else {
+            scheduler.wait(Util::Time::Timestamp());
         }
     }
 
@@ -65,6 +73,8 @@ void DatagramSocket::handleIncomingDatagram(Util::Network::Datagram *datagram) {
     lock.acquire();
     incomingDatagramQueue.offer(datagram);
     lock.release();
+
+    waitQueue.wakeUp();
 }
 
 Util::String DatagramSocket::getName() {
@@ -94,4 +104,8 @@ bool DatagramSocket::isReadyToRead() {
     return !incomingDatagramQueue.isEmpty();
 }
 
+WaitQueue* DatagramSocket::getWaitQueue() {
+    return &waitQueue;
+}
+
 }
\ No newline at end of file
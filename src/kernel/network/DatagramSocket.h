@@ -24,6 +24,7 @@
 #include <stdint.h>
 
 #include "Socket.h"
+#include "kernel/process/WaitQueue.h"
 #include "lib/util/async/Spinlock.h"
 #include "lib/util/collection/ArrayListBlockingQueue.h"
 #include "lib/util/collection/Array.h"
@@ -126,12 +127,18 @@ public:
      */
     bool isReadyToRead() override;
 
+    /**
+     * Overriding function from Node.
+     */
+    WaitQueue* getWaitQueue() override;
+
 private:
 
     void handleIncomingDatagram(Util::Network::Datagram *datagram);
 
     Util::Async::Spinlock lock;
     Util::ArrayListBlockingQueue<Util::Network::Datagram*> incomingDatagramQueue;
+    WaitQueue waitQueue;
 };
 
 }
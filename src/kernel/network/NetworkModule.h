@@ -53,6 +53,8 @@ public:
         const Util::Network::NetworkAddress &sourceAddress;
         const Util::Network::NetworkAddress &destinationAddress;
         const uint32_t payloadLength;
+        // Set, if the network device has already verified the transport layer checksum
+        const bool checksumVerified = false;
     };
 
     /**
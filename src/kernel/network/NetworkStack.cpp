@@ -30,6 +30,7 @@ NetworkStack::NetworkStack() {
     ethernetModule.registerNextLayerModule(Util::Network::Ethernet::EthernetHeader::IP4, ip4Module);
     ip4Module.registerNextLayerModule(Util::Network::Ip4::Ip4Header::ICMP, icmpModule);
     ip4Module.registerNextLayerModule(Util::Network::Ip4::Ip4Header::UDP, udpModule);
+    ip4Module.registerNextLayerModule(Util::Network::Ip4::Ip4Header::TCP, tcpModule);
 }
 
 Network::Ethernet::EthernetModule &NetworkStack::getEthernetModule() {
@@ -52,4 +53,8 @@ Udp::UdpModule &NetworkStack::getUdpModule() {
     return udpModule;
 }
 
+Tcp::TcpModule &NetworkStack::getTcpModule() {
+    return tcpModule;
+}
+
 }
\ No newline at end of file
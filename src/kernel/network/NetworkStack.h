@@ -25,6 +25,7 @@
 #include "kernel/network/arp/ArpModule.h"
 #include "kernel/network/ethernet/EthernetModule.h"
 #include "kernel/network/icmp/IcmpModule.h"
+#include "kernel/network/tcp/TcpModule.h"
 #include "kernel/network/udp/UdpModule.h"
 
 namespace Kernel::Network {
@@ -62,6 +63,8 @@ public:
 
     Udp::UdpModule& getUdpModule();
 
+    Tcp::TcpModule& getTcpModule();
+
 private:
 
     Ethernet::EthernetModule ethernetModule;
@@ -69,6 +72,7 @@ private:
     Ip4::Ip4Module ip4Module;
     Icmp::IcmpModule icmpModule;
     Udp::UdpModule udpModule;
+    Tcp::TcpModule tcpModule;
 };
 
 }
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "PortAllocator.h"
+
+namespace Kernel::Network {
+
+bool PortAllocator::isUsed(uint16_t port) const {
+    return (bitmap[port / 32] & (1 << (port % 32))) != 0;
+}
+
+void PortAllocator::reference(uint16_t port) {
+    auto count = references.containsKey(port) ? references.get(port) : 0;
+    references.put(port, count + 1);
+    bitmap[port / 32] |= 1 << (port % 32);
+}
+
+void PortAllocator::release(uint16_t port) {
+    auto count = references.containsKey(port) ? references.get(port) : 0;
+    if (count > 1) {
+        references.put(port, count - 1);
+    } else {
+        references.remove(port);
+        bitmap[port / 32] &= ~(1 << (port % 32));
+    }
+}
+
+uint16_t PortAllocator::allocate() {
+    // Continue behind the last generated port, so that recently closed ports are not handed out again immediately
+    uint32_t port = nextEphemeralPort;
+    for (uint32_t i = 0; i < EPHEMERAL_PORT_COUNT;) {
+        if (port % 32 == 0 && bitmap[port / 32] == 0xffffffff) {
+            // Skip 32 used ports at once
+            port += 32;
+            i += 32;
+        } else if (!isUsed(port)) {
+            nextEphemeralPort = port == LAST_EPHEMERAL_PORT ? FIRST_EPHEMERAL_PORT : port + 1;
+            return port;
+        } else {
+            port++;
+            i++;
+        }
+
+        if (port > LAST_EPHEMERAL_PORT) {
+            port = FIRST_EPHEMERAL_PORT;
+        }
+    }
+
+    return 0;
+}
+
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef HHUOS_PORTALLOCATOR_H
+#define HHUOS_PORTALLOCATOR_H
+
+#include <stdint.h>
+
+#include "lib/util/collection/HashMap.h"
+
+namespace Kernel::Network {
+
+/**
+ * Keeps track of the ports used by a transport layer module and hands out free ephemeral ports.
+ * Used ports are kept in a bitmap, with the amount of users per port kept separately, so that checking a port
+ * and searching for a free one do not depend on the amount of sockets. Not synchronized, callers hold their socket lock.
+ */
+class PortAllocator {
+
+public:
+    /**
+     * Default Constructor.
+     */
+    PortAllocator() = default;
+
+    /**
+     * Copy Constructor.
+     */
+    PortAllocator(const PortAllocator &other) = delete;
+
+    /**
+     * Assignment operator.
+     */
+    PortAllocator &operator=(const PortAllocator &other) = delete;
+
+    /**
+     * Destructor.
+     */
+    ~PortAllocator() = default;
+
+    [[nodiscard]] bool isUsed(uint16_t port) const;
+
+    void reference(uint16_t port);
+
+    void release(uint16_t port);
+
+    /**
+     * Search for an unused ephemeral port. The port is not referenced by this call.
+     *
+     * @return The port, or 0 if all ephemeral ports are in use
+     */
+    uint16_t allocate();
+
+private:
+
+    static const constexpr uint32_t FIRST_EPHEMERAL_PORT = 49152;
+    static const constexpr uint32_t LAST_EPHEMERAL_PORT = 65535;
+    static const constexpr uint32_t EPHEMERAL_PORT_COUNT = LAST_EPHEMERAL_PORT - FIRST_EPHEMERAL_PORT + 1;
+
+    uint32_t bitmap[(UINT16_MAX + 1) / 32]{};
+    Util::HashMap<uint32_t, uint32_t> references;
+    uint32_t nextEphemeralPort = FIRST_EPHEMERAL_PORT;
+};
+
+}
+
+#endif
@@ -22,6 +22,7 @@
 
 #include "lib/util/base/Exception.h"
 #include "lib/util/network/NetworkAddress.h"
+#include "lib/util/network/Datagram.h"
 #include "lib/util/network/Socket.h"
 #include "lib/util/network/ip4/Ip4Address.h"
 #include "lib/util/io/stream/ByteArrayOutputStream.h"
@@ -50,6 +51,24 @@ void Socket::bind(const Util::Network::NetworkAddress &address) {
         Util::Exception::throwException(Util::Exception::ILLEGAL_STATE, "Socket: Already bound!");
     }
 
+    bindAddress = copyAddress(address);
+
+    if (!networkModule.registerSocket(*this)) {
+        Util::Exception::throwException(Util::Exception::INVALID_ARGUMENT, "Failed to register socket!");
+    }
+}
+
+void Socket::connect(const Util::Network::NetworkAddress &address) {
+    auto *newRemoteAddress = copyAddress(address);
+    delete remoteAddress;
+    remoteAddress = newRemoteAddress;
+}
+
+bool Socket::isConnected() const {
+    return remoteAddress != nullptr;
+}
+
+Util::Network::NetworkAddress* Socket::copyAddress(const Util::Network::NetworkAddress &address) {
     /*
      * We cannot use createCopy() here, because the given address may be a user space object.
      * Since it is a reference of an abstract type, the object's vtable is used to perform the call to createCopy().
@@ -61,26 +80,20 @@ void Socket::bind(const Util::Network::NetworkAddress &address) {
 
     switch (address.getType()) {
         case Util::Network::NetworkAddress::MAC:
-            bindAddress = new Util::Network::MacAddress(addressStream.getBuffer());
-            break;
+            return new Util::Network::MacAddress(addressStream.getBuffer());
         case Util::Network::NetworkAddress::IP4:
-            bindAddress = new Util::Network::Ip4::Ip4Address(addressStream.getBuffer());
-            break;
+            return new Util::Network::Ip4::Ip4Address(addressStream.getBuffer());
         case Util::Network::NetworkAddress::IP4_PORT:
-            bindAddress = new Util::Network::Ip4::Ip4PortAddress(addressStream.getBuffer());
-            break;
+            return new Util::Network::Ip4::Ip4PortAddress(addressStream.getBuffer());
         default:
-            Util::Exception::throwException(Util::Exception::INVALID_ARGUMENT, "Socket: Illegal address type for bind()!");
-    }
-
-    if (!networkModule.registerSocket(*this)) {
-        Util::Exception::throwException(Util::Exception::INVALID_ARGUMENT, "Failed to register socket!");
+            Util::Exception::throwException(Util::Exception::INVALID_ARGUMENT, "Socket: Illegal address type!");
     }
 }
 
 Socket::~Socket() {
     networkModule.deregisterSocket(*this);
     delete bindAddress;
+    delete remoteAddress;
 }
 
 const Util::Network::NetworkAddress& Socket::getAddress() const {
@@ -99,6 +112,46 @@ void Socket::setTimeout(uint32_t timeout) {
     Socket::timeout = timeout;
 }
 
+bool Socket::send(const Util::Network::Datagram &datagram) {
+    const Util::Io::File::Segment segment = { datagram.getData(), datagram.getLength() };
+    return send(datagram, &segment, 1);
+}
+
+bool Socket::receive(Util::Network::Datagram &datagram, const Util::Io::File::Segment *segments, uint32_t segmentCount, uint32_t &length) {
+    auto *kernelDatagram = receive();
+    if (kernelDatagram == nullptr) {
+        return false;
+    }
+
+    auto *source = kernelDatagram->getData();
+    auto remaining = kernelDatagram->getLength();
+    length = 0;
+
+    for (uint32_t i = 0; i < segmentCount && remaining > 0; i++) {
+        auto copyLength = segments[i].length < remaining ? segments[i].length : remaining;
+        auto target = Util::Address<uint32_t>(segments[i].buffer);
+        target.copyRange(Util::Address<uint32_t>(source + length), copyLength);
+
+        length += copyLength;
+        remaining -= copyLength;
+    }
+
+    datagram.setRemoteAddress(kernelDatagram->getRemoteAddress());
+    datagram.setAttributes(*kernelDatagram);
+
+    delete kernelDatagram;
+    return true;
+}
+
+uint32_t Socket::getPayloadLength(const Util::Io::File::Segment *segments, uint32_t segmentCount) {
+    uint32_t length = 0;
+    for (uint32_t i = 0; i < segmentCount; i++) {
+        length += segments[i].length;
+    }
+
+    return length;
+}
+
 bool Socket::control(uint32_t request, const Util::Array<uint32_t> &parameters) {
     switch (request) {
         case Util::Network::Socket::Request::SET_TIMEOUT: {
@@ -117,6 +170,14 @@ bool Socket::control(uint32_t request, const Util::Array<uint32_t> &parameters)
             bind(*reinterpret_cast<Util::Network::NetworkAddress*>(parameters[0]));
             return true;
         }
+        case Util::Network::Socket::Request::CONNECT: {
+            if (parameters.length() < 1) {
+                Util::Exception::throwException(Util::Exception::INVALID_ARGUMENT, "Socket: Missing parameters!");
+            }
+
+            connect(*reinterpret_cast<Util::Network::NetworkAddress*>(parameters[0]));
+            return true;
+        }
         case Util::Network::Socket::Request::GET_LOCAL_ADDRESS: {
             if (!isBound()) {
                 Util::Exception::throwException(Util::Exception::ILLEGAL_STATE, "Socket: Not yet bound!");
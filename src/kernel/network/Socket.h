@@ -25,6 +25,7 @@
 
 #include "filesystem/Node.h"
 #include "lib/util/collection/Array.h"
+#include "lib/util/io/file/File.h"
 #include "lib/util/network/Socket.h"
 
 namespace Kernel {
@@ -67,6 +68,13 @@ public:
 
     void bind(const Util::Network::NetworkAddress &address);
 
+    /**
+     * Set a default remote address, which is used for data written to the socket via writeData().
+     */
+    void connect(const Util::Network::NetworkAddress &address);
+
+    [[nodiscard]] bool isConnected() const;
+
     [[nodiscard]] const Util::Network::NetworkAddress& getAddress() const;
 
     [[nodiscard]] bool isBound() const;
@@ -75,17 +83,35 @@ public:
 
     bool control(uint32_t request, const Util::Array<uint32_t> &parameters) override;
 
-    virtual bool send(const Util::Network::Datagram &datagram) = 0;
+    bool send(const Util::Network::Datagram &datagram);
+
+    /**
+     * Send a datagram, whose payload is gathered from the given segments instead of the datagram's own buffer.
+     * Remote address and protocol specific attributes are still taken from the datagram.
+     */
+    virtual bool send(const Util::Network::Datagram &datagram, const Util::Io::File::Segment *segments, uint32_t segmentCount) = 0;
 
     virtual Util::Network::Datagram* receive() = 0;
 
+    /**
+     * Receive a datagram and scatter its payload into the given segments.
+     * Remote address and attributes are stored in the given datagram, whose buffer is left untouched.
+     * Payload, that does not fit into the segments, is discarded.
+     */
+    bool receive(Util::Network::Datagram &datagram, const Util::Io::File::Segment *segments, uint32_t segmentCount, uint32_t &length);
+
+    static uint32_t getPayloadLength(const Util::Io::File::Segment *segments, uint32_t segmentCount);
+
 protected:
 
     Util::Network::NetworkAddress *bindAddress{};
+    Util::Network::NetworkAddress *remoteAddress{};
     uint32_t timeout = 0;
 
 private:
 
+    static Util::Network::NetworkAddress* copyAddress(const Util::Network::NetworkAddress &address);
+
     NetworkModule &networkModule;
     Util::Network::Socket::Type type;
 };
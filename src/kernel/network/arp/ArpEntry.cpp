@@ -24,8 +24,8 @@
 
 namespace Kernel::Network::Arp {
 
-ArpEntry::ArpEntry(const Util::Network::Ip4::Ip4Address &protocolAddress, const Util::Network::MacAddress &hardwareAddress) :
-        protocolAddress(protocolAddress), hardwareAddress(hardwareAddress) {}
+ArpEntry::ArpEntry(const Util::Network::Ip4::Ip4Address &protocolAddress, const Util::Network::MacAddress &hardwareAddress, const Util::Time::Timestamp &expirationTime) :
+        protocolAddress(protocolAddress), hardwareAddress(hardwareAddress), expirationTime(expirationTime) {}
 
 const Util::Network::MacAddress& ArpEntry::getHardwareAddress() const {
     return hardwareAddress;
@@ -51,4 +51,20 @@ void ArpEntry::setProtocolAddress(const Util::Network::Ip4::Ip4Address &protocol
     ArpEntry::protocolAddress = protocolAddress;
 }
 
-}
\ No newline at end of file
+const Util::Time::Timestamp& ArpEntry::getExpirationTime() const {
+    return expirationTime;
+}
+
+void ArpEntry::setExpirationTime(const Util::Time::Timestamp &expirationTime) {
+    ArpEntry::expirationTime = expirationTime;
+}
+
+bool ArpEntry::isPermanent() const {
+    return expirationTime.toNanoseconds() == 0;
+}
+
+bool ArpEntry::isExpired(const Util::Time::Timestamp &now) const {
+    return !isPermanent() && now >= expirationTime;
+}
+
+}
@@ -23,6 +23,7 @@
 
 #include "lib/util/network/ip4/Ip4Address.h"
 #include "lib/util/network/MacAddress.h"
+#include "lib/util/time/Timestamp.h"
 
 namespace Kernel::Network::Arp {
 
@@ -36,8 +37,9 @@ public:
 
     /**
      * Constructor.
+     * An expiration time of zero creates a permanent entry (e.g. for the addresses of local interfaces).
      */
-    ArpEntry(const Util::Network::Ip4::Ip4Address &protocolAddress, const Util::Network::MacAddress &hardwareAddress);
+    ArpEntry(const Util::Network::Ip4::Ip4Address &protocolAddress, const Util::Network::MacAddress &hardwareAddress, const Util::Time::Timestamp &expirationTime = Util::Time::Timestamp());
 
     /**
      * Copy Constructor.
@@ -62,6 +64,14 @@ public:
 
     void setHardwareAddress(const Util::Network::MacAddress &hardwareAddress);
 
+    [[nodiscard]] const Util::Time::Timestamp& getExpirationTime() const;
+
+    void setExpirationTime(const Util::Time::Timestamp &expirationTime);
+
+    [[nodiscard]] bool isPermanent() const;
+
+    [[nodiscard]] bool isExpired(const Util::Time::Timestamp &now) const;
+
     bool operator!=(const ArpEntry &other) const;
 
     bool operator==(const ArpEntry &other) const;
@@ -70,6 +80,7 @@ private:
 
     Util::Network::Ip4::Ip4Address protocolAddress{};
     Util::Network::MacAddress hardwareAddress{};
+    Util::Time::Timestamp expirationTime{};
 };
 
 }
@@ -20,7 +20,12 @@
 
 #include "ArpModule.h"
 
-#include "lib/util/async/Thread.h"
+#include "ArpTimer.h"
+#include "lib/util/async/Atomic.h"
+#include "kernel/process/Thread.h"
+#include "kernel/process/Scheduler.h"
+#include "kernel/service/ProcessService.h"
+#include "kernel/service/Service.h"
 #include "device/network/NetworkDevice.h"
 #include "kernel/log/Log.h"
 #include "lib/util/base/Exception.h"
@@ -35,6 +40,7 @@
 #include "lib/util/network/ip4/Ip4Address.h"
 #include "kernel/network/ip4/Ip4Interface.h"
 #include "lib/util/collection/Iterator.h"
+#include "lib/util/base/String.h"
 
 namespace Util {
 namespace Io {
@@ -80,115 +86,294 @@ void ArpModule::readPacket(Util::Io::ByteArrayInputStream &stream, [[maybe_unuse
     }
 }
 
-bool ArpModule::resolveAddress(const Util::Network::Ip4::Ip4Address &protocolAddress, Util::Network::MacAddress &hardwareAddress, const Ip4::Ip4Interface &interface) {
-    for (uint32_t i = 0; i < MAX_REQUEST_RETRIES; i++) {
-        lock.acquire();
-        if (hasHardwareAddress(protocolAddress)) {
-            hardwareAddress = getHardwareAddress(protocolAddress);
-            return lock.releaseAndReturn(true);
+bool ArpModule::PendingPacket::operator==(const ArpModule::PendingPacket &other) const {
+    return buffer == other.buffer;
+}
+
+bool ArpModule::Request::operator==(const ArpModule::Request &other) const {
+    return protocolAddress == other.protocolAddress;
+}
+
+ArpModule::~ArpModule() {
+    for (auto *entry : arpCache.values()) {
+        delete entry;
+    }
+
+    for (auto *resolution : resolutions.values()) {
+        for (const auto &packet : resolution->packets) {
+            Device::Network::NetworkDevice::freeOutgoingPacketBuffer(packet.buffer);
         }
-        lock.release();
 
-        auto &device = interface.getDevice();
-        auto ipAddress = interface.getIp4Address();
-        auto packet = Util::Io::ByteArrayOutputStream();
-        writeHeader(packet, ArpHeader::REQUEST, interface.getDevice(), Util::Network::MacAddress::createBroadcastAddress());
+        delete resolution;
+    }
+}
 
-        device.getMacAddress().write(packet);
-        interface.getIp4Address().write(packet);
-        Util::Network::MacAddress().write(packet);
-        protocolAddress.write(packet);
+bool ArpModule::resolveAddress(const Util::Network::Ip4::Ip4Address &protocolAddress, Util::Network::MacAddress &hardwareAddress, const Ip4::Ip4Interface &interface) {
+    auto key = getKey(protocolAddress);
 
-        Ethernet::EthernetModule::finalizePacket(packet);
-        device.sendPacket(packet.getBuffer(), packet.getLength());
+    lock.acquire();
+    auto *entry = findEntry(key);
+    if (entry != nullptr) {
+        hardwareAddress = entry->getHardwareAddress();
+        return lock.releaseAndReturn(true);
+    }
 
-        Util::Async::Thread::sleep(Util::Time::Timestamp::ofMicroseconds(100));
+    // Only the first packet to an address triggers a request, further requests are sent by the timer
+    if (resolutions.containsKey(key)) {
+        return lock.releaseAndReturn(false);
     }
 
+    resolutions.put(key, new Resolution{protocolAddress, interface, Util::Time::getSystemTime(), 1, Util::ArrayList<PendingPacket>()});
+    startTimer();
+    lock.release();
+
+    sendRequest(protocolAddress, interface);
     return false;
 }
 
-void ArpModule::setEntry(const Util::Network::Ip4::Ip4Address &protocolAddress, const Util::Network::MacAddress &hardwareAddress) {
+void ArpModule::holdPacket(const uint8_t *packetBuffer, const Util::Network::Ip4::Ip4Address &protocolAddress) {
     lock.acquire();
-    for (auto &entry : arpCache) {
-        if (entry.getProtocolAddress() == protocolAddress) {
-            entry.setHardwareAddress(hardwareAddress);
-            lock.release();
-            return;
-        }
+    heldPackets.put(reinterpret_cast<uint32_t>(packetBuffer), getKey(protocolAddress));
+    Util::Async::Atomic<uint32_t>(heldPacketCount).inc();
+    lock.release();
+}
+
+bool ArpModule::queuePacket(uint8_t *packetBuffer, uint32_t length, uint16_t checksumStart, uint16_t checksumOffset) {
+    // Fast path for the common case, in which all destinations are resolved
+    if (Util::Async::Atomic<uint32_t>(heldPacketCount).get() == 0) {
+        return false;
+    }
+
+    lock.acquire();
+    auto bufferKey = reinterpret_cast<uint32_t>(packetBuffer);
+    if (!heldPackets.containsKey(bufferKey)) {
+        return lock.releaseAndReturn(false);
+    }
+
+    auto key = heldPackets.remove(bufferKey);
+    Util::Async::Atomic<uint32_t>(heldPacketCount).dec();
+
+    // The reply may have arrived, while the packet was being built
+    auto *entry = findEntry(key);
+    if (entry != nullptr) {
+        entry->getHardwareAddress().getAddress(packetBuffer);
+        return lock.releaseAndReturn(false);
+    }
+
+    if (!resolutions.containsKey(key)) {
+        // Resolution has failed in the meantime
+        lock.release();
+        Device::Network::NetworkDevice::freeOutgoingPacketBuffer(packetBuffer);
+        return true;
+    }
+
+    // Keep only the most recent packets, so that a flood of packets to an unreachable address does not exhaust the transmit buffers
+    auto *resolution = resolutions.get(key);
+    uint8_t *discardedBuffer = nullptr;
+    if (resolution->packets.size() >= MAX_PENDING_PACKETS) {
+        discardedBuffer = resolution->packets.removeIndex(0).buffer;
+    } else if (queuedPacketCount >= MAX_QUEUED_PACKETS) {
+        // Many unresolved addresses at once -> Drop the new packet, as if it was lost on the way
+        lock.release();
+        Device::Network::NetworkDevice::freeOutgoingPacketBuffer(packetBuffer);
+        return true;
+    } else {
+        queuedPacketCount++;
     }
 
-    arpCache.add(ArpEntry{protocolAddress, hardwareAddress});
+    resolution->packets.add(PendingPacket{packetBuffer, length, checksumStart, checksumOffset});
     lock.release();
+
+    if (discardedBuffer != nullptr) {
+        Device::Network::NetworkDevice::freeOutgoingPacketBuffer(discardedBuffer);
+    }
+
+    return true;
+}
+
+void ArpModule::setEntry(const Util::Network::Ip4::Ip4Address &protocolAddress, const Util::Network::MacAddress &hardwareAddress) {
+    learnEntry(protocolAddress, hardwareAddress, Util::Time::Timestamp());
 }
 
 void ArpModule::removeEntry(const Util::Network::Ip4::Ip4Address &protocolAddress) {
-    for (auto &entry : arpCache) {
-        if (entry.getProtocolAddress() == protocolAddress) {
-            arpCache.remove(entry);
-            break;
-        }
+    auto key = getKey(protocolAddress);
+
+    lock.acquire();
+    if (arpCache.containsKey(key)) {
+        delete arpCache.remove(key);
     }
 
     lock.release();
 }
 
-Util::Network::MacAddress ArpModule::getHardwareAddress(const Util::Network::Ip4::Ip4Address &protocolAddress) {
+bool ArpModule::handleTimers() {
+    auto now = Util::Time::getSystemTime();
+    auto failedResolutions = Util::ArrayList<Resolution*>();
+    auto requests = Util::ArrayList<Request>();
+
+    // Sending may have to wait for a free packet buffer -> Collect the requests and send them without holding the lock
     lock.acquire();
+    for (auto key : resolutions.keys()) {
+        auto *resolution = resolutions.get(key);
+        if ((now - resolution->lastRequestTime).toMilliseconds() < REQUEST_INTERVAL) {
+            continue;
+        }
 
-    for (const auto &entry : arpCache) {
-        if (entry.getProtocolAddress() == protocolAddress) {
-            return lock.releaseAndReturn(entry.getHardwareAddress());
+        if (resolution->requestCount >= MAX_REQUEST_RETRIES) {
+            resolutions.remove(key);
+            failedResolutions.add(resolution);
+            queuedPacketCount -= resolution->packets.size();
+            continue;
         }
+
+        resolution->requestCount++;
+        resolution->lastRequestTime = now;
+        requests.add(Request{resolution->protocolAddress, resolution->interface});
     }
 
+    auto unresolvedAddresses = resolutions.size() > 0;
     lock.release();
-    Util::Exception::throwException(Util::Exception::INVALID_ARGUMENT, "ArpModule: Protocol address not found!");
+
+    for (uint32_t i = 0; i < requests.size(); i++) {
+        const auto request = requests.get(i);
+        sendRequest(request.protocolAddress, request.interface);
+    }
+
+    for (auto *resolution : failedResolutions) {
+        auto addressString = resolution->protocolAddress.toString();
+        LOG_WARN("Discarding %u packets, because [%s] could not be resolved", resolution->packets.size(), static_cast<const char*>(addressString));
+
+        for (const auto &packet : resolution->packets) {
+            Device::Network::NetworkDevice::freeOutgoingPacketBuffer(packet.buffer);
+        }
+
+        delete resolution;
+    }
+
+    return unresolvedAddresses;
+}
+
+void ArpModule::startTimer() {
+    if (timer == nullptr) {
+        auto &processService = Service::getService<ProcessService>();
+        timer = new ArpTimer(*this);
+
+        auto &timerThread = Thread::createKernelThread("Arp-Timer", processService.getKernelProcess(), timer);
+        processService.getScheduler().ready(timerThread);
+    }
+
+    timerWaitQueue.wakeUp();
 }
 
-bool ArpModule::hasHardwareAddress(const Util::Network::Ip4::Ip4Address &protocolAddress) {
+void ArpModule::learnEntry(const Util::Network::Ip4::Ip4Address &protocolAddress, const Util::Network::MacAddress &hardwareAddress, const Util::Time::Timestamp &expirationTime) {
+    auto key = getKey(protocolAddress);
+
     lock.acquire();
+    if (arpCache.containsKey(key)) {
+        auto *entry = arpCache.get(key);
+        entry->setHardwareAddress(hardwareAddress);
 
-    for (const auto &entry : arpCache) {
-        if (entry.getProtocolAddress() == protocolAddress) {
-            return lock.releaseAndReturn(true);
+        // Learned addresses must not turn permanent entries into expiring ones
+        if (!entry->isPermanent() || expirationTime.toNanoseconds() == 0) {
+            entry->setExpirationTime(expirationTime);
         }
+    } else {
+        arpCache.put(key, new ArpEntry(protocolAddress, hardwareAddress, expirationTime));
+    }
+
+    auto *resolution = resolutions.containsKey(key) ? resolutions.remove(key) : nullptr;
+    if (resolution != nullptr) {
+        queuedPacketCount -= resolution->packets.size();
+    }
+
+    lock.release();
+
+    if (resolution != nullptr) {
+        sendPendingPackets(*resolution, hardwareAddress);
+        delete resolution;
+    }
+}
+
+ArpEntry* ArpModule::findEntry(uint32_t key) {
+    if (!arpCache.containsKey(key)) {
+        return nullptr;
+    }
+
+    auto *entry = arpCache.get(key);
+    if (entry->isExpired(Util::Time::getSystemTime())) {
+        arpCache.remove(key);
+        delete entry;
+        return nullptr;
+    }
+
+    return entry;
+}
+
+void ArpModule::sendRequest(const Util::Network::Ip4::Ip4Address &protocolAddress, const Ip4::Ip4Interface &interface) {
+    auto &device = interface.getDevice();
+    auto packet = Util::Io::ByteArrayOutputStream(Device::Network::NetworkDevice::allocatePacketBuffer(), Device::Network::NetworkDevice::PACKET_BUFFER_SIZE);
+    packet.setEnforceSizeLimit(true);
+    writeHeader(packet, ArpHeader::REQUEST, device, Util::Network::MacAddress::createBroadcastAddress());
+
+    device.getMacAddress().write(packet);
+    interface.getIp4Address().write(packet);
+    Util::Network::MacAddress().write(packet);
+    protocolAddress.write(packet);
+
+    Ethernet::EthernetModule::finalizePacket(packet);
+    device.sendPacket(packet.getBuffer(), packet.getLength());
+}
+
+void ArpModule::sendPendingPackets(const Resolution &resolution, const Util::Network::MacAddress &hardwareAddress) {
+    auto &device = resolution.interface.getDevice();
+    for (const auto &packet : resolution.packets) {
+        // The destination address is the first field of the ethernet header
+        hardwareAddress.getAddress(packet.buffer);
+        device.sendPacket(packet.buffer, packet.length, packet.checksumStart, packet.checksumOffset);
     }
+}
+
+uint32_t ArpModule::getKey(const Util::Network::Ip4::Ip4Address &address) {
+    uint8_t buffer[Util::Network::Ip4::Ip4Address::ADDRESS_LENGTH];
+    address.getAddress(buffer);
 
-    return lock.releaseAndReturn(false);
+    return buffer[0] << 24 | buffer[1] << 16 | buffer[2] << 8 | buffer[3];
 }
 
 void ArpModule::handleRequest(const Util::Network::MacAddress &sourceHardwareAddress, const Util::Network::Ip4::Ip4Address &sourceAddress,
                               const Util::Network::Ip4::Ip4Address &targetProtocolAddress, Device::Network::NetworkDevice &device) {
-    setEntry(sourceAddress, sourceHardwareAddress);
+    learnEntry(sourceAddress, sourceHardwareAddress, Util::Time::getSystemTime() + Util::Time::Timestamp::ofSeconds(ENTRY_LIFETIME));
 
+    // Only answer requests for local addresses, which are kept as permanent entries
     lock.acquire();
-    if (hasHardwareAddress(targetProtocolAddress)) {
-        auto targetHardwareAddress = getHardwareAddress(targetProtocolAddress);
+    auto *entry = findEntry(getKey(targetProtocolAddress));
+    if (entry == nullptr || !entry->isPermanent()) {
         lock.release();
+        return;
+    }
+    lock.release();
 
-        auto packet = Util::Io::ByteArrayOutputStream();
-        writeHeader(packet, ArpHeader::REPLY, device, targetHardwareAddress);
+    auto packet = Util::Io::ByteArrayOutputStream(Device::Network::NetworkDevice::allocatePacketBuffer(), Device::Network::NetworkDevice::PACKET_BUFFER_SIZE);
+    packet.setEnforceSizeLimit(true);
+    writeHeader(packet, ArpHeader::REPLY, device, sourceHardwareAddress);
 
-        device.getMacAddress().write(packet);
-        targetProtocolAddress.write(packet);
-        sourceHardwareAddress.write(packet);
-        sourceAddress.write(packet);
+    device.getMacAddress().write(packet);
+    targetProtocolAddress.write(packet);
+    sourceHardwareAddress.write(packet);
+    sourceAddress.write(packet);
 
-        Ethernet::EthernetModule::finalizePacket(packet);
-        device.sendPacket(packet.getBuffer(), packet.getLength());
-    } else {
-        lock.release();
-    }
+    Ethernet::EthernetModule::finalizePacket(packet);
+    device.sendPacket(packet.getBuffer(), packet.getLength());
 }
 
 void ArpModule::handleReply(const Util::Network::MacAddress &sourceHardwareAddress, const Util::Network::Ip4::Ip4Address &sourceAddress,
                             const Util::Network::MacAddress &targetHardwareAddress, const Util::Network::Ip4::Ip4Address &targetProtocolAddress) {
-    setEntry(sourceAddress, sourceHardwareAddress);
+    auto expirationTime = Util::Time::getSystemTime() + Util::Time::Timestamp::ofSeconds(ENTRY_LIFETIME);
+    learnEntry(sourceAddress, sourceHardwareAddress, expirationTime);
 
     //Learn own addresses if not broadcast
     if (!targetHardwareAddress.isBroadcastAddress()) {
-        setEntry(targetProtocolAddress, targetHardwareAddress);
+        learnEntry(targetProtocolAddress, targetHardwareAddress, expirationTime);
     }
 }
 
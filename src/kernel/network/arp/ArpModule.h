@@ -28,21 +28,17 @@
 #include "ArpHeader.h"
 #include "ArpEntry.h"
 #include "lib/util/collection/ArrayList.h"
+#include "lib/util/collection/HashMap.h"
 #include "lib/util/network/MacAddress.h"
+#include "lib/util/time/Timestamp.h"
+#include "kernel/network/ip4/Ip4Interface.h"
+#include "kernel/process/WaitQueue.h"
 
 namespace Device {
 namespace Network {
 class NetworkDevice;
 }  // namespace Network
 }  // namespace Device
-namespace Kernel {
-
-namespace Network {
-namespace Ip4 {
-class Ip4Interface;
-}  // namespace Ip4
-}  // namespace Network
-}  // namespace Kernel
 namespace Util {
 namespace Network {
 namespace Ip4 {
@@ -58,8 +54,18 @@ class OutputStream;
 
 namespace Kernel::Network::Arp {
 
+class ArpTimer;
+
+/**
+ * Resolves IPv4 addresses to MAC addresses without blocking the sending thread.
+ * Resolved addresses are kept in a hashed cache, in which learned entries expire after ENTRY_LIFETIME.
+ * Packets to an unresolved address are queued per destination (limited per destination and in total) and sent, as soon as the reply arrives.
+ * Requests are repeated by a kernel thread, which is started with the first resolution and sleeps, while no addresses are unresolved.
+ */
 class ArpModule : public NetworkModule {
 
+friend class ArpTimer;
+
 public:
     /**
      * Default Constructor.
@@ -79,33 +85,112 @@ public:
     /**
      * Destructor.
      */
-    ~ArpModule() = default;
+    ~ArpModule();
 
     void readPacket(Util::Io::ByteArrayInputStream &stream, LayerInformation information, Device::Network::NetworkDevice &device) override;
 
+    /**
+     * Look up the hardware address of the given protocol address in the cache. This function never blocks:
+     * If the address is unknown, a request is sent via the given interface and false is returned.
+     */
     bool resolveAddress(const Util::Network::Ip4::Ip4Address &protocolAddress, Util::Network::MacAddress &hardwareAddress, const Kernel::Network::Ip4::Ip4Interface &interface);
 
+    /**
+     * Mark a packet, which is being built inside the given buffer, as waiting for the given protocol address
+     * (after resolveAddress() has returned false for it). Its destination hardware address is filled in later.
+     */
+    void holdPacket(const uint8_t *packetBuffer, const Util::Network::Ip4::Ip4Address &protocolAddress);
+
+    /**
+     * Called for every complete IPv4 packet before it is sent. If the packet has been marked via holdPacket(),
+     * it is either completed with the meanwhile resolved hardware address, or queued until the reply arrives.
+     *
+     * @return true, if the packet has been taken over (queued or discarded) and must not be sent by the caller
+     */
+    bool queuePacket(uint8_t *packetBuffer, uint32_t length, uint16_t checksumStart, uint16_t checksumOffset);
+
     static void writeHeader(Util::Io::OutputStream &stream, ArpHeader::Operation operation, Device::Network::NetworkDevice &device, const Util::Network::MacAddress &destinationAddress);
 
+    /**
+     * Add a permanent entry (e.g. for the address of a local interface).
+     */
     void setEntry(const Util::Network::Ip4::Ip4Address &protocolAddress, const Util::Network::MacAddress &hardwareAddress);
 
     void removeEntry(const Util::Network::Ip4::Ip4Address &protocolAddress);
 
 private:
 
-    Util::Network::MacAddress getHardwareAddress(const Util::Network::Ip4::Ip4Address &protocolAddress);
+    struct PendingPacket {
+        uint8_t *buffer;
+        uint32_t length;
+        uint16_t checksumStart;
+        uint16_t checksumOffset;
 
-    bool hasHardwareAddress(const Util::Network::Ip4::Ip4Address &protocolAddress);
+        bool operator==(const PendingPacket &other) const;
+    };
+
+    /**
+     * A request to be repeated by the timer, which is sent after releasing the lock.
+     */
+    struct Request {
+        Util::Network::Ip4::Ip4Address protocolAddress;
+        Kernel::Network::Ip4::Ip4Interface interface;
+
+        bool operator==(const Request &other) const;
+    };
+
+    /**
+     * An address, for which requests have been sent, but no reply has been received yet.
+     */
+    struct Resolution {
+        Util::Network::Ip4::Ip4Address protocolAddress;
+        Kernel::Network::Ip4::Ip4Interface interface;
+        Util::Time::Timestamp lastRequestTime;
+        uint32_t requestCount;
+        Util::ArrayList<PendingPacket> packets;
+    };
+
+    /**
+     * Retry requests for all unresolved addresses and discard the packets of addresses, which could not be resolved.
+     *
+     * @return true, if there are unresolved addresses left
+     */
+    bool handleTimers();
+
+    void startTimer();
+
+    void learnEntry(const Util::Network::Ip4::Ip4Address &protocolAddress, const Util::Network::MacAddress &hardwareAddress, const Util::Time::Timestamp &expirationTime);
+
+    ArpEntry* findEntry(uint32_t key);
+
+    static void sendRequest(const Util::Network::Ip4::Ip4Address &protocolAddress, const Kernel::Network::Ip4::Ip4Interface &interface);
+
+    static void sendPendingPackets(const Resolution &resolution, const Util::Network::MacAddress &hardwareAddress);
+
+    static uint32_t getKey(const Util::Network::Ip4::Ip4Address &address);
 
     void handleRequest(const Util::Network::MacAddress &sourceHardwareAddress, const Util::Network::Ip4::Ip4Address &sourceAddress, const Util::Network::Ip4::Ip4Address &targetProtocolAddress, Device::Network::NetworkDevice &device);
 
     void handleReply(const Util::Network::MacAddress &sourceHardwareAddress, const Util::Network::Ip4::Ip4Address &sourceAddress, const Util::Network::MacAddress &targetHardwareAddress, const Util::Network::Ip4::Ip4Address &targetProtocolAddress);
 
     Util::Async::ReentrantSpinlock lock;
-    Util::ArrayList<ArpEntry> arpCache;
-
-    static const constexpr uint32_t REQUEST_WAIT_TIME = 100;
-    static const constexpr uint32_t MAX_REQUEST_RETRIES = 10;
+    Util::HashMap<uint32_t, ArpEntry*> arpCache;
+    Util::HashMap<uint32_t, Resolution*> resolutions;
+    // Maps the addresses of packet buffers, marked via holdPacket(), to the key of their protocol address
+    Util::HashMap<uint32_t, uint32_t> heldPackets;
+    uint32_t heldPacketCount = 0;
+    // Amount of packets queued in all resolutions, each of them pinning a buffer of the shared outgoing packet pool
+    uint32_t queuedPacketCount = 0;
+
+    ArpTimer *timer = nullptr;
+    WaitQueue timerWaitQueue;
+
+    static const constexpr uint32_t REQUEST_INTERVAL = 500;
+    static const constexpr uint32_t MAX_REQUEST_RETRIES = 5;
+    static const constexpr uint32_t MAX_PENDING_PACKETS = 4;
+    // Well below the 64 buffers of the outgoing packet pool, so that sending (e.g. ARP requests) never runs out of buffers
+    static const constexpr uint32_t MAX_QUEUED_PACKETS = 16;
+    static const constexpr uint32_t ENTRY_LIFETIME = 300;
 };
 
 }
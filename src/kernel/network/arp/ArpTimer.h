@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef HHUOS_ARPTIMER_H
+#define HHUOS_ARPTIMER_H
+
+#include <stdint.h>
+
+#include "lib/util/async/Runnable.h"
+
+namespace Kernel::Network::Arp {
+
+class ArpModule;
+
+/**
+ * Repeats ARP requests for unresolved addresses and gives up on them after ArpModule::MAX_REQUEST_RETRIES attempts.
+ */
+class ArpTimer : public Util::Async::Runnable {
+
+public:
+    /**
+     * Constructor.
+     */
+    explicit ArpTimer(ArpModule &arpModule);
+
+    /**
+     * Copy Constructor.
+     */
+    ArpTimer(const ArpTimer &other) = delete;
+
+    /**
+     * Assignment operator.
+     */
+    ArpTimer &operator=(const ArpTimer &other) = delete;
+
+    /**
+     * Destructor.
+     */
+    ~ArpTimer() override = default;
+
+    void run() override;
+
+private:
+
+    ArpModule &arpModule;
+
+    static const constexpr uint32_t INTERVAL = 100;
+};
+
+}
+
+#endif
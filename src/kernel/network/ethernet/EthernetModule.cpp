@@ -34,6 +34,7 @@
 #include "lib/util/network/NetworkAddress.h"
 #include "kernel/network/Socket.h"
 #include "kernel/network/ethernet/EthernetSocket.h"
+#include "lib/util/network/Checksum.h"
 
 namespace Util {
 namespace Io {
@@ -43,12 +44,14 @@ class OutputStream;
 
 namespace Kernel::Network::Ethernet {
 
-bool EthernetModule::checkPacket([[maybe_unused]] const uint8_t *packet, [[maybe_unused]] uint32_t length) {
-    // TODO: Uncomment once checksum calculation is implemented;
-    // uint32_t frameCheckSequence = (packet[length - 4] << 24) | (packet[length - 3] << 16) | (packet[length - 2] << 8) | packet[length - 1];
-    // uint32_t calculatedCheckSequence = calculateCheckSequence(packet, length - 4);
-    // return frameCheckSequence == calculatedCheckSequence;
-    return true;
+bool EthernetModule::checkPacket(const uint8_t *packet, uint32_t length) {
+    if (length < MINIMUM_PACKET_SIZE) {
+        return false;
+    }
+
+    // The frame check sequence is transmitted least significant byte first
+    uint32_t frameCheckSequence = packet[length - 4] | (packet[length - 3] << 8) | (packet[length - 2] << 16) | (packet[length - 1] << 24);
+    return frameCheckSequence == calculateCheckSequence(packet, length - 4);
 }
 
 void EthernetModule::readPacket(Util::Io::ByteArrayInputStream &stream, LayerInformation information, Device::Network::NetworkDevice &device) {
@@ -74,12 +77,11 @@ void EthernetModule::readPacket(Util::Io::ByteArrayInputStream &stream, LayerInf
     }
     socketLock.release();
 
-    invokeNextLayerModule(header.getEtherType(), {header.getSourceAddress(), header.getDestinationAddress(), payloadLength}, stream, device);
+    invokeNextLayerModule(header.getEtherType(), {header.getSourceAddress(), header.getDestinationAddress(), payloadLength, information.checksumVerified}, stream, device);
 }
 
-uint32_t EthernetModule::calculateCheckSequence([[maybe_unused]] const uint8_t *packet, [[maybe_unused]] uint32_t length) {
-    // TODO: Calculate check sequence
-    return 0;
+uint32_t EthernetModule::calculateCheckSequence(const uint8_t *packet, uint32_t length) {
+    return Util::Network::Checksum::calculateCrc32(packet, length);
 }
 
 void EthernetModule::writeHeader(Util::Io::OutputStream &stream, Device::Network::NetworkDevice &device, const Util::Network::MacAddress &destinationAddress, Util::Network::Ethernet::EthernetHeader::EtherType etherType) {
@@ -68,6 +68,9 @@ public:
      */
     ~EthernetModule() = default;
 
+    /**
+     * Verify the frame check sequence at the end of a received frame.
+     */
     static bool checkPacket(const uint8_t *packet, uint32_t length);
 
     static uint32_t calculateCheckSequence(const uint8_t *packet, uint32_t length);
@@ -45,13 +45,17 @@ EthernetSocket::~EthernetSocket() {
     ethernetModule.deregisterSocket(*this);
 }
 
-bool EthernetSocket::send(const Util::Network::Datagram &datagram) {
+bool EthernetSocket::send(const Util::Network::Datagram &datagram, const Util::Io::File::Segment *segments, uint32_t segmentCount) {
     auto &networkService = Service::getService<NetworkService>();
     auto &device = networkService.getNetworkDevice(reinterpret_cast<const Util::Network::MacAddress&>(getAddress()));
-    auto packet = Util::Io::ByteArrayOutputStream();
+    auto packet = Util::Io::ByteArrayOutputStream(Device::Network::NetworkDevice::allocatePacketBuffer(), Device::Network::NetworkDevice::PACKET_BUFFER_SIZE);
+    packet.setEnforceSizeLimit(true);
 
     EthernetModule::writeHeader(packet, device, reinterpret_cast<const Util::Network::MacAddress &>(datagram.getRemoteAddress()), reinterpret_cast<const Util::Network::Ethernet::EthernetDatagram&>(datagram).getEtherType());
-    packet.write(datagram.getData(), 0, datagram.getLength());
+    for (uint32_t i = 0; i < segmentCount; i++) {
+        packet.write(segments[i].buffer, 0, segments[i].length);
+    }
+
     EthernetModule::finalizePacket(packet);
 
     device.sendPacket(packet.getBuffer(), packet.getPosition());
@@ -54,7 +54,7 @@ public:
      */
     ~EthernetSocket() override;
 
-    bool send(const Util::Network::Datagram &datagram) override;
+    bool send(const Util::Network::Datagram &datagram, const Util::Io::File::Segment *segments, uint32_t segmentCount) override;
 };
 
 }
@@ -39,10 +39,17 @@
 #include "kernel/network/ip4/Ip4Interface.h"
 #include "kernel/network/ip4/Ip4Module.h"
 #include "lib/util/network/ip4/Ip4Address.h"
+#include "lib/util/network/Checksum.h"
+#include "lib/util/collection/Array.h"
 
 namespace Kernel::Network::Icmp {
 
 void IcmpModule::readPacket(Util::Io::ByteArrayInputStream &stream, LayerInformation information, [[maybe_unused]] Device::Network::NetworkDevice &device) {
+    if (information.payloadLength < Util::Network::Icmp::IcmpHeader::HEADER_LENGTH) {
+        LOG_WARN("Discarding packet, because it is too short");
+        return;
+    }
+
     auto *buffer = stream.getBuffer() + stream.getPosition();
     auto calculatedChecksum = Ip4::Ip4Module::calculateChecksum(buffer, Util::Network::Icmp::IcmpHeader::CHECKSUM_OFFSET, information.payloadLength);
     auto receivedChecksum = (buffer[Util::Network::Icmp::IcmpHeader::CHECKSUM_OFFSET] << 8) | buffer[Util::Network::Icmp::IcmpHeader::CHECKSUM_OFFSET + 1];
@@ -63,7 +70,7 @@ void IcmpModule::readPacket(Util::Io::ByteArrayInputStream &stream, LayerInforma
             auto payloadLength = information.payloadLength - Util::Network::Icmp::IcmpHeader::HEADER_LENGTH - Util::Network::Icmp::EchoHeader::HEADER_LENGTH;
             auto requestHeader = Util::Network::Icmp::EchoHeader();
             requestHeader.read(stream);
-            sendEchoReply(destinationAddress, sourceAddress, requestHeader, stream.getBuffer() + stream.getPosition(), payloadLength);
+            sendEchoReply(destinationAddress, sourceAddress, header, requestHeader, stream.getBuffer() + stream.getPosition(), payloadLength);
             break;
         }
         default: {
@@ -84,8 +91,26 @@ void IcmpModule::readPacket(Util::Io::ByteArrayInputStream &stream, LayerInforma
 
 void IcmpModule::writePacket(Util::Network::Icmp::IcmpHeader::Type type, uint8_t code, const Util::Network::Ip4::Ip4Address &sourceAddress,
                              const Util::Network::Ip4::Ip4Address &destinationAddress, const uint8_t *buffer, uint16_t length) {
-    auto packet = Util::Io::ByteArrayOutputStream();
-    auto datagramLength = length + Util::Network::Icmp::IcmpHeader::HEADER_LENGTH;
+    const Util::Io::File::Segment segment = { const_cast<uint8_t*>(buffer), length };
+    writePacket(type, code, sourceAddress, destinationAddress, &segment, 1);
+}
+
+void IcmpModule::writePacket(Util::Network::Icmp::IcmpHeader::Type type, uint8_t code, const Util::Network::Ip4::Ip4Address &sourceAddress,
+                             const Util::Network::Ip4::Ip4Address &destinationAddress, const Util::Io::File::Segment *segments, uint32_t segmentCount) {
+    writePacket(type, code, sourceAddress, destinationAddress, segments, segmentCount, nullptr);
+}
+
+void IcmpModule::writePacket(Util::Network::Icmp::IcmpHeader::Type type, uint8_t code, const Util::Network::Ip4::Ip4Address &sourceAddress,
+                             const Util::Network::Ip4::Ip4Address &destinationAddress, const Util::Io::File::Segment *segments, uint32_t segmentCount,
+                             const uint16_t *checksum) {
+    auto datagramLength = Socket::getPayloadLength(segments, segmentCount) + Util::Network::Icmp::IcmpHeader::HEADER_LENGTH;
+    if (datagramLength > Ip4::Ip4Module::MAX_FRAGMENT_PAYLOAD_LENGTH) {
+        writeFragmentedPacket(type, code, sourceAddress, destinationAddress, segments, segmentCount, checksum);
+        return;
+    }
+
+    auto packet = Util::Io::ByteArrayOutputStream(Device::Network::NetworkDevice::allocatePacketBuffer(), Device::Network::NetworkDevice::PACKET_BUFFER_SIZE);
+    packet.setEnforceSizeLimit(true);
 
     // Write IPv4 and Ethernet headers
     auto sourceInterface = Ip4::Ip4Module::writeHeader(packet, sourceAddress, destinationAddress, Util::Network::Ip4::Ip4Header::ICMP, datagramLength);
@@ -98,32 +123,67 @@ void IcmpModule::writePacket(Util::Network::Icmp::IcmpHeader::Type type, uint8_t
     auto positionAfterHeaders = packet.getPosition();
 
     // Write packet
-    packet.write(buffer, 0, length);
+    for (uint32_t i = 0; i < segmentCount; i++) {
+        packet.write(segments[i].buffer, 0, segments[i].length);
+    }
 
-    // Calculate and write checksum
+    // Calculate and write checksum, if it is not known already
     auto *datagramBuffer = packet.getBuffer() + packet.getPosition() - datagramLength;
-    auto checksum = Ip4::Ip4Module::calculateChecksum(datagramBuffer, Util::Network::Icmp::IcmpHeader::CHECKSUM_OFFSET, datagramLength);
+    auto datagramChecksum = checksum != nullptr ? *checksum : Ip4::Ip4Module::calculateChecksum(datagramBuffer, Util::Network::Icmp::IcmpHeader::CHECKSUM_OFFSET, datagramLength);
 
     auto *checksumPointer = packet.getBuffer() + (positionAfterHeaders - sizeof(uint16_t));
-    checksumPointer[0] = checksum >> 8;
-    checksumPointer[1] = checksum;
+    checksumPointer[0] = datagramChecksum >> 8;
+    checksumPointer[1] = datagramChecksum;
 
     // Finalize and send packet
     Ethernet::EthernetModule::finalizePacket(packet);
-    sourceInterface.getDevice().sendPacket(packet.getBuffer(), packet.getLength());
+    Ip4::Ip4Module::sendPacket(sourceInterface, packet.getBuffer(), packet.getLength());
+}
+
+void IcmpModule::writeFragmentedPacket(Util::Network::Icmp::IcmpHeader::Type type, uint8_t code, const Util::Network::Ip4::Ip4Address &sourceAddress,
+                                       const Util::Network::Ip4::Ip4Address &destinationAddress, const Util::Io::File::Segment *segments, uint32_t segmentCount,
+                                       const uint16_t *checksum) {
+    uint8_t headerBuffer[Util::Network::Icmp::IcmpHeader::HEADER_LENGTH];
+    auto headerStream = Util::Io::ByteArrayOutputStream(headerBuffer, sizeof(headerBuffer));
+    auto header = Util::Network::Icmp::IcmpHeader();
+    header.setType(type);
+    header.setCode(code);
+    header.write(headerStream);
+
+    // ICMP has no pseudo header, so an unknown checksum is completed over the datagram, starting with an empty checksum field
+    if (checksum != nullptr) {
+        headerBuffer[Util::Network::Icmp::IcmpHeader::CHECKSUM_OFFSET] = *checksum >> 8;
+        headerBuffer[Util::Network::Icmp::IcmpHeader::CHECKSUM_OFFSET + 1] = *checksum;
+    }
+
+    auto datagramSegments = Util::Array<Util::Io::File::Segment>(segmentCount + 1);
+    datagramSegments[0] = { headerBuffer, sizeof(headerBuffer) };
+    for (uint32_t i = 0; i < segmentCount; i++) {
+        datagramSegments[i + 1] = segments[i];
+    }
+
+    Ip4::Ip4Module::sendFragments(sourceAddress, destinationAddress, Util::Network::Ip4::Ip4Header::ICMP, &datagramSegments[0], datagramSegments.length(),
+                                  checksum == nullptr ? Util::Network::Icmp::IcmpHeader::CHECKSUM_OFFSET : 0);
 }
 
 void IcmpModule::sendEchoReply(const Util::Network::Ip4::Ip4Address &sourceAddress, const Util::Network::Ip4::Ip4Address &destinationAddress,
-                               const Util::Network::Icmp::EchoHeader &requestHeader, const uint8_t *buffer, uint16_t length) {
-    auto packet = Util::Io::ByteArrayOutputStream();
+                               const Util::Network::Icmp::IcmpHeader &icmpHeader, const Util::Network::Icmp::EchoHeader &requestHeader,
+                               const uint8_t *buffer, uint16_t length) {
+    uint8_t headerBuffer[Util::Network::Icmp::EchoHeader::HEADER_LENGTH];
+    auto headerStream = Util::Io::ByteArrayOutputStream(headerBuffer, sizeof(headerBuffer));
     auto replyHeader = Util::Network::Icmp::EchoHeader();
     replyHeader.setIdentifier(requestHeader.getIdentifier());
     replyHeader.setSequenceNumber(requestHeader.getSequenceNumber());
+    replyHeader.write(headerStream);
 
-    replyHeader.write(packet);
-    packet.write(buffer, 0, length);
+    // The reply only differs from the request in type and code, so its checksum is derived from the request's checksum,
+    // instead of summing up the whole payload again (RFC 1624)
+    auto checksum = Util::Network::Checksum::update(icmpHeader.getChecksum(), (Util::Network::Icmp::IcmpHeader::ECHO_REQUEST << 8) | icmpHeader.getCode(),
+                                                    Util::Network::Icmp::IcmpHeader::ECHO_REPLY << 8);
 
-    writePacket(Util::Network::Icmp::IcmpHeader::ECHO_REPLY, 0, sourceAddress, destinationAddress, packet.getBuffer(), packet.getLength());
+    // Echo the request's payload straight from the received packet
+    const Util::Io::File::Segment segments[2] = {{ headerBuffer, sizeof(headerBuffer) }, { const_cast<uint8_t*>(buffer), length }};
+    writePacket(Util::Network::Icmp::IcmpHeader::ECHO_REPLY, 0, sourceAddress, destinationAddress, segments, 2, &checksum);
 }
 
 }
\ No newline at end of file
@@ -24,6 +24,7 @@
 #include <stdint.h>
 
 #include "kernel/network/NetworkModule.h"
+#include "lib/util/io/file/File.h"
 #include "lib/util/network/icmp/IcmpHeader.h"
 
 namespace Device {
@@ -77,8 +78,27 @@ public:
     static void writePacket(Util::Network::Icmp::IcmpHeader::Type type, uint8_t code, const Util::Network::Ip4::Ip4Address &sourceAddress,
                             const Util::Network::Ip4::Ip4Address &destinationAddress, const uint8_t *buffer, uint16_t length);
 
+    static void writePacket(Util::Network::Icmp::IcmpHeader::Type type, uint8_t code, const Util::Network::Ip4::Ip4Address &sourceAddress,
+                            const Util::Network::Ip4::Ip4Address &destinationAddress, const Util::Io::File::Segment *segments, uint32_t segmentCount);
+
     static void sendEchoReply(const Util::Network::Ip4::Ip4Address &sourceAddress, const Util::Network::Ip4::Ip4Address &destinationAddress,
-                  const Util::Network::Icmp::EchoHeader &requestHeader, const uint8_t *buffer, uint16_t length);
+                  const Util::Network::Icmp::IcmpHeader &icmpHeader, const Util::Network::Icmp::EchoHeader &requestHeader, const uint8_t *buffer, uint16_t length);
+
+private:
+
+    /**
+     * Write and send a packet. If 'checksum' is set, it is used instead of calculating the checksum over the whole datagram.
+     */
+    static void writePacket(Util::Network::Icmp::IcmpHeader::Type type, uint8_t code, const Util::Network::Ip4::Ip4Address &sourceAddress,
+                            const Util::Network::Ip4::Ip4Address &destinationAddress, const Util::Io::File::Segment *segments, uint32_t segmentCount,
+                            const uint16_t *checksum);
+
+    /**
+     * Send a datagram, which is too large for a single packet, as multiple IPv4 fragments.
+     */
+    static void writeFragmentedPacket(Util::Network::Icmp::IcmpHeader::Type type, uint8_t code, const Util::Network::Ip4::Ip4Address &sourceAddress,
+                                      const Util::Network::Ip4::Ip4Address &destinationAddress, const Util::Io::File::Segment *segments, uint32_t segmentCount,
+                                      const uint16_t *checksum);
 };
 
 }
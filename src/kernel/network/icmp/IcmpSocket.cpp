@@ -24,6 +24,7 @@
 #include "IcmpSocket.h"
 #include "kernel/network/NetworkStack.h"
 #include "kernel/network/icmp/IcmpModule.h"
+#include "kernel/network/ip4/Ip4Module.h"
 #include "lib/util/network/Socket.h"
 #include "kernel/service/Service.h"
 
@@ -46,11 +47,15 @@ IcmpSocket::~IcmpSocket() {
     icmpModule.deregisterSocket(*this);
 }
 
-bool IcmpSocket::send(const Util::Network::Datagram &datagram) {
+bool IcmpSocket::send(const Util::Network::Datagram &datagram, const Util::Io::File::Segment *segments, uint32_t segmentCount) {
     const auto &icmpDatagram = reinterpret_cast<const Util::Network::Icmp::IcmpDatagram&>(datagram);
     const auto &sourceAddress = reinterpret_cast<const Util::Network::Ip4::Ip4Address&>(*bindAddress);
     const auto &destinationAddress = reinterpret_cast<const Util::Network::Ip4::Ip4Address&>(icmpDatagram.getRemoteAddress());
-    IcmpModule::writePacket(icmpDatagram.getType(), icmpDatagram.getCode(), sourceAddress, destinationAddress, icmpDatagram.getData(), icmpDatagram.getLength());
+    if (getPayloadLength(segments, segmentCount) + Util::Network::Icmp::IcmpHeader::HEADER_LENGTH > Ip4::Ip4Module::MAX_DATAGRAM_LENGTH) {
+        return false;
+    }
+
+    IcmpModule::writePacket(icmpDatagram.getType(), icmpDatagram.getCode(), sourceAddress, destinationAddress, segments, segmentCount);
     return true;
 }
 
@@ -44,10 +44,12 @@
 #include "lib/util/network/ip4/Ip4SubnetAddress.h"
 #include "lib/util/collection/Iterator.h"
 #include "kernel/service/Service.h"
+#include "lib/util/network/Checksum.h"
+#include "lib/util/async/Atomic.h"
 
 namespace Kernel::Network::Ip4 {
 
-void Ip4Module::readPacket(Util::Io::ByteArrayInputStream &stream, [[maybe_unused]] LayerInformation information, Device::Network::NetworkDevice &device) {
+void Ip4Module::readPacket(Util::Io::ByteArrayInputStream &stream, LayerInformation information, Device::Network::NetworkDevice &device) {
     auto &tmpStream = reinterpret_cast<Util::Io::ByteArrayInputStream&>(stream);
     auto *buffer = tmpStream.getBuffer() + tmpStream.getPosition();
     uint8_t headerLength = (buffer[0] & 0x0f) * sizeof(uint32_t);
@@ -71,12 +73,32 @@ void Ip4Module::readPacket(Util::Io::ByteArrayInputStream &stream, [[maybe_unuse
         LOG_WARN("Discarding packet, because its time to live has expired");
     }
 
-    if (getTargetInterfaces(header.getDestinationAddress()).length() == 0) {
+    if (!isLocalAddress(header.getDestinationAddress())) {
         LOG_WARN("Discarding packet, because of wrong destination address!");
         return;
     }
 
-    auto payloadLength = header.getPayloadLength();
+    if (header.getHeaderLength() + header.getPayloadLength() > information.payloadLength) {
+        LOG_WARN("Discarding packet, because it is truncated");
+        return;
+    }
+
+    if (!header.isFragment()) {
+        handleDatagram(header, header.getPayloadLength(), stream, information.checksumVerified, device);
+        return;
+    }
+
+    // Devices only verify checksums of whole datagrams, so the reassembled datagram's checksum is always checked in software
+    uint16_t datagramLength;
+    auto *datagram = reassemblyModule.addFragment(header, stream.getBuffer() + stream.getPosition(), datagramLength);
+    if (datagram != nullptr) {
+        auto datagramStream = Util::Io::ByteArrayInputStream(datagram, datagramLength);
+        handleDatagram(header, datagramLength, datagramStream, false, device);
+        delete[] datagram;
+    }
+}
+
+void Ip4Module::handleDatagram(const Util::Network::Ip4::Ip4Header &header, uint16_t payloadLength, Util::Io::ByteArrayInputStream &stream, bool checksumVerified, Device::Network::NetworkDevice &device) {
     auto *datagramBuffer = stream.getBuffer() + stream.getPosition();
 
     socketLock.acquire();
@@ -88,19 +110,26 @@ void Ip4Module::readPacket(Util::Io::ByteArrayInputStream &stream, [[maybe_unuse
     }
     socketLock.release();
 
-    invokeNextLayerModule(header.getProtocol(), {header.getSourceAddress(), header.getDestinationAddress(), header.getPayloadLength()}, stream, device);
+    invokeNextLayerModule(header.getProtocol(), {header.getSourceAddress(), header.getDestinationAddress(), payloadLength, checksumVerified}, stream, device);
 }
 
 Ip4Interface Ip4Module::writeHeader(Util::Io::ByteArrayOutputStream &stream, const Util::Network::Ip4::Ip4Address &sourceAddress, const Util::Network::Ip4::Ip4Address &destinationAddress, Util::Network::Ip4::Ip4Header::Protocol protocol, uint16_t payloadLength) {
+    return writeHeader(stream, sourceAddress, destinationAddress, protocol, payloadLength, 0, 0, false);
+}
+
+Ip4Interface Ip4Module::writeHeader(Util::Io::ByteArrayOutputStream &stream, const Util::Network::Ip4::Ip4Address &sourceAddress, const Util::Network::Ip4::Ip4Address &destinationAddress, Util::Network::Ip4::Ip4Header::Protocol protocol,
+                                    uint16_t payloadLength, uint16_t identification, uint16_t fragmentOffset, bool moreFragments) {
     auto &networkService = Kernel::Service::getService<Kernel::NetworkService>();
     auto &arpModule = networkService.getNetworkStack().getArpModule();
     auto &ip4Module = networkService.getNetworkStack().getIp4Module();
     auto route = ip4Module.routingModule.findRoute(sourceAddress, destinationAddress);
-    auto interface = ip4Module.getTargetInterfaces(route.getSourceAddress())[0];
+    auto interface = ip4Module.getInterface(route.getSourceAddress());
 
+    // Never wait for address resolution -> Leave the destination empty and let the ARP module complete the packet later
+    auto &nextHop = route.hasNextHop() ? route.getNextHop() : destinationAddress;
     auto destinationMacAddress = Util::Network::MacAddress();
-    if (!arpModule.resolveAddress(route.hasNextHop() ? route.getNextHop() : destinationAddress, destinationMacAddress, interface)) {
-        Util::Exception::throwException(Util::Exception::INVALID_ARGUMENT, "Discarding packet, because the destination IPv4 address could not be resolved");
+    if (!arpModule.resolveAddress(nextHop, destinationMacAddress, interface)) {
+        arpModule.holdPacket(stream.getBuffer(), nextHop);
     }
 
     Ethernet::EthernetModule::writeHeader(stream, interface.getDevice(), destinationMacAddress, Util::Network::Ethernet::EthernetHeader::IP4);
@@ -110,6 +139,9 @@ Ip4Interface Ip4Module::writeHeader(Util::Io::ByteArrayOutputStream &stream, con
     header.setDestinationAddress(destinationAddress);
     header.setProtocol(protocol);
     header.setPayloadLength(payloadLength);
+    header.setIdentification(identification);
+    header.setFragmentOffset(fragmentOffset);
+    header.setMoreFragments(moreFragments);
     header.setTimeToLive(64);
     header.write(stream);
 
@@ -122,6 +154,70 @@ Ip4Interface Ip4Module::writeHeader(Util::Io::ByteArrayOutputStream &stream, con
     return interface;
 }
 
+void Ip4Module::sendPacket(const Ip4Interface &interface, uint8_t *packetBuffer, uint32_t length, uint16_t checksumStart, uint16_t checksumOffset) {
+    auto &arpModule = Kernel::Service::getService<Kernel::NetworkService>().getNetworkStack().getArpModule();
+    if (!arpModule.queuePacket(packetBuffer, length, checksumStart, checksumOffset)) {
+        interface.getDevice().sendPacket(packetBuffer, length, checksumStart, checksumOffset);
+    }
+}
+
+void Ip4Module::sendFragments(const Util::Network::Ip4::Ip4Address &sourceAddress, const Util::Network::Ip4::Ip4Address &destinationAddress, Util::Network::Ip4::Ip4Header::Protocol protocol,
+                              const Util::Io::File::Segment *segments, uint32_t segmentCount, uint16_t checksumOffset) {
+    auto &ip4Module = Kernel::Service::getService<Kernel::NetworkService>().getNetworkStack().getIp4Module();
+    auto identification = static_cast<uint16_t>(Util::Async::Atomic<uint32_t>(ip4Module.identification).fetchAndInc());
+    auto datagramLength = Socket::getPayloadLength(segments, segmentCount);
+    auto fragmentCount = (datagramLength + MAX_FRAGMENT_PAYLOAD_LENGTH - 1) / MAX_FRAGMENT_PAYLOAD_LENGTH;
+    uint16_t checksumSum = 0;
+
+    // Fragments are sent in reverse order, so that the checksum is complete, when the first fragment (containing the checksum field) is written.
+    // This way, only one packet buffer is needed at a time and the receiver learns the datagram's length with the first fragment it gets.
+    for (uint32_t i = fragmentCount; i > 0; i--) {
+        auto fragmentOffset = (i - 1) * MAX_FRAGMENT_PAYLOAD_LENGTH;
+        auto fragmentLength = datagramLength - fragmentOffset > MAX_FRAGMENT_PAYLOAD_LENGTH ? MAX_FRAGMENT_PAYLOAD_LENGTH : datagramLength - fragmentOffset;
+
+        auto packet = Util::Io::ByteArrayOutputStream(Device::Network::NetworkDevice::allocatePacketBuffer(), Device::Network::NetworkDevice::PACKET_BUFFER_SIZE);
+        packet.setEnforceSizeLimit(true);
+        auto interface = writeHeader(packet, sourceAddress, destinationAddress, protocol, fragmentLength, identification, fragmentOffset, i < fragmentCount);
+        auto *fragment = packet.getBuffer() + packet.getPosition();
+
+        // Copy the part of the segments, which belongs to this fragment
+        uint32_t segmentStart = 0;
+        for (uint32_t j = 0; j < segmentCount; j++) {
+            auto segmentEnd = segmentStart + segments[j].length;
+            if (segmentEnd > fragmentOffset && segmentStart < fragmentOffset + fragmentLength) {
+                auto start = fragmentOffset > segmentStart ? fragmentOffset - segmentStart : 0;
+                auto end = fragmentOffset + fragmentLength < segmentEnd ? fragmentOffset + fragmentLength - segmentStart : segments[j].length;
+                packet.write(segments[j].buffer, start, end - start);
+            }
+
+            segmentStart = segmentEnd;
+        }
+
+        // Fragments start at multiples of 8 bytes, so their sums can be added up in any order
+        if (checksumOffset > 0) {
+            checksumSum = Util::Network::Checksum::add(fragment, fragmentLength, checksumSum);
+            if (i == 1) {
+                auto checksum = Util::Network::Checksum::finish(checksumSum);
+                // A UDP checksum of zero means "no checksum", so it is sent as 0xffff instead (RFC 768)
+                if (checksum == 0 && protocol == Util::Network::Ip4::Ip4Header::UDP) {
+                    checksum = 0xffff;
+                }
+
+                fragment[checksumOffset] = checksum >> 8;
+                fragment[checksumOffset + 1] = checksum;
+            }
+        }
+
+        Ethernet::EthernetModule::finalizePacket(packet);
+        sendPacket(interface, packet.getBuffer(), packet.getLength());
+    }
+}
+
+Util::Network::Ip4::Ip4Address Ip4Module::getSourceAddress(const Util::Network::Ip4::Ip4Address &sourceAddress, const Util::Network::Ip4::Ip4Address &destinationAddress) {
+    auto &ip4Module = Kernel::Service::getService<Kernel::NetworkService>().getNetworkStack().getIp4Module();
+    return ip4Module.routingModule.findRoute(sourceAddress, destinationAddress).getSourceAddress();
+}
+
 Util::Array<Ip4Interface> Ip4Module::getInterfaces(const Util::String &deviceIdentifier) {
     auto ret = Util::ArrayList<Ip4Interface>();
 
@@ -150,6 +246,45 @@ Util::Array<Ip4Interface> Ip4Module::getTargetInterfaces(const Util::Network::Ip
     return ret.toArray();
 }
 
+bool Ip4Module::isLocalAddress(const Util::Network::Ip4::Ip4Address &address) {
+    if (address.isBroadcastAddress()) {
+        return true;
+    }
+
+    auto key = address.toInteger();
+
+    lock.acquire();
+    auto ret = interfaceTable.containsKey(key) || broadcastTable.containsKey(key);
+    return lock.releaseAndReturn(ret);
+}
+
+Ip4Interface Ip4Module::getInterface(const Util::Network::Ip4::Ip4Address &address) {
+    auto key = address.toInteger();
+
+    lock.acquire();
+    if (!interfaceTable.containsKey(key)) {
+        lock.release();
+        Util::Exception::throwException(Util::Exception::INVALID_ARGUMENT, "Ip4Module: No interface with the given address!");
+    }
+
+    auto interface = interfaceTable.get(key);
+    lock.release();
+
+    return interface;
+}
+
+void Ip4Module::rebuildAddressTables() {
+    interfaceTable.clear();
+    broadcastTable.clear();
+
+    for (const auto &interface : interfaces) {
+        interfaceTable.put(interface.getIp4Address().toInteger(), interface);
+
+        auto broadcastKey = interface.getSubnetAddress().getBroadcastAddress().toInteger();
+        broadcastTable.put(broadcastKey, broadcastTable.containsKey(broadcastKey) ? broadcastTable.get(broadcastKey) + 1 : 1);
+    }
+}
+
 bool Ip4Module::registerInterface(const Util::Network::Ip4::Ip4SubnetAddress &address, Device::Network::NetworkDevice &device) {
     lock.acquire();
     auto interface = Ip4Interface(address, device);
@@ -159,6 +294,7 @@ bool Ip4Module::registerInterface(const Util::Network::Ip4::Ip4SubnetAddress &ad
     }
 
     auto ret = interfaces.add(interface);
+    rebuildAddressTables();
     lock.release();
 
     if (ret) {
@@ -178,6 +314,7 @@ bool Ip4Module::removeInterface(const Util::Network::Ip4::Ip4SubnetAddress &addr
 
             routingModule.removeRoute(address, deviceIdentifier);
             interfaces.remove(interface);
+            rebuildAddressTables();
 
             lock.release();
             return true;
@@ -193,24 +330,11 @@ Ip4RoutingModule &Ip4Module::getRoutingModule() {
 }
 
 uint16_t Ip4Module::calculateChecksum(const uint8_t *buffer, uint32_t offset, uint32_t length) {
-    uint32_t checksum = 0;
-    for (uint8_t i = 0; i < length; i += 2) {
-        // Ignore checksum field
-        if (i == offset) {
-            continue;
-        }
-
-        checksum += (buffer[i] << 8) | buffer[i + 1];
-    }
-
-    // Add overflow bits
-    checksum += reinterpret_cast<uint16_t*>(&checksum)[1];
-
-    // Cut off high bytes
-    checksum = static_cast<uint16_t>(checksum);
+    // Ignore checksum field
+    auto sum = Util::Network::Checksum::add(buffer, offset);
+    sum = Util::Network::Checksum::add(buffer + offset + sizeof(uint16_t), length - offset - sizeof(uint16_t), sum);
 
-    // Complement result
-    return ~checksum;
+    return Util::Network::Checksum::finish(sum);
 }
 
 }
\ No newline at end of file
@@ -26,8 +26,11 @@
 #include "kernel/network/NetworkModule.h"
 #include "lib/util/network/ip4/Ip4Header.h"
 #include "Ip4RoutingModule.h"
+#include "Ip4ReassemblyModule.h"
+#include "lib/util/io/file/File.h"
 #include "lib/util/collection/Array.h"
 #include "lib/util/collection/ArrayList.h"
+#include "lib/util/collection/HashMap.h"
 #include "lib/util/base/String.h"
 #include "kernel/network/ip4/Ip4Interface.h"
 #include "lib/util/async/ReentrantSpinlock.h"
@@ -80,6 +83,12 @@ public:
 
     Util::Array<Ip4Interface> getTargetInterfaces(const Util::Network::Ip4::Ip4Address &address);
 
+    /**
+     * Check, if packets to the given address are meant for this host (i.e. it is the address of a local interface,
+     * the broadcast address of its subnet or the limited broadcast address). This is a hash table lookup.
+     */
+    bool isLocalAddress(const Util::Network::Ip4::Ip4Address &address);
+
     bool registerInterface(const Util::Network::Ip4::Ip4SubnetAddress &address, Device::Network::NetworkDevice &device);
 
     bool removeInterface(const Util::Network::Ip4::Ip4SubnetAddress &address, const Util::String &deviceIdentifier);
@@ -88,14 +97,61 @@ public:
 
     Ip4RoutingModule& getRoutingModule();
 
+    /**
+     * Write the ethernet and IPv4 headers for a packet to the given destination.
+     * If the hardware address of the next hop is not known yet, it is resolved in the background and filled in by sendPacket().
+     *
+     * @return The interface, via which the packet must be sent
+     */
     static Ip4Interface writeHeader(Util::Io::ByteArrayOutputStream &stream, const Util::Network::Ip4::Ip4Address &sourceAddress, const Util::Network::Ip4::Ip4Address &destinationAddress, Util::Network::Ip4::Ip4Header::Protocol protocol, uint16_t payloadLength);
 
+    /**
+     * Send a packet, that has been started with writeHeader(). Packets to a next hop, whose hardware address
+     * is still being resolved, are queued and sent once the ARP reply arrives (see NetworkDevice::sendPacket() for the checksum parameters).
+     */
+    static void sendPacket(const Ip4Interface &interface, uint8_t *packetBuffer, uint32_t length, uint16_t checksumStart = 0, uint16_t checksumOffset = 0);
+
+    /**
+     * Send a datagram of up to MAX_DATAGRAM_LENGTH bytes, split into fragments of at most MAX_FRAGMENT_PAYLOAD_LENGTH bytes (RFC 791).
+     * The datagram is given as a list of segments, starting with the transport layer header.
+     * If 'checksumOffset' is set, the checksum field at this offset only contains the pseudo header sum and is completed
+     * over the whole datagram in software, since devices can only complete checksums of single packets.
+     */
+    static void sendFragments(const Util::Network::Ip4::Ip4Address &sourceAddress, const Util::Network::Ip4::Ip4Address &destinationAddress, Util::Network::Ip4::Ip4Header::Protocol protocol,
+                              const Util::Io::File::Segment *segments, uint32_t segmentCount, uint16_t checksumOffset = 0);
+
+    /**
+     * Get the address, which writeHeader() uses as source address for packets to the given destination.
+     */
+    static Util::Network::Ip4::Ip4Address getSourceAddress(const Util::Network::Ip4::Ip4Address &sourceAddress, const Util::Network::Ip4::Ip4Address &destinationAddress);
+
     static uint16_t calculateChecksum(const uint8_t *buffer, uint32_t offset, uint32_t length);
 
+    // Largest payload, that fits into a single ethernet frame (1500 bytes MTU - IPv4 header), rounded down to the fragment offset unit
+    static const constexpr uint32_t MAX_FRAGMENT_PAYLOAD_LENGTH = 1480;
+    static const constexpr uint32_t MAX_DATAGRAM_LENGTH = Ip4ReassemblyModule::MAX_DATAGRAM_LENGTH;
+
 private:
 
+    static Ip4Interface writeHeader(Util::Io::ByteArrayOutputStream &stream, const Util::Network::Ip4::Ip4Address &sourceAddress, const Util::Network::Ip4::Ip4Address &destinationAddress, Util::Network::Ip4::Ip4Header::Protocol protocol,
+                                    uint16_t payloadLength, uint16_t identification, uint16_t fragmentOffset, bool moreFragments);
+
+    void handleDatagram(const Util::Network::Ip4::Ip4Header &header, uint16_t payloadLength, Util::Io::ByteArrayInputStream &stream, bool checksumVerified, Device::Network::NetworkDevice &device);
+
+    /**
+     * Get the interface with the given address (e.g. the source address of a route).
+     */
+    Ip4Interface getInterface(const Util::Network::Ip4::Ip4Address &address);
+
+    void rebuildAddressTables();
+
     Ip4RoutingModule routingModule;
+    Ip4ReassemblyModule reassemblyModule;
+    uint32_t identification = 0;
     Util::ArrayList<Ip4Interface> interfaces;
+    // Interface addresses and subnet broadcast addresses (mapped to the amount of interfaces in the subnet)
+    Util::HashMap<uint32_t, Ip4Interface> interfaceTable;
+    Util::HashMap<uint32_t, uint32_t> broadcastTable;
     Util::Async::ReentrantSpinlock lock;
 };
 
@@ -0,0 +1,232 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "Ip4ReassemblyModule.h"
+
+#include "kernel/log/Log.h"
+#include "lib/util/base/Address.h"
+#include "lib/util/network/ip4/Ip4Address.h"
+
+namespace Kernel::Network::Ip4 {
+
+Ip4ReassemblyModule::~Ip4ReassemblyModule() {
+    for (uint32_t i = 0; i < reassemblies.size(); i++) {
+        auto *reassembly = reassemblies.get(i);
+        delete[] reassembly->buffer;
+        delete reassembly;
+    }
+}
+
+uint8_t* Ip4ReassemblyModule::addFragment(const Util::Network::Ip4::Ip4Header &header, const uint8_t *payload, uint16_t &datagramLength) {
+    uint32_t first = header.getFragmentOffset();
+    uint32_t length = header.getPayloadLength();
+    uint32_t last = first + length - 1;
+    auto moreFragments = header.hasMoreFragments();
+
+    // All fragments, except for the last one, must carry a multiple of 8 bytes
+    if (length == 0 || (moreFragments && length % Util::Network::Ip4::Ip4Header::FRAGMENT_OFFSET_UNIT != 0) || last >= MAX_DATAGRAM_LENGTH) {
+        LOG_WARN("Discarding packet, because it is an invalid fragment");
+        return nullptr;
+    }
+
+    auto now = Util::Time::getSystemTime();
+
+    lock.acquire();
+    discardExpiredReassemblies(now);
+
+    auto *reassembly = findReassembly(header);
+    if (reassembly == nullptr) {
+        reassembly = createReassembly(header, now);
+    }
+
+    // The last fragment determines the length of the datagram, which no other fragment may exceed
+    if (!moreFragments) {
+        if (reassembly->datagramLength > 0 && reassembly->datagramLength != last + 1) {
+            LOG_WARN("Discarding fragmented datagram, because of conflicting lengths");
+            discardReassembly(reassembly);
+            lock.release();
+            return nullptr;
+        }
+
+        reassembly->datagramLength = last + 1;
+    } else if (reassembly->datagramLength > 0 && last >= reassembly->datagramLength) {
+        LOG_WARN("Discarding fragmented datagram, because a fragment exceeds its length");
+        discardReassembly(reassembly);
+        lock.release();
+        return nullptr;
+    }
+
+    if (!ensureCapacity(*reassembly, reassembly->datagramLength > 0 ? reassembly->datagramLength : last + 1)) {
+        LOG_WARN("Discarding fragmented datagram, because the reassembly memory is exhausted");
+        discardReassembly(reassembly);
+        lock.release();
+        return nullptr;
+    }
+
+    Util::Address<uint32_t>(reassembly->buffer + first).copyRange(Util::Address<uint32_t>(payload), length);
+
+    if (!fillHoles(*reassembly, first, last, moreFragments)) {
+        LOG_WARN("Discarding fragmented datagram, because of too many missing fragments");
+        discardReassembly(reassembly);
+        lock.release();
+        return nullptr;
+    }
+
+    if (reassembly->holeCount > 0) {
+        lock.release();
+        return nullptr;
+    }
+
+    // The datagram is complete -> Hand its buffer over to the caller
+    auto *datagram = reassembly->buffer;
+    datagramLength = reassembly->datagramLength;
+    reassembly->buffer = nullptr;
+    discardReassembly(reassembly);
+    lock.release();
+
+    return datagram;
+}
+
+Ip4ReassemblyModule::Reassembly* Ip4ReassemblyModule::findReassembly(const Util::Network::Ip4::Ip4Header &header) {
+    auto sourceAddress = header.getSourceAddress().toInteger();
+    auto destinationAddress = header.getDestinationAddress().toInteger();
+
+    for (uint32_t i = 0; i < reassemblies.size(); i++) {
+        auto *reassembly = reassemblies.get(i);
+        if (reassembly->identification == header.getIdentification() && reassembly->sourceAddress == sourceAddress &&
+                reassembly->destinationAddress == destinationAddress && reassembly->protocol == header.getProtocol()) {
+            return reassembly;
+        }
+    }
+
+    return nullptr;
+}
+
+Ip4ReassemblyModule::Reassembly* Ip4ReassemblyModule::createReassembly(const Util::Network::Ip4::Ip4Header &header, const Util::Time::Timestamp &now) {
+    // Reassemblies are kept in order of creation, so the oldest one is always at the front
+    if (reassemblies.size() >= MAX_REASSEMBLIES) {
+        discardReassembly(reassemblies.get(0));
+    }
+
+    auto *reassembly = new Reassembly{};
+    reassembly->sourceAddress = header.getSourceAddress().toInteger();
+    reassembly->destinationAddress = header.getDestinationAddress().toInteger();
+    reassembly->identification = header.getIdentification();
+    reassembly->protocol = header.getProtocol();
+    reassembly->expirationTime = now + Util::Time::Timestamp::ofSeconds(REASSEMBLY_TIMEOUT);
+
+    // Initially, the whole datagram is missing
+    reassembly->holes[0] = Hole{0, MAX_DATAGRAM_LENGTH - 1};
+    reassembly->holeCount = 1;
+
+    reassemblies.add(reassembly);
+    return reassembly;
+}
+
+bool Ip4ReassemblyModule::ensureCapacity(Reassembly &reassembly, uint32_t length) {
+    if (length <= reassembly.capacity) {
+        return true;
+    }
+
+    // As long as the length of the datagram is unknown, the buffer grows exponentially to avoid copying it for each fragment
+    uint32_t capacity = length;
+    if (reassembly.datagramLength == 0) {
+        capacity = reassembly.capacity * 2 > capacity ? reassembly.capacity * 2 : capacity;
+        capacity = capacity < MIN_CAPACITY ? MIN_CAPACITY : capacity;
+        capacity = capacity > MAX_DATAGRAM_LENGTH ? MAX_DATAGRAM_LENGTH : capacity;
+    }
+
+    // Make room by discarding the oldest other reassemblies
+    while (usedMemory - reassembly.capacity + capacity > MAX_MEMORY) {
+        auto *oldest = reassemblies.get(0);
+        if (oldest == &reassembly) {
+            if (reassemblies.size() == 1) {
+                return false;
+            }
+
+            oldest = reassemblies.get(1);
+        }
+
+        discardReassembly(oldest);
+    }
+
+    auto *buffer = new uint8_t[capacity];
+    if (reassembly.buffer != nullptr) {
+        Util::Address<uint32_t>(buffer).copyRange(Util::Address<uint32_t>(reassembly.buffer), reassembly.capacity);
+        delete[] reassembly.buffer;
+    }
+
+    usedMemory = usedMemory - reassembly.capacity + capacity;
+    reassembly.buffer = buffer;
+    reassembly.capacity = capacity;
+
+    return true;
+}
+
+bool Ip4ReassemblyModule::fillHoles(Reassembly &reassembly, uint32_t first, uint32_t last, bool moreFragments) {
+    uint32_t i = 0;
+    while (i < reassembly.holeCount) {
+        auto hole = reassembly.holes[i];
+        // Holes behind the last fragment do not exist
+        auto beyondEnd = !moreFragments && hole.first > last;
+        if (!beyondEnd && (first > hole.last || last < hole.first)) {
+            i++;
+            continue;
+        }
+
+        // Replace the hole by the parts, which are not covered by the fragment (RFC 815, section 3)
+        reassembly.holes[i] = reassembly.holes[--reassembly.holeCount];
+        if (beyondEnd) {
+            continue;
+        }
+
+        if (first > hole.first) {
+            if (reassembly.holeCount == MAX_HOLES) {
+                return false;
+            }
+
+            reassembly.holes[reassembly.holeCount++] = Hole{hole.first, first - 1};
+        }
+
+        if (last < hole.last && moreFragments) {
+            if (reassembly.holeCount == MAX_HOLES) {
+                return false;
+            }
+
+            reassembly.holes[reassembly.holeCount++] = Hole{last + 1, hole.last};
+        }
+    }
+
+    return true;
+}
+
+void Ip4ReassemblyModule::discardExpiredReassemblies(const Util::Time::Timestamp &now) {
+    while (reassemblies.size() > 0 && now >= reassemblies.get(0)->expirationTime) {
+        LOG_WARN("Discarding fragmented datagram, because its reassembly timed out");
+        discardReassembly(reassemblies.get(0));
+    }
+}
+
+void Ip4ReassemblyModule::discardReassembly(Reassembly *reassembly) {
+    usedMemory -= reassembly->capacity;
+    reassemblies.remove(reassembly);
+
+    delete[] reassembly->buffer;
+    delete reassembly;
+}
+
+}
@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef HHUOS_IP4REASSEMBLYMODULE_H
+#define HHUOS_IP4REASSEMBLYMODULE_H
+
+#include <stdint.h>
+
+#include "lib/util/async/Spinlock.h"
+#include "lib/util/collection/ArrayList.h"
+#include "lib/util/network/ip4/Ip4Header.h"
+#include "lib/util/time/Timestamp.h"
+
+namespace Kernel::Network::Ip4 {
+
+/**
+ * Reassembles fragmented IPv4 datagrams (RFC 791), keeping track of the missing parts via hole descriptors (RFC 815).
+ * The memory used for incomplete datagrams is bounded: If a new fragment does not fit, the oldest reassemblies are discarded.
+ * Reassemblies, which are not completed within REASSEMBLY_TIMEOUT seconds, are discarded, once the next fragment arrives.
+ */
+class Ip4ReassemblyModule {
+
+public:
+    /**
+     * Default Constructor.
+     */
+    Ip4ReassemblyModule() = default;
+
+    /**
+     * Copy Constructor.
+     */
+    Ip4ReassemblyModule(const Ip4ReassemblyModule &other) = delete;
+
+    /**
+     * Assignment operator.
+     */
+    Ip4ReassemblyModule &operator=(const Ip4ReassemblyModule &other) = delete;
+
+    /**
+     * Destructor.
+     */
+    ~Ip4ReassemblyModule();
+
+    /**
+     * Add a received fragment to the reassembly of its datagram.
+     *
+     * @return The payload of the complete datagram (owned by the caller, which must delete[] it),
+     *         or nullptr, if fragments are still missing
+     */
+    uint8_t* addFragment(const Util::Network::Ip4::Ip4Header &header, const uint8_t *payload, uint16_t &datagramLength);
+
+    static const constexpr uint32_t MAX_DATAGRAM_LENGTH = Util::Network::Ip4::Ip4Header::MAX_PACKET_LENGTH - Util::Network::Ip4::Ip4Header::MIN_HEADER_LENGTH;
+
+private:
+
+    static const constexpr uint32_t MAX_HOLES = 32;
+    static const constexpr uint32_t MAX_REASSEMBLIES = 16;
+    static const constexpr uint32_t MAX_MEMORY = 256 * 1024;
+    static const constexpr uint32_t MIN_CAPACITY = 4096;
+    static const constexpr uint32_t REASSEMBLY_TIMEOUT = 30;
+
+    /**
+     * A range of missing bytes (both bounds inclusive).
+     */
+    struct Hole {
+        uint32_t first;
+        uint32_t last;
+    };
+
+    struct Reassembly {
+        uint32_t sourceAddress;
+        uint32_t destinationAddress;
+        uint16_t identification;
+        Util::Network::Ip4::Ip4Header::Protocol protocol;
+        Util::Time::Timestamp expirationTime;
+
+        uint8_t *buffer;
+        uint32_t capacity;
+        // Known, once the last fragment has been received
+        uint32_t datagramLength;
+
+        Hole holes[MAX_HOLES];
+        uint32_t holeCount;
+    };
+
+    Reassembly* findReassembly(const Util::Network::Ip4::Ip4Header &header);
+
+    Reassembly* createReassembly(const Util::Network::Ip4::Ip4Header &header, const Util::Time::Timestamp &now);
+
+    /**
+     * Grow the buffer of a reassembly, so that it can hold at least 'length' bytes.
+     *
+     * @return false, if the memory limit does not allow it
+     */
+    bool ensureCapacity(Reassembly &reassembly, uint32_t length);
+
+    /**
+     * Remove the hole descriptors covered by a fragment and add the parts of them, that are still missing.
+     *
+     * @return false, if there are too many holes
+     */
+    static bool fillHoles(Reassembly &reassembly, uint32_t first, uint32_t last, bool moreFragments);
+
+    void discardExpiredReassemblies(const Util::Time::Timestamp &now);
+
+    void discardReassembly(Reassembly *reassembly);
+
+    Util::ArrayList<Reassembly*> reassemblies;
+    uint32_t usedMemory = 0;
+    Util::Async::Spinlock lock;
+
+};
+
+}
+
+#endif
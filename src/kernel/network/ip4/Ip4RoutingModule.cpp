@@ -34,23 +34,40 @@
 
 namespace Kernel::Network::Ip4 {
 
+Ip4RoutingModule::~Ip4RoutingModule() {
+    deleteNode(root);
+}
+
 bool Ip4RoutingModule::addRoute(const Util::Network::Ip4::Ip4Route &route) {
     auto &ip4Module = Service::getService<NetworkService>().getNetworkStack().getIp4Module();
     if (ip4Module.getTargetInterfaces(route.getSourceAddress()).length() == 0) {
         return false;
     }
 
-    bool ret = false;
+    bool ret = true;
+    auto targetAddress = route.getTargetAddress();
+    auto length = targetAddress.getBitCount();
+    auto prefix = targetAddress.getIp4Address().toInteger() & getMask(length);
+
     lock.acquire();
 
-    if (route.getTargetAddress().getBitCount() == 0) {
-        routes.remove(route);
+    if (length == 0) {
         defaultRoute = route;
-        ret = true;
-    } else if (!routes.contains(route)) {
-        ret = routes.add(route);
+    } else {
+        auto *node = insertNode(prefix, length);
+        for (uint32_t i = 0; i < node->routes.size(); i++) {
+            if (*node->routes.get(i) == route) {
+                ret = false;
+                break;
+            }
+        }
+
+        if (ret) {
+            node->routes.add(new Util::Network::Ip4::Ip4Route(route));
+        }
     }
 
+    flushCache();
     lock.release();
     return ret;
 }
@@ -63,9 +80,10 @@ bool Ip4RoutingModule::removeRoute(const Util::Network::Ip4::Ip4Route &route) {
         defaultRoute = Util::Network::Ip4::Ip4Route();
         ret = true;
     } else {
-        ret = routes.remove(route);
+        ret = removeFromTrie(route);
     }
 
+    flushCache();
     lock.release();
     return ret;
 }
@@ -81,17 +99,12 @@ const Util::Network::Ip4::Ip4Route &Ip4RoutingModule::getDefaultRoute() const {
 
 Util::Array<Util::Network::Ip4::Ip4Route> Ip4RoutingModule::getRoutes(const Util::Network::Ip4::Ip4Address &sourceAddress) {
     auto ret = Util::ArrayList<Util::Network::Ip4::Ip4Route>();
-    bool anySource = sourceAddress == Util::Network::Ip4::Ip4Address::ANY;
+    auto source = sourceAddress.toInteger();
 
     lock.acquire();
+    collectRoutes(root, source, ret);
 
-    for (const auto &route : routes) {
-        if (anySource || route.getSourceAddress() == sourceAddress) {
-            ret.add(route);
-        }
-    }
-
-    if (anySource || defaultRoute.getSourceAddress() == sourceAddress) {
+    if (source == 0 || defaultRoute.getSourceAddress().toInteger() == source) {
         ret.add(defaultRoute);
     }
     lock.release();
@@ -99,33 +112,187 @@ Util::Array<Util::Network::Ip4::Ip4Route> Ip4RoutingModule::getRoutes(const Util
     return ret.toArray();
 }
 
-const Util::Network::Ip4::Ip4Route& Ip4RoutingModule::findRoute(const Util::Network::Ip4::Ip4Address &sourceAddress, const Util::Network::Ip4::Ip4Address &address) {
-    uint8_t longestPrefix = 0;
-    const Util::Network::Ip4::Ip4Route *bestRoute = nullptr;
-    bool anySource = sourceAddress == Util::Network::Ip4::Ip4Address::ANY;
-
+Util::Network::Ip4::Ip4Route Ip4RoutingModule::findRoute(const Util::Network::Ip4::Ip4Address &sourceAddress, const Util::Network::Ip4::Ip4Address &address) {
     lock.acquire();
-    for (const auto &route : routes) {
-        if (anySource || sourceAddress == route.getSourceAddress()) {
-            auto subnetAddress = route.getTargetAddress();
-            auto prefix = address.compareTo(subnetAddress);
+    const auto *route = lookup(sourceAddress.toInteger(), address.toInteger());
+    if (route == nullptr) {
+        lock.release();
+        Util::Exception::throwException(Util::Exception::INVALID_ARGUMENT, "Ip4RoutingModule: No route to host!");
+    }
 
-            if (prefix >= subnetAddress.getBitCount() && prefix > longestPrefix) {
-                bestRoute = &route;
+    auto ret = *route;
+    lock.release();
+
+    return ret;
+}
+
+Ip4RoutingModule::Node* Ip4RoutingModule::insertNode(uint32_t prefix, uint8_t length) {
+    auto **link = &root;
+    while (true) {
+        auto *node = *link;
+        if (node == nullptr) {
+            *link = new Node{prefix, length, {nullptr, nullptr}, Util::ArrayList<Util::Network::Ip4::Ip4Route*>()};
+            return *link;
+        }
+
+        auto commonLength = getCommonPrefixLength(node->prefix, prefix, node->length < length ? node->length : length);
+        if (commonLength < node->length) {
+            // The new prefix diverges from (or is shorter than) the node's prefix -> Insert a node for the common part
+            auto *branch = new Node{prefix & getMask(commonLength), commonLength, {nullptr, nullptr}, Util::ArrayList<Util::Network::Ip4::Ip4Route*>()};
+            branch->children[getBit(node->prefix, commonLength)] = node;
+            *link = branch;
+
+            if (commonLength == length) {
+                return branch;
             }
+
+            auto *leaf = new Node{prefix, length, {nullptr, nullptr}, Util::ArrayList<Util::Network::Ip4::Ip4Route*>()};
+            branch->children[getBit(prefix, commonLength)] = leaf;
+            return leaf;
         }
+
+        if (node->length == length) {
+            return node;
+        }
+
+        link = &node->children[getBit(prefix, node->length)];
     }
-    lock.release();
+}
+
+bool Ip4RoutingModule::removeFromTrie(const Util::Network::Ip4::Ip4Route &route) {
+    auto targetAddress = route.getTargetAddress();
+    auto length = targetAddress.getBitCount();
+    auto prefix = targetAddress.getIp4Address().toInteger() & getMask(length);
 
-    if (bestRoute == nullptr) {
-        if (defaultRoute.isValid() && (anySource || sourceAddress == defaultRoute.getSourceAddress())) {
-            return defaultRoute;
+    Node **parentLink = nullptr;
+    auto **link = &root;
+    while (*link != nullptr && (*link)->length < length) {
+        auto *node = *link;
+        if (getCommonPrefixLength(node->prefix, prefix, node->length) < node->length) {
+            return false;
         }
 
-        Util::Exception::throwException(Util::Exception::INVALID_ARGUMENT, "Ip4RoutingModule: No route to host!");
+        parentLink = link;
+        link = &node->children[getBit(prefix, node->length)];
     }
 
-    return *bestRoute;
+    auto *node = *link;
+    if (node == nullptr || node->length != length || node->prefix != prefix) {
+        return false;
+    }
+
+    uint32_t index;
+    for (index = 0; index < node->routes.size() && *node->routes.get(index) != route; index++) {}
+    if (index == node->routes.size()) {
+        return false;
+    }
+
+    delete node->routes.removeIndex(index);
+
+    // Remove nodes, which are neither holding routes nor needed as branching points anymore
+    if (node->routes.isEmpty() && (node->children[0] == nullptr || node->children[1] == nullptr)) {
+        *link = node->children[0] != nullptr ? node->children[0] : node->children[1];
+        delete node;
+
+        // The parent may have been a branching point with the removed node as one of its children
+        if (parentLink != nullptr) {
+            auto *parent = *parentLink;
+            if (parent->routes.isEmpty() && (parent->children[0] == nullptr || parent->children[1] == nullptr)) {
+                *parentLink = parent->children[0] != nullptr ? parent->children[0] : parent->children[1];
+                delete parent;
+            }
+        }
+    }
+
+    return true;
+}
+
+const Util::Network::Ip4::Ip4Route* Ip4RoutingModule::lookup(uint32_t sourceAddress, uint32_t address) {
+    auto &cacheEntry = routeCache[getCacheIndex(sourceAddress, address)];
+    if (cacheEntry.route != nullptr && cacheEntry.sourceAddress == sourceAddress && cacheEntry.destinationAddress == address) {
+        return cacheEntry.route;
+    }
+
+    // Walk down the trie along the destination address -> The last matching node holds the longest matching prefix
+    const Util::Network::Ip4::Ip4Route *bestRoute = nullptr;
+    auto *node = root;
+    while (node != nullptr && getCommonPrefixLength(node->prefix, address, node->length) == node->length) {
+        for (uint32_t i = 0; i < node->routes.size(); i++) {
+            const auto *route = node->routes.get(i);
+            if (sourceAddress == 0 || route->getSourceAddress().toInteger() == sourceAddress) {
+                bestRoute = route;
+                break;
+            }
+        }
+
+        node = node->length < 32 ? node->children[getBit(address, node->length)] : nullptr;
+    }
+
+    if (bestRoute == nullptr && defaultRoute.isValid() && (sourceAddress == 0 || defaultRoute.getSourceAddress().toInteger() == sourceAddress)) {
+        bestRoute = &defaultRoute;
+    }
+
+    if (bestRoute != nullptr) {
+        cacheEntry = CacheEntry{sourceAddress, address, bestRoute};
+    }
+
+    return bestRoute;
+}
+
+void Ip4RoutingModule::collectRoutes(const Node *node, uint32_t sourceAddress, Util::ArrayList<Util::Network::Ip4::Ip4Route> &result) {
+    if (node == nullptr) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < node->routes.size(); i++) {
+        const auto *route = node->routes.get(i);
+        if (sourceAddress == 0 || route->getSourceAddress().toInteger() == sourceAddress) {
+            result.add(*route);
+        }
+    }
+
+    collectRoutes(node->children[0], sourceAddress, result);
+    collectRoutes(node->children[1], sourceAddress, result);
+}
+
+void Ip4RoutingModule::flushCache() {
+    for (auto &cacheEntry : routeCache) {
+        cacheEntry.route = nullptr;
+    }
+}
+
+void Ip4RoutingModule::deleteNode(Node *node) {
+    if (node == nullptr) {
+        return;
+    }
+
+    deleteNode(node->children[0]);
+    deleteNode(node->children[1]);
+
+    for (uint32_t i = 0; i < node->routes.size(); i++) {
+        delete node->routes.get(i);
+    }
+
+    delete node;
 }
 
-}
\ No newline at end of file
+uint8_t Ip4RoutingModule::getCommonPrefixLength(uint32_t first, uint32_t second, uint8_t maxLength) {
+    auto difference = first ^ second;
+    uint8_t commonLength = difference == 0 ? 32 : __builtin_clz(difference);
+
+    return commonLength < maxLength ? commonLength : maxLength;
+}
+
+uint32_t Ip4RoutingModule::getMask(uint8_t length) {
+    return length == 0 ? 0 : 0xffffffff << (32 - length);
+}
+
+uint32_t Ip4RoutingModule::getBit(uint32_t address, uint8_t index) {
+    return (address >> (31 - index)) & 0x01;
+}
+
+uint32_t Ip4RoutingModule::getCacheIndex(uint32_t sourceAddress, uint32_t address) {
+    return ((address ^ (sourceAddress >> 1)) * 0x9e3779b1) >> (32 - ROUTE_CACHE_BITS);
+}
+
+}
@@ -38,6 +38,11 @@ class Ip4SubnetAddress;
 
 namespace Kernel::Network::Ip4 {
 
+/**
+ * Routes are kept in a path compressed binary trie, keyed by their target subnet, so that the longest matching prefix
+ * is found in O(prefix length), independent of the amount of routes. The default route is kept outside the trie.
+ * Recent lookups are remembered in a small direct mapped cache, which is flushed whenever a route is added or removed.
+ */
 class Ip4RoutingModule {
 
 public:
@@ -59,7 +64,7 @@ public:
     /**
      * Destructor.
      */
-    ~Ip4RoutingModule() = default;
+    ~Ip4RoutingModule();
 
     bool addRoute(const Util::Network::Ip4::Ip4Route &route);
 
@@ -71,12 +76,53 @@ public:
 
     [[nodiscard]] Util::Array<Util::Network::Ip4::Ip4Route> getRoutes(const Util::Network::Ip4::Ip4Address &sourceAddress);
 
-    [[nodiscard]] const Util::Network::Ip4::Ip4Route& findRoute(const Util::Network::Ip4::Ip4Address &sourceAddress, const Util::Network::Ip4::Ip4Address &address);
+    [[nodiscard]] Util::Network::Ip4::Ip4Route findRoute(const Util::Network::Ip4::Ip4Address &sourceAddress, const Util::Network::Ip4::Ip4Address &address);
 
 private:
 
+    static const constexpr uint32_t ROUTE_CACHE_BITS = 6;
+    static const constexpr uint32_t ROUTE_CACHE_SIZE = 1 << ROUTE_CACHE_BITS;
+
+    /**
+     * A trie node covers all addresses starting with the first 'length' bits of 'prefix'.
+     * Nodes without routes only exist as branching points with two children.
+     */
+    struct Node {
+        uint32_t prefix;
+        uint8_t length;
+        Node *children[2];
+        Util::ArrayList<Util::Network::Ip4::Ip4Route*> routes;
+    };
+
+    struct CacheEntry {
+        uint32_t sourceAddress;
+        uint32_t destinationAddress;
+        const Util::Network::Ip4::Ip4Route *route;
+    };
+
+    Node* insertNode(uint32_t prefix, uint8_t length);
+
+    bool removeFromTrie(const Util::Network::Ip4::Ip4Route &route);
+
+    const Util::Network::Ip4::Ip4Route* lookup(uint32_t sourceAddress, uint32_t address);
+
+    static void collectRoutes(const Node *node, uint32_t sourceAddress, Util::ArrayList<Util::Network::Ip4::Ip4Route> &result);
+
+    void flushCache();
+
+    static void deleteNode(Node *node);
+
+    static uint8_t getCommonPrefixLength(uint32_t first, uint32_t second, uint8_t maxLength);
+
+    static uint32_t getMask(uint8_t length);
+
+    static uint32_t getBit(uint32_t address, uint8_t index);
+
+    static uint32_t getCacheIndex(uint32_t sourceAddress, uint32_t address);
+
     Util::Network::Ip4::Ip4Route defaultRoute;
-    Util::ArrayList<Util::Network::Ip4::Ip4Route> routes;
+    Node *root = nullptr;
+    CacheEntry routeCache[ROUTE_CACHE_SIZE]{};
     Util::Async::ReentrantSpinlock lock;
 };
 
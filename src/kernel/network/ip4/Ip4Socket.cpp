@@ -49,15 +49,29 @@ Ip4Socket::~Ip4Socket() {
     ip4Module.deregisterSocket(*this);
 }
 
-bool Ip4Socket::send(const Util::Network::Datagram &datagram) {
-    auto packet = Util::Io::ByteArrayOutputStream();
+bool Ip4Socket::send(const Util::Network::Datagram &datagram, const Util::Io::File::Segment *segments, uint32_t segmentCount) {
     const auto &ip4Datagram = reinterpret_cast<const Util::Network::Ip4::Ip4Datagram&>(datagram);
     const auto &sourceAddress = reinterpret_cast<const Util::Network::Ip4::Ip4Address&>(*bindAddress);
     const auto &destinationAddress = reinterpret_cast<const Util::Network::Ip4::Ip4Address&>(ip4Datagram.getRemoteAddress());
-    auto interface = Ip4Module::writeHeader(packet, sourceAddress, destinationAddress, ip4Datagram.getProtocol(), datagram.getLength());
-    packet.write(datagram.getData(), 0, datagram.getLength());
+    auto payloadLength = getPayloadLength(segments, segmentCount);
+    if (payloadLength > Ip4Module::MAX_DATAGRAM_LENGTH) {
+        return false;
+    }
+
+    if (payloadLength > Ip4Module::MAX_FRAGMENT_PAYLOAD_LENGTH) {
+        Ip4Module::sendFragments(sourceAddress, destinationAddress, ip4Datagram.getProtocol(), segments, segmentCount);
+        return true;
+    }
+
+    auto packet = Util::Io::ByteArrayOutputStream(Device::Network::NetworkDevice::allocatePacketBuffer(), Device::Network::NetworkDevice::PACKET_BUFFER_SIZE);
+    packet.setEnforceSizeLimit(true);
+    auto interface = Ip4Module::writeHeader(packet, sourceAddress, destinationAddress, ip4Datagram.getProtocol(), payloadLength);
+    for (uint32_t i = 0; i < segmentCount; i++) {
+        packet.write(segments[i].buffer, 0, segments[i].length);
+    }
+
     Ethernet::EthernetModule::finalizePacket(packet);
-    interface.getDevice().sendPacket(packet.getBuffer(), packet.getPosition());
+    Ip4Module::sendPacket(interface, packet.getBuffer(), packet.getPosition());
     return true;
 }
 
@@ -0,0 +1,1063 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "TcpConnection.h"
+
+#include "TcpModule.h"
+#include "kernel/process/Scheduler.h"
+#include "kernel/service/ProcessService.h"
+#include "kernel/service/Service.h"
+#include "lib/util/base/Address.h"
+#include "lib/util/io/file/File.h"
+#include "lib/util/math/Random.h"
+#include "lib/util/network/tcp/TcpHeader.h"
+#include "lib/util/time/Timestamp.h"
+
+namespace Kernel::Network::Tcp {
+
+TcpConnection::TcpConnection(const Util::Network::Ip4::Ip4PortAddress &localAddress, const Util::Network::Ip4::Ip4PortAddress &remoteAddress) :
+        localAddress(localAddress), remoteAddress(remoteAddress), sendBuffer(new uint8_t[SEND_BUFFER_SIZE]), receiveBuffer(new uint8_t[RECEIVE_BUFFER_SIZE]) {
+    // Use the smallest shift, that allows advertising the whole receive buffer
+    while ((RECEIVE_BUFFER_SIZE >> receiveWindowShift) > UINT16_MAX && receiveWindowShift < MAX_WINDOW_SHIFT) {
+        receiveWindowShift++;
+    }
+}
+
+TcpConnection::~TcpConnection() {
+    delete[] sendBuffer;
+    delete[] receiveBuffer;
+}
+
+bool TcpConnection::connect(uint32_t timeout) {
+    auto &scheduler = Service::getService<ProcessService>().getScheduler();
+    WaitQueue::ThreadListener threadListener(scheduler.getCurrentThread());
+    waitQueue.add(threadListener);
+
+    lock.acquire();
+    initialSendSequence = generateInitialSequenceNumber();
+    sendUnacknowledged = initialSendSequence;
+    sendNext = initialSendSequence + 1;
+    sendMaximum = sendNext;
+    sendBufferSequence = sendNext;
+    state = SYN_SENT;
+
+    sendSynchronize();
+    restartRetransmissionTimer();
+    lock.release();
+
+    auto startTime = getTime();
+    while (state == SYN_SENT || state == SYN_RECEIVED) {
+        if (timeout > 0) {
+            auto elapsedTime = getTime() - startTime;
+            if (elapsedTime >= timeout) {
+                lock.acquire();
+                if (state == SYN_SENT || state == SYN_RECEIVED) {
+                    resetConnection();
+                }
+                lock.release();
+                break;
+            }
+
+            scheduler.wait(Util::Time::Timestamp::ofMilliseconds(timeout - elapsedTime));
+        } else {
+            scheduler.wait(Util::Time::Timestamp());
+        }
+    }
+
+    return isSynchronized();
+}
+
+uint32_t TcpConnection::read(uint8_t *targetBuffer, uint32_t length, uint32_t timeout) {
+    auto &scheduler = Service::getService<ProcessService>().getScheduler();
+    WaitQueue::ThreadListener threadListener(scheduler.getCurrentThread());
+    waitQueue.add(threadListener);
+
+    auto startTime = getTime();
+    lock.acquire();
+    while (receiveBufferLength == 0 && !finReceived && state != CLOSED) {
+        lock.release();
+
+        if (timeout > 0) {
+            auto elapsedTime = getTime() - startTime;
+            if (elapsedTime >= timeout) {
+                return 0;
+            }
+
+            scheduler.wait(Util::Time::Timestamp::ofMilliseconds(timeout - elapsedTime));
+        } else {
+            scheduler.wait(Util::Time::Timestamp());
+        }
+
+        lock.acquire();
+    }
+
+    auto count = length < receiveBufferLength ? length : receiveBufferLength;
+    auto firstLength = count < RECEIVE_BUFFER_SIZE - receiveBufferHead ? count : RECEIVE_BUFFER_SIZE - receiveBufferHead;
+    Util::Address<uint32_t>(targetBuffer).copyRange(Util::Address<uint32_t>(receiveBuffer + receiveBufferHead), firstLength);
+    if (firstLength < count) {
+        Util::Address<uint32_t>(targetBuffer + firstLength).copyRange(Util::Address<uint32_t>(receiveBuffer), count - firstLength);
+    }
+
+    receiveBufferHead = (receiveBufferHead + count) % RECEIVE_BUFFER_SIZE;
+    receiveBufferLength -= count;
+
+    // Announce the opened window, once it has grown significantly (receiver side silly window avoidance)
+    if (count > 0 && (state == ESTABLISHED || state == FIN_WAIT_1 || state == FIN_WAIT_2)) {
+        auto windowEdge = receiveNext + (RECEIVE_BUFFER_SIZE - receiveBufferLength);
+        auto threshold = RECEIVE_BUFFER_SIZE / 2 < 2 * MAXIMUM_SEGMENT_SIZE ? RECEIVE_BUFFER_SIZE / 2 : 2 * MAXIMUM_SEGMENT_SIZE;
+        if (windowEdge - receiveAdvertisedEdge >= threshold) {
+            sendAcknowledgement();
+        }
+    }
+
+    lock.release();
+    return count;
+}
+
+uint32_t TcpConnection::write(const uint8_t *sourceBuffer, uint32_t length, uint32_t timeout) {
+    auto &scheduler = Service::getService<ProcessService>().getScheduler();
+    WaitQueue::ThreadListener threadListener(scheduler.getCurrentThread());
+    waitQueue.add(threadListener);
+
+    uint32_t written = 0;
+    auto startTime = getTime();
+    lock.acquire();
+    while (written < length && (state == ESTABLISHED || state == CLOSE_WAIT) && !finQueued) {
+        auto space = SEND_BUFFER_SIZE - sendBufferLength;
+        if (space == 0) {
+            lock.release();
+
+            if (timeout > 0) {
+                auto elapsedTime = getTime() - startTime;
+                if (elapsedTime >= timeout) {
+                    return written;
+                }
+
+                scheduler.wait(Util::Time::Timestamp::ofMilliseconds(timeout - elapsedTime));
+            } else {
+                scheduler.wait(Util::Time::Timestamp());
+            }
+
+            lock.acquire();
+            continue;
+        }
+
+        auto count = length - written < space ? length - written : space;
+        auto tail = (sendBufferHead + sendBufferLength) % SEND_BUFFER_SIZE;
+        auto firstLength = count < SEND_BUFFER_SIZE - tail ? count : SEND_BUFFER_SIZE - tail;
+        Util::Address<uint32_t>(sendBuffer + tail).copyRange(Util::Address<uint32_t>(sourceBuffer + written), firstLength);
+        if (firstLength < count) {
+            Util::Address<uint32_t>(sendBuffer).copyRange(Util::Address<uint32_t>(sourceBuffer + written + firstLength), count - firstLength);
+        }
+
+        sendBufferLength += count;
+        written += count;
+        transmit();
+    }
+
+    lock.release();
+    return written;
+}
+
+void TcpConnection::close() {
+    lock.acquire();
+    if (receiveBufferLength > 0 && state != CLOSED) {
+        // Data is lost -> Let the peer know (RFC 2525, section 2.17)
+        resetConnection();
+    } else {
+        switch (state) {
+            case SYN_SENT:
+                setClosed(false);
+                break;
+            case SYN_RECEIVED:
+                resetConnection();
+                break;
+            case ESTABLISHED:
+                finQueued = true;
+                state = FIN_WAIT_1;
+                transmit();
+                break;
+            case CLOSE_WAIT:
+                finQueued = true;
+                state = LAST_ACK;
+                transmit();
+                break;
+            default:
+                break;
+        }
+    }
+
+    lock.release();
+    waitQueue.wakeUp();
+}
+
+void TcpConnection::abort() {
+    lock.acquire();
+    resetConnection();
+    lock.release();
+
+    waitQueue.wakeUp();
+}
+
+void TcpConnection::release() {
+    close();
+
+    lock.acquire();
+    if (state == FIN_WAIT_2) {
+        closeDeadline = getTime() + FIN_WAIT_2_TIMEOUT;
+    }
+
+    orphaned = true;
+    lock.release();
+}
+
+bool TcpConnection::isReadyToRead() {
+    return receiveBufferLength > 0 || finReceived || state == CLOSED;
+}
+
+bool TcpConnection::isReadyToWrite() {
+    return (state != ESTABLISHED && state != CLOSE_WAIT) || finQueued || sendBufferLength < SEND_BUFFER_SIZE;
+}
+
+TcpConnection::State TcpConnection::getState() const {
+    return state;
+}
+
+bool TcpConnection::isSynchronized() const {
+    return state >= ESTABLISHED;
+}
+
+const Util::Network::Ip4::Ip4PortAddress& TcpConnection::getLocalAddress() const {
+    return localAddress;
+}
+
+const Util::Network::Ip4::Ip4PortAddress& TcpConnection::getRemoteAddress() const {
+    return remoteAddress;
+}
+
+WaitQueue& TcpConnection::getWaitQueue() {
+    return waitQueue;
+}
+
+void TcpConnection::handleConnectionRequest(const Util::Network::Tcp::TcpHeader &header) {
+    lock.acquire();
+    receiveNext = header.getSequenceNumber() + 1;
+    parseOptions(header);
+
+    initialSendSequence = generateInitialSequenceNumber();
+    sendUnacknowledged = initialSendSequence;
+    sendNext = initialSendSequence + 1;
+    sendMaximum = sendNext;
+    sendBufferSequence = sendNext;
+    sendWindow = header.getWindowSize();
+    sendWindowUpdateSequence = header.getSequenceNumber();
+    state = SYN_RECEIVED;
+
+    restartRetransmissionTimer();
+    lock.release();
+}
+
+void TcpConnection::answerConnectionRequest() {
+    lock.acquire();
+    if (state == SYN_RECEIVED) {
+        sendSynchronize();
+    }
+
+    lock.release();
+}
+
+void TcpConnection::handleSegment(const Util::Network::Tcp::TcpHeader &header, const uint8_t *payload, uint32_t payloadLength) {
+    lock.acquire();
+    if (state == CLOSED) {
+        lock.release();
+        return;
+    }
+
+    if (state == SYN_SENT) {
+        handleSynSent(header);
+        lock.release();
+        waitQueue.wakeUp();
+        return;
+    }
+
+    // Check, if the segment lies (at least partially) inside the receive window (RFC 9293, section 3.10.7.4)
+    auto sequenceNumber = header.getSequenceNumber();
+    auto segmentLength = payloadLength + (header.hasFlag(Util::Network::Tcp::TcpHeader::SYN) ? 1 : 0) + (header.hasFlag(Util::Network::Tcp::TcpHeader::FIN) ? 1 : 0);
+    auto window = RECEIVE_BUFFER_SIZE - receiveBufferLength;
+    bool acceptable;
+    if (segmentLength == 0) {
+        acceptable = window == 0 ? sequenceNumber == receiveNext : sequenceLessEqual(receiveNext, sequenceNumber) && sequenceLess(sequenceNumber, receiveNext + window);
+    } else {
+        auto lastSequenceNumber = sequenceNumber + segmentLength - 1;
+        acceptable = window > 0 && ((sequenceLessEqual(receiveNext, sequenceNumber) && sequenceLess(sequenceNumber, receiveNext + window)) ||
+                (sequenceLessEqual(receiveNext, lastSequenceNumber) && sequenceLess(lastSequenceNumber, receiveNext + window)));
+    }
+
+    if (!acceptable) {
+        if (state == TIME_WAIT && header.hasFlag(Util::Network::Tcp::TcpHeader::FIN)) {
+            // Our last acknowledgement has been lost -> Stay in TIME_WAIT for another period
+            closeDeadline = getTime() + TIME_WAIT_TIMEOUT;
+        }
+
+        if (!header.hasFlag(Util::Network::Tcp::TcpHeader::RST)) {
+            sendAcknowledgement();
+        }
+
+        lock.release();
+        return;
+    }
+
+    if (header.hasFlag(Util::Network::Tcp::TcpHeader::RST)) {
+        // Only accept resets matching the next expected sequence number, otherwise send a challenge acknowledgement (RFC 5961)
+        if (sequenceNumber == receiveNext) {
+            setClosed(true);
+        } else {
+            sendAcknowledgement();
+        }
+
+        lock.release();
+        waitQueue.wakeUp();
+        return;
+    }
+
+    if (header.hasFlag(Util::Network::Tcp::TcpHeader::SYN) || !header.hasFlag(Util::Network::Tcp::TcpHeader::ACK)) {
+        // A SYN in a synchronized state is answered with a challenge acknowledgement (RFC 5961), segments without ACK are dropped
+        if (header.hasFlag(Util::Network::Tcp::TcpHeader::SYN)) {
+            sendAcknowledgement();
+        }
+
+        lock.release();
+        return;
+    }
+
+    // Trim the segment to the part, which has not been received yet and fits into the receive window
+    const auto *data = payload;
+    auto dataLength = payloadLength;
+    bool fin = header.hasFlag(Util::Network::Tcp::TcpHeader::FIN);
+    if (sequenceLess(sequenceNumber, receiveNext)) {
+        auto skip = receiveNext - sequenceNumber;
+        if (skip >= dataLength) {
+            fin = fin && skip == dataLength;
+            dataLength = 0;
+        } else {
+            data += skip;
+            dataLength -= skip;
+        }
+
+        sequenceNumber = receiveNext;
+    }
+
+    if (dataLength > window) {
+        dataLength = window;
+        fin = false;
+    }
+
+    if (state == SYN_RECEIVED) {
+        auto acknowledgementNumber = header.getAcknowledgementNumber();
+        if (!sequenceLess(sendUnacknowledged, acknowledgementNumber) || sequenceLess(sendMaximum, acknowledgementNumber)) {
+            sendSegment(acknowledgementNumber, Util::Network::Tcp::TcpHeader::RST, 0, 0);
+            lock.release();
+            return;
+        }
+
+        // Our SYN has been acknowledged
+        if (measuringRoundTripTime) {
+            updateRoundTripTime(getTime() - roundTripTimeStart);
+            measuringRoundTripTime = false;
+        }
+
+        sendUnacknowledged = initialSendSequence + 1;
+        sendWindow = static_cast<uint32_t>(header.getWindowSize()) << sendWindowShift;
+        sendWindowUpdateSequence = header.getSequenceNumber();
+        sendWindowUpdateAcknowledgement = acknowledgementNumber;
+        retransmissionDeadline = 0;
+        retransmissionCount = 0;
+        initializeCongestionWindow();
+        state = ESTABLISHED;
+    }
+
+    if (!handleAcknowledgement(header, payloadLength)) {
+        lock.release();
+        return;
+    }
+
+    switch (state) {
+        case FIN_WAIT_1:
+            if (isFinAcknowledged()) {
+                state = FIN_WAIT_2;
+                if (orphaned) {
+                    closeDeadline = getTime() + FIN_WAIT_2_TIMEOUT;
+                }
+            }
+            break;
+        case CLOSING:
+            if (isFinAcknowledged()) {
+                enterTimeWait();
+            }
+            break;
+        case LAST_ACK:
+            if (isFinAcknowledged()) {
+                setClosed(false);
+                lock.release();
+                waitQueue.wakeUp();
+                return;
+            }
+            break;
+        default:
+            break;
+    }
+
+    if (state == ESTABLISHED || state == FIN_WAIT_1 || state == FIN_WAIT_2) {
+        handleData(sequenceNumber, data, dataLength);
+
+        // A FIN is only processed in order, otherwise the peer repeats it after the gap has been filled
+        if (fin && sequenceNumber + dataLength == receiveNext) {
+            handleFin();
+        }
+    }
+
+    transmit();
+    lock.release();
+    waitQueue.wakeUp();
+}
+
+void TcpConnection::handleSynSent(const Util::Network::Tcp::TcpHeader &header) {
+    auto acknowledgementNumber = header.getAcknowledgementNumber();
+    bool ack = header.hasFlag(Util::Network::Tcp::TcpHeader::ACK);
+    if (ack && (sequenceLessEqual(acknowledgementNumber, initialSendSequence) || sequenceLess(sendMaximum, acknowledgementNumber))) {
+        if (!header.hasFlag(Util::Network::Tcp::TcpHeader::RST)) {
+            sendSegment(acknowledgementNumber, Util::Network::Tcp::TcpHeader::RST, 0, 0);
+        }
+
+        return;
+    }
+
+    if (header.hasFlag(Util::Network::Tcp::TcpHeader::RST)) {
+        // Connection refused
+        if (ack) {
+            setClosed(true);
+        }
+
+        return;
+    }
+
+    if (!header.hasFlag(Util::Network::Tcp::TcpHeader::SYN)) {
+        return;
+    }
+
+    receiveNext = header.getSequenceNumber() + 1;
+    parseOptions(header);
+
+    if (!ack) {
+        // Simultaneous open
+        sendWindow = header.getWindowSize();
+        sendWindowUpdateSequence = header.getSequenceNumber();
+        state = SYN_RECEIVED;
+        sendSynchronize();
+        restartRetransmissionTimer();
+        return;
+    }
+
+    if (measuringRoundTripTime) {
+        updateRoundTripTime(getTime() - roundTripTimeStart);
+        measuringRoundTripTime = false;
+    }
+
+    // The window of a SYN segment is never scaled
+    sendUnacknowledged = acknowledgementNumber;
+    sendWindow = header.getWindowSize();
+    sendWindowUpdateSequence = header.getSequenceNumber();
+    sendWindowUpdateAcknowledgement = acknowledgementNumber;
+    retransmissionDeadline = 0;
+    retransmissionCount = 0;
+    initializeCongestionWindow();
+    state = ESTABLISHED;
+
+    sendAcknowledgement();
+}
+
+bool TcpConnection::handleAcknowledgement(const Util::Network::Tcp::TcpHeader &header, uint32_t payloadLength) {
+    auto acknowledgementNumber = header.getAcknowledgementNumber();
+    if (sequenceLess(sendMaximum, acknowledgementNumber)) {
+        // Acknowledgement for data, that has not been sent yet
+        sendAcknowledgement();
+        return false;
+    }
+
+    auto sequenceNumber = header.getSequenceNumber();
+    auto window = static_cast<uint32_t>(header.getWindowSize()) << sendWindowShift;
+
+    if (sequenceLess(sendUnacknowledged, acknowledgementNumber)) {
+        handleNewAcknowledgement(acknowledgementNumber);
+    } else if (acknowledgementNumber == sendUnacknowledged) {
+        if (payloadLength == 0 && !header.hasFlag(Util::Network::Tcp::TcpHeader::FIN) && window == sendWindow && getFlightSize() > 0) {
+            handleDuplicateAcknowledgement();
+        } else if (sendWindow == 0) {
+            // The peer answers our window probes, so it is still alive
+            retransmissionCount = 0;
+        }
+    }
+
+    // Update the send window, unless the segment is older than the last window update
+    if (sequenceLess(sendWindowUpdateSequence, sequenceNumber) || (sendWindowUpdateSequence == sequenceNumber && sequenceLessEqual(sendWindowUpdateAcknowledgement, acknowledgementNumber))) {
+        sendWindow = window;
+        sendWindowUpdateSequence = sequenceNumber;
+        sendWindowUpdateAcknowledgement = acknowledgementNumber;
+
+        if (sendWindow > 0) {
+            persistDeadline = 0;
+        }
+    }
+
+    return true;
+}
+
+void TcpConnection::handleNewAcknowledgement(uint32_t acknowledgementNumber) {
+    auto acknowledged = acknowledgementNumber - sendUnacknowledged;
+
+    // Remove acknowledged data from the send buffer (the acknowledgement may additionally cover our FIN)
+    auto acknowledgedData = acknowledgementNumber - sendBufferSequence;
+    if (acknowledgedData > sendBufferLength) {
+        acknowledgedData = sendBufferLength;
+    }
+
+    sendBufferHead = (sendBufferHead + acknowledgedData) % SEND_BUFFER_SIZE;
+    sendBufferLength -= acknowledgedData;
+    sendBufferSequence += acknowledgedData;
+    sendUnacknowledged = acknowledgementNumber;
+    if (sequenceLess(sendNext, acknowledgementNumber)) {
+        // The peer has received segments, which we have started to repeat after a timeout
+        sendNext = acknowledgementNumber;
+    }
+
+    if (finQueued && sendUnacknowledged == getFinSequenceNumber() + 1) {
+        finSent = true;
+    }
+
+    if (measuringRoundTripTime && sequenceLess(roundTripTimeSequence, acknowledgementNumber)) {
+        updateRoundTripTime(getTime() - roundTripTimeStart);
+        measuringRoundTripTime = false;
+    }
+
+    retransmissionCount = 0;
+    duplicateAcknowledgements = 0;
+
+    if (fastRecovery) {
+        if (!sequenceLess(acknowledgementNumber, recover)) {
+            // Full acknowledgement -> Leave fast recovery and deflate the congestion window (RFC 6582, section 3.2)
+            auto flightSize = getFlightSize() > sendMaximumSegmentSize ? getFlightSize() : sendMaximumSegmentSize;
+            congestionWindow = slowStartThreshold < flightSize + sendMaximumSegmentSize ? slowStartThreshold : flightSize + sendMaximumSegmentSize;
+            fastRecovery = false;
+        } else {
+            // Partial acknowledgement -> The next segment has been lost as well
+            retransmitFirstSegment();
+            congestionWindow = congestionWindow > acknowledged ? congestionWindow - acknowledged : 0;
+            if (acknowledged >= sendMaximumSegmentSize || congestionWindow < sendMaximumSegmentSize) {
+                congestionWindow += sendMaximumSegmentSize;
+            }
+        }
+    } else if (congestionWindow < slowStartThreshold) {
+        // Slow start
+        congestionWindow += acknowledged < sendMaximumSegmentSize ? acknowledged : sendMaximumSegmentSize;
+    } else {
+        // Congestion avoidance: Grow by about one segment per round trip
+        auto increment = static_cast<uint32_t>(sendMaximumSegmentSize) * sendMaximumSegmentSize / congestionWindow;
+        congestionWindow += increment > 0 ? increment : 1;
+    }
+
+    if (sendUnacknowledged == sendMaximum) {
+        retransmissionDeadline = 0;
+    } else {
+        restartRetransmissionTimer();
+    }
+}
+
+void TcpConnection::handleDuplicateAcknowledgement() {
+    duplicateAcknowledgements++;
+
+    if (fastRecovery) {
+        // Each duplicate acknowledgement signals, that a segment has left the network
+        congestionWindow += sendMaximumSegmentSize;
+        return;
+    }
+
+    if (duplicateAcknowledgements == DUPLICATE_ACKNOWLEDGEMENT_THRESHOLD && sequenceLess(recover, sendUnacknowledged)) {
+        // Fast retransmit (RFC 5681, section 3.2)
+        auto halfFlightSize = getFlightSize() / 2;
+        slowStartThreshold = halfFlightSize > 2u * sendMaximumSegmentSize ? halfFlightSize : 2u * sendMaximumSegmentSize;
+        recover = sendMaximum;
+        retransmitFirstSegment();
+        congestionWindow = slowStartThreshold + DUPLICATE_ACKNOWLEDGEMENT_THRESHOLD * sendMaximumSegmentSize;
+        fastRecovery = true;
+    }
+}
+
+void TcpConnection::handleData(uint32_t sequenceNumber, const uint8_t *payload, uint32_t payloadLength) {
+    if (payloadLength == 0) {
+        return;
+    }
+
+    if (sequenceNumber == receiveNext) {
+        copyToReceiveBuffer(0, payload, payloadLength);
+        receiveNext += payloadLength;
+        receiveBufferLength += payloadLength;
+
+        // Append out of order data, which has become contiguous
+        bool gapFilled = false;
+        while (outOfOrderRangeCount > 0 && sequenceLessEqual(outOfOrderRanges[0].start, receiveNext)) {
+            if (sequenceLess(receiveNext, outOfOrderRanges[0].end)) {
+                receiveBufferLength += outOfOrderRanges[0].end - receiveNext;
+                receiveNext = outOfOrderRanges[0].end;
+            }
+
+            for (uint32_t i = 1; i < outOfOrderRangeCount; i++) {
+                outOfOrderRanges[i - 1] = outOfOrderRanges[i];
+            }
+
+            outOfOrderRangeCount--;
+            gapFilled = true;
+        }
+
+        // Segments, which fill a gap, are acknowledged immediately (RFC 5681, section 4.2)
+        scheduleAcknowledgement(gapFilled || outOfOrderRangeCount > 0);
+    } else {
+        // Keep out of order data and send a duplicate acknowledgement to trigger fast retransmit at the peer
+        copyToReceiveBuffer(sequenceNumber - receiveNext, payload, payloadLength);
+        addOutOfOrderRange(sequenceNumber, sequenceNumber + payloadLength);
+        scheduleAcknowledgement(true);
+    }
+
+    if (orphaned) {
+        // Nobody is going to read the data anymore
+        receiveBufferHead = (receiveBufferHead + receiveBufferLength) % RECEIVE_BUFFER_SIZE;
+        receiveBufferLength = 0;
+    }
+}
+
+void TcpConnection::handleFin() {
+    receiveNext++;
+    finReceived = true;
+    sendAcknowledgement();
+
+    switch (state) {
+        case ESTABLISHED:
+            state = CLOSE_WAIT;
+            break;
+        case FIN_WAIT_1:
+            if (isFinAcknowledged()) {
+                enterTimeWait();
+            } else {
+                state = CLOSING;
+            }
+            break;
+        case FIN_WAIT_2:
+            enterTimeWait();
+            break;
+        default:
+            break;
+    }
+}
+
+void TcpConnection::copyToReceiveBuffer(uint32_t offset, const uint8_t *data, uint32_t length) {
+    auto position = (receiveBufferHead + receiveBufferLength + offset) % RECEIVE_BUFFER_SIZE;
+    auto firstLength = length < RECEIVE_BUFFER_SIZE - position ? length : RECEIVE_BUFFER_SIZE - position;
+    Util::Address<uint32_t>(receiveBuffer + position).copyRange(Util::Address<uint32_t>(data), firstLength);
+    if (firstLength < length) {
+        Util::Address<uint32_t>(receiveBuffer).copyRange(Util::Address<uint32_t>(data + firstLength), length - firstLength);
+    }
+}
+
+void TcpConnection::addOutOfOrderRange(uint32_t start, uint32_t end) {
+    auto range = Range{start, end};
+
+    // Merge with all overlapping or adjacent ranges, keeping the list sorted
+    uint32_t index = 0;
+    while (index < outOfOrderRangeCount) {
+        auto &current = outOfOrderRanges[index];
+        if (sequenceLess(range.end, current.start)) {
+            break;
+        }
+
+        if (sequenceLess(current.end, range.start)) {
+            index++;
+            continue;
+        }
+
+        if (sequenceLess(current.start, range.start)) {
+            range.start = current.start;
+        }
+        if (sequenceLess(range.end, current.end)) {
+            range.end = current.end;
+        }
+
+        for (uint32_t i = index + 1; i < outOfOrderRangeCount; i++) {
+            outOfOrderRanges[i - 1] = outOfOrderRanges[i];
+        }
+        outOfOrderRangeCount--;
+    }
+
+    if (outOfOrderRangeCount == MAX_OUT_OF_ORDER_RANGES) {
+        // The data stays in the buffer, but is not accounted for -> The peer has to repeat it
+        return;
+    }
+
+    for (uint32_t i = outOfOrderRangeCount; i > index; i--) {
+        outOfOrderRanges[i] = outOfOrderRanges[i - 1];
+    }
+
+    outOfOrderRanges[index] = range;
+    outOfOrderRangeCount++;
+}
+
+bool TcpConnection::handleTimers(uint64_t now) {
+    lock.acquire();
+    if (state == CLOSED) {
+        return lock.releaseAndReturn(false);
+    }
+
+    if (closeDeadline != 0 && now >= closeDeadline) {
+        setClosed(false);
+        lock.release();
+        waitQueue.wakeUp();
+        return false;
+    }
+
+    if (acknowledgementDeadline != 0 && now >= acknowledgementDeadline) {
+        sendAcknowledgement();
+    }
+
+    if (retransmissionDeadline != 0 && now >= retransmissionDeadline) {
+        handleRetransmissionTimeout();
+    }
+
+    if (persistDeadline != 0 && now >= persistDeadline) {
+        // Probe the zero window with an old sequence number, which forces the peer to answer with its current window
+        sendSegment(sendUnacknowledged - 1, Util::Network::Tcp::TcpHeader::ACK, 0, 0);
+        persistTimeout = persistTimeout * 2 < MAX_RETRANSMISSION_TIMEOUT ? persistTimeout * 2 : MAX_RETRANSMISSION_TIMEOUT;
+        persistDeadline = now + persistTimeout;
+    }
+
+    if (state == CLOSED) {
+        lock.release();
+        waitQueue.wakeUp();
+        return false;
+    }
+
+    return lock.releaseAndReturn(true);
+}
+
+void TcpConnection::handleRetransmissionTimeout() {
+    if (++retransmissionCount > MAX_RETRANSMISSIONS) {
+        // The peer does not answer anymore
+        setClosed(true);
+        return;
+    }
+
+    // Exponential backoff, without measuring the round trip time of repeated segments (Karn's algorithm)
+    retransmissionTimeout = retransmissionTimeout * 2 < MAX_RETRANSMISSION_TIMEOUT ? retransmissionTimeout * 2 : MAX_RETRANSMISSION_TIMEOUT;
+    measuringRoundTripTime = false;
+
+    if (state == SYN_SENT || state == SYN_RECEIVED) {
+        sendSynchronize();
+        restartRetransmissionTimer();
+        return;
+    }
+
+    // Loss detected by timeout -> Restart with slow start (RFC 5681, section 3.1)
+    auto halfFlightSize = getFlightSize() / 2;
+    slowStartThreshold = halfFlightSize > 2u * sendMaximumSegmentSize ? halfFlightSize : 2u * sendMaximumSegmentSize;
+    congestionWindow = sendMaximumSegmentSize;
+    recover = sendMaximum;
+    fastRecovery = false;
+    duplicateAcknowledgements = 0;
+
+    // Go back and send all unacknowledged data again
+    sendNext = sendUnacknowledged;
+    finSent = false;
+    transmit();
+
+    if (sendNext == sendUnacknowledged) {
+        // Nothing fits into the window -> Repeat the first segment anyway
+        retransmitFirstSegment();
+    }
+
+    restartRetransmissionTimer();
+}
+
+void TcpConnection::parseOptions(const Util::Network::Tcp::TcpHeader &header) {
+    auto maximumSegmentSize = header.getMaximumSegmentSize();
+    if (maximumSegmentSize == 0) {
+        sendMaximumSegmentSize = DEFAULT_MAXIMUM_SEGMENT_SIZE;
+    } else {
+        sendMaximumSegmentSize = maximumSegmentSize < MAXIMUM_SEGMENT_SIZE ? maximumSegmentSize : MAXIMUM_SEGMENT_SIZE;
+    }
+
+    // Window scaling is only used, if both sides announce it (RFC 7323, section 2.2)
+    windowScaling = header.hasWindowScale();
+    if (windowScaling) {
+        sendWindowShift = header.getWindowScale() < MAX_WINDOW_SHIFT ? header.getWindowScale() : MAX_WINDOW_SHIFT;
+    } else {
+        sendWindowShift = 0;
+        receiveWindowShift = 0;
+    }
+}
+
+void TcpConnection::transmit() {
+    if (state != ESTABLISHED && state != CLOSE_WAIT && state != FIN_WAIT_1 && state != CLOSING && state != LAST_ACK) {
+        return;
+    }
+
+    auto window = sendWindow < congestionWindow ? sendWindow : congestionWindow;
+    while (true) {
+        auto sentLength = sendNext - sendBufferSequence;
+        if (sentLength >= sendBufferLength) {
+            break;
+        }
+
+        auto flightSize = getFlightSize();
+        if (flightSize >= window) {
+            break;
+        }
+
+        auto unsentLength = sendBufferLength - sentLength;
+        auto length = unsentLength < window - flightSize ? unsentLength : window - flightSize;
+        if (length > sendMaximumSegmentSize) {
+            length = sendMaximumSegmentSize;
+        }
+
+        // Sender side silly window avoidance: Wait for the window to open further, instead of sending tiny segments
+        if (length < sendMaximumSegmentSize && length < unsentLength && flightSize > 0) {
+            break;
+        }
+
+        bool last = length == unsentLength;
+        if (sendNext == sendMaximum && !measuringRoundTripTime) {
+            measuringRoundTripTime = true;
+            roundTripTimeSequence = sendNext;
+            roundTripTimeStart = getTime();
+        }
+
+        sendSegment(sendNext, Util::Network::Tcp::TcpHeader::ACK | (last ? Util::Network::Tcp::TcpHeader::PSH : 0), sentLength, length);
+        sendNext += length;
+        if (sequenceLess(sendMaximum, sendNext)) {
+            sendMaximum = sendNext;
+        }
+
+        if (retransmissionDeadline == 0) {
+            restartRetransmissionTimer();
+        }
+    }
+
+    if (finQueued && !finSent && sendNext == getFinSequenceNumber()) {
+        sendSegment(sendNext, Util::Network::Tcp::TcpHeader::FIN | Util::Network::Tcp::TcpHeader::ACK, 0, 0);
+        sendNext++;
+        finSent = true;
+        if (sequenceLess(sendMaximum, sendNext)) {
+            sendMaximum = sendNext;
+        }
+
+        if (retransmissionDeadline == 0) {
+            restartRetransmissionTimer();
+        }
+    }
+
+    // The peer has closed its window -> Probe it periodically, so that a lost window update cannot stall the connection
+    if (sendWindow == 0 && sendUnacknowledged == sendMaximum && sendNext - sendBufferSequence < sendBufferLength && persistDeadline == 0) {
+        persistTimeout = retransmissionTimeout;
+        persistDeadline = getTime() + persistTimeout;
+    }
+}
+
+void TcpConnection::retransmitFirstSegment() {
+    measuringRoundTripTime = false;
+
+    if (sendBufferLength > 0) {
+        auto length = sendBufferLength < sendMaximumSegmentSize ? sendBufferLength : sendMaximumSegmentSize;
+        sendSegment(sendUnacknowledged, Util::Network::Tcp::TcpHeader::ACK, 0, length);
+    } else if (finQueued && !isFinAcknowledged()) {
+        sendSegment(getFinSequenceNumber(), Util::Network::Tcp::TcpHeader::FIN | Util::Network::Tcp::TcpHeader::ACK, 0, 0);
+    }
+}
+
+void TcpConnection::sendSegment(uint32_t sequenceNumber, uint8_t flags, uint32_t bufferOffset, uint32_t length) {
+    auto header = Util::Network::Tcp::TcpHeader();
+    header.setSourcePort(localAddress.getPort());
+    header.setDestinationPort(remoteAddress.getPort());
+    header.setSequenceNumber(sequenceNumber);
+    header.setFlags(flags);
+
+    if (flags & Util::Network::Tcp::TcpHeader::ACK) {
+        // Every segment carrying an acknowledgement makes a pending delayed acknowledgement obsolete
+        header.setAcknowledgementNumber(receiveNext);
+        acknowledgementDeadline = 0;
+        unacknowledgedSegments = 0;
+    }
+
+    bool synchronize = flags & Util::Network::Tcp::TcpHeader::SYN;
+    if (synchronize) {
+        header.setMaximumSegmentSize(MAXIMUM_SEGMENT_SIZE);
+        if (windowScaling) {
+            header.setWindowScale(receiveWindowShift);
+        }
+    }
+
+    header.setWindowSize(calculateWindow(synchronize));
+
+    Util::Io::File::Segment segments[2];
+    uint32_t segmentCount = 0;
+    if (length > 0) {
+        auto start = (sendBufferHead + bufferOffset) % SEND_BUFFER_SIZE;
+        auto firstLength = length < SEND_BUFFER_SIZE - start ? length : SEND_BUFFER_SIZE - start;
+        segments[segmentCount++] = { sendBuffer + start, firstLength };
+        if (firstLength < length) {
+            segments[segmentCount++] = { sendBuffer, length - firstLength };
+        }
+    }
+
+    TcpModule::writeSegment(header, localAddress, remoteAddress, segments, segmentCount);
+}
+
+void TcpConnection::sendSynchronize() {
+    // Measure the round trip time of the handshake, unless the SYN is repeated
+    measuringRoundTripTime = retransmissionCount == 0;
+    roundTripTimeSequence = initialSendSequence;
+    roundTripTimeStart = getTime();
+
+    sendSegment(initialSendSequence, Util::Network::Tcp::TcpHeader::SYN | (state == SYN_RECEIVED ? Util::Network::Tcp::TcpHeader::ACK : 0), 0, 0);
+}
+
+void TcpConnection::sendAcknowledgement() {
+    sendSegment(sendNext, Util::Network::Tcp::TcpHeader::ACK, 0, 0);
+}
+
+void TcpConnection::scheduleAcknowledgement(bool immediately) {
+    // Acknowledge at least every second full segment, but delay the acknowledgement otherwise (RFC 1122, section 4.2.3.2)
+    if (immediately || ++unacknowledgedSegments >= 2) {
+        sendAcknowledgement();
+    } else if (acknowledgementDeadline == 0) {
+        acknowledgementDeadline = getTime() + DELAYED_ACKNOWLEDGEMENT_TIMEOUT;
+    }
+}
+
+void TcpConnection::updateRoundTripTime(uint32_t sample) {
+    // RFC 6298, section 2
+    if (smoothedRoundTripTime == 0) {
+        smoothedRoundTripTime = sample > 0 ? sample : 1;
+        roundTripTimeVariation = sample / 2;
+    } else {
+        auto delta = smoothedRoundTripTime > sample ? smoothedRoundTripTime - sample : sample - smoothedRoundTripTime;
+        roundTripTimeVariation = (3 * roundTripTimeVariation + delta) / 4;
+        smoothedRoundTripTime = (7 * smoothedRoundTripTime + sample) / 8;
+        if (smoothedRoundTripTime == 0) {
+            smoothedRoundTripTime = 1;
+        }
+    }
+
+    auto variation = 4 * roundTripTimeVariation > CLOCK_GRANULARITY ? 4 * roundTripTimeVariation : CLOCK_GRANULARITY;
+    retransmissionTimeout = smoothedRoundTripTime + variation;
+    if (retransmissionTimeout < MIN_RETRANSMISSION_TIMEOUT) {
+        retransmissionTimeout = MIN_RETRANSMISSION_TIMEOUT;
+    } else if (retransmissionTimeout > MAX_RETRANSMISSION_TIMEOUT) {
+        retransmissionTimeout = MAX_RETRANSMISSION_TIMEOUT;
+    }
+}
+
+void TcpConnection::restartRetransmissionTimer() {
+    retransmissionDeadline = getTime() + retransmissionTimeout;
+}
+
+void TcpConnection::initializeCongestionWindow() {
+    // Initial window (RFC 5681, section 3.1)
+    uint32_t twoSegments = 2 * sendMaximumSegmentSize;
+    uint32_t fourSegments = 4 * sendMaximumSegmentSize;
+    congestionWindow = twoSegments > 4380 ? twoSegments : (fourSegments < 4380 ? fourSegments : 4380);
+    slowStartThreshold = UINT32_MAX;
+    recover = sendUnacknowledged;
+}
+
+void TcpConnection::enterTimeWait() {
+    state = TIME_WAIT;
+    retransmissionDeadline = 0;
+    persistDeadline = 0;
+    closeDeadline = getTime() + TIME_WAIT_TIMEOUT;
+}
+
+void TcpConnection::resetConnection() {
+    if (state != CLOSED && state != SYN_SENT) {
+        sendSegment(sendNext, Util::Network::Tcp::TcpHeader::RST, 0, 0);
+    }
+
+    setClosed(true);
+}
+
+void TcpConnection::setClosed(bool reset) {
+    state = CLOSED;
+    wasReset = reset;
+    retransmissionDeadline = 0;
+    persistDeadline = 0;
+    acknowledgementDeadline = 0;
+    closeDeadline = 0;
+}
+
+uint16_t TcpConnection::calculateWindow(bool synchronize) {
+    auto window = RECEIVE_BUFFER_SIZE - receiveBufferLength;
+    if (synchronize) {
+        window = window < UINT16_MAX ? window : UINT16_MAX;
+        receiveAdvertisedEdge = receiveNext + window;
+        return window;
+    }
+
+    auto scaledWindow = window >> receiveWindowShift;
+    if (scaledWindow > UINT16_MAX) {
+        scaledWindow = UINT16_MAX;
+    }
+
+    receiveAdvertisedEdge = receiveNext + (scaledWindow << receiveWindowShift);
+    return scaledWindow;
+}
+
+uint32_t TcpConnection::getFlightSize() const {
+    return sendNext - sendUnacknowledged;
+}
+
+uint32_t TcpConnection::getFinSequenceNumber() const {
+    return sendBufferSequence + sendBufferLength;
+}
+
+bool TcpConnection::isFinAcknowledged() const {
+    return finSent && sendUnacknowledged == getFinSequenceNumber() + 1;
+}
+
+uint32_t TcpConnection::generateInitialSequenceNumber() {
+    // Clock driven with a 4 microsecond tick (RFC 9293, section 3.4.1), randomized to make the sequence numbers harder to guess
+    auto random = Util::Math::Random();
+    return static_cast<uint32_t>(getTime() * 250) + static_cast<uint32_t>(random.nextRandomNumber() * UINT16_MAX);
+}
+
+uint64_t TcpConnection::getTime() {
+    return Util::Time::getSystemTime().toMilliseconds();
+}
+
+bool TcpConnection::sequenceLess(uint32_t a, uint32_t b) {
+    return static_cast<int32_t>(a - b) < 0;
+}
+
+bool TcpConnection::sequenceLessEqual(uint32_t a, uint32_t b) {
+    return static_cast<int32_t>(a - b) <= 0;
+}
+
+}
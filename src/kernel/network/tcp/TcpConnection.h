@@ -0,0 +1,332 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef HHUOS_TCPCONNECTION_H
+#define HHUOS_TCPCONNECTION_H
+
+#include <stdint.h>
+
+#include "kernel/process/WaitQueue.h"
+#include "lib/util/async/Spinlock.h"
+#include "lib/util/network/ip4/Ip4PortAddress.h"
+
+namespace Util {
+namespace Network {
+namespace Tcp {
+class TcpHeader;
+}  // namespace Tcp
+}  // namespace Network
+}  // namespace Util
+
+namespace Kernel::Network::Tcp {
+
+class TcpModule;
+class TcpSocket;
+
+/**
+ * State of a single TCP connection (RFC 9293), identified by its local and remote address.
+ * Outgoing data is kept in a ring buffer until it is acknowledged. The amount of data in flight is limited by the
+ * peer's (scaled) receive window and the congestion window, which is managed by NewReno (RFC 5681, RFC 6582).
+ * Lost segments are repeated by the retransmission timer (RFC 6298) or by fast retransmit after three duplicate acknowledgements.
+ * Incoming data is written directly to its place in the receive ring buffer, so that segments arriving out of order
+ * do not have to be repeated by the peer, once the gap is filled.
+ *
+ * All functions are synchronized by a per connection lock. The TcpModule passes segments to a connection and runs its timers
+ * without holding the socket lock, since both may send segments. It pins the connection meanwhile, so that it is not deleted.
+ * A connection must never call back into the module while holding its lock.
+ */
+class TcpConnection {
+
+friend class TcpModule;
+
+public:
+
+    enum State : uint8_t {
+        CLOSED,
+        SYN_SENT,
+        SYN_RECEIVED,
+        ESTABLISHED,
+        FIN_WAIT_1,
+        FIN_WAIT_2,
+        CLOSE_WAIT,
+        CLOSING,
+        LAST_ACK,
+        TIME_WAIT
+    };
+
+    /**
+     * Constructor.
+     */
+    TcpConnection(const Util::Network::Ip4::Ip4PortAddress &localAddress, const Util::Network::Ip4::Ip4PortAddress &remoteAddress);
+
+    /**
+     * Copy Constructor.
+     */
+    TcpConnection(const TcpConnection &other) = delete;
+
+    /**
+     * Assignment operator.
+     */
+    TcpConnection &operator=(const TcpConnection &other) = delete;
+
+    /**
+     * Destructor.
+     */
+    ~TcpConnection();
+
+    /**
+     * Perform an active open and wait for the handshake to complete.
+     *
+     * @param timeout Time in milliseconds to wait for the handshake (0 = wait until the retransmission limit is reached)
+     * @return true, if the connection has been established
+     */
+    bool connect(uint32_t timeout);
+
+    /**
+     * Read up to length bytes, blocking until at least one byte is available.
+     *
+     * @return The amount of bytes read (0, if the peer has closed the connection, the connection has been reset or the timeout has expired)
+     */
+    uint32_t read(uint8_t *targetBuffer, uint32_t length, uint32_t timeout);
+
+    /**
+     * Queue data for transmission, blocking while the send buffer is full.
+     *
+     * @return The amount of bytes queued (less than length, if the connection has been closed or the timeout has expired)
+     */
+    uint32_t write(const uint8_t *sourceBuffer, uint32_t length, uint32_t timeout);
+
+    /**
+     * Close the sending direction. Remaining data is still transmitted, followed by a FIN.
+     * If received data has not been read yet, the connection is reset instead.
+     */
+    void close();
+
+    /**
+     * Reset the connection immediately.
+     */
+    void abort();
+
+    /**
+     * Close the connection and hand it over to the TcpModule, which deletes it once it has reached the CLOSED state.
+     * Called by the owning socket, which must not use the connection afterwards.
+     */
+    void release();
+
+    [[nodiscard]] bool isReadyToRead();
+
+    [[nodiscard]] bool isReadyToWrite();
+
+    [[nodiscard]] State getState() const;
+
+    [[nodiscard]] bool isSynchronized() const;
+
+    [[nodiscard]] const Util::Network::Ip4::Ip4PortAddress& getLocalAddress() const;
+
+    [[nodiscard]] const Util::Network::Ip4::Ip4PortAddress& getRemoteAddress() const;
+
+    WaitQueue& getWaitQueue();
+
+    static const constexpr uint32_t SEND_BUFFER_SIZE = 64 * 1024;
+    static const constexpr uint32_t RECEIVE_BUFFER_SIZE = 128 * 1024;
+
+private:
+
+    static const constexpr uint16_t MAXIMUM_SEGMENT_SIZE = 1460;
+    static const constexpr uint16_t DEFAULT_MAXIMUM_SEGMENT_SIZE = 536;
+    static const constexpr uint8_t MAX_WINDOW_SHIFT = 14;
+    static const constexpr uint32_t MAX_OUT_OF_ORDER_RANGES = 8;
+    static const constexpr uint32_t DUPLICATE_ACKNOWLEDGEMENT_THRESHOLD = 3;
+    static const constexpr uint32_t INITIAL_RETRANSMISSION_TIMEOUT = 1000;
+    static const constexpr uint32_t MIN_RETRANSMISSION_TIMEOUT = 200;
+    static const constexpr uint32_t MAX_RETRANSMISSION_TIMEOUT = 60000;
+    static const constexpr uint32_t MAX_RETRANSMISSIONS = 12;
+    static const constexpr uint32_t DELAYED_ACKNOWLEDGEMENT_TIMEOUT = 40;
+    static const constexpr uint32_t CLOCK_GRANULARITY = 10;
+    static const constexpr uint32_t TIME_WAIT_TIMEOUT = 30000;
+    static const constexpr uint32_t FIN_WAIT_2_TIMEOUT = 60000;
+
+    struct Range {
+        uint32_t start;
+        uint32_t end;
+    };
+
+    /**
+     * Passive open: Initialize the connection from the SYN, which has been received by a listening socket.
+     * Called with the socket lock held, so nothing is sent yet.
+     */
+    void handleConnectionRequest(const Util::Network::Tcp::TcpHeader &header);
+
+    /**
+     * Passive open: Send the SYN/ACK, after the connection has been registered.
+     */
+    void answerConnectionRequest();
+
+    void handleSegment(const Util::Network::Tcp::TcpHeader &header, const uint8_t *payload, uint32_t payloadLength);
+
+    void handleSynSent(const Util::Network::Tcp::TcpHeader &header);
+
+    /**
+     * @return false, if the segment acknowledges data, that has not been sent yet, and must be dropped
+     */
+    bool handleAcknowledgement(const Util::Network::Tcp::TcpHeader &header, uint32_t payloadLength);
+
+    void handleNewAcknowledgement(uint32_t acknowledgementNumber);
+
+    void handleDuplicateAcknowledgement();
+
+    void handleData(uint32_t sequenceNumber, const uint8_t *payload, uint32_t payloadLength);
+
+    void handleFin();
+
+    void copyToReceiveBuffer(uint32_t offset, const uint8_t *data, uint32_t length);
+
+    void addOutOfOrderRange(uint32_t start, uint32_t end);
+
+    /**
+     * Run the timers of this connection.
+     *
+     * @return false, if the connection is closed
+     */
+    bool handleTimers(uint64_t now);
+
+    void handleRetransmissionTimeout();
+
+    void parseOptions(const Util::Network::Tcp::TcpHeader &header);
+
+    /**
+     * Send as much queued data (and a pending FIN) as the send and congestion windows allow.
+     */
+    void transmit();
+
+    void retransmitFirstSegment();
+
+    void sendSegment(uint32_t sequenceNumber, uint8_t flags, uint32_t bufferOffset, uint32_t length);
+
+    void sendSynchronize();
+
+    void sendAcknowledgement();
+
+    void scheduleAcknowledgement(bool immediately);
+
+    void updateRoundTripTime(uint32_t sample);
+
+    void restartRetransmissionTimer();
+
+    void initializeCongestionWindow();
+
+    void enterTimeWait();
+
+    void resetConnection();
+
+    void setClosed(bool reset);
+
+    /**
+     * Calculate the window to be advertised to the peer. SYN segments always carry an unscaled window.
+     */
+    [[nodiscard]] uint16_t calculateWindow(bool synchronize);
+
+    [[nodiscard]] uint32_t getFlightSize() const;
+
+    [[nodiscard]] uint32_t getFinSequenceNumber() const;
+
+    [[nodiscard]] bool isFinAcknowledged() const;
+
+    static uint32_t generateInitialSequenceNumber();
+
+    static uint64_t getTime();
+
+    static bool sequenceLess(uint32_t a, uint32_t b);
+
+    static bool sequenceLessEqual(uint32_t a, uint32_t b);
+
+    Util::Network::Ip4::Ip4PortAddress localAddress;
+    Util::Network::Ip4::Ip4PortAddress remoteAddress;
+    State state = CLOSED;
+    bool wasReset = false;
+    bool windowScaling = true;
+
+    // A connection is orphaned, while no socket refers to it (not yet accepted or already closed by the user)
+    volatile bool orphaned = true;
+    TcpSocket *listener = nullptr;
+
+    // Amount of module operations, that use the connection outside of the socket lock (guarded by the socket lock)
+    uint32_t users = 0;
+
+    // Send sequence space
+    uint32_t initialSendSequence = 0;
+    uint32_t sendUnacknowledged = 0;
+    uint32_t sendNext = 0;
+    uint32_t sendMaximum = 0;
+    uint32_t sendWindow = 0;
+    uint32_t sendWindowUpdateSequence = 0;
+    uint32_t sendWindowUpdateAcknowledgement = 0;
+    uint8_t sendWindowShift = 0;
+    uint16_t sendMaximumSegmentSize = DEFAULT_MAXIMUM_SEGMENT_SIZE;
+
+    // Send buffer, starting with the byte at sendBufferSequence
+    uint8_t *sendBuffer;
+    uint32_t sendBufferHead = 0;
+    uint32_t sendBufferLength = 0;
+    uint32_t sendBufferSequence = 0;
+    bool finQueued = false;
+    bool finSent = false;
+
+    // Receive sequence space
+    uint32_t receiveNext = 0;
+    uint32_t receiveAdvertisedEdge = 0;
+    uint8_t receiveWindowShift = 0;
+
+    // Receive buffer, containing receiveBufferLength readable bytes, followed by the out of order ranges
+    uint8_t *receiveBuffer;
+    uint32_t receiveBufferHead = 0;
+    uint32_t receiveBufferLength = 0;
+    Range outOfOrderRanges[MAX_OUT_OF_ORDER_RANGES]{};
+    uint32_t outOfOrderRangeCount = 0;
+    bool finReceived = false;
+
+    // Congestion control
+    uint32_t congestionWindow = 0;
+    uint32_t slowStartThreshold = UINT32_MAX;
+    uint32_t duplicateAcknowledgements = 0;
+    uint32_t recover = 0;
+    bool fastRecovery = false;
+
+    // Round trip time estimation
+    uint32_t smoothedRoundTripTime = 0;
+    uint32_t roundTripTimeVariation = 0;
+    uint32_t retransmissionTimeout = INITIAL_RETRANSMISSION_TIMEOUT;
+    bool measuringRoundTripTime = false;
+    uint32_t roundTripTimeSequence = 0;
+    uint64_t roundTripTimeStart = 0;
+
+    // Timers (absolute system time in milliseconds, 0 = inactive)
+    uint64_t retransmissionDeadline = 0;
+    uint64_t persistDeadline = 0;
+    uint64_t acknowledgementDeadline = 0;
+    uint64_t closeDeadline = 0;
+    uint32_t retransmissionCount = 0;
+    uint32_t persistTimeout = 0;
+    uint32_t unacknowledgedSegments = 0;
+
+    Util::Async::Spinlock lock;
+    WaitQueue waitQueue;
+};
+
+}
+
+#endif
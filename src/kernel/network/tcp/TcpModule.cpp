@@ -0,0 +1,381 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "TcpModule.h"
+
+#include "TcpConnection.h"
+#include "TcpSocket.h"
+#include "TcpTimer.h"
+#include "device/network/NetworkDevice.h"
+#include "kernel/log/Log.h"
+#include "kernel/network/Socket.h"
+#include "kernel/network/ethernet/EthernetModule.h"
+#include "kernel/network/ip4/Ip4Interface.h"
+#include "kernel/network/ip4/Ip4Module.h"
+#include "kernel/network/udp/Ip4PseudoHeader.h"
+#include "kernel/process/Scheduler.h"
+#include "kernel/process/Thread.h"
+#include "kernel/service/ProcessService.h"
+#include "kernel/service/Service.h"
+#include "lib/util/base/Exception.h"
+#include "lib/util/io/stream/ByteArrayInputStream.h"
+#include "lib/util/io/stream/ByteArrayOutputStream.h"
+#include "lib/util/network/ip4/Ip4Address.h"
+#include "lib/util/network/ip4/Ip4Header.h"
+#include "lib/util/network/ip4/Ip4PortAddress.h"
+#include "lib/util/network/tcp/TcpHeader.h"
+#include "lib/util/time/Timestamp.h"
+#include "lib/util/network/Checksum.h"
+
+namespace Kernel::Network::Tcp {
+
+bool TcpModule::registerSocket(Socket &socket) {
+    auto &socketAddress = (Util::Network::Ip4::Ip4PortAddress&) socket.getAddress();
+    bool anyAddress = socketAddress.getIp4Address() == Util::Network::Ip4::Ip4Address::ANY;
+
+    socketLock.acquire();
+    if (socketAddress.getPort() == 0) {
+        auto port = ports.allocate();
+        if (port == 0) {
+            return socketLock.releaseAndReturn(false);
+        }
+
+        socketAddress.setPort(port);
+    }
+
+    for (const auto *currentSocket : socketList) {
+        auto &currentAddress = reinterpret_cast<const Util::Network::Ip4::Ip4PortAddress&>(currentSocket->getAddress());
+        if ((currentAddress == Util::Network::Ip4::Ip4Address::ANY && socketAddress.getPort() == currentAddress.getPort()) ||
+                (anyAddress && currentAddress.getPort() == socketAddress.getPort()) ||
+                (currentSocket->getAddress() == socket.getAddress())) {
+            return socketLock.releaseAndReturn(false);
+        }
+    }
+
+    socketList.add(&socket);
+    ports.reference(socketAddress.getPort());
+    return socketLock.releaseAndReturn(true);
+}
+
+void TcpModule::deregisterSocket(Socket &socket) {
+    socketLock.acquire();
+    if (socketList.remove(&socket)) {
+        ports.release(reinterpret_cast<const Util::Network::Ip4::Ip4PortAddress&>(socket.getAddress()).getPort());
+    }
+
+    socketLock.release();
+}
+
+void TcpModule::readPacket(Util::Io::ByteArrayInputStream &stream, NetworkModule::LayerInformation information, [[maybe_unused]] Device::Network::NetworkDevice &device) {
+    const auto *segment = stream.getBuffer() + stream.getPosition();
+    if (information.payloadLength < Util::Network::Tcp::TcpHeader::HEADER_SIZE) {
+        LOG_WARN("Discarding packet, because it is too short");
+        return;
+    }
+
+    uint32_t headerLength = (segment[12] >> 4) * sizeof(uint32_t);
+    if (headerLength < Util::Network::Tcp::TcpHeader::HEADER_SIZE || headerLength > information.payloadLength) {
+        LOG_WARN("Discarding packet, because of invalid header length");
+        return;
+    }
+
+    auto pseudoHeader = Udp::Ip4PseudoHeader(information, Util::Network::Ip4::Ip4Header::TCP);
+    if (!information.checksumVerified) {
+        auto pseudoHeaderStream = Util::Io::ByteArrayOutputStream();
+        pseudoHeader.write(pseudoHeaderStream);
+
+        uint16_t receivedChecksum = (segment[Util::Network::Tcp::TcpHeader::CHECKSUM_OFFSET] << 8) | segment[Util::Network::Tcp::TcpHeader::CHECKSUM_OFFSET + 1];
+        if (receivedChecksum != calculateChecksum(pseudoHeaderStream.getBuffer(), segment, information.payloadLength)) {
+            LOG_WARN("Discarding packet, because of wrong checksum");
+            return;
+        }
+    }
+
+    auto header = Util::Network::Tcp::TcpHeader();
+    header.read(stream);
+
+    const auto *payload = segment + headerLength;
+    auto payloadLength = information.payloadLength - headerLength;
+    auto localAddress = Util::Network::Ip4::Ip4PortAddress(pseudoHeader.getDestinationAddress(), header.getDestinationPort());
+    auto remoteAddress = Util::Network::Ip4::Ip4PortAddress(pseudoHeader.getSourceAddress(), header.getSourcePort());
+
+    // Connections send segments while handling this one, which must not happen with the socket lock held
+    // (allocating a packet buffer may block and routing may fail) -> Pin the connection and release the lock
+    socketLock.acquire();
+    auto *connection = findConnection(localAddress, remoteAddress);
+    if (connection != nullptr) {
+        connection->users++;
+        socketLock.release();
+
+        connection->handleSegment(header, payload, payloadLength);
+
+        socketLock.acquire();
+        connection->users--;
+        if (connection->listener != nullptr) {
+            // The connection may have become ready to be accepted
+            connection->listener->waitQueue.wakeUp();
+        }
+
+        socketLock.release();
+        return;
+    }
+
+    auto *listener = findListener(localAddress);
+    if (listener != nullptr && header.hasFlag(Util::Network::Tcp::TcpHeader::SYN) &&
+            !header.hasFlag(Util::Network::Tcp::TcpHeader::ACK) && !header.hasFlag(Util::Network::Tcp::TcpHeader::RST)) {
+        // Connection requests exceeding the backlog are dropped silently, so that the peer retries later
+        if (listener->pendingConnections.size() < listener->backlog) {
+            connection = new TcpConnection(localAddress, remoteAddress);
+            connection->listener = listener;
+            connection->handleConnectionRequest(header);
+            connection->users++;
+            listener->pendingConnections.add(connection);
+            connections.add(connection);
+            ports.reference(localAddress.getPort());
+            startTimer();
+            socketLock.release();
+
+            connection->answerConnectionRequest();
+
+            socketLock.acquire();
+            connection->users--;
+        }
+
+        socketLock.release();
+        return;
+    }
+
+    socketLock.release();
+
+    if (!header.hasFlag(Util::Network::Tcp::TcpHeader::RST)) {
+        sendReset(header, payloadLength, localAddress, remoteAddress);
+    }
+}
+
+bool TcpModule::registerConnection(TcpConnection &connection) {
+    socketLock.acquire();
+    if (findConnection(connection.getLocalAddress(), connection.getRemoteAddress()) != nullptr) {
+        return socketLock.releaseAndReturn(false);
+    }
+
+    // The connection is still CLOSED until connect() is called -> It must not look orphaned to the timer thread
+    connection.orphaned = false;
+    connections.add(&connection);
+    ports.reference(connection.getLocalAddress().getPort());
+    startTimer();
+    return socketLock.releaseAndReturn(true);
+}
+
+TcpConnection* TcpModule::acceptConnection(TcpSocket &socket) {
+    socketLock.acquire();
+    for (auto *connection : socket.pendingConnections) {
+        if (connection->isSynchronized()) {
+            socket.pendingConnections.remove(connection);
+            connection->listener = nullptr;
+            connection->orphaned = false;
+
+            socketLock.release();
+            return connection;
+        }
+    }
+
+    socketLock.release();
+    return nullptr;
+}
+
+bool TcpModule::isConnectionPending(TcpSocket &socket) {
+    socketLock.acquire();
+    for (const auto *connection : socket.pendingConnections) {
+        if (connection->isSynchronized()) {
+            return socketLock.releaseAndReturn(true);
+        }
+    }
+
+    return socketLock.releaseAndReturn(false);
+}
+
+void TcpModule::closeListener(TcpSocket &socket) {
+    auto abortedConnections = Util::ArrayList<TcpConnection*>();
+
+    socketLock.acquire();
+    if (socketList.remove(&socket)) {
+        ports.release(reinterpret_cast<const Util::Network::Ip4::Ip4PortAddress&>(socket.getAddress()).getPort());
+    }
+
+    for (auto *connection : socket.pendingConnections) {
+        connection->listener = nullptr;
+        connection->users++;
+        abortedConnections.add(connection);
+    }
+
+    socket.pendingConnections.clear();
+    socketLock.release();
+
+    // Resetting sends a segment -> Not with the socket lock held
+    for (uint32_t i = 0; i < abortedConnections.size(); i++) {
+        abortedConnections.get(i)->abort();
+    }
+
+    socketLock.acquire();
+    for (uint32_t i = 0; i < abortedConnections.size(); i++) {
+        abortedConnections.get(i)->users--;
+    }
+
+    socketLock.release();
+}
+
+void TcpModule::writeSegment(const Util::Network::Tcp::TcpHeader &header, const Util::Network::Ip4::Ip4PortAddress &sourceAddress, const Util::Network::Ip4::Ip4PortAddress &destinationAddress, const Util::Io::File::Segment *segments, uint32_t segmentCount) {
+    auto packet = Util::Io::ByteArrayOutputStream(Device::Network::NetworkDevice::allocatePacketBuffer(), Device::Network::NetworkDevice::PACKET_BUFFER_SIZE);
+    packet.setEnforceSizeLimit(true);
+    auto segmentLength = Socket::getPayloadLength(segments, segmentCount) + header.getHeaderLength();
+
+    // Write IPv4 and Ethernet headers
+    auto sourceInterface = Ip4::Ip4Module::writeHeader(packet, sourceAddress.getIp4Address(), destinationAddress.getIp4Address(), Util::Network::Ip4::Ip4Header::TCP, segmentLength);
+
+    // Write TCP header and payload
+    auto tcpOffset = packet.getPosition();
+    header.write(packet);
+    for (uint32_t i = 0; i < segmentCount; i++) {
+        packet.write(segments[i].buffer, 0, segments[i].length);
+    }
+
+    // Write the pseudo header sum into the checksum field and let the device complete the checksum (in hardware if possible)
+    auto pseudoHeader = Udp::Ip4PseudoHeader(sourceInterface.getIp4Address(), destinationAddress.getIp4Address(), segmentLength, Util::Network::Ip4::Ip4Header::TCP);
+    auto pseudoHeaderStream = Util::Io::ByteArrayOutputStream();
+    pseudoHeader.write(pseudoHeaderStream);
+
+    auto pseudoHeaderSum = calculatePseudoHeaderSum(pseudoHeaderStream.getBuffer());
+    auto *checksumPointer = packet.getBuffer() + tcpOffset + Util::Network::Tcp::TcpHeader::CHECKSUM_OFFSET;
+    checksumPointer[0] = pseudoHeaderSum >> 8;
+    checksumPointer[1] = pseudoHeaderSum;
+
+    // Finalize and send packet
+    Ethernet::EthernetModule::finalizePacket(packet);
+    Ip4::Ip4Module::sendPacket(sourceInterface, packet.getBuffer(), packet.getLength(), tcpOffset, Util::Network::Tcp::TcpHeader::CHECKSUM_OFFSET);
+}
+
+uint16_t TcpModule::calculateChecksum(const uint8_t *pseudoHeader, const uint8_t *segment, uint16_t segmentLength) {
+    auto sum = Util::Network::Checksum::add(pseudoHeader, Udp::Ip4PseudoHeader::HEADER_SIZE);
+
+    // Ignore checksum field
+    sum = Util::Network::Checksum::add(segment, Util::Network::Tcp::TcpHeader::CHECKSUM_OFFSET, sum);
+    sum = Util::Network::Checksum::add(segment + Util::Network::Tcp::TcpHeader::CHECKSUM_OFFSET + sizeof(uint16_t), segmentLength - Util::Network::Tcp::TcpHeader::CHECKSUM_OFFSET - sizeof(uint16_t), sum);
+
+    return Util::Network::Checksum::finish(sum);
+}
+
+bool TcpModule::handleTimers() {
+    auto now = Util::Time::getSystemTime().toMilliseconds();
+
+    // Timers send segments (e.g. retransmissions) -> Run them on pinned connections without holding the socket lock
+    socketLock.acquire();
+    auto timerConnections = Util::ArrayList<TcpConnection*>(connections.size());
+    for (uint32_t i = 0; i < connections.size(); i++) {
+        auto *connection = connections.get(i);
+        connection->users++;
+        timerConnections.add(connection);
+    }
+
+    socketLock.release();
+
+    for (uint32_t i = 0; i < timerConnections.size(); i++) {
+        timerConnections.get(i)->handleTimers(now);
+    }
+
+    socketLock.acquire();
+    for (uint32_t i = 0; i < timerConnections.size(); i++) {
+        timerConnections.get(i)->users--;
+    }
+
+    // Only this thread deletes connections, but other threads may still be using a connection outside of the socket lock
+    for (uint32_t i = 0; i < connections.size();) {
+        auto *connection = connections.get(i);
+        if (connection->getState() == TcpConnection::CLOSED && connection->orphaned && connection->users == 0) {
+            if (connection->listener != nullptr) {
+                connection->listener->pendingConnections.remove(connection);
+            }
+
+            // Ports of connections, which outlived their socket (e.g. in TIME_WAIT), cannot be reused before this point
+            connections.removeIndex(i);
+            ports.release(connection->getLocalAddress().getPort());
+            delete connection;
+            continue;
+        }
+
+        i++;
+    }
+
+    return socketLock.releaseAndReturn(!connections.isEmpty());
+}
+
+TcpConnection* TcpModule::findConnection(const Util::Network::Ip4::Ip4PortAddress &localAddress, const Util::Network::Ip4::Ip4PortAddress &remoteAddress) {
+    for (auto *connection : connections) {
+        if (connection->getState() != TcpConnection::CLOSED && connection->getLocalAddress() == localAddress && connection->getRemoteAddress() == remoteAddress) {
+            return connection;
+        }
+    }
+
+    return nullptr;
+}
+
+TcpSocket* TcpModule::findListener(const Util::Network::Ip4::Ip4PortAddress &localAddress) {
+    for (auto *socket : socketList) {
+        auto *tcpSocket = reinterpret_cast<TcpSocket*>(socket);
+        auto &socketAddress = reinterpret_cast<const Util::Network::Ip4::Ip4PortAddress&>(socket->getAddress());
+        if (tcpSocket->listening && ((socketAddress.getIp4Address() == Util::Network::Ip4::Ip4Address::ANY && socketAddress.getPort() == localAddress.getPort()) || socketAddress == localAddress)) {
+            return tcpSocket;
+        }
+    }
+
+    return nullptr;
+}
+
+void TcpModule::startTimer() {
+    if (timer == nullptr) {
+        auto &processService = Service::getService<ProcessService>();
+        timer = new TcpTimer(*this);
+
+        auto &timerThread = Thread::createKernelThread("Tcp-Timer", processService.getKernelProcess(), timer);
+        processService.getScheduler().ready(timerThread);
+    }
+
+    timerWaitQueue.wakeUp();
+}
+
+void TcpModule::sendReset(const Util::Network::Tcp::TcpHeader &header, uint32_t payloadLength, const Util::Network::Ip4::Ip4PortAddress &localAddress, const Util::Network::Ip4::Ip4PortAddress &remoteAddress) {
+    auto reset = Util::Network::Tcp::TcpHeader();
+    reset.setSourcePort(localAddress.getPort());
+    reset.setDestinationPort(remoteAddress.getPort());
+
+    // RFC 9293, section 3.10.7.1
+    if (header.hasFlag(Util::Network::Tcp::TcpHeader::ACK)) {
+        reset.setSequenceNumber(header.getAcknowledgementNumber());
+        reset.setFlags(Util::Network::Tcp::TcpHeader::RST);
+    } else {
+        auto segmentLength = payloadLength + (header.hasFlag(Util::Network::Tcp::TcpHeader::SYN) ? 1 : 0) + (header.hasFlag(Util::Network::Tcp::TcpHeader::FIN) ? 1 : 0);
+        reset.setAcknowledgementNumber(header.getSequenceNumber() + segmentLength);
+        reset.setFlags(Util::Network::Tcp::TcpHeader::RST | Util::Network::Tcp::TcpHeader::ACK);
+    }
+
+    writeSegment(reset, localAddress, remoteAddress, nullptr, 0);
+}
+
+uint16_t TcpModule::calculatePseudoHeaderSum(const uint8_t *pseudoHeader) {
+    return Util::Network::Checksum::add(pseudoHeader, Udp::Ip4PseudoHeader::HEADER_SIZE);
+}
+
+}
\ No newline at end of file
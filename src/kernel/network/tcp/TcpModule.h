@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef HHUOS_TCPMODULE_H
+#define HHUOS_TCPMODULE_H
+
+#include <stdint.h>
+
+#include "kernel/network/NetworkModule.h"
+#include "kernel/network/PortAllocator.h"
+#include "kernel/process/WaitQueue.h"
+#include "lib/util/collection/ArrayList.h"
+#include "lib/util/io/file/File.h"
+
+namespace Device {
+namespace Network {
+class NetworkDevice;
+}  // namespace Network
+}  // namespace Device
+namespace Kernel::Network {
+class Socket;
+}  // namespace Network
+namespace Util {
+namespace Network {
+namespace Ip4 {
+class Ip4Address;
+class Ip4PortAddress;
+}  // namespace Ip4
+
+namespace Tcp {
+class TcpHeader;
+}  // namespace Tcp
+}  // namespace Network
+
+namespace Io {
+class ByteArrayInputStream;
+}  // namespace Stream
+}  // namespace Util
+
+namespace Kernel::Network::Tcp {
+
+class TcpConnection;
+class TcpSocket;
+class TcpTimer;
+
+/**
+ * Demultiplexes incoming TCP segments to their connections and creates new connections for listening sockets.
+ * Segments, which do not belong to any connection, are answered with a reset.
+ * The timers of all connections are run by a kernel thread, which is started with the first connection
+ * and sleeps, while there are no connections. Closed connections, that are no longer used by a socket, are deleted by this thread.
+ */
+class TcpModule : public NetworkModule {
+
+friend class TcpTimer;
+
+public:
+    /**
+     * Default Constructor.
+     */
+    TcpModule() = default;
+
+    /**
+     * Copy Constructor.
+     */
+    TcpModule(const TcpModule &other) = delete;
+
+    /**
+     * Assignment operator.
+     */
+    TcpModule &operator=(const TcpModule &other) = delete;
+
+    /**
+     * Destructor.
+     */
+    ~TcpModule() = default;
+
+    bool registerSocket(Socket &socket) override;
+
+    void deregisterSocket(Socket &socket) override;
+
+    void readPacket(Util::Io::ByteArrayInputStream &stream, LayerInformation information, Device::Network::NetworkDevice &device) override;
+
+    /**
+     * Add a connection, created by an active open, so that it receives incoming segments.
+     * The connection is owned by the calling socket from now on, so it is not deleted by the timer thread.
+     *
+     * @return false, if a connection between the same addresses already exists
+     */
+    bool registerConnection(TcpConnection &connection);
+
+    /**
+     * Take an established connection from the queue of a listening socket.
+     *
+     * @return The connection, or nullptr if no connection is ready to be accepted
+     */
+    TcpConnection* acceptConnection(TcpSocket &socket);
+
+    /**
+     * Check if a listening socket has an established connection, that is ready to be accepted.
+     */
+    bool isConnectionPending(TcpSocket &socket);
+
+    /**
+     * Deregister a listening socket and reset all connections, which have not been accepted yet.
+     */
+    void closeListener(TcpSocket &socket);
+
+    static void writeSegment(const Util::Network::Tcp::TcpHeader &header, const Util::Network::Ip4::Ip4PortAddress &sourceAddress, const Util::Network::Ip4::Ip4PortAddress &destinationAddress, const Util::Io::File::Segment *segments, uint32_t segmentCount);
+
+    static uint16_t calculateChecksum(const uint8_t *pseudoHeader, const uint8_t *segment, uint16_t segmentLength);
+
+private:
+
+    /**
+     * Run the timers of all connections and delete closed connections, which are not used anymore.
+     *
+     * @return false, if there are no connections left
+     */
+    bool handleTimers();
+
+    TcpConnection* findConnection(const Util::Network::Ip4::Ip4PortAddress &localAddress, const Util::Network::Ip4::Ip4PortAddress &remoteAddress);
+
+    TcpSocket* findListener(const Util::Network::Ip4::Ip4PortAddress &localAddress);
+
+    void startTimer();
+
+    static void sendReset(const Util::Network::Tcp::TcpHeader &header, uint32_t payloadLength, const Util::Network::Ip4::Ip4PortAddress &localAddress, const Util::Network::Ip4::Ip4PortAddress &remoteAddress);
+
+    static uint16_t calculatePseudoHeaderSum(const uint8_t *pseudoHeader);
+
+    Util::ArrayList<TcpConnection*> connections;
+    PortAllocator ports;
+    TcpTimer *timer = nullptr;
+    WaitQueue timerWaitQueue;
+};
+
+}
+
+#endif
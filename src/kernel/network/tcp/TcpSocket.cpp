@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "TcpSocket.h"
+
+#include "TcpConnection.h"
+#include "TcpModule.h"
+#include "kernel/network/NetworkStack.h"
+#include "kernel/network/ip4/Ip4Module.h"
+#include "kernel/network/ip4/Ip4RoutingModule.h"
+#include "kernel/process/Scheduler.h"
+#include "kernel/service/FilesystemService.h"
+#include "kernel/service/NetworkService.h"
+#include "kernel/service/ProcessService.h"
+#include "kernel/service/Service.h"
+#include "lib/util/base/Exception.h"
+#include "lib/util/network/NetworkAddress.h"
+#include "lib/util/network/Socket.h"
+#include "lib/util/network/ip4/Ip4Address.h"
+#include "lib/util/network/ip4/Ip4PortAddress.h"
+#include "lib/util/network/ip4/Ip4Route.h"
+#include "lib/util/time/Timestamp.h"
+
+namespace Kernel::Network::Tcp {
+
+TcpSocket::TcpSocket() : Socket(Service::getService<NetworkService>().getNetworkStack().getTcpModule(), Util::Network::Socket::TCP),
+        tcpModule(Service::getService<NetworkService>().getNetworkStack().getTcpModule()) {}
+
+TcpSocket::TcpSocket(TcpConnection &connection) : TcpSocket() {
+    TcpSocket::connection = &connection;
+
+    // Accepted sockets share the port of the listening socket, so they are not registered at the module
+    bindAddress = new Util::Network::Ip4::Ip4PortAddress(connection.getLocalAddress());
+    remoteAddress = new Util::Network::Ip4::Ip4PortAddress(connection.getRemoteAddress());
+}
+
+TcpSocket::~TcpSocket() {
+    if (listening) {
+        tcpModule.closeListener(*this);
+    } else {
+        tcpModule.deregisterSocket(*this);
+    }
+
+    if (connection != nullptr) {
+        connection->release();
+    }
+}
+
+bool TcpSocket::control(uint32_t request, const Util::Array<uint32_t> &parameters) {
+    switch (request) {
+        case Util::Network::Socket::Request::CONNECT: {
+            if (parameters.length() < 1) {
+                Util::Exception::throwException(Util::Exception::INVALID_ARGUMENT, "TcpSocket: Missing parameters!");
+            }
+
+            return connect(*reinterpret_cast<Util::Network::NetworkAddress*>(parameters[0]));
+        }
+        case Util::Network::Socket::Request::LISTEN: {
+            if (parameters.length() < 1) {
+                Util::Exception::throwException(Util::Exception::INVALID_ARGUMENT, "TcpSocket: Missing parameters!");
+            }
+
+            listen(parameters[0]);
+            return true;
+        }
+        case Util::Network::Socket::Request::ACCEPT: {
+            if (parameters.length() < 1) {
+                Util::Exception::throwException(Util::Exception::INVALID_ARGUMENT, "TcpSocket: Missing parameters!");
+            }
+
+            auto fileDescriptor = accept();
+            *reinterpret_cast<int32_t*>(parameters[0]) = fileDescriptor;
+            return fileDescriptor >= 0;
+        }
+        default:
+            return Socket::control(request, parameters);
+    }
+}
+
+bool TcpSocket::send([[maybe_unused]] const Util::Network::Datagram &datagram, [[maybe_unused]] const Util::Io::File::Segment *segments, [[maybe_unused]] uint32_t segmentCount) {
+    return false;
+}
+
+Util::Network::Datagram* TcpSocket::receive() {
+    return nullptr;
+}
+
+Util::String TcpSocket::getName() {
+    return isBound() ? bindAddress->toString() : Util::String("tcp");
+}
+
+Util::Io::File::Type TcpSocket::getType() {
+    return Util::Io::File::CHARACTER;
+}
+
+uint64_t TcpSocket::getLength() {
+    return 0;
+}
+
+Util::Array<Util::String> TcpSocket::getChildren() {
+    return Util::Array<Util::String>(0);
+}
+
+uint64_t TcpSocket::readData(uint8_t *targetBuffer, [[maybe_unused]] uint64_t pos, uint64_t numBytes) {
+    if (connection == nullptr) {
+        Util::Exception::throwException(Util::Exception::ILLEGAL_STATE, "TcpSocket: Not connected!");
+    }
+
+    return connection->read(targetBuffer, numBytes > UINT32_MAX ? UINT32_MAX : numBytes, timeout);
+}
+
+uint64_t TcpSocket::writeData(const uint8_t *sourceBuffer, [[maybe_unused]] uint64_t pos, uint64_t numBytes) {
+    if (connection == nullptr) {
+        Util::Exception::throwException(Util::Exception::ILLEGAL_STATE, "TcpSocket: Not connected!");
+    }
+
+    return connection->write(sourceBuffer, numBytes > UINT32_MAX ? UINT32_MAX : numBytes, timeout);
+}
+
+bool TcpSocket::isReadyToRead() {
+    if (listening) {
+        return tcpModule.isConnectionPending(*this);
+    }
+
+    return connection != nullptr && connection->isReadyToRead();
+}
+
+bool TcpSocket::isReadyToWrite() {
+    return connection != nullptr && connection->isReadyToWrite();
+}
+
+WaitQueue* TcpSocket::getWaitQueue() {
+    return connection == nullptr ? &waitQueue : &connection->getWaitQueue();
+}
+
+bool TcpSocket::connect(const Util::Network::NetworkAddress &address) {
+    if (connection != nullptr || listening) {
+        Util::Exception::throwException(Util::Exception::ILLEGAL_STATE, "TcpSocket: Already connected or listening!");
+    }
+    if (address.getType() != Util::Network::NetworkAddress::IP4_PORT) {
+        Util::Exception::throwException(Util::Exception::INVALID_ARGUMENT, "TcpSocket: Illegal address type!");
+    }
+
+    if (!isBound()) {
+        bind(Util::Network::Ip4::Ip4PortAddress());
+    }
+
+    Socket::connect(address);
+    auto &destinationAddress = reinterpret_cast<const Util::Network::Ip4::Ip4PortAddress&>(*remoteAddress);
+    auto sourceAddress = reinterpret_cast<const Util::Network::Ip4::Ip4PortAddress&>(*bindAddress);
+
+    // The connection is identified by a concrete local address, which is chosen by the routing module
+    if (sourceAddress.getIp4Address() == Util::Network::Ip4::Ip4Address::ANY) {
+        auto &routingModule = Service::getService<NetworkService>().getNetworkStack().getIp4Module().getRoutingModule();
+        sourceAddress = Util::Network::Ip4::Ip4PortAddress(routingModule.findRoute(Util::Network::Ip4::Ip4Address::ANY, destinationAddress.getIp4Address()).getSourceAddress(), sourceAddress.getPort());
+    }
+
+    auto *newConnection = new TcpConnection(sourceAddress, destinationAddress);
+    if (!tcpModule.registerConnection(*newConnection)) {
+        delete newConnection;
+        Util::Exception::throwException(Util::Exception::INVALID_ARGUMENT, "TcpSocket: Address already in use!");
+    }
+
+    connection = newConnection;
+    return connection->connect(timeout);
+}
+
+void TcpSocket::listen(uint32_t backlog) {
+    if (!isBound()) {
+        Util::Exception::throwException(Util::Exception::ILLEGAL_STATE, "TcpSocket: Not yet bound!");
+    }
+    if (connection != nullptr) {
+        Util::Exception::throwException(Util::Exception::ILLEGAL_STATE, "TcpSocket: Already connected!");
+    }
+
+    TcpSocket::backlog = backlog == 0 ? 1 : (backlog > MAX_BACKLOG ? MAX_BACKLOG : backlog);
+    listening = true;
+}
+
+int32_t TcpSocket::accept() {
+    if (!listening) {
+        Util::Exception::throwException(Util::Exception::ILLEGAL_STATE, "TcpSocket: Not listening!");
+    }
+
+    auto &scheduler = Service::getService<ProcessService>().getScheduler();
+    WaitQueue::ThreadListener listener(scheduler.getCurrentThread());
+    waitQueue.add(listener);
+
+    auto startTime = Util::Time::getSystemTime().toMilliseconds();
+    auto *acceptedConnection = tcpModule.acceptConnection(*this);
+    while (acceptedConnection == nullptr) {
+        if (timeout > 0) {
+            auto elapsedTime = Util::Time::getSystemTime().toMilliseconds() - startTime;
+            if (elapsedTime >= timeout) {
+                return -1;
+            }
+
+            scheduler.wait(Util::Time::Timestamp::ofMilliseconds(timeout - elapsedTime));
+        } else {
+            scheduler.wait(Util::Time::Timestamp());
+        }
+
+        acceptedConnection = tcpModule.acceptConnection(*this);
+    }
+
+    return Service::getService<FilesystemService>().registerFile(new TcpSocket(*acceptedConnection));
+}
+
+}
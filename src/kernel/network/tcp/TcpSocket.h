@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef HHUOS_TCPSOCKET_H
+#define HHUOS_TCPSOCKET_H
+
+#include <stdint.h>
+
+#include "kernel/network/Socket.h"
+#include "kernel/process/WaitQueue.h"
+#include "lib/util/base/String.h"
+#include "lib/util/collection/Array.h"
+#include "lib/util/collection/ArrayList.h"
+#include "lib/util/io/file/File.h"
+
+namespace Util {
+namespace Network {
+class Datagram;
+class NetworkAddress;
+}  // namespace Network
+}  // namespace Util
+
+namespace Kernel::Network::Tcp {
+
+class TcpConnection;
+class TcpModule;
+
+/**
+ * Stream socket on top of a TcpConnection. Data is transferred via the regular file API (readData()/writeData()),
+ * datagram functions are not supported. A socket is either connected actively (CONNECT request),
+ * or listens for incoming connections (LISTEN request), which are handed out as new sockets (ACCEPT request).
+ */
+class TcpSocket : public Socket {
+
+friend class TcpModule;
+
+public:
+    /**
+     * Default Constructor.
+     */
+    TcpSocket();
+
+    /**
+     * Constructor for connections, which have been accepted by a listening socket.
+     */
+    explicit TcpSocket(TcpConnection &connection);
+
+    /**
+     * Copy Constructor.
+     */
+    TcpSocket(const TcpSocket &other) = delete;
+
+    /**
+     * Assignment operator.
+     */
+    TcpSocket &operator=(const TcpSocket &other) = delete;
+
+    /**
+     * Destructor.
+     */
+    ~TcpSocket() override;
+
+    bool control(uint32_t request, const Util::Array<uint32_t> &parameters) override;
+
+    bool send(const Util::Network::Datagram &datagram, const Util::Io::File::Segment *segments, uint32_t segmentCount) override;
+
+    Util::Network::Datagram* receive() override;
+
+    /**
+     * Overriding function from Node.
+     */
+    Util::String getName() override;
+
+    /**
+     * Overriding function from Node.
+     */
+    Util::Io::File::Type getType() override;
+
+    /**
+     * Overriding function from Node.
+     */
+    uint64_t getLength() override;
+
+    /**
+     * Overriding function from Node.
+     */
+    Util::Array<Util::String> getChildren() override;
+
+    /**
+     * Overriding function from Node.
+     */
+    uint64_t readData(uint8_t *targetBuffer, uint64_t pos, uint64_t numBytes) override;
+
+    /**
+     * Overriding function from Node.
+     */
+    uint64_t writeData(const uint8_t *sourceBuffer, uint64_t pos, uint64_t numBytes) override;
+
+    /**
+     * Overriding function from Node.
+     */
+    bool isReadyToRead() override;
+
+    /**
+     * Overriding function from Node.
+     */
+    bool isReadyToWrite() override;
+
+    /**
+     * Overriding function from Node.
+     */
+    WaitQueue* getWaitQueue() override;
+
+private:
+
+    bool connect(const Util::Network::NetworkAddress &address);
+
+    void listen(uint32_t backlog);
+
+    int32_t accept();
+
+    TcpModule &tcpModule;
+    TcpConnection *connection = nullptr;
+
+    bool listening = false;
+    uint32_t backlog = 0;
+    Util::ArrayList<TcpConnection*> pendingConnections;
+    WaitQueue waitQueue;
+
+    static const constexpr uint32_t MAX_BACKLOG = 64;
+};
+
+}
+
+#endif
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef HHUOS_TCPTIMER_H
+#define HHUOS_TCPTIMER_H
+
+#include <stdint.h>
+
+#include "lib/util/async/Runnable.h"
+
+namespace Kernel::Network::Tcp {
+
+class TcpModule;
+
+/**
+ * Runs the retransmission, delayed acknowledgement, persist and TIME_WAIT timers of all TCP connections.
+ */
+class TcpTimer : public Util::Async::Runnable {
+
+public:
+    /**
+     * Constructor.
+     */
+    explicit TcpTimer(TcpModule &tcpModule);
+
+    /**
+     * Copy Constructor.
+     */
+    TcpTimer(const TcpTimer &other) = delete;
+
+    /**
+     * Assignment operator.
+     */
+    TcpTimer &operator=(const TcpTimer &other) = delete;
+
+    /**
+     * Destructor.
+     */
+    ~TcpTimer() override = default;
+
+    void run() override;
+
+private:
+
+    TcpModule &tcpModule;
+
+    static const constexpr uint32_t INTERVAL = 10;
+};
+
+}
+
+#endif
@@ -31,20 +31,22 @@ class OutputStream;
 
 namespace Kernel::Network::Udp {
 
-Ip4PseudoHeader::Ip4PseudoHeader(const Util::Network::Ip4::Ip4Address &sourceAddress, const Util::Network::Ip4::Ip4Address &destinationAddress, uint16_t datagramLength) :
+Ip4PseudoHeader::Ip4PseudoHeader(const Util::Network::Ip4::Ip4Address &sourceAddress, const Util::Network::Ip4::Ip4Address &destinationAddress, uint16_t datagramLength, Util::Network::Ip4::Ip4Header::Protocol protocol) :
         sourceAddress(sourceAddress),
         destinationAddress(destinationAddress),
-        datagramLength(datagramLength) {}
+        datagramLength(datagramLength),
+        protocol(protocol) {}
 
-Ip4PseudoHeader::Ip4PseudoHeader(const NetworkModule::LayerInformation &information) :
+Ip4PseudoHeader::Ip4PseudoHeader(const NetworkModule::LayerInformation &information, Util::Network::Ip4::Ip4Header::Protocol protocol) :
         sourceAddress(reinterpret_cast<const Util::Network::Ip4::Ip4Address&>(information.sourceAddress)),
         destinationAddress(reinterpret_cast<const Util::Network::Ip4::Ip4Address&>(information.destinationAddress)),
-        datagramLength(information.payloadLength) {}
+        datagramLength(information.payloadLength),
+        protocol(protocol) {}
 
 void Ip4PseudoHeader::write(Util::Io::OutputStream &stream) const {
     sourceAddress.write(stream);
     destinationAddress.write(stream);
-    Util::Network::NumberUtil::writeUnsigned16BitValue(Util::Network::Ip4::Ip4Header::UDP, stream);
+    Util::Network::NumberUtil::writeUnsigned16BitValue(protocol, stream);
     Util::Network::NumberUtil::writeUnsigned16BitValue(datagramLength, stream);
 }
 
@@ -25,6 +25,7 @@
 
 #include "lib/util/network/ip4/Ip4Address.h"
 #include "kernel/network/NetworkModule.h"
+#include "lib/util/network/ip4/Ip4Header.h"
 
 namespace Util {
 namespace Io {
@@ -34,18 +35,21 @@ class OutputStream;
 
 namespace Kernel::Network::Udp {
 
+/**
+ * Pseudo header, which is prepended to UDP datagrams and TCP segments for checksum calculation.
+ */
 class Ip4PseudoHeader {
 
 public:
     /**
      * Constructor.
      */
-    Ip4PseudoHeader(const Util::Network::Ip4::Ip4Address &sourceAddress, const Util::Network::Ip4::Ip4Address &destinationAddress, uint16_t datagramLength);
+    Ip4PseudoHeader(const Util::Network::Ip4::Ip4Address &sourceAddress, const Util::Network::Ip4::Ip4Address &destinationAddress, uint16_t datagramLength, Util::Network::Ip4::Ip4Header::Protocol protocol = Util::Network::Ip4::Ip4Header::UDP);
 
     /**
      * Constructor.
      */
-    explicit Ip4PseudoHeader(const NetworkModule::LayerInformation &information);
+    explicit Ip4PseudoHeader(const NetworkModule::LayerInformation &information, Util::Network::Ip4::Ip4Header::Protocol protocol = Util::Network::Ip4::Ip4Header::UDP);
 
     /**
      * Copy Constructor.
@@ -77,6 +81,7 @@ private:
     const Util::Network::Ip4::Ip4Address sourceAddress;
     const Util::Network::Ip4::Ip4Address destinationAddress;
     const uint16_t datagramLength;
+    const Util::Network::Ip4::Ip4Header::Protocol protocol;
 };
 
 }
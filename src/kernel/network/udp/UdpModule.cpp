@@ -28,8 +28,6 @@
 #include "device/network/NetworkDevice.h"
 #include "kernel/log/Log.h"
 #include "lib/util/async/Spinlock.h"
-#include "lib/util/collection/ArrayList.h"
-#include "lib/util/collection/Iterator.h"
 #include "lib/util/io/stream/ByteArrayInputStream.h"
 #include "lib/util/network/NetworkAddress.h"
 #include "kernel/network/Socket.h"
@@ -40,32 +38,95 @@
 #include "kernel/network/udp/UdpSocket.h"
 #include "lib/util/base/Exception.h"
 #include "lib/util/network/ip4/Ip4Address.h"
+#include "lib/util/async/Atomic.h"
+#include "lib/util/async/Thread.h"
+#include "lib/util/base/Address.h"
+#include "lib/util/network/Checksum.h"
+#include "lib/util/collection/Array.h"
 
 namespace Kernel::Network::Udp {
 
 bool UdpModule::registerSocket(Socket &socket) {
+    auto &udpSocket = reinterpret_cast<UdpSocket&>(socket);
     auto &socketAddress = (Util::Network::Ip4::Ip4PortAddress&) socket.getAddress();
     bool anyAddress = socketAddress.getIp4Address() == Util::Network::Ip4::Ip4Address::ANY;
 
     socketLock.acquire();
     if (socketAddress.getPort() == 0) {
-        socketAddress.setPort(generatePort(socketAddress.getIp4Address()));
+        auto port = ports.allocate();
+        if (port == 0) {
+            return socketLock.releaseAndReturn(false);
+        }
+
+        socketAddress.setPort(port);
     }
 
-    for (const auto *currentSocket : socketList) {
-        auto &currentAddress = reinterpret_cast<const Util::Network::Ip4::Ip4PortAddress&>(currentSocket->getAddress());
-        if ((currentAddress == Util::Network::Ip4::Ip4Address::ANY && socketAddress.getPort() == currentAddress.getPort()) ||
-                (anyAddress && currentAddress.getPort() == socketAddress.getPort()) ||
-                (currentSocket->getAddress() == socket.getAddress())) {
+    uint8_t key[Util::Network::Ip4::Ip4PortAddress::ADDRESS_LENGTH];
+    socketAddress.getAddress(key);
+    auto port = socketAddress.getPort();
+
+    // A socket bound to Ip4Address::ANY claims the whole port, other sockets only their address and port
+    if (anyAddress) {
+        if (ports.isUsed(port)) {
+            return socketLock.releaseAndReturn(false);
+        }
+    } else {
+        if (findSocket(key) != nullptr) {
+            return socketLock.releaseAndReturn(false);
+        }
+
+        uint8_t anyKey[Util::Network::Ip4::Ip4PortAddress::ADDRESS_LENGTH]{};
+        Util::Address<uint32_t>(anyKey).setShort(port, Util::Network::Ip4::Ip4Address::ADDRESS_LENGTH);
+        if (findSocket(anyKey) != nullptr) {
             return socketLock.releaseAndReturn(false);
         }
     }
 
-    socketList.add(&socket);
+    // Link the socket completely, before publishing it to lock-free readers
+    auto *volatile *bucket = getBucket(key);
+    udpSocket.nextSocket = *bucket;
+    asm volatile ("" : : : "memory");
+    *bucket = &udpSocket;
+
+    ports.reference(port);
     return socketLock.releaseAndReturn(true);
 }
 
+void UdpModule::deregisterSocket(Socket &socket) {
+    if (!socket.isBound()) {
+        return;
+    }
+
+    uint8_t key[Util::Network::Ip4::Ip4PortAddress::ADDRESS_LENGTH];
+    socket.getAddress().getAddress(key);
+
+    // Only compare pointers while searching, since this is also called from ~Socket(), after ~UdpSocket() has run
+    socketLock.acquire();
+    auto *volatile *link = getBucket(key);
+    while (*link != nullptr && *link != reinterpret_cast<UdpSocket*>(&socket)) {
+        link = &(*link)->nextSocket;
+    }
+
+    if (*link == nullptr) {
+        socketLock.release();
+        return;
+    }
+
+    // Readers, that currently look at the socket, can still follow its next pointer
+    auto *udpSocket = *link;
+    *link = udpSocket->nextSocket;
+    ports.release(reinterpret_cast<const Util::Network::Ip4::Ip4PortAddress&>(socket.getAddress()).getPort());
+
+    waitForReaders();
+    socketLock.release();
+}
+
 void UdpModule::readPacket(Util::Io::ByteArrayInputStream &stream, NetworkModule::LayerInformation information, [[maybe_unused]] Device::Network::NetworkDevice &device) {
+    if (information.payloadLength < Util::Network::Udp::UdpHeader::HEADER_SIZE) {
+        LOG_WARN("Discarding packet, because it is too short");
+        return;
+    }
+
     auto pseudoHeader = Ip4PseudoHeader(information);
     auto header = Util::Network::Udp::UdpHeader();
     header.read(stream);
@@ -73,31 +134,59 @@ void UdpModule::readPacket(Util::Io::ByteArrayInputStream &stream, NetworkModule
     auto pseudoHeaderStream = Util::Io::ByteArrayOutputStream();
     pseudoHeader.write(pseudoHeaderStream);
 
-    auto checksum = calculateChecksum(pseudoHeaderStream.getBuffer(), stream.getBuffer() + stream.getPosition() - Util::Network::Udp::UdpHeader::HEADER_SIZE, information.payloadLength);
+    // The network device may have already verified the checksum
+    auto checksum = information.checksumVerified ? header.getChecksum() : calculateChecksum(pseudoHeaderStream.getBuffer(), stream.getBuffer() + stream.getPosition() - Util::Network::Udp::UdpHeader::HEADER_SIZE, information.payloadLength);
     if (header.getChecksum() != checksum) {
         LOG_WARN("Discarding packet, because of wrong checksum");
         return;
     }
 
-    auto sourceAddress = Util::Network::Ip4::Ip4PortAddress(reinterpret_cast<const Util::Network::Ip4::Ip4Address&>(information.sourceAddress), header.getSourcePort());
     auto destinationAddress = Util::Network::Ip4::Ip4PortAddress(pseudoHeader.getDestinationAddress(), header.getDestinationPort());
     auto payloadLength = header.getDatagramLength() - Util::Network::Udp::UdpHeader::HEADER_SIZE;
     auto *datagramBuffer = stream.getBuffer() + stream.getPosition();
 
-    socketLock.acquire();
-    for (auto *socket : socketList) {
-        auto &socketAddress = reinterpret_cast<const Util::Network::Ip4::Ip4PortAddress&>(socket->getAddress());
-        if ((socketAddress.getIp4Address() == Util::Network::Ip4::Ip4Address::ANY && socketAddress.getPort() == destinationAddress.getPort()) || socketAddress == destinationAddress) {
-            auto *datagram = new Util::Network::Udp::UdpDatagram(datagramBuffer, payloadLength, sourceAddress);
-            reinterpret_cast<UdpSocket *>(socket)->handleIncomingDatagram(datagram);
-        }
+    uint8_t key[Util::Network::Ip4::Ip4PortAddress::ADDRESS_LENGTH];
+    destinationAddress.getAddress(key);
+
+    // Bind conflicts guarantee, that at most one socket matches (either the exact address or Ip4Address::ANY)
+    // The epoch may flip between loading it and announcing this reader in its counter, which the writer would miss
+    // -> Check the epoch again after announcing and retry with the new one, if it has changed
+    auto epoch = Util::Async::Atomic<uint32_t>(readerEpoch).get();
+    Util::Async::Atomic<uint32_t>(readerCounts[epoch]).inc();
+    while (Util::Async::Atomic<uint32_t>(readerEpoch).get() != epoch) {
+        Util::Async::Atomic<uint32_t>(readerCounts[epoch]).dec();
+        epoch = Util::Async::Atomic<uint32_t>(readerEpoch).get();
+        Util::Async::Atomic<uint32_t>(readerCounts[epoch]).inc();
     }
-    socketLock.release();
+
+    auto *socket = findSocket(key);
+    if (socket == nullptr) {
+        Util::Address<uint32_t>(key).setRange(0, Util::Network::Ip4::Ip4Address::ADDRESS_LENGTH);
+        socket = findSocket(key);
+    }
+
+    if (socket != nullptr) {
+        auto sourceAddress = Util::Network::Ip4::Ip4PortAddress(reinterpret_cast<const Util::Network::Ip4::Ip4Address&>(information.sourceAddress), header.getSourcePort());
+        socket->handleIncomingDatagram(new Util::Network::Udp::UdpDatagram(datagramBuffer, payloadLength, sourceAddress));
+    }
+
+    Util::Async::Atomic<uint32_t>(readerCounts[epoch]).dec();
 }
 
 void UdpModule::writePacket(const Util::Network::Ip4::Ip4PortAddress &sourceAddress, const Util::Network::Ip4::Ip4PortAddress &destinationAddress, const uint8_t *buffer, uint16_t length) {
-    auto packet = Util::Io::ByteArrayOutputStream();
-    auto datagramLength = length + Util::Network::Udp::UdpHeader::HEADER_SIZE;
+    const Util::Io::File::Segment segment = { const_cast<uint8_t*>(buffer), length };
+    writePacket(sourceAddress, destinationAddress, &segment, 1);
+}
+
+void UdpModule::writePacket(const Util::Network::Ip4::Ip4PortAddress &sourceAddress, const Util::Network::Ip4::Ip4PortAddress &destinationAddress, const Util::Io::File::Segment *segments, uint32_t segmentCount) {
+    auto datagramLength = Socket::getPayloadLength(segments, segmentCount) + Util::Network::Udp::UdpHeader::HEADER_SIZE;
+    if (datagramLength > Ip4::Ip4Module::MAX_FRAGMENT_PAYLOAD_LENGTH) {
+        writeFragmentedPacket(sourceAddress, destinationAddress, segments, segmentCount, datagramLength);
+        return;
+    }
+
+    auto packet = Util::Io::ByteArrayOutputStream(Device::Network::NetworkDevice::allocatePacketBuffer(), Device::Network::NetworkDevice::PACKET_BUFFER_SIZE);
+    packet.setEnforceSizeLimit(true);
 
     // Write IPv4 and Ethernet headers
     auto sourceInterface = Ip4::Ip4Module::writeHeader(packet, sourceAddress.getIp4Address(), destinationAddress.getIp4Address(), Util::Network::Ip4::Ip4Header::UDP, datagramLength);
@@ -111,70 +200,100 @@ void UdpModule::writePacket(const Util::Network::Ip4::Ip4PortAddress &sourceAddr
     auto positionAfterHeaders = packet.getPosition();
 
     // Write packet
-    packet.write(buffer, 0, length);
+    for (uint32_t i = 0; i < segmentCount; i++) {
+        packet.write(segments[i].buffer, 0, segments[i].length);
+    }
 
-    // Calculate and write checksum
+    // Write the pseudo header sum into the checksum field and let the device complete the checksum (in hardware if possible)
     auto pseudoHeader = Ip4PseudoHeader(sourceInterface.getIp4Address(), destinationAddress.getIp4Address(), datagramLength);
     auto pseudoHeaderStream = Util::Io::ByteArrayOutputStream();
     pseudoHeader.write(pseudoHeaderStream);
 
-    auto checksum = calculateChecksum(pseudoHeaderStream.getBuffer(), packet.getBuffer() + (positionAfterHeaders - Util::Network::Udp::UdpHeader::HEADER_SIZE), datagramLength);
+    auto pseudoHeaderSum = calculatePseudoHeaderSum(pseudoHeaderStream.getBuffer());
     auto *checksumPointer = packet.getBuffer() + (positionAfterHeaders - sizeof(uint16_t));
-    checksumPointer[0] = checksum >> 8;
-    checksumPointer[1] = checksum;
+    checksumPointer[0] = pseudoHeaderSum >> 8;
+    checksumPointer[1] = pseudoHeaderSum;
 
     // Finalize and send packet
     Ethernet::EthernetModule::finalizePacket(packet);
-    sourceInterface.getDevice().sendPacket(packet.getBuffer(), packet.getLength());
+    Ip4::Ip4Module::sendPacket(sourceInterface, packet.getBuffer(), packet.getLength(), positionAfterHeaders - Util::Network::Udp::UdpHeader::HEADER_SIZE, CHECKSUM_OFFSET);
 }
 
-uint16_t UdpModule::calculateChecksum(const uint8_t *pseudoHeader, const uint8_t *datagram, uint16_t datagramLength) {
-    uint32_t checksum = 0;
-    for (uint16_t i = 0; i < Ip4PseudoHeader::HEADER_SIZE; i += 2) {
-        checksum += (pseudoHeader[i] << 8) | pseudoHeader[i + 1];
+void UdpModule::writeFragmentedPacket(const Util::Network::Ip4::Ip4PortAddress &sourceAddress, const Util::Network::Ip4::Ip4PortAddress &destinationAddress,
+                                      const Util::Io::File::Segment *segments, uint32_t segmentCount, uint16_t datagramLength) {
+    // The checksum field contains the pseudo header sum, just like for single packets (see writePacket())
+    auto sourceIp4Address = Ip4::Ip4Module::getSourceAddress(sourceAddress.getIp4Address(), destinationAddress.getIp4Address());
+    auto pseudoHeader = Ip4PseudoHeader(sourceIp4Address, destinationAddress.getIp4Address(), datagramLength);
+    auto pseudoHeaderStream = Util::Io::ByteArrayOutputStream();
+    pseudoHeader.write(pseudoHeaderStream);
+    auto pseudoHeaderSum = calculatePseudoHeaderSum(pseudoHeaderStream.getBuffer());
+
+    uint8_t headerBuffer[Util::Network::Udp::UdpHeader::HEADER_SIZE];
+    auto headerStream = Util::Io::ByteArrayOutputStream(headerBuffer, sizeof(headerBuffer));
+    auto udpHeader = Util::Network::Udp::UdpHeader();
+    udpHeader.setSourcePort(sourceAddress.getPort());
+    udpHeader.setDestinationPort(destinationAddress.getPort());
+    udpHeader.setDatagramLength(datagramLength);
+    udpHeader.write(headerStream);
+    headerBuffer[CHECKSUM_OFFSET] = pseudoHeaderSum >> 8;
+    headerBuffer[CHECKSUM_OFFSET + 1] = pseudoHeaderSum;
+
+    auto datagramSegments = Util::Array<Util::Io::File::Segment>(segmentCount + 1);
+    datagramSegments[0] = { headerBuffer, sizeof(headerBuffer) };
+    for (uint32_t i = 0; i < segmentCount; i++) {
+        datagramSegments[i + 1] = segments[i];
     }
 
-    for (uint16_t i = 0; i < datagramLength; i += 2) {
-        // Ignore checksum field
-        if (i == 6) {
-            continue;
-        }
+    Ip4::Ip4Module::sendFragments(sourceIp4Address, destinationAddress.getIp4Address(), Util::Network::Ip4::Ip4Header::UDP, &datagramSegments[0], datagramSegments.length(), CHECKSUM_OFFSET);
+}
+
+uint16_t UdpModule::calculateChecksum(const uint8_t *pseudoHeader, const uint8_t *datagram, uint16_t datagramLength) {
+    auto sum = Util::Network::Checksum::add(pseudoHeader, Ip4PseudoHeader::HEADER_SIZE);
+
+    // Ignore checksum field
+    sum = Util::Network::Checksum::add(datagram, CHECKSUM_OFFSET, sum);
+    sum = Util::Network::Checksum::add(datagram + CHECKSUM_OFFSET + sizeof(uint16_t), datagramLength - CHECKSUM_OFFSET - sizeof(uint16_t), sum);
+
+    return Util::Network::Checksum::finish(sum);
+}
 
-        if (i == datagramLength - 1) {
-            checksum += datagram[i] << 8;
-        } else {
-            checksum += (datagram[i] << 8) | datagram[i + 1];
+uint16_t UdpModule::calculatePseudoHeaderSum(const uint8_t *pseudoHeader) {
+    return Util::Network::Checksum::add(pseudoHeader, Ip4PseudoHeader::HEADER_SIZE);
+}
+
+UdpSocket* UdpModule::findSocket(const uint8_t *key) {
+    uint8_t socketKey[Util::Network::Ip4::Ip4PortAddress::ADDRESS_LENGTH];
+    for (auto *socket = *getBucket(key); socket != nullptr; socket = socket->nextSocket) {
+        socket->getAddress().getAddress(socketKey);
+        if (Util::Address<uint32_t>(socketKey).compareRange(Util::Address<uint32_t>(key), sizeof(socketKey)) == 0) {
+            return socket;
         }
     }
 
-    // Add overflow bits
-    while (checksum >> 16 > 0) {
-        checksum = (checksum >> 16) + (checksum & 0xffff);
-    }
+    return nullptr;
+}
 
-    // Complement result
-    return ~checksum;
+UdpSocket* volatile* UdpModule::getBucket(const uint8_t *key) {
+    bool anyAddress = key[0] == 0 && key[1] == 0 && key[2] == 0 && key[3] == 0;
+    return anyAddress ? &portTable[hash(key)] : &addressTable[hash(key)];
 }
 
-uint16_t UdpModule::generatePort(const Util::Network::Ip4::Ip4Address &address) {
-    bool anyAddress = address == Util::Network::Ip4::Ip4Address::ANY;
-
-    for (uint32_t i = 1024; i < UINT16_MAX; i++) {
-        bool validPort = true;
-        for (auto *socket : socketList) {
-            auto &socketAddress = reinterpret_cast<const Util::Network::Ip4::Ip4PortAddress&>(socket->getAddress());
-            if (socketAddress.getPort() == i && (anyAddress || socketAddress == Util::Network::Ip4::Ip4Address::ANY || socketAddress.getIp4Address() == address)) {
-                validPort = false;
-                break;
-            }
-        }
+void UdpModule::waitForReaders() {
+    // Readers, that started before the epoch flip, may still reference an unlinked socket.
+    // Every such reader has announced itself in the old counter, since readers only proceed after confirming their epoch.
+    auto oldEpoch = readerEpoch;
+    Util::Async::Atomic<uint32_t>(readerEpoch).set(oldEpoch ^ 1);
 
-        if (validPort) {
-            return i;
-        }
+    while (Util::Async::Atomic<uint32_t>(readerCounts[oldEpoch]).get() != 0) {
+        Util::Async::Thread::yield();
     }
+}
+
+uint32_t UdpModule::hash(const uint8_t *key) {
+    uint32_t value = (key[0] << 24 | key[1] << 16 | key[2] << 8 | key[3]) ^ (key[4] << 8 | key[5]);
 
-    Util::Exception::throwException(Util::Exception::INVALID_ARGUMENT, "UdpModule: Address already in use!");
+    // Fibonacci hashing, which spreads consecutive addresses and ports across the whole table
+    return (value * 0x9e3779b1) >> (32 - TABLE_BITS);
 }
 
 }
@@ -24,6 +24,8 @@
 #include <stdint.h>
 
 #include "kernel/network/NetworkModule.h"
+#include "kernel/network/PortAllocator.h"
+#include "lib/util/io/file/File.h"
 
 namespace Device {
 namespace Network {
@@ -48,6 +50,14 @@ class ByteArrayInputStream;
 
 namespace Kernel::Network::Udp {
 
+class UdpSocket;
+
+/**
+ * Incoming datagrams are demultiplexed via two hash tables: One for sockets bound to a specific address (keyed by address and port)
+ * and one for sockets bound to Ip4Address::ANY (keyed by port only). Both tables are read without taking the socket lock.
+ * Writers (bind/close) are serialized by the socket lock and wait for all readers, that may still see a removed socket,
+ * before the socket is destroyed.
+ */
 class UdpModule : public NetworkModule {
 
 public:
@@ -71,17 +81,52 @@ public:
      */
     ~UdpModule() = default;
 
-    virtual bool registerSocket(Socket &socket) override;
+    bool registerSocket(Socket &socket) override;
+
+    void deregisterSocket(Socket &socket) override;
 
     void readPacket(Util::Io::ByteArrayInputStream &stream, LayerInformation information, Device::Network::NetworkDevice &device) override;
 
     static void writePacket(const Util::Network::Ip4::Ip4PortAddress &sourceAddress, const Util::Network::Ip4::Ip4PortAddress &destinationAddress, const uint8_t *buffer, uint16_t length);
 
+    static void writePacket(const Util::Network::Ip4::Ip4PortAddress &sourceAddress, const Util::Network::Ip4::Ip4PortAddress &destinationAddress, const Util::Io::File::Segment *segments, uint32_t segmentCount);
+
     static uint16_t calculateChecksum(const uint8_t *pseudoHeader, const uint8_t *datagram, uint16_t datagramLength);
 
 private:
 
-    uint16_t generatePort(const Util::Network::Ip4::Ip4Address &address);
+    /**
+     * Send a datagram, which is too large for a single packet, as multiple IPv4 fragments.
+     */
+    static void writeFragmentedPacket(const Util::Network::Ip4::Ip4PortAddress &sourceAddress, const Util::Network::Ip4::Ip4PortAddress &destinationAddress,
+                                      const Util::Io::File::Segment *segments, uint32_t segmentCount, uint16_t datagramLength);
+
+    static uint16_t calculatePseudoHeaderSum(const uint8_t *pseudoHeader);
+
+    /**
+     * Keys are the raw bytes of an Ip4PortAddress (4 bytes address, followed by 2 bytes port).
+     */
+    UdpSocket* findSocket(const uint8_t *key);
+
+    UdpSocket* volatile* getBucket(const uint8_t *key);
+
+    void waitForReaders();
+
+    static uint32_t hash(const uint8_t *key);
+
+    static const constexpr uint16_t CHECKSUM_OFFSET = 6;
+    static const constexpr uint32_t TABLE_BITS = 8;
+    static const constexpr uint32_t TABLE_SIZE = 1 << TABLE_BITS;
+
+    UdpSocket *volatile addressTable[TABLE_SIZE]{};
+    UdpSocket *volatile portTable[TABLE_SIZE]{};
+
+    // Readers announce themselves in the counter of the current epoch (and retry, if it has flipped meanwhile),
+    // writers flip the epoch and wait for the old counter to drain
+    uint32_t readerEpoch = 0;
+    uint32_t readerCounts[2]{};
+
+    PortAllocator ports;
 };
 
 }
@@ -27,6 +27,7 @@
 #include "lib/util/network/ip4/Ip4PortAddress.h"
 #include "lib/util/network/Socket.h"
 #include "kernel/service/Service.h"
+#include "lib/util/base/Exception.h"
 
 namespace Kernel::Network::Udp {
 
@@ -37,13 +38,33 @@ UdpSocket::~UdpSocket() {
     udpModule.deregisterSocket(*this);
 }
 
-bool UdpSocket::send(const Util::Network::Datagram &datagram) {
+bool UdpSocket::send(const Util::Network::Datagram &datagram, const Util::Io::File::Segment *segments, uint32_t segmentCount) {
     const auto &sourceAddress = reinterpret_cast<const Util::Network::Ip4::Ip4PortAddress&>(*bindAddress);
     const auto &destinationAddress = reinterpret_cast<const Util::Network::Ip4::Ip4PortAddress&>(datagram.getRemoteAddress());
-    UdpModule::writePacket(sourceAddress, destinationAddress, datagram.getData(), datagram.getLength());
+    if (getPayloadLength(segments, segmentCount) > MAX_PAYLOAD_SIZE) {
+        return false;
+    }
+
+    UdpModule::writePacket(sourceAddress, destinationAddress, segments, segmentCount);
     return true;
 }
 
+uint64_t UdpSocket::writeData(const uint8_t *sourceBuffer, [[maybe_unused]] uint64_t pos, uint64_t numBytes) {
+    if (!isBound() || !isConnected()) {
+        Util::Exception::throwException(Util::Exception::ILLEGAL_STATE, "UdpSocket: Not bound or connected!");
+    }
+
+    const auto &sourceAddress = reinterpret_cast<const Util::Network::Ip4::Ip4PortAddress&>(*bindAddress);
+    const auto &destinationAddress = reinterpret_cast<const Util::Network::Ip4::Ip4PortAddress&>(*remoteAddress);
+
+    for (uint64_t offset = 0; offset < numBytes; offset += MAX_PAYLOAD_SIZE) {
+        auto length = numBytes - offset > MAX_PAYLOAD_SIZE ? MAX_PAYLOAD_SIZE : numBytes - offset;
+        UdpModule::writePacket(sourceAddress, destinationAddress, sourceBuffer + offset, length);
+    }
+
+    return numBytes;
+}
+
 uint16_t UdpSocket::getPort() const {
     return reinterpret_cast<const Util::Network::Ip4::Ip4PortAddress*>(bindAddress)->getPort();
 }
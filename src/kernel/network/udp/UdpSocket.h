@@ -35,6 +35,8 @@ namespace Kernel::Network::Udp {
 
 class UdpSocket : public DatagramSocket {
 
+friend class UdpModule;
+
 public:
     /**
      * Default Constructor.
@@ -56,9 +58,25 @@ public:
      */
     ~UdpSocket() override;
 
-    bool send(const Util::Network::Datagram &datagram) override;
+    bool send(const Util::Network::Datagram &datagram, const Util::Io::File::Segment *segments, uint32_t segmentCount) override;
+
+    /**
+     * Send data to the remote address, set via connect(). The data is split into datagrams of at most MAX_PAYLOAD_SIZE bytes.
+     */
+    uint64_t writeData(const uint8_t *sourceBuffer, uint64_t pos, uint64_t numBytes) override;
 
     [[nodiscard]] uint16_t getPort() const;
+
+    /**
+     * Largest payload of a single datagram (65535 bytes maximum IPv4 packet length - IPv4 header - UDP header).
+     * Datagrams, which do not fit into a single ethernet frame, are sent as multiple IPv4 fragments.
+     */
+    static const constexpr uint32_t MAX_PAYLOAD_SIZE = 65507;
+
+private:
+
+    // Next socket in the same bucket of the UdpModule's socket tables
+    UdpSocket *volatile nextSocket = nullptr;
 };
 
 }
@@ -0,0 +1,256 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+#include "EventQueueNode.h"
+
+#include "kernel/process/FileDescriptor.h"
+#include "kernel/process/Scheduler.h"
+#include "kernel/service/FilesystemService.h"
+#include "kernel/service/ProcessService.h"
+#include "kernel/service/Service.h"
+#include "lib/util/async/Atomic.h"
+#include "lib/util/base/Exception.h"
+#include "lib/util/time/Timestamp.h"
+
+namespace Kernel {
+
+EventQueueNode::Watch::Watch(EventQueueNode &eventQueue, int32_t fileDescriptor, Filesystem::Node &node, uint8_t events) :
+        eventQueue(eventQueue), fileDescriptor(fileDescriptor), node(node), signaling(node.getWaitQueue() != nullptr), events(events) {}
+
+void EventQueueNode::Watch::wakeUp() {
+    Util::Async::Atomic<uint32_t>(pending).set(1);
+    eventQueue.waitQueue.wakeUp();
+}
+
+EventQueueNode::~EventQueueNode() {
+    watchLock.acquire();
+    for (uint32_t i = 0; i < watches.size(); i++) {
+        delete watches.get(i);
+    }
+
+    watches.clear();
+    watchLock.release();
+}
+
+Util::String EventQueueNode::getName() {
+    return "event-queue";
+}
+
+Util::Io::File::Type EventQueueNode::getType() {
+    return Util::Io::File::CHARACTER;
+}
+
+uint64_t EventQueueNode::getLength() {
+    return 0;
+}
+
+Util::Array<Util::String> EventQueueNode::getChildren() {
+    return Util::Array<Util::String>(0);
+}
+
+uint64_t EventQueueNode::readData([[maybe_unused]] uint8_t *targetBuffer, [[maybe_unused]] uint64_t pos, [[maybe_unused]] uint64_t numBytes) {
+    return 0;
+}
+
+uint64_t EventQueueNode::writeData([[maybe_unused]] const uint8_t *sourceBuffer, [[maybe_unused]] uint64_t pos, [[maybe_unused]] uint64_t numBytes) {
+    return 0;
+}
+
+bool EventQueueNode::isReadyToRead() {
+    watchLock.acquire();
+    for (uint32_t i = 0; i < watches.size(); i++) {
+        auto *watch = watches.get(i);
+        auto pending = watch->signaling ? watch->pending != 0 : (FilesystemService::getReadyEvents(watch->node, watch->events) & ~watch->lastReadyEvents) != 0;
+        if (pending) {
+            watchLock.release();
+            return true;
+        }
+    }
+
+    watchLock.release();
+    return false;
+}
+
+bool EventQueueNode::isReadyToWrite() {
+    return false;
+}
+
+WaitQueue* EventQueueNode::getWaitQueue() {
+    return &waitQueue;
+}
+
+bool EventQueueNode::control(uint32_t request, const Util::Array<uint32_t> &parameters) {
+    switch (request) {
+        case Util::Io::EventQueue::ADD:
+            if (parameters.length() < 2) {
+                Util::Exception::throwException(Util::Exception::INVALID_ARGUMENT, "EventQueue: Missing parameters for adding a file descriptor!");
+            }
+
+            return add(static_cast<int32_t>(parameters[0]), parameters[1]);
+        case Util::Io::EventQueue::REMOVE:
+            if (parameters.length() < 1) {
+                Util::Exception::throwException(Util::Exception::INVALID_ARGUMENT, "EventQueue: Missing parameter for removing a file descriptor!");
+            }
+
+            return remove(static_cast<int32_t>(parameters[0]));
+        case Util::Io::EventQueue::WAIT: {
+            if (parameters.length() < 4) {
+                Util::Exception::throwException(Util::Exception::INVALID_ARGUMENT, "EventQueue: Missing parameters for waiting!");
+            }
+
+            auto *events = reinterpret_cast<Util::Io::EventQueue::Event*>(parameters[0]);
+            auto &eventCount = *reinterpret_cast<uint32_t*>(parameters[3]);
+            eventCount = wait(events, parameters[1], static_cast<int32_t>(parameters[2]));
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+bool EventQueueNode::add(int32_t fileDescriptor, uint8_t events) {
+    auto &descriptor = Service::getService<FilesystemService>().getFileDescriptor(fileDescriptor);
+    if (!descriptor.isValid() || &descriptor.getNode() == this) {
+        return false;
+    }
+
+    auto &node = descriptor.getNode();
+    watchLock.acquire();
+
+    for (uint32_t i = 0; i < watches.size(); i++) {
+        auto *watch = watches.get(i);
+        if (watch->fileDescriptor != fileDescriptor) {
+            continue;
+        }
+
+        if (&watch->node == &node) {
+            // Modify an existing registration and report the descriptor's current state once more
+            watch->events = events;
+            watch->lastReadyEvents = 0;
+            Util::Async::Atomic<uint32_t>(watch->pending).set(1);
+            watchLock.release();
+            return true;
+        }
+
+        // The descriptor has been closed and reused in the meantime
+        delete watches.removeIndex(i);
+        break;
+    }
+
+    auto *watch = new Watch(*this, fileDescriptor, node, events);
+    if (watch->signaling) {
+        node.getWaitQueue()->add(*watch);
+    }
+
+    watches.add(watch);
+    watchLock.release();
+    return true;
+}
+
+bool EventQueueNode::remove(int32_t fileDescriptor) {
+    watchLock.acquire();
+
+    for (uint32_t i = 0; i < watches.size(); i++) {
+        if (watches.get(i)->fileDescriptor == fileDescriptor) {
+            delete watches.removeIndex(i);
+            watchLock.release();
+            return true;
+        }
+    }
+
+    watchLock.release();
+    return false;
+}
+
+uint32_t EventQueueNode::wait(Util::Io::EventQueue::Event *events, uint32_t count, int32_t timeout) {
+    auto &scheduler = Service::getService<ProcessService>().getScheduler();
+    WaitQueue::ThreadListener listener(scheduler.getCurrentThread());
+    waitQueue.add(listener);
+
+    auto startTime = Util::Time::getSystemTime().toMilliseconds();
+    uint32_t eventCount;
+    while (true) {
+        auto polling = false;
+        watchLock.acquire();
+        eventCount = collectEvents(events, count, polling);
+        watchLock.release();
+
+        if (eventCount > 0 || timeout == 0) {
+            break;
+        }
+
+        // A wait time of zero blocks the thread until it is woken up
+        uint64_t waitTime = polling ? FilesystemService::POLL_INTERVAL : 0;
+        if (timeout > 0) {
+            auto elapsedTime = Util::Time::getSystemTime().toMilliseconds() - startTime;
+            if (elapsedTime >= static_cast<uint32_t>(timeout)) {
+                break;
+            }
+
+            auto remainingTime = timeout - elapsedTime;
+            if (!polling || remainingTime < waitTime) {
+                waitTime = remainingTime;
+            }
+        }
+
+        scheduler.wait(Util::Time::Timestamp::ofMilliseconds(waitTime));
+    }
+
+    return eventCount;
+}
+
+uint32_t EventQueueNode::collectEvents(Util::Io::EventQueue::Event *events, uint32_t count, bool &polling) {
+    auto &filesystemService = Service::getService<FilesystemService>();
+    uint32_t eventCount = 0;
+
+    for (uint32_t i = 0; i < watches.size() && eventCount < count;) {
+        auto *watch = watches.get(i);
+        auto &descriptor = filesystemService.getFileDescriptor(watch->fileDescriptor);
+        if (!descriptor.isValid() || &descriptor.getNode() != &watch->node || (watch->signaling && !watch->isAttached())) {
+            // The descriptor has been closed -> Drop the watch without touching its node
+            delete watches.removeIndex(i);
+            continue;
+        }
+
+        uint8_t readyEvents;
+        if (watch->signaling) {
+            // Every wake up counts as an edge, even if the node has already been ready before
+            if (Util::Async::Atomic<uint32_t>(watch->pending).getAndSet(0) == 0) {
+                i++;
+                continue;
+            }
+
+            readyEvents = FilesystemService::getReadyEvents(watch->node, watch->events);
+        } else {
+            auto currentEvents = FilesystemService::getReadyEvents(watch->node, watch->events);
+            readyEvents = currentEvents & ~watch->lastReadyEvents;
+            watch->lastReadyEvents = currentEvents;
+            polling = true;
+        }
+
+        if (readyEvents != 0) {
+            events[eventCount++] = Util::Io::EventQueue::Event{watch->fileDescriptor, readyEvents};
+        }
+
+        i++;
+    }
+
+    return eventCount;
+}
+
+}
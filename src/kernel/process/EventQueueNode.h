@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+#ifndef HHUOS_EVENTQUEUENODE_H
+#define HHUOS_EVENTQUEUENODE_H
+
+#include <stdint.h>
+
+#include "filesystem/Node.h"
+#include "kernel/process/WaitQueue.h"
+#include "lib/util/async/Spinlock.h"
+#include "lib/util/base/String.h"
+#include "lib/util/collection/Array.h"
+#include "lib/util/collection/ArrayList.h"
+#include "lib/util/io/file/EventQueue.h"
+#include "lib/util/io/file/File.h"
+
+namespace Kernel {
+
+/**
+ * Kernel side of Util::Io::EventQueue.
+ * Each registered file descriptor is watched by a listener, which is attached to the wait queue of the descriptor's node.
+ * When the node signals new data, the watch is marked as pending and the threads waiting on this queue are woken up.
+ * Nodes without a wait queue are checked on every wait() and reported, when they change from not ready to ready.
+ */
+class EventQueueNode : public Filesystem::Node {
+
+public:
+    /**
+     * Default Constructor.
+     */
+    EventQueueNode() = default;
+
+    /**
+     * Copy Constructor.
+     */
+    EventQueueNode(const EventQueueNode &other) = delete;
+
+    /**
+     * Assignment operator.
+     */
+    EventQueueNode &operator=(const EventQueueNode &other) = delete;
+
+    /**
+     * Destructor.
+     */
+    ~EventQueueNode() override;
+
+    /**
+     * Overriding function from Node.
+     */
+    Util::String getName() override;
+
+    /**
+     * Overriding function from Node.
+     */
+    Util::Io::File::Type getType() override;
+
+    /**
+     * Overriding function from Node.
+     */
+    uint64_t getLength() override;
+
+    /**
+     * Overriding function from Node.
+     */
+    Util::Array<Util::String> getChildren() override;
+
+    /**
+     * Overriding function from Node.
+     */
+    uint64_t readData(uint8_t *targetBuffer, uint64_t pos, uint64_t numBytes) override;
+
+    /**
+     * Overriding function from Node.
+     */
+    uint64_t writeData(const uint8_t *sourceBuffer, uint64_t pos, uint64_t numBytes) override;
+
+    /**
+     * Overriding function from Node.
+     */
+    bool isReadyToRead() override;
+
+    /**
+     * Overriding function from Node.
+     */
+    bool isReadyToWrite() override;
+
+    /**
+     * Overriding function from Node.
+     */
+    WaitQueue* getWaitQueue() override;
+
+    /**
+     * Overriding function from Node.
+     */
+    bool control(uint32_t request, const Util::Array<uint32_t> &parameters) override;
+
+private:
+
+    class Watch : public WaitQueue::Listener {
+
+    public:
+        /**
+         * Constructor.
+         */
+        Watch(EventQueueNode &eventQueue, int32_t fileDescriptor, Filesystem::Node &node, uint8_t events);
+
+        /**
+         * Copy Constructor.
+         */
+        Watch(const Watch &other) = delete;
+
+        /**
+         * Assignment operator.
+         */
+        Watch &operator=(const Watch &other) = delete;
+
+        /**
+         * Destructor.
+         */
+        ~Watch() override = default;
+
+        void wakeUp() override;
+
+        EventQueueNode &eventQueue;
+        int32_t fileDescriptor;
+        Filesystem::Node &node;
+        bool signaling;
+        uint8_t events;
+        uint8_t lastReadyEvents = 0;
+        uint32_t pending = 1;
+    };
+
+    bool add(int32_t fileDescriptor, uint8_t events);
+
+    bool remove(int32_t fileDescriptor);
+
+    uint32_t wait(Util::Io::EventQueue::Event *events, uint32_t count, int32_t timeout);
+
+    uint32_t collectEvents(Util::Io::EventQueue::Event *events, uint32_t count, bool &polling);
+
+    Util::ArrayList<Watch*> watches;
+    Util::Async::Spinlock watchLock;
+    WaitQueue waitQueue;
+};
+
+}
+
+#endif
@@ -38,6 +38,10 @@ bool FileDescriptor::control(uint32_t request, const Util::Array<uint32_t> &para
             readyToRead = node->isReadyToRead();
             return true;
         }
+        case Util::Io::File::SYNC:
+            return node->sync();
+        case Util::Io::File::TRUNCATE:
+            return node->truncate(parameters[0] | static_cast<uint64_t>(parameters[1]) << 32);
         default:
             return false;
     }
@@ -64,6 +68,14 @@ void FileDescriptor::setNode(Filesystem::Node *node) {
     FileDescriptor::node = node;
 }
 
+Filesystem::Node* FileDescriptor::releaseNode() {
+    auto *releasedNode = node;
+    node = nullptr;
+    accessMode = Util::Io::File::BLOCKING;
+
+    return releasedNode;
+}
+
 void FileDescriptor::setAccessMode(Util::Io::File::AccessMode accessMode) {
     FileDescriptor::accessMode = accessMode;
 }
@@ -67,6 +67,14 @@ public:
 
     void setNode(Filesystem::Node *node);
 
+    /**
+     * Invalidate this descriptor without deleting its node.
+     * This is used to hand a node over to another file descriptor table.
+     *
+     * @return The node, which is now owned by the caller
+     */
+    Filesystem::Node* releaseNode();
+
     void setAccessMode(Util::Io::File::AccessMode accessMode);
 
     void clear();
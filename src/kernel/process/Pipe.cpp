@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+#include "Pipe.h"
+
+#include "kernel/process/Scheduler.h"
+#include "kernel/service/ProcessService.h"
+#include "kernel/service/Service.h"
+#include "lib/util/base/Address.h"
+#include "lib/util/time/Timestamp.h"
+
+namespace Kernel {
+
+Pipe::Pipe(uint32_t capacity) : buffer(new uint8_t[capacity]), capacity(capacity) {}
+
+Pipe::~Pipe() {
+    delete[] buffer;
+}
+
+uint32_t Pipe::read(uint8_t *targetBuffer, uint32_t length) {
+    if (length == 0) {
+        return 0;
+    }
+
+    lock.acquire();
+    if (fillLevel == 0 && writers > 0) {
+        // Register at the queue before releasing the lock, so that no wake up gets lost
+        auto &scheduler = Service::getService<ProcessService>().getScheduler();
+        WaitQueue::ThreadListener listener(scheduler.getCurrentThread());
+        readerQueue.add(listener);
+
+        while (fillLevel == 0 && writers > 0) {
+            lock.release();
+            scheduler.wait(Util::Time::Timestamp());
+            lock.acquire();
+        }
+    }
+
+    auto toRead = length < fillLevel ? length : fillLevel;
+    auto firstPart = capacity - readPosition < toRead ? capacity - readPosition : toRead;
+    Util::Address<uint32_t>(targetBuffer).copyRange(Util::Address<uint32_t>(buffer + readPosition), firstPart);
+    Util::Address<uint32_t>(targetBuffer + firstPart).copyRange(Util::Address<uint32_t>(buffer), toRead - firstPart);
+
+    readPosition = (readPosition + toRead) % capacity;
+    fillLevel -= toRead;
+    lock.release();
+
+    if (toRead > 0) {
+        writerQueue.wakeUp();
+    }
+
+    return toRead;
+}
+
+uint32_t Pipe::write(const uint8_t *sourceBuffer, uint32_t length) {
+    auto &scheduler = Service::getService<ProcessService>().getScheduler();
+    WaitQueue::ThreadListener listener(scheduler.getCurrentThread());
+    uint32_t written = 0;
+
+    lock.acquire();
+    while (written < length && readers > 0) {
+        if (fillLevel == capacity) {
+            writerQueue.add(listener);
+            lock.release();
+            scheduler.wait(Util::Time::Timestamp());
+            lock.acquire();
+            continue;
+        }
+
+        auto writePosition = (readPosition + fillLevel) % capacity;
+        auto free = capacity - fillLevel;
+        auto toWrite = length - written < free ? length - written : free;
+        auto firstPart = capacity - writePosition < toWrite ? capacity - writePosition : toWrite;
+        Util::Address<uint32_t>(buffer + writePosition).copyRange(Util::Address<uint32_t>(sourceBuffer + written), firstPart);
+        Util::Address<uint32_t>(buffer).copyRange(Util::Address<uint32_t>(sourceBuffer + written + firstPart), toWrite - firstPart);
+
+        fillLevel += toWrite;
+        written += toWrite;
+
+        // Let readers drain the pipe, while we are waiting for free space
+        lock.release();
+        readerQueue.wakeUp();
+        lock.acquire();
+    }
+
+    lock.release();
+    return written;
+}
+
+bool Pipe::isReadyToRead() {
+    return fillLevel > 0 || writers == 0;
+}
+
+bool Pipe::isReadyToWrite() {
+    return fillLevel < capacity || readers == 0;
+}
+
+void Pipe::attach(bool writeEnd) {
+    lock.acquire();
+    if (writeEnd) {
+        writers++;
+    } else {
+        readers++;
+    }
+    lock.release();
+}
+
+bool Pipe::detach(bool writeEnd) {
+    lock.acquire();
+    if (writeEnd) {
+        writers--;
+    } else {
+        readers--;
+    }
+
+    auto unused = readers == 0 && writers == 0;
+    lock.release();
+
+    if (!unused) {
+        // Blocked readers need to see the end of file, blocked writers need to notice that nobody reads anymore
+        readerQueue.wakeUp();
+        writerQueue.wakeUp();
+    }
+
+    return unused;
+}
+
+WaitQueue& Pipe::getReaderQueue() {
+    return readerQueue;
+}
+
+WaitQueue& Pipe::getWriterQueue() {
+    return writerQueue;
+}
+
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+#ifndef HHUOS_PIPE_H
+#define HHUOS_PIPE_H
+
+#include <stdint.h>
+
+#include "kernel/process/WaitQueue.h"
+#include "lib/util/async/Spinlock.h"
+
+namespace Kernel {
+
+/**
+ * Anonymous pipe with a fixed size ring buffer, which is shared between a read end and a write end (see PipeNode).
+ * Readers block while the pipe is empty and writers block while it is full. Both sides are woken up via wait queues.
+ * As soon as all writers are gone, reading from an empty pipe returns 0 (end of file).
+ * As soon as all readers are gone, writing to the pipe fails.
+ */
+class Pipe {
+
+public:
+    /**
+     * Constructor.
+     */
+    explicit Pipe(uint32_t capacity = DEFAULT_CAPACITY);
+
+    /**
+     * Copy Constructor.
+     */
+    Pipe(const Pipe &other) = delete;
+
+    /**
+     * Assignment operator.
+     */
+    Pipe &operator=(const Pipe &other) = delete;
+
+    /**
+     * Destructor.
+     */
+    ~Pipe();
+
+    /**
+     * Read at least one byte, blocking while the pipe is empty.
+     *
+     * @return The amount of read bytes (0, if the pipe is empty and has no writers left)
+     */
+    uint32_t read(uint8_t *targetBuffer, uint32_t length);
+
+    /**
+     * Write all bytes, blocking while the pipe is full.
+     *
+     * @return The amount of written bytes (less than length, if all readers are gone)
+     */
+    uint32_t write(const uint8_t *sourceBuffer, uint32_t length);
+
+    [[nodiscard]] bool isReadyToRead();
+
+    [[nodiscard]] bool isReadyToWrite();
+
+    void attach(bool writeEnd);
+
+    /**
+     * Detach a read or write end and wake up the other side.
+     *
+     * @return true, if no ends are left and the pipe can be deleted
+     */
+    bool detach(bool writeEnd);
+
+    [[nodiscard]] WaitQueue& getReaderQueue();
+
+    [[nodiscard]] WaitQueue& getWriterQueue();
+
+    static const constexpr uint32_t DEFAULT_CAPACITY = 16384;
+
+private:
+
+    uint8_t *buffer;
+    uint32_t capacity;
+    uint32_t readPosition = 0;
+    uint32_t fillLevel = 0;
+    uint32_t readers = 0;
+    uint32_t writers = 0;
+
+    Util::Async::Spinlock lock;
+    WaitQueue readerQueue;
+    WaitQueue writerQueue;
+};
+
+}
+
+#endif
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+#include "PipeNode.h"
+
+#include "kernel/process/Pipe.h"
+
+namespace Kernel {
+
+PipeNode::PipeNode(Pipe &pipe, bool writeEnd) : pipe(pipe), writeEnd(writeEnd) {
+    pipe.attach(writeEnd);
+}
+
+PipeNode::~PipeNode() {
+    if (pipe.detach(writeEnd)) {
+        delete &pipe;
+    }
+}
+
+Util::String PipeNode::getName() {
+    return "pipe";
+}
+
+Util::Io::File::Type PipeNode::getType() {
+    return Util::Io::File::CHARACTER;
+}
+
+uint64_t PipeNode::getLength() {
+    return 0;
+}
+
+Util::Array<Util::String> PipeNode::getChildren() {
+    return Util::Array<Util::String>(0);
+}
+
+uint64_t PipeNode::readData(uint8_t *targetBuffer, [[maybe_unused]] uint64_t pos, uint64_t numBytes) {
+    if (writeEnd) {
+        return 0;
+    }
+
+    return pipe.read(targetBuffer, numBytes);
+}
+
+uint64_t PipeNode::writeData(const uint8_t *sourceBuffer, [[maybe_unused]] uint64_t pos, uint64_t numBytes) {
+    if (!writeEnd) {
+        return 0;
+    }
+
+    return pipe.write(sourceBuffer, numBytes);
+}
+
+bool PipeNode::isReadyToRead() {
+    return !writeEnd && pipe.isReadyToRead();
+}
+
+bool PipeNode::isReadyToWrite() {
+    return writeEnd && pipe.isReadyToWrite();
+}
+
+WaitQueue* PipeNode::getWaitQueue() {
+    return writeEnd ? &pipe.getWriterQueue() : &pipe.getReaderQueue();
+}
+
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+#ifndef HHUOS_PIPENODE_H
+#define HHUOS_PIPENODE_H
+
+#include <stdint.h>
+
+#include "filesystem/Node.h"
+#include "lib/util/base/String.h"
+#include "lib/util/collection/Array.h"
+#include "lib/util/io/file/File.h"
+
+namespace Kernel {
+class Pipe;
+class WaitQueue;
+
+/**
+ * Read or write end of an anonymous pipe. Pipe ends are not part of the filesystem,
+ * but only exist as file descriptors, which are created via the CREATE_PIPE system call.
+ * The pipe is deleted, when both of its ends have been closed.
+ */
+class PipeNode : public Filesystem::Node {
+
+public:
+    /**
+     * Constructor.
+     */
+    PipeNode(Pipe &pipe, bool writeEnd);
+
+    /**
+     * Copy Constructor.
+     */
+    PipeNode(const PipeNode &other) = delete;
+
+    /**
+     * Assignment operator.
+     */
+    PipeNode &operator=(const PipeNode &other) = delete;
+
+    /**
+     * Destructor.
+     */
+    ~PipeNode() override;
+
+    /**
+     * Overriding function from Node.
+     */
+    Util::String getName() override;
+
+    /**
+     * Overriding function from Node.
+     */
+    Util::Io::File::Type getType() override;
+
+    /**
+     * Overriding function from Node.
+     */
+    uint64_t getLength() override;
+
+    /**
+     * Overriding function from Node.
+     */
+    Util::Array<Util::String> getChildren() override;
+
+    /**
+     * Overriding function from Node.
+     */
+    uint64_t readData(uint8_t *targetBuffer, uint64_t pos, uint64_t numBytes) override;
+
+    /**
+     * Overriding function from Node.
+     */
+    uint64_t writeData(const uint8_t *sourceBuffer, uint64_t pos, uint64_t numBytes) override;
+
+    /**
+     * Overriding function from Node.
+     */
+    bool isReadyToRead() override;
+
+    /**
+     * Overriding function from Node.
+     */
+    bool isReadyToWrite() override;
+
+    /**
+     * Overriding function from Node.
+     */
+    WaitQueue* getWaitQueue() override;
+
+private:
+
+    Pipe &pipe;
+    bool writeEnd;
+};
+
+}
+
+#endif
@@ -146,8 +146,17 @@ void Scheduler::kill(Thread &thread) {
         Util::Exception::throwException(Util::Exception::INVALID_ARGUMENT,"Scheduler: A thread cannot kill itself!");
     }
 
+    // The thread may be blocked with listeners on its stack, which must not stay registered at their wait queues
     lockReadyQueue();
-    while (!joinLock.tryAcquire()) {
+    while (true) {
+        if (joinLock.tryAcquire()) {
+            if (WaitQueue::detachListeners(thread)) {
+                break;
+            }
+
+            joinLock.release();
+        }
+
         readyQueueLock.release();
         yield();
         lockReadyQueue();
@@ -157,6 +166,8 @@ void Scheduler::kill(Thread &thread) {
     sleepList.remove(SleepEntry{&thread, Util::Time::Timestamp()});
     sleepQueueLock.release();
 
+    waitList.remove(SleepEntry{&thread, Util::Time::Timestamp()});
+
     // Ready threads that are joining on the current thread
     auto *joinList = joinMap.get(thread.getId());
     for (uint32_t i = 0; i < joinList->size(); i++) {
@@ -180,6 +191,7 @@ void Scheduler::yield(bool interrupt) {
     }
 
     checkSleepList();
+    checkWaitList();
 
     auto *current = currentThread;
     auto *next = readyQueue.poll();
@@ -237,6 +249,7 @@ void Scheduler::block() {
 
     do {
         checkSleepList();
+        checkWaitList();
     } while (readyQueue.isEmpty());
 
     auto *current = currentThread;
@@ -283,6 +296,64 @@ void Scheduler::join(const Thread& thread) {
     block();
 }
 
+bool Scheduler::wait(const Util::Time::Timestamp &timeout) {
+    lockReadyQueue();
+
+    auto *current = currentThread;
+    Util::Async::Atomic<uint32_t> wakeUpPending(current->wakeUpPending);
+    if (wakeUpPending.getAndSet(0) != 0) {
+        readyQueueLock.release();
+        return true;
+    }
+
+    // Holding the ready queue lock prevents the thread from being preempted, until it has switched to the next thread
+    auto wakeupTime = timeout.toMilliseconds() == 0 ? Util::Time::Timestamp() : Util::Time::getSystemTime() + timeout;
+    waitList.add(SleepEntry{current, wakeupTime});
+
+    do {
+        checkSleepList();
+        checkWaitList();
+    } while (readyQueue.isEmpty());
+
+    auto *next = readyQueue.poll();
+    currentThread = next;
+
+    if (current == next) {
+        // The thread has been woken up, before another thread could be scheduled
+        readyQueueLock.release();
+    } else {
+        if (fpu != nullptr) {
+            Device::Fpu::armFpuMonitor();
+        }
+
+        Thread::switchThread(*current, *next);
+    }
+
+    return wakeUpPending.getAndSet(0) != 0;
+}
+
+void Scheduler::wakeUp(Thread &thread) {
+    Util::Async::Atomic<uint32_t>(thread.wakeUpPending).set(1);
+}
+
+void Scheduler::checkWaitList() {
+    if (waitList.isEmpty()) {
+        return;
+    }
+
+    auto systemTime = Service::getService<TimeService>().getSystemTime();
+    for (uint32_t i = 0; i < waitList.size();) {
+        const auto &entry = waitList.get(i);
+        auto timedOut = entry.wakeupTime.toMilliseconds() != 0 && systemTime >= entry.wakeupTime;
+        if (Util::Async::Atomic<uint32_t>(entry.thread->wakeUpPending).get() != 0 || timedOut) {
+            readyQueue.offer(entry.thread);
+            waitList.removeIndex(i);
+        } else {
+            i++;
+        }
+    }
+}
+
 void Scheduler::checkSleepList() {
     if (sleepQueueLock.tryAcquire()) {
         auto systemTime = Service::getService<TimeService>().getSystemTime();
@@ -311,6 +382,14 @@ Thread* Scheduler::getThread(uint32_t id) {
             return thread;
         }
     }
+
+    for (uint32_t i = 0; i < waitList.size(); i++) {
+        auto *thread = waitList.get(i).thread;
+        if (thread->getId() == id) {
+            readyQueueLock.release();
+            return thread;
+        }
+    }
     readyQueueLock.release();
 
     sleepQueueLock.acquire();
@@ -102,6 +102,21 @@ public:
 
     void join(const Thread &thread);
 
+    /**
+     * Block the current thread, until it is woken up via wakeUp() or the timeout has expired.
+     * A timeout of zero blocks the thread until it is woken up.
+     * A wake up, that arrives before the thread has been blocked, is not lost, but makes this function return immediately.
+     *
+     * @return true, if the thread has been woken up; false, if the timeout has expired
+     */
+    bool wait(const Util::Time::Timestamp &timeout);
+
+    /**
+     * Wake up a thread, which is blocked in wait(). The thread is put back into the ready queue by the next
+     * scheduling decision. This function does not acquire any lock and may thus be called from interrupt handlers.
+     */
+    static void wakeUp(Thread &thread);
+
     /**
      * Returns the activeFlag Thread.
      *
@@ -127,6 +142,8 @@ private:
 
     void checkSleepList();
 
+    void checkWaitList();
+
     void resetLastFpuThread(Thread &terminatedThread);
 
     struct SleepEntry {
@@ -151,6 +168,9 @@ private:
     Util::ArrayList<SleepEntry> sleepList;
     Util::Async::Spinlock sleepQueueLock;
 
+    // Threads blocked in wait() (protected by the ready queue lock)
+    Util::ArrayList<SleepEntry> waitList;
+
     Util::HashMap<uint32_t, Util::ArrayList<Thread*>*> joinMap;
     Util::Async::Spinlock joinLock;
 };
@@ -20,6 +20,7 @@
 
 #include <stdint.h>
 
+#include "kernel/process/WaitQueue.h"
 #include "lib/util/base/String.h"
 
 namespace Util {
@@ -36,6 +37,7 @@ class Process;
 class Thread {
 
     friend class Scheduler;
+    friend class WaitQueue;
 
 public:
 
@@ -121,6 +123,10 @@ private:
     uint32_t *oldStackPointer;
 
     uint8_t *fpuContext;
+    uint32_t wakeUpPending = 0;
+
+    // Listeners of this thread, that may be registered at wait queues (only modified by the thread itself)
+    WaitQueue::ThreadListener *volatile waitListeners = nullptr;
 
     static Util::Async::IdGenerator<uint32_t> idGenerator;
     static const constexpr uint32_t STACK_SIZE = 0x10000;
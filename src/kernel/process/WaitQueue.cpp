@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+#include "WaitQueue.h"
+
+#include "kernel/process/Scheduler.h"
+#include "kernel/process/Thread.h"
+#include "kernel/service/ProcessService.h"
+#include "kernel/service/Service.h"
+#include "lib/util/async/Atomic.h"
+
+namespace Kernel {
+
+WaitQueue::Listener::~Listener() {
+    if (queue != nullptr) {
+        queue->remove(*this);
+    }
+}
+
+bool WaitQueue::Listener::isAttached() const {
+    return queue != nullptr;
+}
+
+WaitQueue::ThreadListener::ThreadListener(Thread &thread) : thread(thread) {
+    // Publishing the listener with a single store keeps the list consistent, whenever the thread is preempted
+    nextListener = thread.waitListeners;
+    thread.waitListeners = this;
+}
+
+WaitQueue::ThreadListener::~ThreadListener() {
+    // Leave the queue first, so that a killed thread never leaves behind a listener, which is not in its list anymore
+    if (queue != nullptr) {
+        queue->remove(*this);
+    }
+
+    auto *volatile *link = &thread.waitListeners;
+    while (*link != nullptr && *link != this) {
+        link = &(*link)->nextListener;
+    }
+
+    if (*link == this) {
+        *link = nextListener;
+    }
+}
+
+void WaitQueue::ThreadListener::wakeUp() {
+    Scheduler::wakeUp(thread);
+}
+
+WaitQueue::~WaitQueue() {
+    lock.acquire();
+    for (auto *listener : listeners) {
+        listener->queue = nullptr;
+        listener->wakeUp();
+    }
+
+    listeners.clear();
+    lock.release();
+}
+
+void WaitQueue::add(Listener &listener) {
+    lock.acquire();
+    if (listener.queue == nullptr) {
+        listener.queue = this;
+        listeners.add(&listener);
+    }
+
+    unlock();
+}
+
+void WaitQueue::remove(Listener &listener) {
+    lock.acquire();
+    if (listener.queue == this) {
+        listener.queue = nullptr;
+        listeners.remove(&listener);
+    }
+
+    unlock();
+}
+
+void WaitQueue::wakeUp() {
+    if (!lock.tryAcquire()) {
+        // The lock's owner may be the thread, that we have interrupted -> Leave the wake up to the owner
+        Util::Async::Atomic<uint32_t>(deferredWakeUp).set(1);
+        return;
+    }
+
+    notifyListeners();
+    unlock();
+}
+
+bool WaitQueue::detachListeners(Thread &thread) {
+    for (auto *listener = thread.waitListeners; listener != nullptr; listener = listener->nextListener) {
+        auto *queue = listener->queue;
+        if (queue == nullptr) {
+            continue;
+        }
+
+        if (!queue->lock.tryAcquire()) {
+            return false;
+        }
+
+        listener->queue = nullptr;
+        queue->listeners.remove(listener);
+        queue->unlock();
+    }
+
+    // The listeners live on the thread's stack, which is about to be freed
+    thread.waitListeners = nullptr;
+    return true;
+}
+
+void WaitQueue::unlock() {
+    lock.release();
+
+    // Deliver wake ups, that have arrived while the lock was held
+    Util::Async::Atomic<uint32_t> deferred(deferredWakeUp);
+    while (deferred.get() != 0 && lock.tryAcquire()) {
+        if (deferred.getAndSet(0) != 0) {
+            notifyListeners();
+        }
+
+        lock.release();
+    }
+}
+
+void WaitQueue::notifyListeners() {
+    for (uint32_t i = 0; i < listeners.size(); i++) {
+        listeners.get(i)->wakeUp();
+    }
+}
+
+}
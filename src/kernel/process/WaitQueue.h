@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+#ifndef HHUOS_WAITQUEUE_H
+#define HHUOS_WAITQUEUE_H
+
+#include <stdint.h>
+
+#include "lib/util/async/Spinlock.h"
+#include "lib/util/collection/ArrayList.h"
+
+namespace Kernel {
+class Thread;
+
+/**
+ * A queue of listeners, that wait for an object (e.g. a file node) to change its state.
+ * Producers call wakeUp() whenever new data is available, which notifies all registered listeners.
+ * Since producers may run inside an interrupt handler, wakeUp() never spins on the queue's lock.
+ * If the lock is currently held, the wake up is deferred and delivered by the lock's owner.
+ */
+class WaitQueue {
+
+public:
+
+    class Listener {
+
+    friend class WaitQueue;
+
+    public:
+        /**
+         * Default Constructor.
+         */
+        Listener() = default;
+
+        /**
+         * Copy Constructor.
+         */
+        Listener(const Listener &other) = delete;
+
+        /**
+         * Assignment operator.
+         */
+        Listener &operator=(const Listener &other) = delete;
+
+        /**
+         * Destructor.
+         * Removes the listener from the queue it is registered at.
+         */
+        virtual ~Listener();
+
+        /**
+         * Check if the listener is still registered at a queue.
+         * A listener gets detached, when the queue it is registered at is destroyed.
+         */
+        [[nodiscard]] bool isAttached() const;
+
+        /**
+         * Called by the queue, when it is woken up. May be called from interrupt context.
+         */
+        virtual void wakeUp() = 0;
+
+    private:
+
+        WaitQueue *queue = nullptr;
+    };
+
+    /**
+     * Wakes up a thread, which has been blocked via Scheduler::wait().
+     * Must be created by the thread itself. The thread keeps track of its listeners, so that they can be
+     * detached from their queues, if the thread is killed while waiting (see detachListeners()).
+     */
+    class ThreadListener : public Listener {
+
+    friend class WaitQueue;
+
+    public:
+        /**
+         * Constructor.
+         */
+        explicit ThreadListener(Thread &thread);
+
+        /**
+         * Copy Constructor.
+         */
+        ThreadListener(const ThreadListener &other) = delete;
+
+        /**
+         * Assignment operator.
+         */
+        ThreadListener &operator=(const ThreadListener &other) = delete;
+
+        /**
+         * Destructor.
+         */
+        ~ThreadListener() override;
+
+        void wakeUp() override;
+
+    private:
+
+        Thread &thread;
+        ThreadListener *nextListener = nullptr;
+    };
+
+    /**
+     * Default Constructor.
+     */
+    WaitQueue() = default;
+
+    /**
+     * Copy Constructor.
+     */
+    WaitQueue(const WaitQueue &other) = delete;
+
+    /**
+     * Assignment operator.
+     */
+    WaitQueue &operator=(const WaitQueue &other) = delete;
+
+    /**
+     * Destructor.
+     * Wakes up and detaches all remaining listeners.
+     */
+    ~WaitQueue();
+
+    void add(Listener &listener);
+
+    void remove(Listener &listener);
+
+    void wakeUp();
+
+    /**
+     * Remove all listeners of a thread, that is not running, from their queues (called when the thread is killed).
+     * Never spins on a queue's lock, since the thread may have been preempted while holding it.
+     *
+     * @return false, if a queue's lock is currently held and the caller has to try again later
+     */
+    static bool detachListeners(Thread &thread);
+
+private:
+
+    void unlock();
+
+    void notifyListeners();
+
+    Util::ArrayList<Listener*> listeners;
+    Util::Async::Spinlock lock;
+    uint32_t deferredWakeUp = 0;
+};
+
+}
+
+#endif
@@ -29,6 +29,12 @@
 #include "InterruptService.h"
 #include "kernel/service/Service.h"
 #include "kernel/process/FileDescriptor.h"
+#include "kernel/process/EventQueueNode.h"
+#include "kernel/process/Pipe.h"
+#include "kernel/process/PipeNode.h"
+#include "kernel/process/Scheduler.h"
+#include "kernel/process/WaitQueue.h"
+#include "lib/util/time/Timestamp.h"
 
 namespace Kernel {
 
@@ -161,6 +167,23 @@ FilesystemService::FilesystemService() {
         return true;
     });
 
+    Service::getService<InterruptService>().assignSystemCall(Util::System::READ_DIRECTORY, [](uint32_t paramCount, va_list arguments) -> bool {
+        if (paramCount < 5) {
+            return false;
+        }
+
+        auto &filesystemService = Service::getService<FilesystemService>();
+        auto fileDescriptor = va_arg(arguments, int32_t);
+        auto &cursor = *va_arg(arguments, uint32_t*);
+        auto *entries = va_arg(arguments, Util::Io::File::DirectoryEntry*);
+        auto count = va_arg(arguments, uint32_t);
+        auto &read = *va_arg(arguments, uint32_t*);
+
+        // Entries are written directly into the caller's buffer, no user memory needs to be allocated
+        read = filesystemService.getFileDescriptor(fileDescriptor).getNode().readDirectory(cursor, entries, count);
+        return true;
+    });
+
     Service::getService<InterruptService>().assignSystemCall(Util::System::WRITE_FILE, [](uint32_t paramCount, va_list arguments) -> bool {
         if (paramCount < 5) {
             return false;
@@ -173,7 +196,13 @@ FilesystemService::FilesystemService() {
         auto length = va_arg(arguments, uint64_t);
         auto &written = *va_arg(arguments, uint64_t*);
 
-        written = filesystemService.getFileDescriptor(fileDescriptor).getNode().writeData(sourceBuffer, pos, length);
+        auto &descriptor = filesystemService.getFileDescriptor(fileDescriptor);
+        if (descriptor.getAccessMode() == Util::Io::File::BLOCKING || descriptor.getNode().isReadyToWrite()) {
+            written = descriptor.getNode().writeData(sourceBuffer, pos, length);
+        } else {
+            written = 0;
+        }
+
         return true;
     });
 
@@ -199,6 +228,55 @@ FilesystemService::FilesystemService() {
         return true;
     });
 
+    Service::getService<InterruptService>().assignSystemCall(Util::System::WRITE_FILE_VECTOR, [](uint32_t paramCount, va_list arguments) -> bool {
+        if (paramCount < 5) {
+            return false;
+        }
+
+        auto &filesystemService = Service::getService<FilesystemService>();
+        auto fileDescriptor = va_arg(arguments, int32_t);
+        auto *segments = va_arg(arguments, const Util::Io::File::Segment*);
+        auto count = va_arg(arguments, uint32_t);
+        auto pos = va_arg(arguments, uint64_t);
+        auto &written = *va_arg(arguments, uint64_t*);
+
+        written = filesystemService.writeFileVector(fileDescriptor, segments, count, pos);
+        return true;
+    });
+
+    Service::getService<InterruptService>().assignSystemCall(Util::System::READ_FILE_VECTOR, [](uint32_t paramCount, va_list arguments) -> bool {
+        if (paramCount < 5) {
+            return false;
+        }
+
+        auto &filesystemService = Service::getService<FilesystemService>();
+        auto fileDescriptor = va_arg(arguments, int32_t);
+        auto *segments = va_arg(arguments, const Util::Io::File::Segment*);
+        auto count = va_arg(arguments, uint32_t);
+        auto pos = va_arg(arguments, uint64_t);
+        auto &read = *va_arg(arguments, uint64_t*);
+
+        read = filesystemService.readFileVector(fileDescriptor, segments, count, pos);
+        return true;
+    });
+
+    Service::getService<InterruptService>().assignSystemCall(Util::System::TRANSFER_FILE, [](uint32_t paramCount, va_list arguments) -> bool {
+        if (paramCount < 6) {
+            return false;
+        }
+
+        auto &filesystemService = Service::getService<FilesystemService>();
+        auto sourceFileDescriptor = va_arg(arguments, int32_t);
+        auto sourcePos = va_arg(arguments, uint64_t);
+        auto targetFileDescriptor = va_arg(arguments, int32_t);
+        auto targetPos = va_arg(arguments, uint64_t);
+        auto length = va_arg(arguments, uint64_t);
+        auto &transferred = *va_arg(arguments, uint64_t*);
+
+        transferred = filesystemService.transferFile(sourceFileDescriptor, sourcePos, targetFileDescriptor, targetPos, length);
+        return true;
+    });
+
     Service::getService<InterruptService>().assignSystemCall(Util::System::CONTROL_FILE, [](uint32_t paramCount, va_list arguments) -> bool {
         if (paramCount < 3) {
             return false;
@@ -225,6 +303,45 @@ FilesystemService::FilesystemService() {
         return filesystemService.getFileDescriptor(fileDescriptor).control(request, parameters);
     });
 
+    Service::getService<InterruptService>().assignSystemCall(Util::System::POLL_FILES, [](uint32_t paramCount, va_list arguments) -> bool {
+        if (paramCount < 4) {
+            return false;
+        }
+
+        auto &filesystemService = Service::getService<FilesystemService>();
+        auto *entries = va_arg(arguments, Util::Io::File::PollEntry*);
+        auto count = va_arg(arguments, uint32_t);
+        auto timeout = va_arg(arguments, int32_t);
+        auto &readyCount = *va_arg(arguments, uint32_t*);
+
+        readyCount = filesystemService.poll(entries, count, timeout);
+        return true;
+    });
+
+    Service::getService<InterruptService>().assignSystemCall(Util::System::CREATE_EVENT_QUEUE, [](uint32_t paramCount, va_list arguments) -> bool {
+        if (paramCount < 1) {
+            return false;
+        }
+
+        auto &filesystemService = Service::getService<FilesystemService>();
+        auto &fileDescriptor = *va_arg(arguments, int32_t*);
+
+        fileDescriptor = filesystemService.createEventQueue();
+        return fileDescriptor >= 0;
+    });
+
+    Service::getService<InterruptService>().assignSystemCall(Util::System::CREATE_PIPE, [](uint32_t paramCount, va_list arguments) -> bool {
+        if (paramCount < 2) {
+            return false;
+        }
+
+        auto &filesystemService = Service::getService<FilesystemService>();
+        auto &readFileDescriptor = *va_arg(arguments, int32_t*);
+        auto &writeFileDescriptor = *va_arg(arguments, int32_t*);
+
+        return filesystemService.createPipe(readFileDescriptor, writeFileDescriptor);
+    });
+
     Service::getService<InterruptService>().assignSystemCall(Util::System::CHANGE_DIRECTORY, [](uint32_t paramCount, va_list arguments) -> bool {
         if (paramCount < 1) {
             return false;
@@ -296,6 +413,182 @@ FileDescriptor& FilesystemService::getFileDescriptor(int32_t fileDescriptor) {
     return Service::getService<ProcessService>().getCurrentProcess().getFileDescriptorManager().getDescriptor(fileDescriptor);
 }
 
+uint32_t FilesystemService::poll(Util::Io::File::PollEntry *entries, uint32_t count, int32_t timeout) {
+    auto &scheduler = Service::getService<ProcessService>().getScheduler();
+    auto &thread = scheduler.getCurrentThread();
+
+    // Register at the wait queues first, so that no wake up between checking and blocking gets lost
+    auto **listeners = new WaitQueue::ThreadListener*[count];
+    auto polling = false;
+    for (uint32_t i = 0; i < count; i++) {
+        auto *waitQueue = getFileDescriptor(entries[i].fileDescriptor).getNode().getWaitQueue();
+        if (waitQueue == nullptr) {
+            listeners[i] = nullptr;
+            polling = true;
+        } else {
+            listeners[i] = new WaitQueue::ThreadListener(thread);
+            waitQueue->add(*listeners[i]);
+        }
+    }
+
+    auto startTime = Util::Time::getSystemTime().toMilliseconds();
+    uint32_t readyCount;
+    while (true) {
+        readyCount = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            auto &node = getFileDescriptor(entries[i].fileDescriptor).getNode();
+            entries[i].readyEvents = getReadyEvents(node, entries[i].events);
+            if (entries[i].readyEvents != 0) {
+                readyCount++;
+            }
+        }
+
+        if (readyCount > 0 || timeout == 0) {
+            break;
+        }
+
+        // A wait time of zero blocks the thread until it is woken up
+        uint64_t waitTime = polling ? POLL_INTERVAL : 0;
+        if (timeout > 0) {
+            auto elapsedTime = Util::Time::getSystemTime().toMilliseconds() - startTime;
+            if (elapsedTime >= static_cast<uint32_t>(timeout)) {
+                break;
+            }
+
+            auto remainingTime = timeout - elapsedTime;
+            if (!polling || remainingTime < waitTime) {
+                waitTime = remainingTime;
+            }
+        }
+
+        scheduler.wait(Util::Time::Timestamp::ofMilliseconds(waitTime));
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        delete listeners[i];
+    }
+
+    delete[] listeners;
+    return readyCount;
+}
+
+int32_t FilesystemService::createEventQueue() {
+    return registerFile(new EventQueueNode());
+}
+
+uint64_t FilesystemService::readFileVector(int32_t fileDescriptor, const Util::Io::File::Segment *segments, uint32_t count, uint64_t pos) {
+    auto &descriptor = getFileDescriptor(fileDescriptor);
+    auto &node = descriptor.getNode();
+    auto blocking = descriptor.getAccessMode() == Util::Io::File::BLOCKING;
+
+    uint64_t read = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (!blocking && !node.isReadyToRead()) {
+            break;
+        }
+
+        auto segmentRead = node.readData(segments[i].buffer, pos + read, segments[i].length);
+        read += segmentRead;
+
+        if (segmentRead < segments[i].length) {
+            break;
+        }
+    }
+
+    return read;
+}
+
+uint64_t FilesystemService::writeFileVector(int32_t fileDescriptor, const Util::Io::File::Segment *segments, uint32_t count, uint64_t pos) {
+    auto &descriptor = getFileDescriptor(fileDescriptor);
+    auto &node = descriptor.getNode();
+    auto blocking = descriptor.getAccessMode() == Util::Io::File::BLOCKING;
+
+    uint64_t written = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (!blocking && !node.isReadyToWrite()) {
+            break;
+        }
+
+        auto segmentWritten = node.writeData(segments[i].buffer, pos + written, segments[i].length);
+        written += segmentWritten;
+
+        if (segmentWritten < segments[i].length) {
+            break;
+        }
+    }
+
+    return written;
+}
+
+uint64_t FilesystemService::transferFile(int32_t sourceFileDescriptor, uint64_t sourcePos, int32_t targetFileDescriptor, uint64_t targetPos, uint64_t length) {
+    auto &sourceDescriptor = getFileDescriptor(sourceFileDescriptor);
+    auto &targetDescriptor = getFileDescriptor(targetFileDescriptor);
+    auto &sourceNode = sourceDescriptor.getNode();
+    auto &targetNode = targetDescriptor.getNode();
+    auto sourceBlocking = sourceDescriptor.getAccessMode() == Util::Io::File::BLOCKING;
+    auto targetBlocking = targetDescriptor.getAccessMode() == Util::Io::File::BLOCKING;
+
+    auto bufferSize = length < TRANSFER_BUFFER_SIZE ? static_cast<uint32_t>(length) : TRANSFER_BUFFER_SIZE;
+    auto *buffer = new uint8_t[bufferSize];
+
+    uint64_t transferred = 0;
+    while (transferred < length) {
+        if ((!sourceBlocking && !sourceNode.isReadyToRead()) || (!targetBlocking && !targetNode.isReadyToWrite())) {
+            break;
+        }
+
+        auto chunkSize = length - transferred < bufferSize ? length - transferred : bufferSize;
+        auto read = sourceNode.readData(buffer, sourcePos + transferred, chunkSize);
+        if (read == 0) {
+            break;
+        }
+
+        auto written = targetNode.writeData(buffer, targetPos + transferred, read);
+        transferred += written;
+
+        if (written < read) {
+            break;
+        }
+    }
+
+    delete[] buffer;
+    return transferred;
+}
+
+bool FilesystemService::createPipe(int32_t &readFileDescriptor, int32_t &writeFileDescriptor) {
+    auto *pipe = new Pipe();
+    auto *readEnd = new PipeNode(*pipe, false);
+    auto *writeEnd = new PipeNode(*pipe, true);
+
+    readFileDescriptor = registerFile(readEnd);
+    if (readFileDescriptor < 0) {
+        delete writeEnd;
+        delete readEnd;
+        return false;
+    }
+
+    writeFileDescriptor = registerFile(writeEnd);
+    if (writeFileDescriptor < 0) {
+        closeFile(readFileDescriptor);
+        delete writeEnd;
+        return false;
+    }
+
+    return true;
+}
+
+uint8_t FilesystemService::getReadyEvents(Filesystem::Node &node, uint8_t events) {
+    uint8_t readyEvents = 0;
+    if ((events & Util::Io::File::READY_TO_READ) && node.isReadyToRead()) {
+        readyEvents |= Util::Io::File::READY_TO_READ;
+    }
+    if ((events & Util::Io::File::READY_TO_WRITE) && node.isReadyToWrite()) {
+        readyEvents |= Util::Io::File::READY_TO_WRITE;
+    }
+
+    return readyEvents;
+}
+
 Filesystem::Filesystem& FilesystemService::getFilesystem() {
     return filesystem;
 }
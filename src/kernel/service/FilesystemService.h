@@ -24,6 +24,7 @@
 #include "Service.h"
 #include "lib/util/collection/Array.h"
 #include "lib/util/base/String.h"
+#include "lib/util/io/file/File.h"
 
 namespace Filesystem {
 class Node;
@@ -75,11 +76,41 @@ public:
 
     FileDescriptor& getFileDescriptor(int32_t fileDescriptor);
 
+    /**
+     * Read from a file directly into the given segments. Non-blocking descriptors stop at the first segment,
+     * for which no data is available.
+     */
+    uint64_t readFileVector(int32_t fileDescriptor, const Util::Io::File::Segment *segments, uint32_t count, uint64_t pos);
+
+    uint64_t writeFileVector(int32_t fileDescriptor, const Util::Io::File::Segment *segments, uint32_t count, uint64_t pos);
+
+    /**
+     * Copy data between two file descriptors, using a kernel buffer of TRANSFER_BUFFER_SIZE bytes.
+     */
+    uint64_t transferFile(int32_t sourceFileDescriptor, uint64_t sourcePos, int32_t targetFileDescriptor, uint64_t targetPos, uint64_t length);
+
+    /**
+     * Block the current thread, until at least one of the given file descriptors is ready for one of its requested events.
+     * Nodes providing a wait queue wake the thread up directly, all other nodes are checked every POLL_INTERVAL milliseconds.
+     *
+     * @param timeout The maximum time to wait in milliseconds (0 = return immediately, -1 = wait indefinitely)
+     * @return The amount of ready file descriptors
+     */
+    uint32_t poll(Util::Io::File::PollEntry *entries, uint32_t count, int32_t timeout);
+
+    int32_t createEventQueue();
+
+    bool createPipe(int32_t &readFileDescriptor, int32_t &writeFileDescriptor);
+
+    static uint8_t getReadyEvents(Filesystem::Node &node, uint8_t events);
+
     [[nodiscard]] Filesystem::Filesystem& getFilesystem();
 
     [[nodiscard]] Util::Array<Filesystem::MountInformation> getMountInformation();
 
     static const constexpr uint8_t SERVICE_ID = 0;
+    static const constexpr uint32_t POLL_INTERVAL = 10;
+    static const constexpr uint32_t TRANSFER_BUFFER_SIZE = 64 * 1024;
 
 private:
 
@@ -169,6 +169,30 @@ uint8_t InterruptService::getCpuId() const {
     return usesApic() ? Device::LocalApic::getId() : 0;
 }
 
+uint32_t InterruptService::getCpuCount() const {
+    return usesApic() ? apic->getCpuCount() : 1;
+}
+
+uint32_t InterruptService::getCpuIndex() const {
+    return usesApic() ? apic->getCurrentCpuIndex() : 0;
+}
+
+bool InterruptService::isMessageSignaledInterruptAvailable() const {
+    return usesApic() && nextMessageSignaledInterrupt <= MESSAGE_SIGNALED_INTERRUPT_END;
+}
+
+InterruptVector InterruptService::allocateMessageSignaledInterrupt() {
+    if (!usesApic()) {
+        Util::Exception::throwException(Util::Exception::UNSUPPORTED_OPERATION, "InterruptService: Message signaled interrupts require the APIC!");
+    }
+
+    if (nextMessageSignaledInterrupt > MESSAGE_SIGNALED_INTERRUPT_END) {
+        Util::Exception::throwException(Util::Exception::OUT_OF_BOUNDS, "InterruptService: No free message signaled interrupt vector left!");
+    }
+
+    return static_cast<InterruptVector>(nextMessageSignaledInterrupt++);
+}
+
 bool InterruptService::isParallelComputingAllowed() const {
     return parallelComputingAllowed;
 }
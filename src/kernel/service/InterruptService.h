@@ -27,6 +27,7 @@
 #include "lib/util/base/System.h"
 #include "kernel/interrupt/SystemCallDispatcher.h"
 #include "kernel/interrupt/GlobalSystemInterrupt.h"
+#include "kernel/interrupt/InterruptVector.h"
 
 namespace Device {
 class Apic;
@@ -36,7 +37,6 @@ class Pic;
 
 namespace Kernel {
 class InterruptHandler;
-enum InterruptVector : uint8_t;
 struct InterruptFrame;
 
 class InterruptService : public Service {
@@ -111,6 +111,25 @@ public:
 
     [[nodiscard]] uint8_t getCpuId() const;
 
+    [[nodiscard]] uint32_t getCpuCount() const;
+
+    /**
+     * Get the dense index (0 to getCpuCount() - 1) of the current CPU, which, unlike getCpuId(), may be used to select per-CPU resources.
+     */
+    [[nodiscard]] uint32_t getCpuIndex() const;
+
+    /**
+     * Check if message signaled interrupts can be used (requires the APIC) and there are unused MSI vectors left.
+     */
+    [[nodiscard]] bool isMessageSignaledInterruptAvailable() const;
+
+    /**
+     * Reserve an interrupt vector for a message signaled interrupt.
+     * The vector must be programmed into the device (e.g. via PciDevice::enableMessageSignaledInterrupts())
+     * and a handler must be assigned to it via assignInterrupt().
+     */
+    InterruptVector allocateMessageSignaledInterrupt();
+
     [[nodiscard]] bool isParallelComputingAllowed() const;
 
     void allowParallelComputing();
@@ -127,6 +146,7 @@ private:
     SystemCallDispatcher systemCallDispatcher;
 
     bool parallelComputingAllowed = false;
+    uint8_t nextMessageSignaledInterrupt = MESSAGE_SIGNALED_INTERRUPT_START;
 };
 
 }
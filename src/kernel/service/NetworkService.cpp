@@ -32,6 +32,7 @@
 #include "kernel/network/ip4/Ip4Socket.h"
 #include "kernel/network/icmp/IcmpSocket.h"
 #include "kernel/network/udp/UdpSocket.h"
+#include "kernel/network/tcp/TcpSocket.h"
 #include "lib/util/base/System.h"
 #include "FilesystemService.h"
 #include "MemoryService.h"
@@ -130,6 +131,51 @@ NetworkService::NetworkService() {
             return false;
         }
     });
+
+    Service::getService<InterruptService>().assignSystemCall(Util::System::SEND_DATAGRAM_VECTOR, [](uint32_t paramCount, va_list arguments) -> bool {
+        if (paramCount < 4) {
+            return false;
+        }
+
+        auto &filesystemService = Service::getService<FilesystemService>();
+        auto fileDescriptor = va_arg(arguments, int32_t);
+        auto &datagram = *va_arg(arguments, Util::Network::Datagram*);
+        auto *segments = va_arg(arguments, const Util::Io::File::Segment*);
+        auto segmentCount = va_arg(arguments, uint32_t);
+
+        auto &socket = reinterpret_cast<Network::Socket&>(filesystemService.getFileDescriptor(fileDescriptor).getNode());
+        if (!socket.isBound()) {
+            Util::Exception::throwException(Util::Exception::ILLEGAL_STATE, "Socket: Not yet bound!");
+        }
+
+        return socket.send(datagram, segments, segmentCount);
+    });
+
+    Service::getService<InterruptService>().assignSystemCall(Util::System::RECEIVE_DATAGRAM_VECTOR, [](uint32_t paramCount, va_list arguments) -> bool {
+        if (paramCount < 5) {
+            return false;
+        }
+
+        auto &filesystemService = Service::getService<FilesystemService>();
+        auto fileDescriptor = va_arg(arguments, int32_t);
+        auto &datagram = *va_arg(arguments, Util::Network::Datagram*);
+        auto *segments = va_arg(arguments, const Util::Io::File::Segment*);
+        auto segmentCount = va_arg(arguments, uint32_t);
+        auto &length = *va_arg(arguments, uint32_t*);
+
+        auto &socketDescriptor = filesystemService.getFileDescriptor(fileDescriptor);
+        auto &socket = reinterpret_cast<Network::Socket&>(socketDescriptor.getNode());
+        if (!socket.isBound()) {
+            Util::Exception::throwException(Util::Exception::ILLEGAL_STATE, "Socket: Not yet bound!");
+        }
+
+        if (socketDescriptor.getAccessMode() == Util::Io::File::NON_BLOCKING && !socket.isReadyToRead()) {
+            return false;
+        }
+
+        // The payload is copied directly into the user's segments, without allocating a buffer on the user heap
+        return socket.receive(datagram, segments, segmentCount, length);
+    });
 }
 
 void NetworkService::initializeLoopback() {
@@ -209,6 +255,9 @@ int32_t NetworkService::createSocket(Util::Network::Socket::Type socketType) {
         case Util::Network::Socket::UDP:
             socket = reinterpret_cast<Filesystem::Node*>(new Network::Udp::UdpSocket());
             break;
+        case Util::Network::Socket::TCP:
+            socket = reinterpret_cast<Filesystem::Node*>(new Network::Tcp::TcpSocket());
+            break;
         default:
             return false;
     }
@@ -21,6 +21,7 @@
 #include "kernel/process/BinaryLoader.h"
 #include "ProcessService.h"
 #include "FilesystemService.h"
+#include "kernel/process/FileDescriptor.h"
 #include "kernel/process/FileDescriptorManager.h"
 #include "kernel/process/Process.h"
 #include "kernel/process/Thread.h"
@@ -144,6 +145,26 @@ ProcessService::ProcessService(Process *kernelProcess) : kernelProcess(kernelPro
         return true;
     });
 
+    Service::getService<InterruptService>().assignSystemCall(Util::System::EXECUTE_BINARY_WITH_FILE_DESCRIPTORS, [](uint32_t paramCount, va_list arguments) -> bool {
+        if (paramCount < 7) {
+            return false;
+        }
+
+        auto &processService = Service::getService<ProcessService>();
+        auto *binaryFile = va_arg(arguments, Util::Io::File*);
+        auto inputFileDescriptor = va_arg(arguments, int32_t);
+        auto outputFileDescriptor = va_arg(arguments, int32_t);
+        auto errorFileDescriptor = va_arg(arguments, int32_t);
+        auto *command = va_arg(arguments, const Util::String*);
+        auto *commandArguments = va_arg(arguments, Util::Array<Util::String>*);
+        auto &processId = *va_arg(arguments, uint32_t*);
+
+        auto &process = processService.loadBinary(*binaryFile, inputFileDescriptor, outputFileDescriptor, errorFileDescriptor, *command, *commandArguments);
+
+        processId = process.getId();
+        return true;
+    });
+
     Service::getService<InterruptService>().assignSystemCall(Util::System::GET_CURRENT_PROCESS, [](uint32_t paramCount, va_list arguments) -> bool {
         if (paramCount < 1) {
             return false;
@@ -208,6 +229,22 @@ Process& ProcessService::createProcess(VirtualAddressSpace &addressSpace, const
     return *process;
 }
 
+Process& ProcessService::createProcess(VirtualAddressSpace &addressSpace, const Util::String &name, const Util::Io::File &workingDirectory, int32_t standardIn, int32_t standardOut, int32_t standardError) {
+    auto &currentDescriptors = getCurrentProcess().getFileDescriptorManager();
+    auto *process = new Process(addressSpace, name, workingDirectory);
+
+    // Move the nodes into the new process' descriptor table, so that e.g. the end of a pipe is closed, when the new process exits
+    process->getFileDescriptorManager().registerFile(currentDescriptors.getDescriptor(standardIn).releaseNode());
+    process->getFileDescriptorManager().registerFile(currentDescriptors.getDescriptor(standardOut).releaseNode());
+    process->getFileDescriptorManager().registerFile(currentDescriptors.getDescriptor(standardError).releaseNode());
+
+    lock.acquire();
+    processList.add(process);
+    lock.release();
+
+    return *process;
+}
+
 Process& ProcessService::loadBinary(const Util::Io::File &binaryFile, const Util::Io::File &inputFile, const Util::Io::File &outputFile, const Util::Io::File &errorFile, const Util::String &command, const Util::Array<Util::String> &arguments) {
     auto &memoryService = Kernel::Service::getService<Kernel::MemoryService>();
 
@@ -219,6 +256,26 @@ Process& ProcessService::loadBinary(const Util::Io::File &binaryFile, const Util
     return process;
 }
 
+Process& ProcessService::loadBinary(const Util::Io::File &binaryFile, int32_t inputFileDescriptor, int32_t outputFileDescriptor, int32_t errorFileDescriptor, const Util::String &command, const Util::Array<Util::String> &arguments) {
+    auto &currentDescriptors = getCurrentProcess().getFileDescriptorManager();
+    if (!currentDescriptors.getDescriptor(inputFileDescriptor).isValid() || !currentDescriptors.getDescriptor(outputFileDescriptor).isValid() || !currentDescriptors.getDescriptor(errorFileDescriptor).isValid()) {
+        Util::Exception::throwException(Util::Exception::INVALID_ARGUMENT, "ProcessService: Invalid standard file descriptor!");
+    }
+
+    if (inputFileDescriptor == outputFileDescriptor || inputFileDescriptor == errorFileDescriptor || outputFileDescriptor == errorFileDescriptor) {
+        Util::Exception::throwException(Util::Exception::INVALID_ARGUMENT, "ProcessService: A file descriptor can only be handed over once!");
+    }
+
+    auto &memoryService = Kernel::Service::getService<Kernel::MemoryService>();
+
+    auto &virtualAddressSpace = memoryService.createAddressSpace();
+    auto &process = createProcess(virtualAddressSpace, binaryFile.getCanonicalPath(), Util::Io::File::getCurrentWorkingDirectory(), inputFileDescriptor, outputFileDescriptor, errorFileDescriptor);
+    auto &thread = Kernel::Thread::createKernelThread("Loader", process, new Kernel::BinaryLoader(binaryFile.getCanonicalPath(), command, arguments));
+
+    scheduler.ready(thread);
+    return process;
+}
+
 void ProcessService::killProcess(Process &process) {
     if (process == getCurrentProcess()) {
         Util::Exception::throwException(Util::Exception::INVALID_ARGUMENT, "A process cannot kill itself!");
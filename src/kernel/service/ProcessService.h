@@ -64,8 +64,16 @@ public:
 
     Process& createProcess(VirtualAddressSpace &addressSpace, const Util::String &name, const Util::Io::File &workingDirectory, const Util::Io::File &standardIn, const Util::Io::File &standardOut, const Util::Io::File &standardError);
 
+    /**
+     * Create a process, whose standard file descriptors are handed over from the current process.
+     * The given descriptors are no longer valid in the current process afterwards.
+     */
+    Process& createProcess(VirtualAddressSpace &addressSpace, const Util::String &name, const Util::Io::File &workingDirectory, int32_t standardIn, int32_t standardOut, int32_t standardError);
+
     Process& loadBinary(const Util::Io::File &binaryFile, const Util::Io::File &inputFile, const Util::Io::File &outputFile, const Util::Io::File &errorFile, const Util::String &command, const Util::Array<Util::String> &arguments);
 
+    Process& loadBinary(const Util::Io::File &binaryFile, int32_t inputFileDescriptor, int32_t outputFileDescriptor, int32_t errorFileDescriptor, const Util::String &command, const Util::Array<Util::String> &arguments);
+
     void killProcess(Process &process);
 
     [[noreturn]] void exitCurrentProcess(int32_t exitCode);
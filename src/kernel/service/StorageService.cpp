@@ -81,4 +81,12 @@ bool StorageService::isDeviceRegistered(const Util::String &deviceName) {
     return result;
 }
 
+Util::Array<Util::String> StorageService::getDeviceNames() {
+    lock.acquire();
+    auto names = deviceMap.keys();
+    lock.release();
+
+    return names;
+}
+
 }
\ No newline at end of file
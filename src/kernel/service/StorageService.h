@@ -62,6 +62,8 @@ public:
 
     bool isDeviceRegistered(const Util::String &deviceName);
 
+    Util::Array<Util::String> getDeviceNames();
+
     static const constexpr uint8_t SERVICE_ID = 5;
 
 private:
@@ -58,18 +58,28 @@ void closeFile(int32_t fileDescriptor);
 Util::Io::File::Type getFileType(int32_t fileDescriptor);
 uint32_t getFileLength(int32_t fileDescriptor);
 Util::Array<Util::String> getFileChildren(int32_t fileDescriptor);
+uint32_t readDirectory(int32_t fileDescriptor, uint32_t &cursor, Util::Io::File::DirectoryEntry *entries, uint32_t count);
 uint64_t readFile(int32_t fileDescriptor, uint8_t *targetBuffer, uint64_t pos, uint64_t length);
 uint64_t writeFile(int32_t fileDescriptor, const uint8_t *sourceBuffer, uint64_t pos, uint64_t length);
+uint64_t readFileVector(int32_t fileDescriptor, const Util::Io::File::Segment *segments, uint32_t count, uint64_t pos);
+uint64_t writeFileVector(int32_t fileDescriptor, const Util::Io::File::Segment *segments, uint32_t count, uint64_t pos);
+uint64_t transferFile(int32_t sourceFileDescriptor, uint64_t sourcePos, int32_t targetFileDescriptor, uint64_t targetPos, uint64_t length);
 bool controlFile(int32_t fileDescriptor, uint32_t request, const Util::Array<uint32_t> &parameters);
 bool controlFileDescriptor(int32_t fileDescriptor, uint32_t request, const Util::Array<uint32_t> &parameters);
+uint32_t pollFiles(Util::Io::File::PollEntry *entries, uint32_t count, int32_t timeout);
+int32_t createEventQueue();
+bool createPipe(int32_t &readFileDescriptor, int32_t &writeFileDescriptor);
 bool changeDirectory(const Util::String &path);
 Util::Io::File getCurrentWorkingDirectory();
 
 int32_t createSocket(Util::Network::Socket::Type socketType);
 bool sendDatagram(int32_t fileDescriptor, const Util::Network::Datagram &datagram);
 bool receiveDatagram(int32_t fileDescriptor, Util::Network::Datagram &datagram);
+bool sendDatagramVector(int32_t fileDescriptor, const Util::Network::Datagram &datagram, const Util::Io::File::Segment *segments, uint32_t count);
+bool receiveDatagramVector(int32_t fileDescriptor, Util::Network::Datagram &datagram, const Util::Io::File::Segment *segments, uint32_t count, uint32_t &length);
 
 Util::Async::Process executeBinary(const Util::Io::File &binaryFile, const Util::Io::File &inputFile, const Util::Io::File &outputFile, const Util::Io::File &errorFile, const Util::String &command, const Util::Array<Util::String> &arguments);
+Util::Async::Process executeBinary(const Util::Io::File &binaryFile, int32_t inputFileDescriptor, int32_t outputFileDescriptor, int32_t errorFileDescriptor, const Util::String &command, const Util::Array<Util::String> &arguments);
 Util::Async::Process getCurrentProcess();
 Util::Async::Thread createThread(const Util::String &name, Util::Async::Runnable *runnable);
 Util::Async::Thread getCurrentThread();
@@ -129,6 +129,10 @@ Util::Array<Util::String> getFileChildren(int32_t fileDescriptor) {
     return Kernel::Service::getService<Kernel::FilesystemService>().getFileDescriptor(fileDescriptor).getNode().getChildren();
 }
 
+uint32_t readDirectory(int32_t fileDescriptor, uint32_t &cursor, Util::Io::File::DirectoryEntry *entries, uint32_t count) {
+    return Kernel::Service::getService<Kernel::FilesystemService>().getFileDescriptor(fileDescriptor).getNode().readDirectory(cursor, entries, count);
+}
+
 uint64_t readFile(int32_t fileDescriptor, uint8_t *targetBuffer, uint64_t pos, uint64_t length) {
     uint32_t read = 0;
 
@@ -141,7 +145,12 @@ uint64_t readFile(int32_t fileDescriptor, uint8_t *targetBuffer, uint64_t pos, u
 }
 
 uint64_t writeFile(int32_t fileDescriptor, const uint8_t *sourceBuffer, uint64_t pos, uint64_t length) {
-    return Kernel::Service::getService<Kernel::FilesystemService>().getFileDescriptor(fileDescriptor).getNode().writeData(sourceBuffer, pos, length);
+    auto &descriptor = Kernel::Service::getService<Kernel::FilesystemService>().getFileDescriptor(fileDescriptor);
+    if (descriptor.getAccessMode() == Util::Io::File::NON_BLOCKING && !descriptor.getNode().isReadyToWrite()) {
+        return 0;
+    }
+
+    return descriptor.getNode().writeData(sourceBuffer, pos, length);
 }
 
 bool controlFile(int32_t fileDescriptor, uint32_t request, const Util::Array<uint32_t> &parameters) {
@@ -152,6 +161,18 @@ bool controlFileDescriptor(int32_t fileDescriptor, uint32_t request, const Util:
     return Kernel::Service::getService<Kernel::FilesystemService>().getFileDescriptor(fileDescriptor).control(request, parameters);
 }
 
+uint32_t pollFiles(Util::Io::File::PollEntry *entries, uint32_t count, int32_t timeout) {
+    return Kernel::Service::getService<Kernel::FilesystemService>().poll(entries, count, timeout);
+}
+
+int32_t createEventQueue() {
+    return Kernel::Service::getService<Kernel::FilesystemService>().createEventQueue();
+}
+
+bool createPipe(int32_t &readFileDescriptor, int32_t &writeFileDescriptor) {
+    return Kernel::Service::getService<Kernel::FilesystemService>().createPipe(readFileDescriptor, writeFileDescriptor);
+}
+
 bool changeDirectory(const Util::String &path) {
     return Kernel::Service::getService<Kernel::ProcessService>().getCurrentProcess().setWorkingDirectory(path);
 }
@@ -164,6 +185,18 @@ int32_t createSocket(Util::Network::Socket::Type socketType) {
     return Kernel::Service::getService<Kernel::NetworkService>().createSocket(socketType);
 }
 
+uint64_t readFileVector(int32_t fileDescriptor, const Util::Io::File::Segment *segments, uint32_t count, uint64_t pos) {
+    return Kernel::Service::getService<Kernel::FilesystemService>().readFileVector(fileDescriptor, segments, count, pos);
+}
+
+uint64_t writeFileVector(int32_t fileDescriptor, const Util::Io::File::Segment *segments, uint32_t count, uint64_t pos) {
+    return Kernel::Service::getService<Kernel::FilesystemService>().writeFileVector(fileDescriptor, segments, count, pos);
+}
+
+uint64_t transferFile(int32_t sourceFileDescriptor, uint64_t sourcePos, int32_t targetFileDescriptor, uint64_t targetPos, uint64_t length) {
+    return Kernel::Service::getService<Kernel::FilesystemService>().transferFile(sourceFileDescriptor, sourcePos, targetFileDescriptor, targetPos, length);
+}
+
 bool sendDatagram(int32_t fileDescriptor, const Util::Network::Datagram &datagram) {
     auto &socket = reinterpret_cast<Kernel::Network::Socket&>(Kernel::Service::getService<Kernel::FilesystemService>().getFileDescriptor(fileDescriptor).getNode());
     return socket.send(datagram);
@@ -190,11 +223,26 @@ bool receiveDatagram(int32_t fileDescriptor, Util::Network::Datagram &datagram)
     return true;
 }
 
+bool sendDatagramVector(int32_t fileDescriptor, const Util::Network::Datagram &datagram, const Util::Io::File::Segment *segments, uint32_t count) {
+    auto &socket = reinterpret_cast<Kernel::Network::Socket&>(Kernel::Service::getService<Kernel::FilesystemService>().getFileDescriptor(fileDescriptor).getNode());
+    return socket.send(datagram, segments, count);
+}
+
+bool receiveDatagramVector(int32_t fileDescriptor, Util::Network::Datagram &datagram, const Util::Io::File::Segment *segments, uint32_t count, uint32_t &length) {
+    auto &socket = reinterpret_cast<Kernel::Network::Socket&>(Kernel::Service::getService<Kernel::FilesystemService>().getFileDescriptor(fileDescriptor).getNode());
+    return socket.receive(datagram, segments, count, length);
+}
+
 Util::Async::Process executeBinary(const Util::Io::File &binaryFile, const Util::Io::File &inputFile, const Util::Io::File &outputFile, const Util::Io::File &errorFile, const Util::String &command, const Util::Array<Util::String> &arguments) {
     auto &process = Kernel::Service::getService<Kernel::ProcessService>().loadBinary(binaryFile, inputFile, outputFile, errorFile, command, arguments);
     return Util::Async::Process(process.getId());
 }
 
+Util::Async::Process executeBinary(const Util::Io::File &binaryFile, int32_t inputFileDescriptor, int32_t outputFileDescriptor, int32_t errorFileDescriptor, const Util::String &command, const Util::Array<Util::String> &arguments) {
+    auto &process = Kernel::Service::getService<Kernel::ProcessService>().loadBinary(binaryFile, inputFileDescriptor, outputFileDescriptor, errorFileDescriptor, command, arguments);
+    return Util::Async::Process(process.getId());
+}
+
 Util::Async::Process getCurrentProcess() {
     auto &process = Kernel::Service::getService<Kernel::ProcessService>().getCurrentProcess();
     return Util::Async::Process(process.getId());
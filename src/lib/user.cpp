@@ -123,6 +123,12 @@ Util::Array<Util::String> getFileChildren(int32_t fileDescriptor) {
     return ret;
 }
 
+uint32_t readDirectory(int32_t fileDescriptor, uint32_t &cursor, Util::Io::File::DirectoryEntry *entries, uint32_t count) {
+    uint32_t read;
+    Util::System::call(Util::System::READ_DIRECTORY, 5, fileDescriptor, &cursor, entries, count, &read);
+    return read;
+}
+
 uint64_t readFile(int32_t fileDescriptor, uint8_t *targetBuffer, uint64_t pos, uint64_t length) {
     uint64_t read;
     Util::System::call(Util::System::READ_FILE, 5, fileDescriptor, targetBuffer, pos, length, &read);
@@ -143,6 +149,22 @@ bool controlFileDescriptor(int32_t fileDescriptor, uint32_t request, const Util:
     return Util::System::call(Util::System::CONTROL_FILE_DESCRIPTOR, 3, fileDescriptor, request, &parameters);
 }
 
+uint32_t pollFiles(Util::Io::File::PollEntry *entries, uint32_t count, int32_t timeout) {
+    uint32_t readyCount = 0;
+    Util::System::call(Util::System::POLL_FILES, 4, entries, count, timeout, &readyCount);
+    return readyCount;
+}
+
+int32_t createEventQueue() {
+    int32_t fileDescriptor;
+    auto result = Util::System::call(Util::System::CREATE_EVENT_QUEUE, 1, &fileDescriptor);
+    return result ? fileDescriptor : -1;
+}
+
+bool createPipe(int32_t &readFileDescriptor, int32_t &writeFileDescriptor) {
+    return Util::System::call(Util::System::CREATE_PIPE, 2, &readFileDescriptor, &writeFileDescriptor);
+}
+
 bool changeDirectory(const Util::String &path) {
     return Util::System::call(Util::System::CHANGE_DIRECTORY, 1, static_cast<const char*>(path));
 }
@@ -159,6 +181,24 @@ int32_t createSocket(Util::Network::Socket::Type socketType) {
     return result ? fileDescriptor : -1;
 }
 
+uint64_t readFileVector(int32_t fileDescriptor, const Util::Io::File::Segment *segments, uint32_t count, uint64_t pos) {
+    uint64_t read;
+    Util::System::call(Util::System::READ_FILE_VECTOR, 5, fileDescriptor, segments, count, pos, &read);
+    return read;
+}
+
+uint64_t writeFileVector(int32_t fileDescriptor, const Util::Io::File::Segment *segments, uint32_t count, uint64_t pos) {
+    uint64_t written;
+    Util::System::call(Util::System::WRITE_FILE_VECTOR, 5, fileDescriptor, segments, count, pos, &written);
+    return written;
+}
+
+uint64_t transferFile(int32_t sourceFileDescriptor, uint64_t sourcePos, int32_t targetFileDescriptor, uint64_t targetPos, uint64_t length) {
+    uint64_t transferred;
+    Util::System::call(Util::System::TRANSFER_FILE, 6, sourceFileDescriptor, sourcePos, targetFileDescriptor, targetPos, length, &transferred);
+    return transferred;
+}
+
 bool sendDatagram(int32_t fileDescriptor, const Util::Network::Datagram &datagram) {
     return Util::System::call(Util::System::SEND_DATAGRAM, 2, fileDescriptor, &datagram);
 }
@@ -167,12 +207,26 @@ bool receiveDatagram(int32_t fileDescriptor, Util::Network::Datagram &datagram){
     return Util::System::call(Util::System::RECEIVE_DATAGRAM, 2, fileDescriptor, &datagram);
 }
 
+bool sendDatagramVector(int32_t fileDescriptor, const Util::Network::Datagram &datagram, const Util::Io::File::Segment *segments, uint32_t count) {
+    return Util::System::call(Util::System::SEND_DATAGRAM_VECTOR, 4, fileDescriptor, &datagram, segments, count);
+}
+
+bool receiveDatagramVector(int32_t fileDescriptor, Util::Network::Datagram &datagram, const Util::Io::File::Segment *segments, uint32_t count, uint32_t &length) {
+    return Util::System::call(Util::System::RECEIVE_DATAGRAM_VECTOR, 5, fileDescriptor, &datagram, segments, count, &length);
+}
+
 Util::Async::Process executeBinary(const Util::Io::File &binaryFile, const Util::Io::File &inputFile, const Util::Io::File &outputFile, const Util::Io::File &errorFile, const Util::String &command, const Util::Array<Util::String> &arguments) {
     uint32_t processId;
     Util::System::call(Util::System::EXECUTE_BINARY, 7, &binaryFile, &inputFile, &outputFile, &errorFile, &command, &arguments, &processId);
     return Util::Async::Process(processId);
 }
 
+Util::Async::Process executeBinary(const Util::Io::File &binaryFile, int32_t inputFileDescriptor, int32_t outputFileDescriptor, int32_t errorFileDescriptor, const Util::String &command, const Util::Array<Util::String> &arguments) {
+    uint32_t processId;
+    Util::System::call(Util::System::EXECUTE_BINARY_WITH_FILE_DESCRIPTORS, 7, &binaryFile, inputFileDescriptor, outputFileDescriptor, errorFileDescriptor, &command, &arguments, &processId);
+    return Util::Async::Process(processId);
+}
+
 Util::Async::Process getCurrentProcess() {
     uint32_t processId;
     Util::System::call(Util::System::GET_CURRENT_PROCESS, 1, &processId);
@@ -36,6 +36,10 @@ Process Process::execute(const Io::File &binaryFile, const Io::File &inpuputFile
     return ::executeBinary(binaryFile, inpuputFile, outputFile, errorFile, command, arguments);
 }
 
+Process Process::execute(const Io::File &binaryFile, int32_t inputFileDescriptor, int32_t outputFileDescriptor, int32_t errorFileDescriptor, const Util::String &command, const Util::Array<Util::String> &arguments) {
+    return ::executeBinary(binaryFile, inputFileDescriptor, outputFileDescriptor, errorFileDescriptor, command, arguments);
+}
+
 Process Process::getCurrentProcess() {
     return ::getCurrentProcess();
 }
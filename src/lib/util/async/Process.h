@@ -58,6 +58,12 @@ public:
 
     static Process execute(const Io::File &binaryFile, const Io::File &inputFile, const Io::File &outputFile, const Io::File &errorFile, const Util::String &command, const Util::Array<Util::String> &arguments);
 
+    /**
+     * Execute a binary with standard file descriptors of the calling process (e.g. the ends of a pipe).
+     * The descriptors are handed over to the new process and must not be used by the calling process afterwards.
+     */
+    static Process execute(const Io::File &binaryFile, int32_t inputFileDescriptor, int32_t outputFileDescriptor, int32_t errorFileDescriptor, const Util::String &command, const Util::Array<Util::String> &arguments);
+
     static Process getCurrentProcess();
 
     static void yield();
@@ -44,6 +44,7 @@ public:
         YIELD,
         EXIT_PROCESS,
         EXECUTE_BINARY,
+        EXECUTE_BINARY_WITH_FILE_DESCRIPTORS,
         GET_CURRENT_PROCESS,
         GET_CURRENT_THREAD,
         JOIN_THREAD,
@@ -65,12 +66,21 @@ public:
         FILE_TYPE,
         FILE_LENGTH,
         FILE_CHILDREN,
+        READ_DIRECTORY,
         WRITE_FILE,
         READ_FILE,
+        WRITE_FILE_VECTOR,
+        READ_FILE_VECTOR,
+        TRANSFER_FILE,
         CONTROL_FILE,
+        POLL_FILES,
+        CREATE_EVENT_QUEUE,
+        CREATE_PIPE,
         CREATE_SOCKET,
         SEND_DATAGRAM,
         RECEIVE_DATAGRAM,
+        SEND_DATAGRAM_VECTOR,
+        RECEIVE_DATAGRAM_VECTOR,
         CHANGE_DIRECTORY,
         GET_CURRENT_WORKING_DIRECTORY,
         GET_SYSTEM_TIME,
@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+#include "EventQueue.h"
+
+#include "lib/interface.h"
+#include "lib/util/base/Exception.h"
+#include "lib/util/collection/Array.h"
+#include "lib/util/io/file/File.h"
+
+namespace Util::Io {
+
+EventQueue::EventQueue() : fileDescriptor(::createEventQueue()) {
+    if (fileDescriptor < 0) {
+        Exception::throwException(Exception::ILLEGAL_STATE, "EventQueue: Failed to create event queue!");
+    }
+}
+
+EventQueue::~EventQueue() {
+    File::close(fileDescriptor);
+}
+
+bool EventQueue::add(int32_t fileDescriptor, uint8_t events) {
+    return File::controlFile(EventQueue::fileDescriptor, ADD, Array<uint32_t>({static_cast<uint32_t>(fileDescriptor), events}));
+}
+
+bool EventQueue::remove(int32_t fileDescriptor) {
+    return File::controlFile(EventQueue::fileDescriptor, REMOVE, Array<uint32_t>({static_cast<uint32_t>(fileDescriptor)}));
+}
+
+uint32_t EventQueue::wait(Event *events, uint32_t count, int32_t timeout) {
+    uint32_t eventCount = 0;
+    auto parameters = Array<uint32_t>({reinterpret_cast<uint32_t>(events), count, static_cast<uint32_t>(timeout), reinterpret_cast<uint32_t>(&eventCount)});
+    if (!File::controlFile(fileDescriptor, WAIT, parameters)) {
+        Exception::throwException(Exception::INVALID_ARGUMENT, "EventQueue: Failed to wait for events!");
+    }
+
+    return eventCount;
+}
+
+int32_t EventQueue::getFileDescriptor() const {
+    return fileDescriptor;
+}
+
+}
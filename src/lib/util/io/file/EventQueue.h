@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+#ifndef HHUOS_EVENTQUEUE_H
+#define HHUOS_EVENTQUEUE_H
+
+#include <stdint.h>
+
+namespace Util::Io {
+
+/**
+ * Persistent, edge-triggered registration of file descriptors for readiness events.
+ * Contrary to File::poll(), the set of file descriptors is only handed to the kernel once
+ * and wait() only reports descriptors, which have received new data (or have become ready) since they were last reported.
+ * This makes it suitable for event loops, that have to handle many sockets at once.
+ * The queue itself is a file descriptor, that is ready to read while events are pending.
+ */
+class EventQueue {
+
+public:
+
+    enum Request {
+        ADD,
+        REMOVE,
+        WAIT
+    };
+
+    struct Event {
+        int32_t fileDescriptor;
+        uint8_t events;
+    };
+
+    /**
+     * Constructor.
+     */
+    EventQueue();
+
+    /**
+     * Copy Constructor.
+     */
+    EventQueue(const EventQueue &other) = delete;
+
+    /**
+     * Assignment operator.
+     */
+    EventQueue &operator=(const EventQueue &other) = delete;
+
+    /**
+     * Destructor.
+     */
+    ~EventQueue();
+
+    /**
+     * Register a file descriptor or change the events it is registered for.
+     *
+     * @param events A combination of File::Event values
+     */
+    bool add(int32_t fileDescriptor, uint8_t events);
+
+    bool remove(int32_t fileDescriptor);
+
+    /**
+     * Wait for events on the registered file descriptors.
+     *
+     * @param events The array to store the events in
+     * @param count The capacity of the array
+     * @param timeout The maximum time to wait in milliseconds (0 = return immediately, -1 = wait indefinitely)
+     *
+     * @return The amount of stored events (0, if the timeout has expired)
+     */
+    uint32_t wait(Event *events, uint32_t count, int32_t timeout = -1);
+
+    [[nodiscard]] int32_t getFileDescriptor() const;
+
+private:
+
+    int32_t fileDescriptor;
+};
+
+}
+
+#endif
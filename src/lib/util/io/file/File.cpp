@@ -105,6 +105,15 @@ Array<String> File::getChildren() {
     return ::getFileChildren(fileDescriptor);
 }
 
+uint32_t File::readDirectory(uint32_t &cursor, DirectoryEntry *entries, uint32_t count) {
+    ensureFileIsOpened();
+    if (fileDescriptor < 0) {
+        Util::Exception::throwException(Exception::INVALID_ARGUMENT, "File: Could not open file!");
+    }
+
+    return ::readDirectory(fileDescriptor, cursor, entries, count);
+}
+
 File File::getParentFile() const {
     return File(getParent());
 }
@@ -159,6 +168,24 @@ bool File::isReadyToRead() {
     return isReadyToRead(fileDescriptor);
 }
 
+bool File::sync() {
+    ensureFileIsOpened();
+    if (fileDescriptor < 0) {
+        Util::Exception::throwException(Exception::INVALID_ARGUMENT, "File: Could not open file!");
+    }
+
+    return sync(fileDescriptor);
+}
+
+bool File::truncate(uint64_t length) {
+    ensureFileIsOpened();
+    if (fileDescriptor < 0) {
+        Util::Exception::throwException(Exception::INVALID_ARGUMENT, "File: Could not open file!");
+    }
+
+    return truncate(fileDescriptor, length);
+}
+
 Util::String File::getCanonicalPath(const Util::String &path) {
     if (path.isEmpty()) {
         return "";
@@ -227,6 +254,34 @@ bool File::isReadyToRead(int32_t fileDescriptor) {
     return readyToRead;
 }
 
+bool File::sync(int32_t fileDescriptor) {
+    return controlFileDescriptor(fileDescriptor, SYNC, Util::Array<uint32_t>(0));
+}
+
+bool File::truncate(int32_t fileDescriptor, uint64_t length) {
+    return controlFileDescriptor(fileDescriptor, TRUNCATE, Util::Array<uint32_t>({static_cast<uint32_t>(length), static_cast<uint32_t>(length >> 32)}));
+}
+
+uint32_t File::poll(PollEntry *entries, uint32_t count, int32_t timeout) {
+    return ::pollFiles(entries, count, timeout);
+}
+
+bool File::createPipe(int32_t &readFileDescriptor, int32_t &writeFileDescriptor) {
+    return ::createPipe(readFileDescriptor, writeFileDescriptor);
+}
+
+uint64_t File::readVector(int32_t fileDescriptor, const Segment *segments, uint32_t count, uint64_t pos) {
+    return ::readFileVector(fileDescriptor, segments, count, pos);
+}
+
+uint64_t File::writeVector(int32_t fileDescriptor, const Segment *segments, uint32_t count, uint64_t pos) {
+    return ::writeFileVector(fileDescriptor, segments, count, pos);
+}
+
+uint64_t File::transfer(int32_t sourceFileDescriptor, uint64_t sourcePos, int32_t targetFileDescriptor, uint64_t targetPos, uint64_t length) {
+    return ::transferFile(sourceFileDescriptor, sourcePos, targetFileDescriptor, targetPos, length);
+}
+
 void File::close(int32_t fileDescriptor) {
     return ::closeFile(fileDescriptor);
 }
@@ -240,7 +295,11 @@ File File::getCurrentWorkingDirectory() {
 }
 
 const char* File::getTypeColor(File &file) {
-    switch (file.getType()) {
+    return getTypeColor(file.getType());
+}
+
+const char* File::getTypeColor(Type type) {
+    switch (type) {
         case Util::Io::File::DIRECTORY:
             return Util::Graphic::Ansi::FOREGROUND_BRIGHT_BLUE;
         case Util::Io::File::REGULAR:
@@ -52,7 +52,47 @@ public:
      */
     enum Request {
         SET_ACCESS_MODE,
-        IS_READY_TO_READ
+        IS_READY_TO_READ,
+        SYNC,
+        TRUNCATE
+    };
+
+    /**
+     * Readiness events, for which poll() can wait.
+     */
+    enum Event : uint8_t {
+        READY_TO_READ = 0x01,
+        READY_TO_WRITE = 0x02
+    };
+
+    /**
+     * A file descriptor and the events poll() shall wait for.
+     * The events, that have actually occurred, are stored in 'readyEvents'.
+     */
+    struct PollEntry {
+        int32_t fileDescriptor;
+        uint8_t events;
+        uint8_t readyEvents;
+    };
+
+    static const constexpr uint32_t MAX_NAME_LENGTH = 255;
+
+    /**
+     * An entry of a directory, as returned by readDirectory().
+     * Type and length are stored inline, so that listing a directory does not require opening each child.
+     */
+    struct DirectoryEntry {
+        Type type;
+        uint64_t length;
+        char name[MAX_NAME_LENGTH + 1];
+    };
+
+    /**
+     * A buffer segment for vectored (scatter/gather) I/O.
+     */
+    struct Segment {
+        uint8_t *buffer;
+        uint32_t length;
     };
 
     /**
@@ -93,6 +133,14 @@ public:
 
     [[nodiscard]] Array<String> getChildren();
 
+    /**
+     * Read the next batch of entries from this directory. The cursor must be 0 for the first call
+     * and is advanced past the returned entries. Its value is specific to the filesystem driver.
+     *
+     * @return The amount of entries written to 'entries' (0 = end of directory)
+     */
+    [[nodiscard]] uint32_t readDirectory(uint32_t &cursor, DirectoryEntry *entries, uint32_t count);
+
     [[nodiscard]] File getParentFile() const;
 
     bool create(Type fileType);
@@ -107,12 +155,18 @@ public:
 
     bool isReadyToRead();
 
+    bool sync();
+
+    bool truncate(uint64_t length);
+
     [[nodiscard]] static String getCanonicalPath(const Util::String &path);
 
     [[nodiscard]] static File getCurrentWorkingDirectory();
 
     [[nodiscard]] static const char* getTypeColor(Util::Io::File &file);
 
+    [[nodiscard]] static const char* getTypeColor(Type type);
+
     int32_t static open(const Util::String &path);
 
     static bool controlFile(int32_t fileDescriptor, uint32_t request, const Util::Array<uint32_t> &parameters);
@@ -123,6 +177,52 @@ public:
 
     static bool isReadyToRead(int32_t fileDescriptor);
 
+    static bool sync(int32_t fileDescriptor);
+
+    static bool truncate(int32_t fileDescriptor, uint64_t length);
+
+    /**
+     * Wait until at least one of the given file descriptors is ready for one of its requested events.
+     * The waiting thread is blocked and does not consume any CPU time.
+     *
+     * @param entries The file descriptors and their requested events
+     * @param count The amount of entries
+     * @param timeout The maximum time to wait in milliseconds (0 = return immediately, -1 = wait indefinitely)
+     *
+     * @return The amount of ready file descriptors (0, if the timeout has expired)
+     */
+    static uint32_t poll(PollEntry *entries, uint32_t count, int32_t timeout = -1);
+
+    /**
+     * Create an anonymous pipe. Data written to the write end can be read from the read end.
+     * Reading from an empty pipe returns 0 bytes, after the write end has been closed.
+     */
+    static bool createPipe(int32_t &readFileDescriptor, int32_t &writeFileDescriptor);
+
+    /**
+     * Read from a file into multiple buffers, starting at the given position, with a single system call.
+     * The segments are filled in order. Reading stops at the first segment, which could not be filled completely.
+     *
+     * @return The total amount of bytes read
+     */
+    static uint64_t readVector(int32_t fileDescriptor, const Segment *segments, uint32_t count, uint64_t pos);
+
+    /**
+     * Write multiple buffers to a file, starting at the given position, with a single system call.
+     *
+     * @return The total amount of bytes written
+     */
+    static uint64_t writeVector(int32_t fileDescriptor, const Segment *segments, uint32_t count, uint64_t pos);
+
+    /**
+     * Copy data from one file descriptor to another inside the kernel, without passing it through a user space buffer.
+     * Works for any combination of files, pipes and connected sockets. Copying stops after 'length' bytes,
+     * or if the source has no more data, or if the target does not accept all data.
+     *
+     * @return The amount of bytes copied
+     */
+    static uint64_t transfer(int32_t sourceFileDescriptor, uint64_t sourcePos, int32_t targetFileDescriptor, uint64_t targetPos, uint64_t length);
+
     static void close(int32_t fileDescriptor);
 
     static bool mount(const Util::String &device, const Util::String &targetPath, const Util::String &driverName);
@@ -35,6 +35,7 @@ Archive::Archive(uint32_t address) {
 
         if (header->typeFlag == LF_OLDNORMAL) {
             fileCount++;
+            indexFile(header);
         }
 
         archiveAddress = archiveAddress.add(((size / BLOCKSIZE) + 1) * BLOCKSIZE);
@@ -44,6 +45,12 @@ Archive::Archive(uint32_t address) {
     }
 }
 
+Archive::~Archive() {
+    for (auto *children : directoryIndex.values()) {
+        delete children;
+    }
+}
+
 uint32_t Archive::calculateFileSize(const Header &header) {
     uint32_t ret = 0;
     uint32_t count = 1;
@@ -72,13 +79,51 @@ Util::Array<Archive::Header> Archive::getFileHeaders() {
 }
 
 uint8_t *Archive::getFile(const Util::String &path) {
-    for (auto *header : headers) {
-        if (path == header->filename) {
-            return reinterpret_cast<uint8_t*>(header) + BLOCKSIZE;
+    auto *header = getHeader(path);
+    return header == nullptr ? nullptr : reinterpret_cast<uint8_t*>(header) + BLOCKSIZE;
+}
+
+Archive::Header* Archive::getHeader(const Util::String &path) {
+    return fileIndex.containsKey(path) ? fileIndex.get(path) : nullptr;
+}
+
+bool Archive::isDirectory(const Util::String &path) {
+    return directoryIndex.containsKey(path);
+}
+
+Util::Array<Util::String> Archive::getChildren(const Util::String &path) {
+    return directoryIndex.containsKey(path) ? directoryIndex.get(path)->toArray() : Util::Array<Util::String>(0);
+}
+
+void Archive::indexFile(Header *header) {
+    Util::String path = header->filename;
+    fileIndex.put(path, header);
+
+    // Add the file to its parent directory and create missing parent directories on the way up to the root
+    while (!path.isEmpty()) {
+        auto separatorIndex = path.length();
+        while (separatorIndex > 0 && path[separatorIndex - 1] != '/') {
+            separatorIndex--;
         }
-    }
 
-    return nullptr;
+        auto name = path.substring(separatorIndex);
+        auto parent = separatorIndex > 0 ? path.substring(0, separatorIndex - 1) : Util::String();
+
+        if (directoryIndex.containsKey(parent)) {
+            auto *children = directoryIndex.get(parent);
+            if (!children->contains(name)) {
+                children->add(name);
+            }
+
+            // All directories above an existing directory have already been indexed
+            return;
+        }
+
+        auto *children = new Util::ArrayList<Util::String>();
+        children->add(name);
+        directoryIndex.put(parent, children);
+        path = parent;
+    }
 }
 
 }
@@ -22,6 +22,7 @@
 #include "lib/util/collection/Array.h"
 #include "lib/util/base/String.h"
 #include "lib/util/collection/ArrayList.h"
+#include "lib/util/collection/HashMap.h"
 
 namespace Util::Io::Tar {
 
@@ -45,7 +46,7 @@ public:
 
     explicit Archive(uint32_t address);
 
-    ~Archive() = default;
+    ~Archive();
 
     Archive(const Archive &other) = delete;
 
@@ -66,6 +67,30 @@ public:
      */
     uint8_t* getFile(const Util::String &path);
 
+    /**
+     * Returns the header of the specified file within this archive.
+     *
+     * @param path The file's path.
+     * @return The file's header or nullptr if it does not exist.
+     */
+    Header* getHeader(const Util::String &path);
+
+    /**
+     * Checks whether the specified path is a directory, containing at least one file.
+     *
+     * @param path The directory's path (empty for the root directory).
+     * @return true, if the directory exists.
+     */
+    bool isDirectory(const Util::String &path);
+
+    /**
+     * Returns the names of all files and directories directly inside the specified directory.
+     *
+     * @param path The directory's path (empty for the root directory).
+     * @return The children's names (empty, if the directory does not exist).
+     */
+    Util::Array<Util::String> getChildren(const Util::String &path);
+
     /**
      * Converts the size (base8) to the decimal system.
      *
@@ -81,6 +106,12 @@ private:
 
     Util::ArrayList<Header*> headers;
 
+    // Built once while parsing, so that lookups do not need to scan all headers
+    Util::HashMap<Util::String, Header*> fileIndex;
+    Util::HashMap<Util::String, Util::ArrayList<Util::String>*> directoryIndex;
+
+    void indexFile(Header *header);
+
     static const constexpr uint8_t LF_NORMAL = 0;
     static const constexpr uint8_t LF_LINK = 1;
     static const constexpr uint8_t LF_SYMLINK = 2;
@@ -64,6 +64,8 @@ FileStream::~FileStream() {
 	if (freeBufferOnDelete && buffer) {
         delete[] buffer;
     }
+
+	delete[] readBuffer;
 }
 
 int FileStream::setBuffer(char* newBuffer, BufferMode mode, size_t size) {
@@ -71,6 +73,8 @@ int FileStream::setBuffer(char* newBuffer, BufferMode mode, size_t size) {
 	
 	if (mode == BufferMode::NONE) {
 		buffer = nullptr;
+		bufferMode = mode;
+		readBufferingAllowed = false;
 		return 0;
 	}
 	
@@ -91,6 +95,12 @@ int FileStream::setBuffer(char* newBuffer, BufferMode mode, size_t size) {
 }
 
 int FileStream::fflush() {
+	if (readBuffered) {
+		// Nothing to write back, but the file position must be set to where the reader actually is
+		discardReadBuffer();
+		return 0;
+	}
+
 	if (buffer == nullptr || !isWriteAllowed() || isError()) {
         return EOF;
     }
@@ -126,6 +136,10 @@ void FileStream::write(const uint8_t *sourceBuffer, uint32_t offset, uint32_t le
         pos += offset;
     }
 
+    if (readBuffered) {
+        discardReadBuffer();
+    }
+
     bufferChangeAllowed = false;
     if (buffer) {
         for (uint32_t i = 0; i < length; i++) {
@@ -156,6 +170,15 @@ int16_t FileStream::read() {
 	if (!ungottenChars.isEmpty()) {
 		return ungottenChars.pop();
 	}
+
+	if (isReadBufferingEnabled()) {
+		if ((!readBuffered || readPos >= readLength) && !fillReadBuffer()) {
+			eof = true;
+			return EOF;
+		}
+
+		return readBuffer[readPos++];
+	}
 	
 	int32_t len = readFile(fileDescriptor, &ret, pos++, 1);
 	if (len == 0) {
@@ -167,6 +190,10 @@ int16_t FileStream::read() {
 }
 
 int16_t FileStream::peek() {
+	if (ungottenChars.isEmpty() && readBuffered && readPos < readLength) {
+		return readBuffer[readPos];
+	}
+
 	int16_t ret = read();
 	ungetChar(ret);
 
@@ -174,6 +201,10 @@ int16_t FileStream::peek() {
 }
 
 bool FileStream::isReadyToRead() {
+	if (!ungottenChars.isEmpty() || (readBuffered && readPos < readLength)) {
+		return true;
+	}
+
 	return Util::Io::File::isReadyToRead(fileDescriptor);
 }
 
@@ -182,35 +213,77 @@ int32_t FileStream::read(uint8_t *targetBuffer, uint32_t offset, uint32_t length
         return EOF;
     }
 	
+	// Pending writes must reach the file first (and a read buffer is dropped, when skipping data)
+	if (offset > 0 || bufferPos > 0) {
+		flush();
+	}
+
 	pos += offset;
     bufferChangeAllowed = false;
-	
+
+	uint32_t copied = 0;
 	if (!offset) {
-		uint32_t i = 0;
-		for (; i<length && !ungottenChars.isEmpty(); i++) {
-			targetBuffer[i] = ungottenChars.pop();
+		for (; copied < length && !ungottenChars.isEmpty(); copied++) {
+			targetBuffer[copied] = ungottenChars.pop();
 		}
-		targetBuffer += i;
-		length -= i;
 	}
-	
-	uint32_t len = readFile(fileDescriptor, targetBuffer, pos, length);
+
+	// Serve as much as possible from the read buffer
+	if (readBuffered && copied < length && readPos < readLength) {
+		auto count = readLength - readPos < length - copied ? readLength - readPos : length - copied;
+		for (uint32_t i = 0; i < count; i++) {
+			targetBuffer[copied + i] = readBuffer[readPos + i];
+		}
+
+		readPos += count;
+		copied += count;
+	}
+
+	if (copied == length) {
+		return copied;
+	}
+
+	// Small requests refill the buffer, large requests bypass it
+	if (isReadBufferingEnabled() && length - copied < readBufferSize) {
+		if (!fillReadBuffer()) {
+			eof = true;
+			return copied;
+		}
+
+		return copied + read(targetBuffer + copied, 0, length - copied);
+	}
+
+	if (readBuffered) {
+		discardReadBuffer();
+	}
+
+	uint32_t len = readFile(fileDescriptor, targetBuffer + copied, pos, length - copied);
 	pos += len;
-	
-	if (len < length) eof = true;
-	return len;
+
+	if (len < length - copied) eof = true;
+	return copied + len;
 }
 
 int FileStream::ungetChar(int ch) {
+	// Stepping back in the read buffer avoids allocating memory in the common case of reading one character too far
+	if (ungottenChars.isEmpty() && readBuffered && readPos > 0 && readBuffer[readPos - 1] == ch) {
+		readPos--;
+		return ch;
+	}
+
 	ungottenChars.add(ch);
 	return ch;
 }
 
 uint32_t FileStream::getPos() const {
-	return pos;
+	// Each character pushed back via ungetChar() moves the logical position back by one
+	auto position = readBuffered ? pos + readPos : pos + bufferPos;
+	auto ungottenCount = ungottenChars.size();
+	return position > ungottenCount ? position - ungottenCount : 0;
 }
 
 void FileStream::setPos(uint32_t newPos, SeekMode mode) {
+	auto currentPos = getPos();
 	flush();
     eof = false;
 	ungottenChars.clear();
@@ -219,7 +292,7 @@ void FileStream::setPos(uint32_t newPos, SeekMode mode) {
 		case SeekMode::SET:
 			break;
 		case SeekMode::CURRENT:
-			newPos += pos;
+			newPos += currentPos;
 			break;
 		case SeekMode::END:
 			newPos = getFileLength(fileDescriptor) - newPos;
@@ -259,4 +332,41 @@ bool FileStream::setAccessMode(File::AccessMode accessMode) const {
     return File::setAccessMode(fileDescriptor, accessMode);
 }
 
+bool FileStream::isReadBufferingEnabled() {
+	if (!readBufferingChecked) {
+		readBufferingChecked = true;
+		readBuffering = readBufferingAllowed && getFileType(fileDescriptor) == File::REGULAR;
+
+		if (readBuffering) {
+			// The read buffer has the size requested via setBuffer(), but is separate from the write buffer
+			readBufferSize = bufferSize > 0 ? bufferSize : DEFAULT_BUFFER_SIZE;
+			readBuffer = new uint8_t[readBufferSize];
+		}
+	}
+
+	return readBuffering;
+}
+
+bool FileStream::fillReadBuffer() {
+	if (readBuffered) {
+		pos += readLength;
+	} else if (bufferPos > 0) {
+		// Pending writes must reach the file, before it is read again
+		flush();
+	}
+
+	readLength = readFile(fileDescriptor, readBuffer, pos, readBufferSize);
+	readPos = 0;
+	readBuffered = readLength > 0;
+
+	return readBuffered;
+}
+
+void FileStream::discardReadBuffer() {
+	pos += readPos;
+	readPos = 0;
+	readLength = 0;
+	readBuffered = false;
+}
+
 }
\ No newline at end of file
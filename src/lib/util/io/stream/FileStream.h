@@ -19,6 +19,9 @@ namespace Util::Io {
 /**
  * A stream that can read from and write to a file.
  * Exposes libc compatible functions (fflush, fputc, ungetc, etc.)
+ * Writes are only buffered, if a buffer has been set via setBuffer().
+ * Reads from a regular file always go through a separate read buffer (unless buffering has been disabled via setBuffer()),
+ * so that reading a file character by character does not cost one system call per character.
  */
 class FileStream : public InputStream, public OutputStream {
 
@@ -97,6 +100,12 @@ public:
 	
 private:
 
+	bool isReadBufferingEnabled();
+
+	bool fillReadBuffer();
+
+	void discardReadBuffer();
+
 	int32_t fileDescriptor;
 	uint32_t pos = 0; // next position to be written to, or start of buffer
 	
@@ -105,16 +114,29 @@ private:
 	bool error = false;
 	bool eof = false;
 	
-	BufferMode bufferMode;
+	BufferMode bufferMode = BufferMode::NONE;
 	bool bufferChangeAllowed = true;
 	bool freeBufferOnDelete = false;
 
-	uint32_t bufferPos; // current position inside buffer
-	uint32_t bufferSize;
+	uint32_t bufferPos = 0; // current position inside buffer
+	uint32_t bufferSize = 0;
 	uint8_t *buffer = nullptr;
+
+	// If the read buffer holds data, 'pos' is the file position of its first byte (there is never pending write data at the same time)
+	uint8_t *readBuffer = nullptr;
+	uint32_t readBufferSize = 0;
+	uint32_t readPos = 0; // current position inside read buffer
+	uint32_t readLength = 0;
+	bool readBuffered = false;
+
+	// Read buffering is only used for regular files, since reading ahead from streams (e.g. terminals) could block
+	bool readBufferingAllowed = true;
+	bool readBufferingChecked = false;
+	bool readBuffering = false;
 	
 	Util::ArrayList<int> ungottenChars;
-	
+
+	static const constexpr uint32_t DEFAULT_BUFFER_SIZE = 4096;
 };
 
 }
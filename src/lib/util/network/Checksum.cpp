@@ -0,0 +1,254 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "Checksum.h"
+
+#include "lib/util/hardware/CpuId.h"
+
+namespace Util::Network {
+
+struct Crc32Table {
+    uint32_t entries[8][256];
+};
+
+/**
+ * Table k contains the CRC of each byte value, followed by k zero bytes.
+ * This way, slicing-by-8 can look up the contribution of eight input bytes independently.
+ */
+static constexpr Crc32Table generateCrc32Table() {
+    Crc32Table table{};
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t crc = i;
+        for (uint32_t j = 0; j < 8; j++) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xedb88320 : crc >> 1;
+        }
+
+        table.entries[0][i] = crc;
+    }
+
+    for (uint32_t i = 0; i < 256; i++) {
+        for (uint32_t j = 1; j < 8; j++) {
+            auto previous = table.entries[j - 1][i];
+            table.entries[j][i] = (previous >> 8) ^ table.entries[0][previous & 0xff];
+        }
+    }
+
+    return table;
+}
+
+static constexpr Crc32Table CRC32_TABLE = generateCrc32Table();
+
+static uint16_t swapBytes(uint16_t value) {
+    return static_cast<uint16_t>((value << 8) | (value >> 8));
+}
+
+uint16_t Checksum::add(const uint8_t *buffer, uint32_t length, uint16_t sum) {
+    return add(ACCUMULATOR_64, buffer, length, sum);
+}
+
+uint16_t Checksum::add(Checksum::Implementation implementation, const uint8_t *buffer, uint32_t length, uint16_t sum) {
+    // The one's complement sum is independent of byte order (RFC 1071, section 2),
+    // so the words are summed up in host byte order and only the folded result is swapped
+    uint64_t total;
+    switch (implementation) {
+        case ACCUMULATOR_32:
+            total = addWords32(buffer, length);
+            break;
+        case SSE2:
+            total = addWordsSse2(buffer, length);
+            break;
+        default:
+            total = addWords64(buffer, length);
+    }
+
+    return swapBytes(fold(total + swapBytes(sum)));
+}
+
+uint16_t Checksum::finish(uint16_t sum) {
+    return ~sum;
+}
+
+uint16_t Checksum::calculate(const uint8_t *buffer, uint32_t length, uint16_t sum) {
+    return finish(add(buffer, length, sum));
+}
+
+uint16_t Checksum::update(uint16_t checksum, uint16_t oldValue, uint16_t newValue) {
+    // HC' = ~(~HC + ~m + m')
+    uint32_t sum = static_cast<uint16_t>(~checksum) + static_cast<uint16_t>(~oldValue) + newValue;
+    return finish(fold(sum));
+}
+
+uint16_t Checksum::update32(uint16_t checksum, uint32_t oldValue, uint32_t newValue) {
+    checksum = update(checksum, oldValue >> 16, newValue >> 16);
+    return update(checksum, oldValue, newValue);
+}
+
+uint32_t Checksum::calculateCrc32(const uint8_t *buffer, uint32_t length, uint32_t crc) {
+    const auto &table = CRC32_TABLE.entries;
+    crc = ~crc;
+
+    while (length >= 8) {
+        uint32_t words[2];
+        __builtin_memcpy(words, buffer, sizeof(words));
+        auto low = words[0] ^ crc;
+        auto high = words[1];
+
+        crc = table[7][low & 0xff] ^ table[6][(low >> 8) & 0xff] ^ table[5][(low >> 16) & 0xff] ^ table[4][low >> 24] ^
+              table[3][high & 0xff] ^ table[2][(high >> 8) & 0xff] ^ table[1][(high >> 16) & 0xff] ^ table[0][high >> 24];
+
+        buffer += 8;
+        length -= 8;
+    }
+
+    while (length > 0) {
+        crc = table[0][(crc ^ *buffer) & 0xff] ^ (crc >> 8);
+        buffer++;
+        length--;
+    }
+
+    return ~crc;
+}
+
+bool Checksum::isSupported(Checksum::Implementation implementation) {
+    if (implementation == SSE2) {
+        return Hardware::CpuId::isAvailable() && (Hardware::CpuId::getCpuFeatureBits() & Hardware::CpuId::SSE2) != 0;
+    }
+
+    return true;
+}
+
+Checksum::Implementation Checksum::getFastestImplementation() {
+    return isSupported(SSE2) ? SSE2 : ACCUMULATOR_64;
+}
+
+uint64_t Checksum::addWords32(const uint8_t *buffer, uint32_t length) {
+    uint32_t sum = 0;
+    while (length > 1) {
+        uint16_t word;
+        __builtin_memcpy(&word, buffer, sizeof(word));
+        sum += word;
+
+        // Fold carries back, before they can overflow the accumulator
+        if (sum & 0x80000000) {
+            sum = (sum & 0xffff) + (sum >> 16);
+        }
+
+        buffer += 2;
+        length -= 2;
+    }
+
+    // A trailing byte is padded with a zero byte
+    if (length > 0) {
+        sum += *buffer;
+    }
+
+    return sum;
+}
+
+uint64_t Checksum::addWords64(const uint8_t *buffer, uint32_t length) {
+    // The carries of 32-bit additions are kept in the upper half of the accumulator and folded back at the end
+    uint64_t sum = 0;
+    while (length >= 16) {
+        uint32_t words[4];
+        __builtin_memcpy(words, buffer, sizeof(words));
+        sum += words[0];
+        sum += words[1];
+        sum += words[2];
+        sum += words[3];
+
+        buffer += 16;
+        length -= 16;
+    }
+
+    while (length >= 4) {
+        uint32_t word;
+        __builtin_memcpy(&word, buffer, sizeof(word));
+        sum += word;
+
+        buffer += 4;
+        length -= 4;
+    }
+
+    if (length >= 2) {
+        uint16_t word;
+        __builtin_memcpy(&word, buffer, sizeof(word));
+        sum += word;
+
+        buffer += 2;
+        length -= 2;
+    }
+
+    if (length > 0) {
+        sum += *buffer;
+    }
+
+    return sum;
+}
+
+__attribute__((target("sse2"))) uint64_t Checksum::addWordsSse2(const uint8_t *buffer, uint32_t length) {
+    uint64_t sum = 0;
+    auto blocks = length / 16;
+
+    while (blocks > 0) {
+        // Each 32-bit lane receives one word per block, so it cannot overflow within MAX_SSE2_BLOCKS blocks
+        auto chunkBlocks = blocks > MAX_SSE2_BLOCKS ? MAX_SSE2_BLOCKS : blocks;
+        auto remainingBlocks = chunkBlocks;
+        uint32_t lanes[8];
+
+        asm volatile (
+        "pxor %%xmm0, %%xmm0;"
+        "pxor %%xmm1, %%xmm1;"
+        "pxor %%xmm2, %%xmm2;"
+        "1:"
+        "movdqu (%0), %%xmm3;"
+        "movdqa %%xmm3, %%xmm4;"
+        "punpcklwd %%xmm0, %%xmm3;"
+        "punpckhwd %%xmm0, %%xmm4;"
+        "paddd %%xmm3, %%xmm1;"
+        "paddd %%xmm4, %%xmm2;"
+        "add $16, %0;"
+        "dec %1;"
+        "jnz 1b;"
+        "movdqu %%xmm1, (%2);"
+        "movdqu %%xmm2, 16(%2);"
+        : "+r"(buffer), "+r"(remainingBlocks)
+        : "r"(lanes)
+        : "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "cc", "memory"
+        );
+
+        for (auto lane : lanes) {
+            sum += lane;
+        }
+
+        blocks -= chunkBlocks;
+    }
+
+    return sum + addWords64(buffer, length % 16);
+}
+
+uint16_t Checksum::fold(uint64_t sum) {
+    sum = (sum & 0xffffffff) + (sum >> 32);
+    sum = (sum & 0xffffffff) + (sum >> 32);
+
+    auto result = static_cast<uint32_t>(sum);
+    result = (result & 0xffff) + (result >> 16);
+    result = (result & 0xffff) + (result >> 16);
+
+    return result;
+}
+
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef HHUOS_CHECKSUM_H
+#define HHUOS_CHECKSUM_H
+
+#include <stdint.h>
+
+namespace Util::Network {
+
+/**
+ * Internet checksum (RFC 1071) and Ethernet frame check sequence (CRC-32).
+ * Partial checksum sums are passed and returned in network byte order, folded to 16 bits,
+ * so that a sum can be continued over several buffers (e.g. pseudo header and datagram).
+ */
+class Checksum {
+
+public:
+
+    enum Implementation : uint8_t {
+        // 16-bit words, added to a 32-bit accumulator (the classic RFC 1071 loop)
+        ACCUMULATOR_32,
+        // 32-bit words, added to a 64-bit accumulator, 16 bytes per loop iteration
+        ACCUMULATOR_64,
+        // 16 bytes per loop iteration, widened to eight 32-bit lanes in SSE registers
+        SSE2
+    };
+
+    /**
+     * Default Constructor.
+     * Deleted, as this class has only static members.
+     */
+    Checksum() = delete;
+
+    /**
+     * Copy Constructor.
+     */
+    Checksum(const Checksum &other) = delete;
+
+    /**
+     * Assignment operator.
+     */
+    Checksum &operator=(const Checksum &other) = delete;
+
+    /**
+     * Destructor.
+     */
+    ~Checksum() = default;
+
+    /**
+     * Add all 16-bit words of a buffer to a partial sum, using the ACCUMULATOR_64 implementation.
+     * If a sum is continued over several buffers, each buffer must start at an even offset of the checksummed data.
+     */
+    [[nodiscard]] static uint16_t add(const uint8_t *buffer, uint32_t length, uint16_t sum = 0);
+
+    /**
+     * Add all 16-bit words of a buffer to a partial sum, using the given implementation.
+     * SSE2 may only be used in user space, since the kernel does not save the SSE registers of interrupted code.
+     */
+    [[nodiscard]] static uint16_t add(Implementation implementation, const uint8_t *buffer, uint32_t length, uint16_t sum = 0);
+
+    /**
+     * Complement a partial sum, yielding the value of the checksum field.
+     */
+    [[nodiscard]] static uint16_t finish(uint16_t sum);
+
+    /**
+     * Calculate the checksum of a buffer, continuing the given partial sum.
+     */
+    [[nodiscard]] static uint16_t calculate(const uint8_t *buffer, uint32_t length, uint16_t sum = 0);
+
+    /**
+     * Update a checksum after a 16-bit field of the checksummed data has been rewritten (RFC 1624, equation 3),
+     * without summing up the whole data again.
+     */
+    [[nodiscard]] static uint16_t update(uint16_t checksum, uint16_t oldValue, uint16_t newValue);
+
+    /**
+     * Update a checksum after a 32-bit field (e.g. an IPv4 address) of the checksummed data has been rewritten.
+     */
+    [[nodiscard]] static uint16_t update32(uint16_t checksum, uint32_t oldValue, uint32_t newValue);
+
+    /**
+     * Calculate the CRC-32 (IEEE 802.3) of a buffer, continuing the CRC of preceding data.
+     * Eight bytes are processed per loop iteration (slicing-by-8).
+     */
+    [[nodiscard]] static uint32_t calculateCrc32(const uint8_t *buffer, uint32_t length, uint32_t crc = 0);
+
+    [[nodiscard]] static bool isSupported(Implementation implementation);
+
+    /**
+     * Get the fastest implementation, supported by the CPU.
+     * The result must not be used in the kernel (see add()).
+     */
+    [[nodiscard]] static Implementation getFastestImplementation();
+
+private:
+
+    [[nodiscard]] static uint64_t addWords32(const uint8_t *buffer, uint32_t length);
+
+    [[nodiscard]] static uint64_t addWords64(const uint8_t *buffer, uint32_t length);
+
+    [[nodiscard]] static uint64_t addWordsSse2(const uint8_t *buffer, uint32_t length);
+
+    [[nodiscard]] static uint16_t fold(uint64_t sum);
+
+    static const constexpr uint32_t MAX_SSE2_BLOCKS = 65536;
+};
+
+}
+
+#endif
@@ -61,6 +61,31 @@ bool Socket::bind(const NetworkAddress &address) const {
     return ::controlFile(fileDescriptor, BIND, Util::Array<uint32_t>({reinterpret_cast<uint32_t>(&address)}));
 }
 
+bool Socket::connect(const NetworkAddress &address) const {
+    return ::controlFile(fileDescriptor, CONNECT, Util::Array<uint32_t>({reinterpret_cast<uint32_t>(&address)}));
+}
+
+bool Socket::listen(uint32_t backlog) const {
+    return ::controlFile(fileDescriptor, LISTEN, Util::Array<uint32_t>({backlog}));
+}
+
+Socket Socket::accept() const {
+    int32_t acceptedFileDescriptor = -1;
+    if (!::controlFile(fileDescriptor, ACCEPT, Util::Array<uint32_t>({reinterpret_cast<uint32_t>(&acceptedFileDescriptor)}))) {
+        Util::Exception::throwException(Exception::ILLEGAL_STATE, "Failed to accept connection!");
+    }
+
+    return Socket(acceptedFileDescriptor, type);
+}
+
+uint32_t Socket::read(uint8_t *targetBuffer, uint32_t length) const {
+    return ::readFile(fileDescriptor, targetBuffer, 0, length);
+}
+
+uint32_t Socket::write(const uint8_t *sourceBuffer, uint32_t length) const {
+    return ::writeFile(fileDescriptor, sourceBuffer, 0, length);
+}
+
 bool Socket::getLocalAddress(NetworkAddress &address) const {
     return ::controlFile(fileDescriptor, GET_LOCAL_ADDRESS, Util::Array<uint32_t>({reinterpret_cast<uint32_t>(&address)}));
 }
@@ -73,6 +98,14 @@ bool Socket::receive(Util::Network::Datagram &datagram) const {
     return ::receiveDatagram(fileDescriptor, datagram);
 }
 
+bool Socket::send(const Datagram &datagram, const Io::File::Segment *segments, uint32_t count) const {
+    return ::sendDatagramVector(fileDescriptor, datagram, segments, count);
+}
+
+bool Socket::receive(Datagram &datagram, const Io::File::Segment *segments, uint32_t count, uint32_t &length) const {
+    return ::receiveDatagramVector(fileDescriptor, datagram, segments, count, length);
+}
+
 Array<Ip4::Ip4SubnetAddress> Socket::getIp4Addresses() const {
     uint32_t size = 1;
     auto addresses = Array<Ip4::Ip4SubnetAddress>(size);
@@ -50,9 +50,10 @@ public:
 
     enum Request {
         SET_TIMEOUT,
-        BIND, GET_LOCAL_ADDRESS,
+        BIND, CONNECT, GET_LOCAL_ADDRESS,
         GET_IP4_ADDRESSES, REMOVE_IP4_ADDRESS, ADD_IP4_ADDRESS,
-        GET_ROUTES, REMOVE_ROUTE, ADD_ROUTE
+        GET_ROUTES, REMOVE_ROUTE, ADD_ROUTE,
+        LISTEN, ACCEPT
     };
 
     /**
@@ -76,12 +77,60 @@ public:
 
     [[nodiscard]] bool bind(const NetworkAddress &address) const;
 
+    /**
+     * Set the default remote address of this socket. Afterwards, data can be written to the socket like to a file
+     * (e.g. via Util::Io::File::transfer()). For UDP sockets, each write is sent as one or more datagrams to the remote address.
+     * TCP sockets perform the handshake with the remote address and block until the connection is established (or the timeout expires).
+     */
+    [[nodiscard]] bool connect(const NetworkAddress &address) const;
+
+    /**
+     * Let a bound TCP socket accept incoming connections.
+     *
+     * @param backlog The maximum amount of connections, that may wait to be accepted
+     */
+    [[nodiscard]] bool listen(uint32_t backlog) const;
+
+    /**
+     * Wait for an incoming connection on a listening TCP socket.
+     * Throws an exception, if no connection has been established before the timeout expires.
+     *
+     * @return A new socket, which is connected to the remote host
+     */
+    [[nodiscard]] Socket accept() const;
+
+    /**
+     * Read data from a connected stream socket, blocking until at least one byte is available.
+     *
+     * @return The amount of bytes read (0, if the connection has been closed by the remote host)
+     */
+    uint32_t read(uint8_t *targetBuffer, uint32_t length) const;
+
+    /**
+     * Write data to a connected socket.
+     *
+     * @return The amount of bytes written
+     */
+    uint32_t write(const uint8_t *sourceBuffer, uint32_t length) const;
+
     [[nodiscard]] bool getLocalAddress(NetworkAddress &address) const;
 
     [[nodiscard]] bool send(const Util::Network::Datagram &datagram) const;
 
     [[nodiscard]] bool receive(Util::Network::Datagram &datagram) const;
 
+    /**
+     * Send a datagram, whose payload is gathered from multiple buffers (e.g. a header and the actual data).
+     * Only the remote address and protocol specific attributes of the given datagram are used.
+     */
+    [[nodiscard]] bool send(const Util::Network::Datagram &datagram, const Io::File::Segment *segments, uint32_t count) const;
+
+    /**
+     * Receive a datagram and scatter its payload into the given buffers. Payload, that does not fit, is discarded.
+     * The datagram's own buffer is not touched, only its remote address and attributes are set.
+     */
+    [[nodiscard]] bool receive(Util::Network::Datagram &datagram, const Io::File::Segment *segments, uint32_t count, uint32_t &length) const;
+
     [[nodiscard]] Array<Ip4::Ip4SubnetAddress> getIp4Addresses() const;
 
     [[nodiscard]] bool removeIp4Address(const Ip4::Ip4SubnetAddress &address) const;
@@ -62,4 +62,8 @@ bool Ip4Address::isBroadcastAddress() const {
     return true;
 }
 
+uint32_t Ip4Address::toInteger() const {
+    return buffer[0] << 24 | buffer[1] << 16 | buffer[2] << 8 | buffer[3];
+}
+
 }
\ No newline at end of file
@@ -65,6 +65,11 @@ public:
 
     [[nodiscard]] bool isBroadcastAddress() const;
 
+    /**
+     * Get the address as an integer in host byte order (e.g. for hashing or prefix comparisons).
+     */
+    [[nodiscard]] uint32_t toInteger() const;
+
     [[nodiscard]] NetworkAddress* createCopy() const override;
 
     [[nodiscard]] Util::String toString() const override;
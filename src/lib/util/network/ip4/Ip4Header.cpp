@@ -44,11 +44,11 @@ void Ip4Header::read(Util::Io::InputStream &stream) {
     auto totalLength = Util::Network::NumberUtil::readUnsigned16BitValue(stream);
     payloadLength = totalLength - headerLength;
 
-    // Discard Identification, Flags and Offset
-    stream.read();
-    stream.read();
-    stream.read();
-    stream.read();
+    identification = Util::Network::NumberUtil::readUnsigned16BitValue(stream);
+    auto flagsAndOffset = Util::Network::NumberUtil::readUnsigned16BitValue(stream);
+    dontFragment = (flagsAndOffset & DONT_FRAGMENT) != 0;
+    moreFragments = (flagsAndOffset & MORE_FRAGMENTS) != 0;
+    fragmentOffset = (flagsAndOffset & FRAGMENT_OFFSET_MASK) * FRAGMENT_OFFSET_UNIT;
 
     timeToLive = Util::Network::NumberUtil::readUnsigned8BitValue(stream);
     protocol = static_cast<Protocol>(Util::Network::NumberUtil::readUnsigned8BitValue(stream));
@@ -75,8 +75,9 @@ void Ip4Header::write(Util::Io::OutputStream &stream) const {
 
     Util::Network::NumberUtil::writeUnsigned16BitValue(headerLength + payloadLength, stream);
 
-    // Write empty Identification, Flags and Offset
-    Util::Network::NumberUtil::writeUnsigned32BitValue(0, stream);
+    Util::Network::NumberUtil::writeUnsigned16BitValue(identification, stream);
+    uint16_t flagsAndOffset = (dontFragment ? DONT_FRAGMENT : 0) | (moreFragments ? MORE_FRAGMENTS : 0) | (fragmentOffset / FRAGMENT_OFFSET_UNIT);
+    Util::Network::NumberUtil::writeUnsigned16BitValue(flagsAndOffset, stream);
 
     Util::Network::NumberUtil::writeUnsigned8BitValue(timeToLive, stream);
     Util::Network::NumberUtil::writeUnsigned8BitValue(protocol, stream);
@@ -96,6 +97,26 @@ uint16_t Ip4Header::getPayloadLength() const {
     return payloadLength;
 }
 
+uint16_t Ip4Header::getIdentification() const {
+    return identification;
+}
+
+bool Ip4Header::isDontFragment() const {
+    return dontFragment;
+}
+
+bool Ip4Header::hasMoreFragments() const {
+    return moreFragments;
+}
+
+uint16_t Ip4Header::getFragmentOffset() const {
+    return fragmentOffset;
+}
+
+bool Ip4Header::isFragment() const {
+    return moreFragments || fragmentOffset > 0;
+}
+
 uint8_t Ip4Header::getTimeToLive() const {
     return timeToLive;
 }
@@ -116,6 +137,22 @@ void Ip4Header::setPayloadLength(uint16_t payloadLength) {
     Ip4Header::payloadLength = payloadLength;
 }
 
+void Ip4Header::setIdentification(uint16_t identification) {
+    Ip4Header::identification = identification;
+}
+
+void Ip4Header::setDontFragment(bool dontFragment) {
+    Ip4Header::dontFragment = dontFragment;
+}
+
+void Ip4Header::setMoreFragments(bool moreFragments) {
+    Ip4Header::moreFragments = moreFragments;
+}
+
+void Ip4Header::setFragmentOffset(uint16_t fragmentOffset) {
+    Ip4Header::fragmentOffset = fragmentOffset;
+}
+
 void Ip4Header::setTimeToLive(uint8_t timeToLive) {
     Ip4Header::timeToLive = timeToLive;
 }
@@ -74,6 +74,22 @@ public:
 
     [[nodiscard]] uint16_t getPayloadLength() const;
 
+    [[nodiscard]] uint16_t getIdentification() const;
+
+    [[nodiscard]] bool isDontFragment() const;
+
+    [[nodiscard]] bool hasMoreFragments() const;
+
+    /**
+     * Get the offset of this fragment's payload inside the original datagram in bytes.
+     */
+    [[nodiscard]] uint16_t getFragmentOffset() const;
+
+    /**
+     * Check, if the packet only carries a part of a datagram (i.e. it has an offset or more fragments follow).
+     */
+    [[nodiscard]] bool isFragment() const;
+
     [[nodiscard]] uint8_t getTimeToLive() const;
 
     [[nodiscard]] Protocol getProtocol() const;
@@ -84,6 +100,17 @@ public:
 
     void setPayloadLength(uint16_t payloadLength);
 
+    void setIdentification(uint16_t identification);
+
+    void setDontFragment(bool dontFragment);
+
+    void setMoreFragments(bool moreFragments);
+
+    /**
+     * Set the offset of this fragment's payload inside the original datagram in bytes (must be a multiple of FRAGMENT_OFFSET_UNIT).
+     */
+    void setFragmentOffset(uint16_t fragmentOffset);
+
     void setTimeToLive(uint8_t timeToLive);
 
     void setProtocol(Protocol aProtocol);
@@ -92,15 +119,25 @@ public:
 
     void setDestinationAddress(const Util::Network::Ip4::Ip4Address &destinationAddress);
 
+    static const constexpr uint32_t PROTOCOL_OFFSET = 9;
     static const constexpr uint32_t CHECKSUM_OFFSET = 10;
+    static const constexpr uint32_t MIN_HEADER_LENGTH = 20;
+    static const constexpr uint32_t MAX_PACKET_LENGTH = 65535;
+    static const constexpr uint32_t FRAGMENT_OFFSET_UNIT = 8;
 
 private:
 
-    static const constexpr uint32_t MIN_HEADER_LENGTH = 20;
+    static const constexpr uint16_t DONT_FRAGMENT = 0x4000;
+    static const constexpr uint16_t MORE_FRAGMENTS = 0x2000;
+    static const constexpr uint16_t FRAGMENT_OFFSET_MASK = 0x1fff;
 
     uint8_t version = 4;
     uint8_t headerLength = MIN_HEADER_LENGTH;
     uint16_t payloadLength = 0;
+    uint16_t identification = 0;
+    bool dontFragment = false;
+    bool moreFragments = false;
+    uint16_t fragmentOffset = 0;
     uint8_t timeToLive = 64;
     Protocol protocol{};
     Util::Network::Ip4::Ip4Address sourceAddress{};
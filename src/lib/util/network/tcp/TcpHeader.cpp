@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "lib/util/network/tcp/TcpHeader.h"
+
+#include "lib/util/network/NumberUtil.h"
+
+namespace Util {
+namespace Io {
+class InputStream;
+class OutputStream;
+}  // namespace Stream
+}  // namespace Util
+
+namespace Util::Network::Tcp {
+
+void TcpHeader::read(Util::Io::InputStream &stream) {
+    sourcePort = Util::Network::NumberUtil::readUnsigned16BitValue(stream);
+    destinationPort = Util::Network::NumberUtil::readUnsigned16BitValue(stream);
+    sequenceNumber = Util::Network::NumberUtil::readUnsigned32BitValue(stream);
+    acknowledgementNumber = Util::Network::NumberUtil::readUnsigned32BitValue(stream);
+    headerLength = (Util::Network::NumberUtil::readUnsigned8BitValue(stream) >> 4) * sizeof(uint32_t);
+    flags = Util::Network::NumberUtil::readUnsigned8BitValue(stream);
+    windowSize = Util::Network::NumberUtil::readUnsigned16BitValue(stream);
+    checksum = Util::Network::NumberUtil::readUnsigned16BitValue(stream);
+    urgentPointer = Util::Network::NumberUtil::readUnsigned16BitValue(stream);
+
+    maximumSegmentSize = 0;
+    windowScalePresent = false;
+
+    uint32_t position = HEADER_SIZE;
+    while (position < headerLength) {
+        auto kind = Util::Network::NumberUtil::readUnsigned8BitValue(stream);
+        position++;
+
+        if (kind == NO_OPERATION) {
+            continue;
+        }
+
+        if (kind == END_OF_OPTIONS || position >= headerLength) {
+            break;
+        }
+
+        auto length = Util::Network::NumberUtil::readUnsigned8BitValue(stream);
+        position++;
+        if (length < 2 || position + length - 2 > headerLength) {
+            break; // Malformed option
+        }
+
+        if (kind == MAXIMUM_SEGMENT_SIZE && length == 4) {
+            maximumSegmentSize = Util::Network::NumberUtil::readUnsigned16BitValue(stream);
+        } else if (kind == WINDOW_SCALE && length == 3) {
+            windowScale = Util::Network::NumberUtil::readUnsigned8BitValue(stream);
+            windowScalePresent = true;
+        } else {
+            for (uint32_t i = 2; i < length; i++) {
+                Util::Network::NumberUtil::readUnsigned8BitValue(stream);
+            }
+        }
+
+        position += length - 2;
+    }
+
+    // Skip remaining option bytes, so that the stream points to the payload
+    for (; position < headerLength; position++) {
+        Util::Network::NumberUtil::readUnsigned8BitValue(stream);
+    }
+}
+
+void TcpHeader::write(Util::Io::OutputStream &stream) const {
+    Util::Network::NumberUtil::writeUnsigned16BitValue(sourcePort, stream);
+    Util::Network::NumberUtil::writeUnsigned16BitValue(destinationPort, stream);
+    Util::Network::NumberUtil::writeUnsigned32BitValue(sequenceNumber, stream);
+    Util::Network::NumberUtil::writeUnsigned32BitValue(acknowledgementNumber, stream);
+    Util::Network::NumberUtil::writeUnsigned8BitValue((getHeaderLength() / sizeof(uint32_t)) << 4, stream);
+    Util::Network::NumberUtil::writeUnsigned8BitValue(flags, stream);
+    Util::Network::NumberUtil::writeUnsigned16BitValue(windowSize, stream);
+    Util::Network::NumberUtil::writeUnsigned16BitValue(checksum, stream);
+    Util::Network::NumberUtil::writeUnsigned16BitValue(urgentPointer, stream);
+
+    if (maximumSegmentSize > 0) {
+        Util::Network::NumberUtil::writeUnsigned8BitValue(MAXIMUM_SEGMENT_SIZE, stream);
+        Util::Network::NumberUtil::writeUnsigned8BitValue(4, stream);
+        Util::Network::NumberUtil::writeUnsigned16BitValue(maximumSegmentSize, stream);
+    }
+
+    if (windowScalePresent) {
+        // Padded to four bytes with a leading NOP
+        Util::Network::NumberUtil::writeUnsigned8BitValue(NO_OPERATION, stream);
+        Util::Network::NumberUtil::writeUnsigned8BitValue(WINDOW_SCALE, stream);
+        Util::Network::NumberUtil::writeUnsigned8BitValue(3, stream);
+        Util::Network::NumberUtil::writeUnsigned8BitValue(windowScale, stream);
+    }
+}
+
+uint16_t TcpHeader::getSourcePort() const {
+    return sourcePort;
+}
+
+void TcpHeader::setSourcePort(uint16_t sourcePort) {
+    TcpHeader::sourcePort = sourcePort;
+}
+
+uint16_t TcpHeader::getDestinationPort() const {
+    return destinationPort;
+}
+
+void TcpHeader::setDestinationPort(uint16_t destinationPort) {
+    TcpHeader::destinationPort = destinationPort;
+}
+
+uint32_t TcpHeader::getSequenceNumber() const {
+    return sequenceNumber;
+}
+
+void TcpHeader::setSequenceNumber(uint32_t sequenceNumber) {
+    TcpHeader::sequenceNumber = sequenceNumber;
+}
+
+uint32_t TcpHeader::getAcknowledgementNumber() const {
+    return acknowledgementNumber;
+}
+
+void TcpHeader::setAcknowledgementNumber(uint32_t acknowledgementNumber) {
+    TcpHeader::acknowledgementNumber = acknowledgementNumber;
+}
+
+uint8_t TcpHeader::getFlags() const {
+    return flags;
+}
+
+bool TcpHeader::hasFlag(TcpHeader::Flag flag) const {
+    return (flags & flag) != 0;
+}
+
+void TcpHeader::setFlags(uint8_t flags) {
+    TcpHeader::flags = flags;
+}
+
+uint16_t TcpHeader::getWindowSize() const {
+    return windowSize;
+}
+
+void TcpHeader::setWindowSize(uint16_t windowSize) {
+    TcpHeader::windowSize = windowSize;
+}
+
+uint16_t TcpHeader::getChecksum() const {
+    return checksum;
+}
+
+uint16_t TcpHeader::getMaximumSegmentSize() const {
+    return maximumSegmentSize;
+}
+
+void TcpHeader::setMaximumSegmentSize(uint16_t maximumSegmentSize) {
+    TcpHeader::maximumSegmentSize = maximumSegmentSize;
+}
+
+bool TcpHeader::hasWindowScale() const {
+    return windowScalePresent;
+}
+
+uint8_t TcpHeader::getWindowScale() const {
+    return windowScale;
+}
+
+void TcpHeader::setWindowScale(uint8_t windowScale) {
+    TcpHeader::windowScale = windowScale;
+    windowScalePresent = true;
+}
+
+uint8_t TcpHeader::getHeaderLength() const {
+    return HEADER_SIZE + (maximumSegmentSize > 0 ? 4 : 0) + (windowScalePresent ? 4 : 0);
+}
+
+}
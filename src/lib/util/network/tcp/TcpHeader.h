@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2018-2024 Heinrich-Heine-Universitaet Duesseldorf,
+ * Institute of Computer Science, Department Operating Systems
+ * Burak Akguel, Christian Gesse, Fabian Ruhland, Filip Krakowski, Michael Schoettner
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef HHUOS_TCPHEADER_H
+#define HHUOS_TCPHEADER_H
+
+#include <stdint.h>
+
+namespace Util {
+namespace Io {
+class InputStream;
+class OutputStream;
+}  // namespace Stream
+}  // namespace Util
+
+namespace Util::Network::Tcp {
+
+/**
+ * TCP segment header (RFC 9293) with the options for maximum segment size and window scaling (RFC 7323).
+ * Other options are skipped when reading a header.
+ */
+class TcpHeader {
+
+public:
+
+    enum Flag : uint8_t {
+        FIN = 0x01,
+        SYN = 0x02,
+        RST = 0x04,
+        PSH = 0x08,
+        ACK = 0x10,
+        URG = 0x20
+    };
+
+    /**
+     * Default Constructor.
+     */
+    TcpHeader() = default;
+
+    /**
+     * Copy Constructor.
+     */
+    TcpHeader(const TcpHeader &other) = delete;
+
+    /**
+     * Assignment operator.
+     */
+    TcpHeader &operator=(const TcpHeader &other) = delete;
+
+    /**
+     * Destructor.
+     */
+    ~TcpHeader() = default;
+
+    void read(Util::Io::InputStream &stream);
+
+    void write(Util::Io::OutputStream &stream) const;
+
+    [[nodiscard]] uint16_t getSourcePort() const;
+
+    void setSourcePort(uint16_t sourcePort);
+
+    [[nodiscard]] uint16_t getDestinationPort() const;
+
+    void setDestinationPort(uint16_t destinationPort);
+
+    [[nodiscard]] uint32_t getSequenceNumber() const;
+
+    void setSequenceNumber(uint32_t sequenceNumber);
+
+    [[nodiscard]] uint32_t getAcknowledgementNumber() const;
+
+    void setAcknowledgementNumber(uint32_t acknowledgementNumber);
+
+    [[nodiscard]] uint8_t getFlags() const;
+
+    [[nodiscard]] bool hasFlag(Flag flag) const;
+
+    void setFlags(uint8_t flags);
+
+    [[nodiscard]] uint16_t getWindowSize() const;
+
+    void setWindowSize(uint16_t windowSize);
+
+    [[nodiscard]] uint16_t getChecksum() const;
+
+    /**
+     * Get the maximum segment size, announced by the sender (0, if the option is not present).
+     */
+    [[nodiscard]] uint16_t getMaximumSegmentSize() const;
+
+    void setMaximumSegmentSize(uint16_t maximumSegmentSize);
+
+    [[nodiscard]] bool hasWindowScale() const;
+
+    [[nodiscard]] uint8_t getWindowScale() const;
+
+    void setWindowScale(uint8_t windowScale);
+
+    /**
+     * Get the length of the header including options (always a multiple of 4 bytes).
+     */
+    [[nodiscard]] uint8_t getHeaderLength() const;
+
+    static const constexpr uint32_t HEADER_SIZE = 20;
+    static const constexpr uint32_t CHECKSUM_OFFSET = 16;
+
+private:
+
+    enum Option : uint8_t {
+        END_OF_OPTIONS = 0,
+        NO_OPERATION = 1,
+        MAXIMUM_SEGMENT_SIZE = 2,
+        WINDOW_SCALE = 3
+    };
+
+    uint16_t sourcePort{};
+    uint16_t destinationPort{};
+    uint32_t sequenceNumber{};
+    uint32_t acknowledgementNumber{};
+    uint8_t headerLength = HEADER_SIZE;
+    uint8_t flags{};
+    uint16_t windowSize{};
+    uint16_t checksum{};
+    uint16_t urgentPointer{};
+
+    uint16_t maximumSegmentSize{};
+    bool windowScalePresent = false;
+    uint8_t windowScale{};
+};
+
+}
+
+#endif